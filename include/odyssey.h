@@ -7,10 +7,24 @@
  */
 
 #include <QMainWindow>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
 
+#include "odyssey_clustered_lights.h"
 #include "odyssey_keyboard_event.h"
+#include "odyssey_mesh_stream.h"
 #include "odyssey_model.h"
 #include "odyssey_object.h"
+#include "odyssey_options.h"
+#include "odyssey_picker.h"
+#include "odyssey_point_cloud.h"
+#include "odyssey_redraw_scheduler.h"
+#include "odyssey_render_graph.h"
+#include "odyssey_render_thread.h"
+#include "odyssey_scene_graph.h"
+#include "odyssey_static_batcher.h"
 
 namespace Ui {
 class Odyssey;
@@ -25,8 +39,14 @@ class OdysseyRenderSystem;
 class OdysseyCamera;
 
 class Odyssey : public QMainWindow {
+private:
+    struct PendingInput {
+        OdysseyKeyboardEventType type{};
+        double time{};
+    };
+
 public:
-    Odyssey();
+    explicit Odyssey(const OdysseyOptions& options);
     ~Odyssey();
     Odyssey(const Odyssey& odyssey) = delete;
     Odyssey(Odyssey&& odyssey) = delete;
@@ -35,11 +55,16 @@ public:
 
 private:
     virtual void paintEvent(QPaintEvent* event) override;
-    virtual void resizeEvent(QResizeEvent* event) override;
     virtual void keyPressEvent(QKeyEvent* event) override;
 
 private:
-    void draw();
+    // Render thread.
+    void handleCommand(OdysseyRenderCommand& command);
+    bool draw();
+    void publishSnapshot();
+    void sampleInput();
+    void recordBenchmarkFrame();
+    void recordFirstFrame();
 
 public slots:
     void importObject();
@@ -47,10 +72,37 @@ public slots:
 private:
     void keyboardCallback(const OdysseyKeyboardEventType& event);
     void loadObject(const std::string& filePath);
+    // Merged by the static batcher unless static batching is off.
+    void addStaticObjects(std::vector<OdysseyObject> objects);
 
 private:
     void setupUI();
     void setupEngine();
+    void createRenderSystem(const PipelineVariant& variant);
+    void setupTestScene();
+    void setupInteriorWalls();
+    void setupAssembly();
+    void animateTestScene();
+    void setupLights(uint32_t count);
+    void animateLights();
+    void updateSceneGraph();
+    void pickObject(float ndcX, float ndcY);
+    void setupRenderGraph();
+    // With --dump-render-graph: compiles a chain of transients and checks
+    // which of them share memory.
+    void checkTransientAliasing();
+    void setupOcclusionPasses();
+    // Where the scene's render passes leave its color.
+    vk::ImageLayout getSceneColorLayout() const;
+    vk::SubpassContents getSceneContents() const;
+    // Inside the scene pass, after the objects.
+    void renderStreamedGeometry(vk::CommandBuffer commandBuffer);
+    void setupScheduler();
+    // UI thread: times the event loop while measuring, and shows the latest
+    // snapshot whenever the render thread publishes one.
+    void setupHeartbeat();
+    void heartbeat();
+    void showStatus();
     void setupEvent();
     void setupSignalsSlots();
 
@@ -60,8 +112,53 @@ private:
     OdysseyDevice* m_device{};
     OdysseyRender* m_render{};
     std::vector<OdysseyObject> m_objects{};
+    OdysseySceneGraph m_sceneGraph{};
+    std::unique_ptr<OdysseyPicker> m_picker{};
+    std::unique_ptr<OdysseyStaticBatcher> m_staticBatcher{};
+    uint32_t m_assemblyNode{OdysseySceneGraph::INVALID_NODE};
+    std::unique_ptr<OdysseyPointCloud> m_pointCloud{};
+    std::unique_ptr<OdysseyMeshStream> m_meshStream{};
+    size_t m_testSceneFirst{0};
+    uint64_t m_animationFrame{0};
+    std::vector<OdysseyPointLight> m_lights{};
+    // Each light circles its own point at its own phase.
+    std::vector<glm::vec4> m_lightOrbits{};
+    uint64_t m_lightFrame{0};
+    size_t m_lightSweepStep{0};
     OdysseyRenderSystem* m_renderSystem{};
     OdysseyCamera* m_camera{};
+    std::unique_ptr<OdysseyRenderGraph> m_renderGraph{};
+    RenderGraphResource m_backbuffer{};
+    RenderGraphResource m_depth{};
+    // The backbuffer, unless dynamic resolution renders offscreen.
+    RenderGraphResource m_sceneColor{};
+    uint64_t m_renderPassVersion{0};
+    OdysseyOptions m_options{};
+    OdysseyRedrawScheduler* m_scheduler{};
+    // Owns every member above from start() until the destructor stops it;
+    // the UI thread only reaches them through commands and snapshots.
+    std::unique_ptr<OdysseyRenderThread> m_renderThread{};
+    QTimer* m_redrawReportTimer{};
+    QTimer* m_heartbeatTimer{};
+    QTimer* m_statusTimer{};
+    // Set by the render thread when it queues showStatus(), cleared there.
+    std::atomic<bool> m_statusQueued{false};
+    std::chrono::steady_clock::time_point m_lastHeartbeat{};
+    std::chrono::steady_clock::time_point m_lastStall{};
+    std::chrono::steady_clock::time_point m_lastStatus{};
+    std::chrono::steady_clock::time_point m_lastDrawnFrame{};
+    OdysseyPickSnapshot m_lastPick{};
+    std::vector<PendingInput> m_pendingInput{};
+    std::vector<double> m_benchmarkFrameTimes{};
+    std::vector<double> m_benchmarkCpuTimes{};
+    std::vector<double> m_benchmarkGpuTimes{};
+    std::vector<double> m_benchmarkScales{};
+    size_t m_benchmarkReplayedFrames{0};
+    double m_cpuFrameTime{0.0};
+    std::chrono::steady_clock::time_point m_lastFrameTime{};
+    bool m_firstFramePresented{false};
+    std::future<std::unique_ptr<Assimp::Importer>> m_importerReady{};
+    std::unique_ptr<Assimp::Importer> m_importer{};
 };
 
 }  // namespace odyssey
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+/**
+ * @file odyssey_buffer.h
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include "odyssey_header.h"
+
+namespace odyssey {
+
+class OdysseyDevice;
+
+class OdysseyBuffer {
+public:
+    OdysseyBuffer(OdysseyDevice* device, vk::DeviceSize instanceSize, uint32_t instanceCount, vk::BufferUsageFlags usageFlags, vk::MemoryPropertyFlags memoryPropertyFlags, vk::DeviceSize minOffsetAlignment = 1);
+    ~OdysseyBuffer();
+
+    OdysseyBuffer() = delete;
+    OdysseyBuffer(const OdysseyBuffer& odysseyBuffer) = delete;
+    OdysseyBuffer(OdysseyBuffer&& odysseyBuffer) = delete;
+    OdysseyBuffer& operator=(const OdysseyBuffer& odysseyBuffer) = delete;
+    OdysseyBuffer& operator=(OdysseyBuffer&& odysseyBuffer) = delete;
+
+public:
+    void map(vk::DeviceSize size = VK_WHOLE_SIZE, vk::DeviceSize offset = 0);
+    void unmap();
+    void writeToBuffer(const void* data, vk::DeviceSize size = VK_WHOLE_SIZE, vk::DeviceSize offset = 0);
+    void flush(vk::DeviceSize size = VK_WHOLE_SIZE, vk::DeviceSize offset = 0);
+    void writeToIndex(const void* data, uint32_t index);
+    void flushIndex(uint32_t index);
+    vk::DescriptorBufferInfo descriptorInfo(vk::DeviceSize size = VK_WHOLE_SIZE, vk::DeviceSize offset = 0) const;
+    vk::DescriptorBufferInfo descriptorInfoForIndex(uint32_t index) const;
+
+public:
+    vk::Buffer getBuffer() const;
+    void* getMappedMemory() const;
+    uint32_t getInstanceCount() const;
+    vk::DeviceSize getInstanceSize() const;
+    vk::DeviceSize getAlignmentSize() const;
+    vk::DeviceSize getBufferSize() const;
+
+private:
+    static vk::DeviceSize getAlignment(vk::DeviceSize instanceSize, vk::DeviceSize minOffsetAlignment);
+
+private:
+    OdysseyDevice* m_device{};
+    void* m_mapped{nullptr};
+    vk::Buffer m_buffer{};
+    vk::DeviceMemory m_memory{};
+    vk::DeviceSize m_bufferSize{};
+    uint32_t m_instanceCount{};
+    vk::DeviceSize m_instanceSize{};
+    vk::DeviceSize m_alignmentSize{};
+    vk::BufferUsageFlags m_usageFlags{};
+    vk::MemoryPropertyFlags m_memoryPropertyFlags{};
+};
+
+}  // namespace odyssey
\ No newline at end of file
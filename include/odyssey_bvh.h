@@ -0,0 +1,121 @@
+#pragma once
+
+/**
+ * @file odyssey_bvh.h
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "odyssey_header.h"
+
+namespace odyssey {
+
+struct OdysseyRay {
+    glm::vec3 origin{0.0F};
+    // Not necessarily normalized; hit distances are in units of its length.
+    glm::vec3 direction{0.0F, 0.0F, 1.0F};
+};
+
+struct OdysseyAabb {
+    glm::vec3 min{std::numeric_limits<float>::infinity()};
+    glm::vec3 max{-std::numeric_limits<float>::infinity()};
+
+    void grow(const glm::vec3& point);
+    void grow(const OdysseyAabb& aabb);
+    float area() const;
+    OdysseyAabb transformed(const glm::mat4& matrix) const;
+};
+
+/**
+ * Bounding volume hierarchy over any primitives given as boxes, built with
+ * binned SAH. Nodes are flattened into one array with both children of a
+ * node next to each other, so a node is 32 bytes and two fit a cache line.
+ */
+class OdysseyBvh {
+public:
+    struct Node {
+        glm::vec3 min{};
+        // First primitive of a leaf, or the left child of an inner node; the
+        // right child follows it.
+        uint32_t first{0};
+        glm::vec3 max{};
+        // Zero for inner nodes.
+        uint32_t count{0};
+    };
+
+public:
+    OdysseyBvh() = default;
+    ~OdysseyBvh() = default;
+    OdysseyBvh(const OdysseyBvh& odysseyBvh) = delete;
+    OdysseyBvh(OdysseyBvh&& odysseyBvh) = default;
+    OdysseyBvh& operator=(const OdysseyBvh& odysseyBvh) = delete;
+    OdysseyBvh& operator=(OdysseyBvh&& odysseyBvh) = default;
+
+public:
+    void build(const std::vector<OdysseyAabb>& bounds);
+    bool empty() const;
+    OdysseyAabb getBounds() const;
+    size_t getNodeCount() const;
+
+    // Calls intersect(primitive, tMax) for every primitive in a leaf the ray
+    // reaches before tMax, nearest child first; intersect lowers tMax on a hit.
+    template <typename Intersect>
+    void traverse(const OdysseyRay& ray, float& tMax, Intersect&& intersect) const {
+        if (m_nodes.empty()) {
+            return;
+        }
+        auto inverseDirection = 1.0F / ray.direction;
+        uint32_t stack[MAX_DEPTH + 1]{};
+        uint32_t stackSize{0};
+        if (intersectNode(m_nodes[0], ray.origin, inverseDirection, tMax) == NO_HIT) {
+            return;
+        }
+        stack[stackSize++] = 0;
+        while (stackSize > 0) {
+            const auto& node = m_nodes[stack[--stackSize]];
+            if (node.count > 0) {
+                for (auto i = node.first; i < node.first + node.count; ++i) {
+                    intersect(m_primitives[i], tMax);
+                }
+                continue;
+            }
+            auto nearChild = node.first;
+            auto farChild = node.first + 1;
+            auto nearDistance = intersectNode(m_nodes[nearChild], ray.origin, inverseDirection, tMax);
+            auto farDistance = intersectNode(m_nodes[farChild], ray.origin, inverseDirection, tMax);
+            if (farDistance < nearDistance) {
+                std::swap(nearChild, farChild);
+                std::swap(nearDistance, farDistance);
+            }
+            // The nearer child is popped first; the farther one may be
+            // visited after a hit has already lowered tMax.
+            if (farDistance != NO_HIT) {
+                stack[stackSize++] = farChild;
+            }
+            if (nearDistance != NO_HIT) {
+                stack[stackSize++] = nearChild;
+            }
+        }
+    }
+
+public:
+    static constexpr float NO_HIT{std::numeric_limits<float>::infinity()};
+    static constexpr uint32_t MAX_LEAF_SIZE{8};
+    // Traversal stack size; build() stops splitting below this depth.
+    static constexpr uint32_t MAX_DEPTH{64};
+
+private:
+    static float intersectNode(const Node& node, const glm::vec3& origin, const glm::vec3& inverseDirection, float tMax);
+    void subdivide(uint32_t nodeIndex, uint32_t depth, const std::vector<OdysseyAabb>& bounds, const std::vector<glm::vec3>& centroids);
+
+private:
+    std::vector<Node> m_nodes{};
+    std::vector<uint32_t> m_primitives{};
+};
+
+}  // namespace odyssey
\ No newline at end of file
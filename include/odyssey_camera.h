@@ -6,6 +6,7 @@
  * @date 2023-04-21
  */
 
+#include "odyssey_bvh.h"
 #include "odyssey_header.h"
 
 namespace odyssey {
@@ -28,10 +29,20 @@ public:
 
     const glm::mat4& getProjection() const;
     const glm::mat4& getView() const;
+    // Ray from the near plane through a point in normalized device
+    // coordinates, y down as in OdysseyMouseEvent; direction is unnormalized
+    // and reaches the far plane at t = 1.
+    OdysseyRay getRay(float ndcX, float ndcY) const;
+    // Changes whenever the projection or view matrix does.
+    uint64_t getVersion() const;
+
+private:
+    void updateVersion(const glm::mat4& previous, const glm::mat4& current);
 
 private:
     glm::mat4 m_projectionMat{1.0F};
     glm::mat4 m_viewMat{1.0F};
+    uint64_t m_version{0};
 };
 
 }  // namespace odyssey
\ No newline at end of file
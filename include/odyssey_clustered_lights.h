@@ -0,0 +1,109 @@
+#pragma once
+
+/**
+ * @file odyssey_clustered_lights.h
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include <memory>
+#include <vector>
+
+#include "odyssey_buffer.h"
+#include "odyssey_camera.h"
+#include "odyssey_descriptors.h"
+#include "odyssey_header.h"
+#include "odyssey_pipeline.h"
+
+namespace odyssey {
+
+class OdysseyDevice;
+
+// Must match PointLight in light_cull.comp and shader.frag.
+struct OdysseyPointLight {
+    // World-space position and the distance the light reaches.
+    glm::vec4 positionRadius{0.0F, 0.0F, 0.0F, 1.0F};
+    // Color times intensity; w unused.
+    glm::vec4 color{1.0F};
+};
+
+/**
+ * Point lights binned into a froxel grid, for clustered forward shading.
+ * The view frustum is split into CLUSTERS_X by CLUSTERS_Y screen tiles and
+ * CLUSTERS_Z depth slices, spaced exponentially between the near and far
+ * planes so that near slices stay thin. light_cull.comp tests every light's
+ * sphere against every cluster's view-space box and writes each cluster's
+ * light count followed by its light indices; shader.frag finds its cluster
+ * from the pixel and view depth and loops over that list alone.
+ */
+class OdysseyClusteredLights {
+public:
+    // Where shader.frag finds this frame's lights and clusters, as written
+    // to GlobalData.
+    struct FrameInfo {
+        // (clusters per pixel in x and y, slice scale, slice bias): the
+        // slice of view depth z is log(z) * scale + bias.
+        glm::vec4 clusterScale{0.0F};
+        // (light count, first light, first cluster word, unused).
+        glm::uvec4 lightInfo{0U};
+    };
+
+public:
+    explicit OdysseyClusteredLights(OdysseyDevice* device);
+    ~OdysseyClusteredLights();
+
+    OdysseyClusteredLights() = delete;
+    OdysseyClusteredLights(const OdysseyClusteredLights& odysseyClusteredLights) = delete;
+    OdysseyClusteredLights(OdysseyClusteredLights&& odysseyClusteredLights) = delete;
+    OdysseyClusteredLights& operator=(const OdysseyClusteredLights& odysseyClusteredLights) = delete;
+    OdysseyClusteredLights& operator=(OdysseyClusteredLights&& odysseyClusteredLights) = delete;
+
+public:
+    // Outside a render pass, once the frame's fence has been waited on:
+    // copies the lights into the frame's slot and bins them for the camera.
+    // Lights past MAX_LIGHTS are dropped.
+    void cull(vk::CommandBuffer commandBuffer, const std::vector<OdysseyPointLight>& lights, const OdysseyCamera& camera, vk::Extent2D extent, size_t frameIndex);
+    const FrameInfo& getFrameInfo(size_t frameIndex) const;
+    // Every frame's slots; shader.frag offsets into them with FrameInfo.
+    vk::DescriptorBufferInfo getLightBufferInfo() const;
+    vk::DescriptorBufferInfo getClusterBufferInfo() const;
+
+public:
+    // Must match the constants in light_cull.comp and shader.frag.
+    static constexpr uint32_t CLUSTERS_X{16};
+    static constexpr uint32_t CLUSTERS_Y{9};
+    static constexpr uint32_t CLUSTERS_Z{24};
+    static constexpr uint32_t CLUSTER_COUNT{CLUSTERS_X * CLUSTERS_Y * CLUSTERS_Z};
+    // A cluster's count and its light indices; lights past the limit are
+    // left out of that cluster.
+    static constexpr uint32_t MAX_LIGHTS_PER_CLUSTER{255};
+    static constexpr uint32_t CLUSTER_STRIDE{MAX_LIGHTS_PER_CLUSTER + 1};
+    static constexpr uint32_t MAX_LIGHTS{16384};
+
+private:
+    // Must match the push constant block in light_cull.comp.
+    struct PushConstantData {
+        glm::mat4 view{1.0F};
+        // (projection[0][0], projection[1][1], near, far).
+        glm::vec4 projection{0.0F};
+        uint32_t lightCount{0};
+        uint32_t firstLight{0};
+        uint32_t firstCluster{0};
+        uint32_t padding{0};
+    };
+
+private:
+    OdysseyDevice* m_device{};
+    // MAX_LIGHTS per frame in flight, written by the CPU every frame.
+    std::unique_ptr<OdysseyBuffer> m_lightBuffer{};
+    // CLUSTER_COUNT * CLUSTER_STRIDE words per frame in flight.
+    std::unique_ptr<OdysseyBuffer> m_clusterBuffer{};
+    std::unique_ptr<OdysseyDescriptorSetLayout> m_setLayout{};
+    std::unique_ptr<OdysseyDescriptorPool> m_descriptorPool{};
+    vk::DescriptorSet m_descriptorSet{};
+    vk::PipelineLayout m_pipelineLayout{};
+    std::unique_ptr<OdysseyComputePipeline> m_pipeline{};
+    std::vector<FrameInfo> m_frames{};
+};
+
+}  // namespace odyssey
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+/**
+ * @file odyssey_command_pools.h
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include <vector>
+
+#include "odyssey_header.h"
+
+namespace odyssey {
+
+class OdysseyDevice;
+
+/**
+ * One command pool per frame in flight and recording thread. A pool is only
+ * ever touched by its own thread, so recording needs no locking, and a frame's
+ * pools are reset in one call once its fence has signalled instead of resetting
+ * every buffer on its own. Buffers are kept and handed out again after a reset.
+ */
+class OdysseyCommandPools {
+public:
+    // Pools whose buffers outlive a frame should pass no eTransient hint.
+    OdysseyCommandPools(OdysseyDevice* device, size_t frameCount, size_t threadCount, vk::CommandPoolCreateFlags flags = vk::CommandPoolCreateFlagBits::eTransient);
+    ~OdysseyCommandPools();
+
+    OdysseyCommandPools() = delete;
+    OdysseyCommandPools(const OdysseyCommandPools& odysseyCommandPools) = delete;
+    OdysseyCommandPools(OdysseyCommandPools&& odysseyCommandPools) = delete;
+    OdysseyCommandPools& operator=(const OdysseyCommandPools& odysseyCommandPools) = delete;
+    OdysseyCommandPools& operator=(OdysseyCommandPools&& odysseyCommandPools) = delete;
+
+public:
+    void reset(size_t frameIndex);
+    vk::CommandBuffer allocate(size_t frameIndex, size_t threadIndex, vk::CommandBufferLevel level);
+    size_t getThreadCount() const;
+
+private:
+    // Cache-line aligned, since neighbouring pools are used by different threads.
+    struct alignas(64) Pool {
+        vk::CommandPool pool{};
+        std::vector<vk::CommandBuffer> primaries{};
+        std::vector<vk::CommandBuffer> secondaries{};
+        size_t usedPrimaries{0};
+        size_t usedSecondaries{0};
+    };
+
+private:
+    OdysseyDevice* m_device{};
+    size_t m_threadCount{};
+    // frameIndex * m_threadCount + threadIndex.
+    std::vector<Pool> m_pools{};
+};
+
+}  // namespace odyssey
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+
+/**
+ * @file odyssey_culling.h
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "odyssey_header.h"
+
+namespace odyssey {
+
+/**
+ * Six planes (left, right, bottom, top, near, far) as (normal, distance) with
+ * normals pointing inwards and normalized, so a point's signed distance to a
+ * plane is dot(normal, point) + distance.
+ */
+struct OdysseyFrustum {
+    std::array<glm::vec4, 6> planes{};
+
+    static OdysseyFrustum fromMatrix(const glm::mat4& projectionView);
+};
+
+/**
+ * Sphere-against-frustum visibility over structure-of-arrays bounds. Spheres
+ * are tested four or eight at a time with SSE or AVX, picked at runtime, and
+ * large sets are split across OdysseyThreadPool.
+ */
+class OdysseyCuller {
+public:
+    OdysseyCuller() = default;
+    ~OdysseyCuller() = default;
+    OdysseyCuller(const OdysseyCuller& odysseyCuller) = delete;
+    OdysseyCuller(OdysseyCuller&& odysseyCuller) = delete;
+    OdysseyCuller& operator=(const OdysseyCuller& odysseyCuller) = delete;
+    OdysseyCuller& operator=(OdysseyCuller&& odysseyCuller) = delete;
+
+public:
+    void resize(size_t count);
+    // A negative radius marks an object without bounds, which is never culled.
+    void setSphere(size_t index, const glm::vec3& center, float radius);
+    size_t cull(const OdysseyFrustum& frustum);
+
+    bool isVisible(size_t index) const;
+    size_t getCount() const;
+    size_t getVisibleCount() const;
+
+public:
+    // Objects per parallelFor chunk; smaller sets are culled on the calling thread.
+    static constexpr size_t PARALLEL_GRAIN_SIZE{16384};
+
+private:
+    size_t cullRange(const OdysseyFrustum& frustum, size_t begin, size_t end);
+
+private:
+    size_t m_count{0};
+    std::vector<float> m_centerX{};
+    std::vector<float> m_centerY{};
+    std::vector<float> m_centerZ{};
+    std::vector<float> m_radius{};
+    std::vector<uint8_t> m_visible{};
+    size_t m_visibleCount{0};
+};
+
+}  // namespace odyssey
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+/**
+ * @file odyssey_depth_pyramid.h
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include <memory>
+#include <vector>
+
+#include "odyssey_descriptors.h"
+#include "odyssey_header.h"
+#include "odyssey_pipeline.h"
+
+namespace odyssey {
+
+class OdysseyDevice;
+
+/**
+ * Hierarchical-Z pyramid built from a depth attachment, one per frame in
+ * flight. Level 0 is half the depth resolution and every texel holds the
+ * farthest depth of the texels it covers, down to a single texel, so a
+ * bounding rectangle can be tested against at most 2x2 texels of one level.
+ */
+class OdysseyDepthPyramid {
+public:
+    explicit OdysseyDepthPyramid(OdysseyDevice* device);
+    ~OdysseyDepthPyramid();
+
+    OdysseyDepthPyramid() = delete;
+    OdysseyDepthPyramid(const OdysseyDepthPyramid& odysseyDepthPyramid) = delete;
+    OdysseyDepthPyramid(OdysseyDepthPyramid&& odysseyDepthPyramid) = delete;
+    OdysseyDepthPyramid& operator=(const OdysseyDepthPyramid& odysseyDepthPyramid) = delete;
+    OdysseyDepthPyramid& operator=(OdysseyDepthPyramid&& odysseyDepthPyramid) = delete;
+
+public:
+    // depthView must be in eDepthStencilReadOnlyOptimal; the pyramid is left
+    // in eGeneral and visible to later compute shaders.
+    void build(vk::CommandBuffer commandBuffer, size_t frameIndex, vk::ImageView depthView, vk::Extent2D depthExtent);
+    vk::DescriptorImageInfo descriptorInfo(size_t frameIndex) const;
+    vk::ImageView getImageView(size_t frameIndex) const;
+    vk::Extent2D getExtent(size_t frameIndex) const;
+
+public:
+    static constexpr uint32_t MAX_LEVELS{16};
+
+private:
+    struct Level {
+        vk::ImageView view{};
+        vk::Extent2D extent{};
+        vk::DescriptorSet descriptorSet{};
+    };
+
+    struct Frame {
+        vk::Image image{};
+        vk::DeviceMemory memory{};
+        vk::ImageView view{};
+        vk::Extent2D extent{};
+        std::vector<Level> levels{};
+        vk::ImageView depthView{};
+    };
+
+    struct PushConstantData {
+        glm::ivec2 sourceSize{};
+        glm::ivec2 destinationSize{};
+    };
+
+private:
+    void createFrame(Frame& frame, vk::Extent2D extent);
+    void destroyFrame(Frame& frame);
+    void writeLevel(Level& level, vk::ImageView source, vk::ImageLayout sourceLayout);
+
+private:
+    OdysseyDevice* m_device{};
+    vk::Sampler m_sampler{};
+    std::unique_ptr<OdysseyDescriptorSetLayout> m_setLayout{};
+    std::unique_ptr<OdysseyDescriptorPool> m_descriptorPool{};
+    vk::PipelineLayout m_pipelineLayout{};
+    std::unique_ptr<OdysseyComputePipeline> m_pipeline{};
+    std::vector<Frame> m_frames{};
+};
+
+}  // namespace odyssey
\ No newline at end of file
@@ -0,0 +1,110 @@
+#pragma once
+
+/**
+ * @file odyssey_descriptors.h
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "odyssey_header.h"
+
+namespace odyssey {
+
+class OdysseyDevice;
+
+class OdysseyDescriptorSetLayout {
+public:
+    class Builder {
+    public:
+        explicit Builder(OdysseyDevice* device) : m_device(device) {}
+
+        Builder& addBinding(uint32_t binding, vk::DescriptorType descriptorType, vk::ShaderStageFlags stageFlags, uint32_t count = 1);
+        std::unique_ptr<OdysseyDescriptorSetLayout> build() const;
+
+    private:
+        OdysseyDevice* m_device{};
+        std::unordered_map<uint32_t, vk::DescriptorSetLayoutBinding> m_bindings{};
+    };
+
+public:
+    OdysseyDescriptorSetLayout(OdysseyDevice* device, const std::unordered_map<uint32_t, vk::DescriptorSetLayoutBinding>& bindings);
+    ~OdysseyDescriptorSetLayout();
+
+    OdysseyDescriptorSetLayout() = delete;
+    OdysseyDescriptorSetLayout(const OdysseyDescriptorSetLayout& odysseyDescriptorSetLayout) = delete;
+    OdysseyDescriptorSetLayout(OdysseyDescriptorSetLayout&& odysseyDescriptorSetLayout) = delete;
+    OdysseyDescriptorSetLayout& operator=(const OdysseyDescriptorSetLayout& odysseyDescriptorSetLayout) = delete;
+    OdysseyDescriptorSetLayout& operator=(OdysseyDescriptorSetLayout&& odysseyDescriptorSetLayout) = delete;
+
+public:
+    vk::DescriptorSetLayout getDescriptorSetLayout() const;
+
+private:
+    OdysseyDevice* m_device{};
+    vk::DescriptorSetLayout m_descriptorSetLayout{};
+    std::unordered_map<uint32_t, vk::DescriptorSetLayoutBinding> m_bindings{};
+
+    friend class OdysseyDescriptorWriter;
+};
+
+class OdysseyDescriptorPool {
+public:
+    class Builder {
+    public:
+        explicit Builder(OdysseyDevice* device) : m_device(device) {}
+
+        Builder& addPoolSize(vk::DescriptorType descriptorType, uint32_t count);
+        Builder& setPoolFlags(vk::DescriptorPoolCreateFlags flags);
+        Builder& setMaxSets(uint32_t count);
+        std::unique_ptr<OdysseyDescriptorPool> build() const;
+
+    private:
+        OdysseyDevice* m_device{};
+        std::vector<vk::DescriptorPoolSize> m_poolSizes{};
+        uint32_t m_maxSets{1000};
+        vk::DescriptorPoolCreateFlags m_poolFlags{};
+    };
+
+public:
+    OdysseyDescriptorPool(OdysseyDevice* device, uint32_t maxSets, vk::DescriptorPoolCreateFlags poolFlags, const std::vector<vk::DescriptorPoolSize>& poolSizes);
+    ~OdysseyDescriptorPool();
+
+    OdysseyDescriptorPool() = delete;
+    OdysseyDescriptorPool(const OdysseyDescriptorPool& odysseyDescriptorPool) = delete;
+    OdysseyDescriptorPool(OdysseyDescriptorPool&& odysseyDescriptorPool) = delete;
+    OdysseyDescriptorPool& operator=(const OdysseyDescriptorPool& odysseyDescriptorPool) = delete;
+    OdysseyDescriptorPool& operator=(OdysseyDescriptorPool&& odysseyDescriptorPool) = delete;
+
+public:
+    bool allocateDescriptorSet(vk::DescriptorSetLayout descriptorSetLayout, vk::DescriptorSet& descriptorSet) const;
+    void freeDescriptors(const std::vector<vk::DescriptorSet>& descriptorSets) const;
+    void resetPool();
+
+private:
+    OdysseyDevice* m_device{};
+    vk::DescriptorPool m_descriptorPool{};
+
+    friend class OdysseyDescriptorWriter;
+};
+
+class OdysseyDescriptorWriter {
+public:
+    OdysseyDescriptorWriter(OdysseyDescriptorSetLayout& setLayout, OdysseyDescriptorPool& pool);
+
+public:
+    OdysseyDescriptorWriter& writeBuffer(uint32_t binding, const vk::DescriptorBufferInfo* bufferInfo);
+    OdysseyDescriptorWriter& writeImage(uint32_t binding, const vk::DescriptorImageInfo* imageInfo);
+    bool build(vk::DescriptorSet& set);
+    void overwrite(const vk::DescriptorSet& set);
+
+private:
+    OdysseyDescriptorSetLayout& m_setLayout;
+    OdysseyDescriptorPool& m_pool;
+    std::vector<vk::WriteDescriptorSet> m_writes{};
+};
+
+}  // namespace odyssey
\ No newline at end of file
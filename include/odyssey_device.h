@@ -59,10 +59,20 @@ public:
     const vk::Queue& getGraphicsQueue() const;
     const vk::Queue& getPresentQueue() const;
     const vk::CommandPool& getCommandPool() const;
+    const vk::PipelineCache& getPipelineCache() const;
+    void savePipelineCache() const;
     void createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties, vk::Buffer& buffer, vk::DeviceMemory& memory);
     void copyBuffer(const vk::Buffer& src, vk::Buffer& dst, vk::DeviceSize size);
     vk::CommandBuffer beginSingleTimeCommands();
     void endSingleTimeCommands(vk::CommandBuffer commandBuffer);
+    uint32_t findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties);
+    // Whether a memory type allowed by typeFilter has all of properties.
+    bool supportsMemoryProperties(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const;
+    const vk::PhysicalDeviceProperties& getProperties() const;
+    vk::FormatProperties getFormatProperties(vk::Format format) const;
+    bool supportsMultiDrawIndirect() const;
+    bool supportsDrawIndirectFirstInstance() const;
+    bool supportsDrawIndirectCount() const;
 
 private:
     void createInstance();
@@ -70,6 +80,7 @@ private:
     void pickPhysicalDevice();
     void createLogicalDevice();
     void createCommandPool();
+    void createPipelineCache();
 
 private:
     bool checkValidationLayerSupport();
@@ -79,7 +90,6 @@ private:
     bool isPhysicalDeviceSuitable(const vk::PhysicalDevice& device);
     QueueFamilyIndices findQueueFamilies(const vk::PhysicalDevice& device) const;
     SwapChainSupportDetails querySwapChainSupport(const vk::PhysicalDevice& device) const;
-    uint32_t findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties);
 
 private:
 #if defined(NODEBUG)
@@ -94,10 +104,17 @@ private:
     vk::DebugUtilsMessengerEXT m_debugUtilsMessenger;
 #endif  // NODEBUG
 
+private:
+    static constexpr const char* PIPELINE_CACHE_PATH{"pipeline_cache.bin"};
+
 private:
     vk::Instance m_instance{};
     vk::SurfaceKHR m_surface{};
     vk::PhysicalDevice m_physical{};
+    vk::PhysicalDeviceProperties m_properties{};
+    bool m_multiDrawIndirect{false};
+    bool m_drawIndirectFirstInstance{false};
+    bool m_drawIndirectCount{false};
 
 private:
 #if defined(_WIN32)
@@ -111,6 +128,7 @@ private:
     vk::Queue m_graphicsQueue{};
     vk::Queue m_presentQueue{};
     vk::CommandPool m_commandPool{};
+    vk::PipelineCache m_pipelineCache{};
 };
 
 }  // namespace odyssey
\ No newline at end of file
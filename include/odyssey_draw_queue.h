@@ -0,0 +1,61 @@
+#pragma once
+
+/**
+ * @file odyssey_draw_queue.h
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace odyssey {
+
+/**
+ * One draw, ordered by key and pointing back at whatever describes the draw
+ * through index.
+ */
+struct OdysseyDrawPacket {
+    uint64_t key{0};
+    uint32_t index{0};
+};
+
+/**
+ * Draw packets for one frame, sorted by a 64-bit key with an LSD radix sort.
+ * From the most significant bits down the key holds the pipeline, material,
+ * model and quantized depth, so sorted draws change the most expensive state
+ * least often and draws sharing all state run front to back.
+ */
+class OdysseyDrawQueue {
+public:
+    OdysseyDrawQueue() = default;
+    ~OdysseyDrawQueue() = default;
+    OdysseyDrawQueue(const OdysseyDrawQueue& odysseyDrawQueue) = delete;
+    OdysseyDrawQueue(OdysseyDrawQueue&& odysseyDrawQueue) = delete;
+    OdysseyDrawQueue& operator=(const OdysseyDrawQueue& odysseyDrawQueue) = delete;
+    OdysseyDrawQueue& operator=(OdysseyDrawQueue&& odysseyDrawQueue) = delete;
+
+public:
+    void clear();
+    void reserve(size_t count);
+    void push(uint64_t key, uint32_t index);
+    void sort();
+    const std::vector<OdysseyDrawPacket>& getPackets() const;
+
+    // Fields wider than their bits are wrapped; depth is clamped to [0, 1]
+    // with 0 nearest.
+    static uint64_t makeKey(uint32_t pipeline, uint32_t material, uint32_t model, float depth);
+
+public:
+    static constexpr uint32_t PIPELINE_BITS{8};
+    static constexpr uint32_t MATERIAL_BITS{12};
+    static constexpr uint32_t MODEL_BITS{20};
+    static constexpr uint32_t DEPTH_BITS{24};
+
+private:
+    std::vector<OdysseyDrawPacket> m_packets{};
+    std::vector<OdysseyDrawPacket> m_scratch{};
+};
+
+}  // namespace odyssey
\ No newline at end of file
@@ -0,0 +1,120 @@
+#pragma once
+
+/**
+ * @file odyssey_dynamic_resolution.h
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include <memory>
+#include <vector>
+
+#include "odyssey_descriptors.h"
+#include "odyssey_header.h"
+#include "odyssey_pipeline.h"
+
+namespace odyssey {
+
+class OdysseyDevice;
+
+struct OdysseyResolutionPolicy {
+    // GPU frame time (ms) the render scale is steered towards; 0 renders
+    // straight into the swap chain.
+    double targetFrameTime{0.0};
+    // Bounds on the render scale along each axis.
+    float minScale{0.5F};
+    float maxScale{1.0F};
+};
+
+/**
+ * Offscreen color and depth targets rendered at a fraction of the swap chain
+ * size and upscaled into it by a final pass. Each frame in flight owns a pair
+ * sized for the largest scale and the scene draws into its top-left corner,
+ * so changing the scale allocates nothing. Every GPU frame time read back
+ * moves the scale towards the target, taking GPU time to grow with the pixel
+ * count; the result is smoothed and rounded to SCALE_STEP so that cached
+ * command buffers and the depth pyramid are not rebuilt on every frame.
+ */
+class OdysseyDynamicResolution {
+public:
+    // renderPass is any of the offscreen passes, presentRenderPass the one
+    // upscale() records into.
+    OdysseyDynamicResolution(OdysseyDevice* device, const OdysseyResolutionPolicy& policy, vk::Format colorFormat, bool sampledDepth, vk::RenderPass renderPass, vk::RenderPass presentRenderPass);
+    ~OdysseyDynamicResolution();
+
+    OdysseyDynamicResolution() = delete;
+    OdysseyDynamicResolution(const OdysseyDynamicResolution& odysseyDynamicResolution) = delete;
+    OdysseyDynamicResolution(OdysseyDynamicResolution&& odysseyDynamicResolution) = delete;
+    OdysseyDynamicResolution& operator=(const OdysseyDynamicResolution& odysseyDynamicResolution) = delete;
+    OdysseyDynamicResolution& operator=(OdysseyDynamicResolution&& odysseyDynamicResolution) = delete;
+
+public:
+    // Once the frame's fence has been waited on: fixes the scale the frame is
+    // rendered at and reallocates its targets if the swap chain was resized.
+    void beginFrame(size_t frameIndex, vk::Extent2D presentExtent);
+    // The GPU time of the frame last rendered in the slot.
+    void update(size_t frameIndex, double gpuFrameTime);
+    // Inside a render pass on the swap chain image, after the targets were
+    // written and made readable by fragment shaders.
+    void upscale(vk::CommandBuffer commandBuffer, size_t frameIndex);
+    float getScale() const;
+    vk::Extent2D getExtent(size_t frameIndex) const;
+    vk::Framebuffer getFramebuffer(size_t frameIndex) const;
+    vk::Image getColorImage(size_t frameIndex) const;
+    vk::ImageView getColorImageView(size_t frameIndex) const;
+    vk::Image getDepthImage(size_t frameIndex) const;
+    vk::ImageView getDepthImageView(size_t frameIndex) const;
+
+public:
+    static constexpr float SCALE_STEP{1.0F / 32.0F};
+    // Fraction of the way to the measured scale moved per GPU time read back.
+    static constexpr float SMOOTHING{0.25F};
+
+private:
+    // Must match the push constant block in upscale.frag.
+    struct PushConstantData {
+        // The rendered corner in texture coordinates, and the farthest
+        // coordinate bilinear filtering may sample without reading past it.
+        glm::vec2 uvScale{1.0F};
+        glm::vec2 uvMax{1.0F};
+    };
+
+    struct Frame {
+        vk::Image colorImage{};
+        vk::DeviceMemory colorMemory{};
+        vk::ImageView colorView{};
+        vk::Image depthImage{};
+        vk::DeviceMemory depthMemory{};
+        vk::ImageView depthView{};
+        vk::Framebuffer framebuffer{};
+        vk::DescriptorSet descriptorSet{};
+        // The allocated size, and the corner this frame renders into.
+        vk::Extent2D targetExtent{};
+        vk::Extent2D extent{};
+        float scale{1.0F};
+    };
+
+private:
+    void createFrame(Frame& frame, vk::Extent2D targetExtent);
+    void destroyFrame(Frame& frame);
+    void createPipeline(vk::RenderPass presentRenderPass);
+
+private:
+    OdysseyDevice* m_device{};
+    OdysseyResolutionPolicy m_policy{};
+    vk::Format m_colorFormat{};
+    vk::Format m_depthFormat{};
+    bool m_sampledDepth{false};
+    vk::RenderPass m_renderPass{};
+    vk::Sampler m_sampler{};
+    std::unique_ptr<OdysseyDescriptorSetLayout> m_setLayout{};
+    std::unique_ptr<OdysseyDescriptorPool> m_descriptorPool{};
+    vk::PipelineLayout m_pipelineLayout{};
+    std::unique_ptr<OdysseyPipeline> m_pipeline{};
+    std::vector<Frame> m_frames{};
+    // Smoothed, and the SCALE_STEP multiple new frames are rendered at.
+    float m_targetScale{1.0F};
+    float m_scale{1.0F};
+};
+
+}  // namespace odyssey
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+/**
+ * @file odyssey_geometry_pool.h
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "odyssey_buffer.h"
+#include "odyssey_header.h"
+#include "odyssey_model.h"
+
+namespace odyssey {
+
+class OdysseyDevice;
+
+// Must match MeshData in cull.comp.
+struct OdysseyMeshRange {
+    uint32_t indexCount{};
+    uint32_t firstIndex{};
+    int32_t vertexOffset{};
+    uint32_t padding{};
+};
+
+/**
+ * One vertex and one index buffer shared by every registered model, so a
+ * single bind serves any number of indirect draws. Models are copied in on the
+ * GPU the first time they are seen and addressed by OdysseyMeshRange.
+ */
+class OdysseyGeometryPool {
+public:
+    explicit OdysseyGeometryPool(OdysseyDevice* device);
+    ~OdysseyGeometryPool() = default;
+
+    OdysseyGeometryPool() = delete;
+    OdysseyGeometryPool(const OdysseyGeometryPool& odysseyGeometryPool) = delete;
+    OdysseyGeometryPool(OdysseyGeometryPool&& odysseyGeometryPool) = delete;
+    OdysseyGeometryPool& operator=(const OdysseyGeometryPool& odysseyGeometryPool) = delete;
+    OdysseyGeometryPool& operator=(OdysseyGeometryPool&& odysseyGeometryPool) = delete;
+
+public:
+    uint32_t addModel(const std::shared_ptr<OdysseyModel>& model);
+    void bind(vk::CommandBuffer commandBuffer) const;
+
+public:
+    const std::vector<OdysseyMeshRange>& getMeshes() const;
+    uint64_t getVersion() const;
+
+public:
+    static constexpr uint32_t INVALID_MESH{~0U};
+
+private:
+    void reserve(uint32_t vertexCount, uint32_t indexCount);
+    static std::unique_ptr<OdysseyBuffer> createBuffer(OdysseyDevice* device, vk::DeviceSize elementSize, uint32_t capacity, vk::BufferUsageFlags usage);
+
+private:
+    OdysseyDevice* m_device{};
+    std::unique_ptr<OdysseyBuffer> m_vertexBuffer{};
+    std::unique_ptr<OdysseyBuffer> m_indexBuffer{};
+    uint32_t m_vertexCount{0};
+    uint32_t m_indexCount{0};
+    std::vector<OdysseyMeshRange> m_meshes{};
+    std::vector<std::shared_ptr<OdysseyModel>> m_models{};
+    std::unordered_map<const OdysseyModel*, uint32_t> m_meshIndices{};
+    uint64_t m_version{0};
+};
+
+}  // namespace odyssey
\ No newline at end of file
@@ -0,0 +1,128 @@
+#pragma once
+
+/**
+ * @file odyssey_impostors.h
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "odyssey_descriptors.h"
+#include "odyssey_header.h"
+#include "odyssey_model.h"
+#include "odyssey_object.h"
+#include "odyssey_pipeline.h"
+
+namespace odyssey {
+
+class OdysseyDevice;
+
+/**
+ * Octahedral impostor atlases, one per model. Each model is rendered once,
+ * orthographically, from FRAMES_PER_AXIS^2 directions spread over the sphere
+ * by an octahedral map, into a color atlas (vertex color, coverage in alpha)
+ * and a normal and depth atlas (object-space normal, depth across the
+ * bounding sphere in alpha). impostor.vert picks the frame nearest the view
+ * direction and draws it on a camera-facing quad; impostor.frag lights it
+ * and writes the depth back, so impostors intersect like the mesh.
+ *
+ * Bakes are recorded into the frame that first holds a model rather than
+ * submitted on their own, so a new model costs no stall on the queue.
+ *
+ * Atlases are found by model address but remember the model weakly: once it
+ * is destroyed its atlas is retired, so a model allocated at the same address
+ * is baked afresh and the slot is freed for it.
+ */
+class OdysseyImpostors {
+public:
+    struct Atlas {
+        vk::DescriptorSet descriptorSet{};
+        // Object-space bounding sphere the frames were rendered around.
+        glm::vec4 sphere{0.0F};
+    };
+
+public:
+    explicit OdysseyImpostors(OdysseyDevice* device);
+    ~OdysseyImpostors();
+    OdysseyImpostors() = delete;
+    OdysseyImpostors(const OdysseyImpostors& odysseyImpostors) = delete;
+    OdysseyImpostors(OdysseyImpostors&& odysseyImpostors) = delete;
+    OdysseyImpostors& operator=(const OdysseyImpostors& odysseyImpostors) = delete;
+    OdysseyImpostors& operator=(OdysseyImpostors&& odysseyImpostors) = delete;
+
+public:
+    // Once the frame's fence has been waited on: frees what the slot's last
+    // frame retired and retires the atlases of destroyed models.
+    void beginFrame(size_t frameIndex);
+    // Outside a render pass, after beginFrame(): whenever sceneVersion
+    // changes, records the bakes of the models in objects that have no atlas
+    // yet into the frame, ahead of the passes that sample them. Models
+    // without bounds get none.
+    void prepare(vk::CommandBuffer commandBuffer, const std::vector<OdysseyObject>& objects, uint64_t sceneVersion);
+    // An atlas already baked, or nothing.
+    const Atlas* findAtlas(const OdysseyModel* model) const;
+    // Set 1 of the impostor pipeline.
+    vk::DescriptorSetLayout getSetLayout() const;
+    size_t getAtlasCount() const;
+    // CPU time spent recording bakes.
+    double getBakeTime() const;
+
+    // Maps a unit direction to [0, 1]^2 and back, as impostor.vert does.
+    static glm::vec2 octahedralEncode(const glm::vec3& direction);
+    static glm::vec3 octahedralDecode(const glm::vec2& uv);
+
+public:
+    static constexpr uint32_t FRAMES_PER_AXIS{8};
+    static constexpr uint32_t FRAME_SIZE{128};
+    static constexpr uint32_t MAX_ATLASES{256};
+    static constexpr vk::Format COLOR_FORMAT{vk::Format::eR8G8B8A8Unorm};
+    static constexpr vk::Format NORMAL_DEPTH_FORMAT{vk::Format::eR16G16B16A16Sfloat};
+
+private:
+    struct AtlasImages {
+        std::weak_ptr<const OdysseyModel> model{};
+        Atlas atlas{};
+        vk::Image colorImage{};
+        vk::DeviceMemory colorMemory{};
+        vk::ImageView colorView{};
+        vk::Image normalDepthImage{};
+        vk::DeviceMemory normalDepthMemory{};
+        vk::ImageView normalDepthView{};
+        vk::Framebuffer framebuffer{};
+    };
+
+    // Must match the push constant block in impostor_bake.vert.
+    struct BakePushConstantData {
+        glm::mat4 projectionView{1.0F};
+    };
+
+private:
+    void createRenderPass();
+    void createBakeResources();
+    void bake(vk::CommandBuffer commandBuffer, const OdysseyModel* model, AtlasImages& images);
+    void destroyAtlas(AtlasImages& images);
+
+private:
+    OdysseyDevice* m_device{};
+    vk::RenderPass m_renderPass{};
+    vk::Format m_depthFormat{};
+    vk::Image m_depthImage{};
+    vk::DeviceMemory m_depthMemory{};
+    vk::ImageView m_depthView{};
+    vk::PipelineLayout m_bakePipelineLayout{};
+    std::unique_ptr<OdysseyPipeline> m_bakePipeline{};
+    vk::Sampler m_sampler{};
+    std::unique_ptr<OdysseyDescriptorSetLayout> m_setLayout{};
+    std::unique_ptr<OdysseyDescriptorPool> m_descriptorPool{};
+    std::unordered_map<const OdysseyModel*, AtlasImages> m_atlases{};
+    // Retired atlases, freed once their frame slot comes round again.
+    std::vector<std::vector<AtlasImages>> m_retired{};
+    std::optional<uint64_t> m_sceneVersion{};
+    double m_bakeTime{0.0};
+};
+
+}  // namespace odyssey
\ No newline at end of file
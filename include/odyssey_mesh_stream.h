@@ -0,0 +1,123 @@
+#pragma once
+
+/**
+ * @file odyssey_mesh_stream.h
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "odyssey_camera.h"
+#include "odyssey_header.h"
+#include "odyssey_model.h"
+#include "odyssey_stream_residency.h"
+
+namespace odyssey {
+
+class OdysseyDevice;
+
+/**
+ * Paged mesh written by OdysseyMeshStream::convert: the header, each chunk's
+ * vertices followed by its indices, then the chunk table. Chunks are the
+ * triangles centered in one cell of a uniform grid, with their own vertices,
+ * so any chunk can be read and drawn without the others.
+ */
+struct OdysseyMeshStreamFile {
+    static constexpr std::array<char, 8> MAGIC{'O', 'D', 'Y', 'M', 'E', 'S', 'H', '\0'};
+    static constexpr uint32_t VERSION{1};
+
+    struct Header {
+        std::array<char, 8> magic{MAGIC};
+        uint32_t version{VERSION};
+        uint32_t chunkCount{0};
+        uint64_t chunkTableOffset{0};
+        // Of every chunk, in model space.
+        glm::vec3 min{0.0F};
+        float padding0{0.0F};
+        glm::vec3 max{0.0F};
+        float padding1{0.0F};
+    };
+
+    struct Chunk {
+        glm::vec3 min{0.0F};
+        float padding0{0.0F};
+        glm::vec3 max{0.0F};
+        float padding1{0.0F};
+        uint64_t offset{0};
+        uint32_t vertexCount{0};
+        uint32_t indexCount{0};
+
+        uint64_t getSize() const;
+    };
+};
+
+/**
+ * Keeps the chunks of an OdysseyMeshStreamFile near the camera on the GPU,
+ * within a memory budget, so meshes larger than device memory can be drawn.
+ * Chunks within the load radius are wanted nearest first until the budget is
+ * spent; OdysseyStreamResidency reads and uploads them. A resident
+ * chunk is only evicted once it is HYSTERESIS times farther than it would
+ * need to be to load, so chunks at the edge of the radius or the budget do
+ * not thrash as the camera moves back and forth.
+ */
+class OdysseyMeshStream {
+public:
+    struct Draw {
+        vk::Buffer buffer{};
+        // Indices follow the chunk's vertices in the same buffer.
+        vk::DeviceSize indexOffset{0};
+        uint32_t indexCount{0};
+    };
+
+public:
+    // Scaled and moved so the mesh's longest side spans size units around
+    // center.
+    OdysseyMeshStream(OdysseyDevice* device, const std::string& path, uint64_t memoryBudget, float loadRadius, const glm::vec3& center, float size);
+    ~OdysseyMeshStream();
+    OdysseyMeshStream() = delete;
+    OdysseyMeshStream(const OdysseyMeshStream& odysseyMeshStream) = delete;
+    OdysseyMeshStream(OdysseyMeshStream&& odysseyMeshStream) = delete;
+    OdysseyMeshStream& operator=(const OdysseyMeshStream& odysseyMeshStream) = delete;
+    OdysseyMeshStream& operator=(OdysseyMeshStream&& odysseyMeshStream) = delete;
+
+public:
+    // Splits a model into chunks of about CHUNK_TRIANGLES triangles. The
+    // model is read whole, so this needs it to fit in host memory only.
+    static void convert(const std::string& modelPath, const std::string& outputPath);
+
+    // Outside a render pass, after the transform store is updated: evicts,
+    // requests and uploads chunks, then picks this frame's draws.
+    void update(vk::CommandBuffer commandBuffer, const OdysseyCamera& camera, size_t frameIndex);
+    const std::vector<Draw>& getDraws() const;
+    // The stream's slot in OdysseyTransformStore.
+    uint32_t getTransformIndex() const;
+    size_t getChunkCount() const;
+    size_t getResidentCount() const;
+    uint64_t getEvictionCount() const;
+
+public:
+    static constexpr size_t CHUNK_TRIANGLES{65536};
+    static constexpr float HYSTERESIS{1.25F};
+    // Chunks copied to the GPU per frame, which bounds the staging memory.
+    static constexpr size_t MAX_UPLOADS_PER_FRAME{8};
+
+private:
+    void select(const glm::vec3& cameraPosition, size_t frameIndex);
+
+private:
+    std::vector<OdysseyMeshStreamFile::Chunk> m_chunks{};
+    std::unique_ptr<OdysseyStreamResidency> m_residency{};
+    // Selected this frame.
+    std::vector<bool> m_wanted{};
+    uint64_t m_memoryBudget{0};
+    float m_loadRadius{0.0F};
+    uint32_t m_transformIndex{0};
+    std::vector<Draw> m_draws{};
+};
+
+}  // namespace odyssey
\ No newline at end of file
@@ -6,6 +6,7 @@
  * @date 2023-04-11
  */
 
+#include <array>
 #include <memory>
 #include <string>
 #include <vector>
@@ -31,16 +32,37 @@ public:
         static std::vector<vk::VertexInputAttributeDescription> getAttributeDescriptions();
     };
 
+    // Object-space bounds, computed once when the model is created.
+    struct Bounds {
+        glm::vec3 min{0.0F};
+        glm::vec3 max{0.0F};
+        glm::vec3 center{0.0F};
+        // Negative for a model without vertices.
+        float radius{-1.0F};
+    };
+
     struct Builder {
         std::vector<Vertex> vertices{};
         std::vector<uint32_t> indices{};
-        void loadModel(const std::string& filepath);
+        void loadModel(const std::string& filepath, Assimp::Importer* importer = nullptr);
+        void loadCube();
+        // The node's own meshes, without its children.
+        void loadNodeMeshes(const aiNode* node, const aiScene* scene);
 
     private:
         void processNode(const aiNode* node, const aiScene* scene);
         void processMesh(const aiMesh* mesh);
     };
 
+    // One node of an imported file, in depth-first order: parent indexes the
+    // same list and the model holds the node's own meshes, if it has any.
+    struct Node {
+        std::string name{};
+        uint32_t parent{INVALID_NODE};
+        glm::mat4 localMatrix{1.0F};
+        std::shared_ptr<OdysseyModel> model{};
+    };
+
 public:
     OdysseyModel(OdysseyDevice* device, const Builder& builder);
     ~OdysseyModel();
@@ -52,13 +74,40 @@ public:
     OdysseyModel& operator=(OdysseyModel&& odysseyModel) = delete;
 
 public:
-    static std::shared_ptr<OdysseyModel> createModelFromFile(OdysseyDevice* device, const std::string& filepath);
+    static std::shared_ptr<OdysseyModel> createModelFromFile(OdysseyDevice* device, const std::string& filepath, Assimp::Importer* importer = nullptr);
+    static std::shared_ptr<OdysseyModel> createCubeModel(OdysseyDevice* device);
+    // Keeps the file's node hierarchy instead of flattening it into one model.
+    static std::vector<Node> createNodesFromFile(OdysseyDevice* device, const std::string& filepath, Assimp::Importer* importer = nullptr);
+
+public:
+    static constexpr uint32_t INVALID_NODE{~0U};
+    // Models with at most this many vertices keep all of them on the CPU, so
+    // static batching can merge them.
+    static constexpr size_t MAX_MERGEABLE_VERTICES{1024};
 
 public:
     void bind(vk::CommandBuffer& commandBuffer) const;
-    void draw(vk::CommandBuffer& commandBuffer) const;
+    void draw(vk::CommandBuffer& commandBuffer, uint32_t instanceCount = 1, uint32_t firstInstance = 0) const;
+
+public:
+    vk::Buffer getVertexBuffer() const;
+    vk::Buffer getIndexBuffer() const;
+    uint32_t getVertexCount() const;
+    uint32_t getIndexCount() const;
+    bool hasIndexBuffer() const;
+    const Bounds& getBounds() const;
+    // CPU copies for queries such as picking; indices are empty for models
+    // drawn without an index buffer.
+    const std::vector<glm::vec3>& getPositions() const;
+    const std::vector<uint32_t>& getIndices() const;
+    // Empty for models above MAX_MERGEABLE_VERTICES.
+    const std::vector<Vertex>& getVertices() const;
+    uint32_t getTriangleCount() const;
+    // Indices into getPositions() of a triangle's corners.
+    std::array<uint32_t, 3> getTriangle(uint32_t triangle) const;
 
 private:
+    static Bounds computeBounds(const std::vector<Vertex>& vertices);
     void createVertexBuffer(const std::vector<Vertex>& vertices);
     void createIndexBuffer(const std::vector<uint32_t>& indices);
 
@@ -71,6 +120,10 @@ private:
     vk::Buffer m_indexBuffer{};
     vk::DeviceMemory m_indexBufferMemory{};
     uint32_t m_indexCount{0};
+    Bounds m_bounds{};
+    std::vector<glm::vec3> m_positions{};
+    std::vector<uint32_t> m_indices{};
+    std::vector<Vertex> m_vertices{};
 };
 
 }  // namespace odyssey
@@ -9,16 +9,38 @@
 #include <memory>
 
 #include "odyssey_model.h"
+#include "odyssey_transform_store.h"
 
 namespace odyssey {
 
-struct TransformComponent {
-    glm::vec3 translation{};
-    glm::vec3 scale{1.0F, 1.0F, 1.0F};
-    glm::vec3 rotation{};
+/**
+ * Handle to a slot of OdysseyTransformStore. Setters mark the slot dirty and
+ * mat4() and normal() return the matrices cached by the store's last update.
+ */
+class TransformComponent {
+public:
+    TransformComponent();
+    ~TransformComponent();
+    TransformComponent(const TransformComponent& transformComponent) = delete;
+    TransformComponent(TransformComponent&& transformComponent) noexcept;
+    TransformComponent& operator=(const TransformComponent& transformComponent) = delete;
+    TransformComponent& operator=(TransformComponent&& transformComponent) noexcept;
 
-    glm::mat4 mat4();
-    glm::mat3 normal();
+public:
+    void setTranslation(const glm::vec3& translation);
+    void setRotation(const glm::vec3& rotation);
+    void setScale(const glm::vec3& scale);
+    glm::vec3 getTranslation() const;
+    glm::vec3 getRotation() const;
+    glm::vec3 getScale() const;
+
+    const glm::mat4& mat4() const;
+    const glm::mat3x4& normal() const;
+    // The slot in OdysseyTransformStore.
+    uint32_t getIndex() const;
+
+private:
+    uint32_t m_index;
 };
 
 class OdysseyObject {
@@ -0,0 +1,67 @@
+#pragma once
+
+/**
+ * @file odyssey_options.h
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include <QStringList>
+#include <cstdint>
+#include <string>
+
+#include "odyssey_dynamic_resolution.h"
+#include "odyssey_pipeline.h"
+#include "odyssey_redraw_scheduler.h"
+#include "odyssey_swap_chain.h"
+
+namespace odyssey {
+
+struct OdysseyOptions {
+    PipelineVariant variant{};
+    OdysseyLatencyPolicy latency{};
+    OdysseyRedrawPolicy redraw{};
+    bool redrawReport{false};
+    uint32_t testSceneObjects{0};
+    std::string modelPath{};
+    bool batching{true};
+    bool gpuDriven{false};
+    bool culling{true};
+    bool occlusionCulling{false};
+    bool interiorScene{false};
+    bool parallelRecording{true};
+    bool commandCaching{true};
+    bool perObjectTransforms{false};
+    uint32_t movingObjects{0};
+    uint32_t assemblyParts{0};
+    bool staticAssembly{false};
+    bool staticBatching{true};
+    std::string pointCloudPath{};
+    // Points resident on the GPU at once.
+    uint64_t pointBudget{8'000'000};
+    // Converts this ASCII point list to <path>.octree and exits.
+    std::string convertPointsPath{};
+    std::string meshStreamPath{};
+    // Bytes of mesh stream chunks resident on the GPU at once.
+    uint64_t streamBudget{512ULL << 20};
+    float streamRadius{4.0F};
+    // Converts this model to <path>.mstream and exits.
+    std::string convertMeshPath{};
+    // Objects beyond this distance are drawn as impostors; 0 for never.
+    float impostorDistance{0.0F};
+    // Moving point lights, shaded with clustered forward lighting.
+    uint32_t lightCount{0};
+    // Benchmarks every count in Odyssey's sweep in turn instead.
+    bool lightSweep{false};
+    OdysseyResolutionPolicy resolution{};
+    uint32_t benchmarkFrames{0};
+    bool startupReport{false};
+    // Milliseconds the UI thread blocks once a second, to show that frames
+    // do not wait for it.
+    uint32_t uiStall{0};
+    bool dumpRenderGraph{false};
+
+    static OdysseyOptions parse(const QStringList& arguments);
+};
+
+}  // namespace odyssey
\ No newline at end of file
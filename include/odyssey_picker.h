@@ -0,0 +1,83 @@
+#pragma once
+
+/**
+ * @file odyssey_picker.h
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "odyssey_bvh.h"
+#include "odyssey_object.h"
+
+namespace odyssey {
+
+struct OdysseyPickResult {
+    size_t objectIndex{0};
+    uint32_t triangle{0};
+    glm::vec3 position{0.0F};
+    // Along the picking ray, in units of its direction.
+    float distance{0.0F};
+};
+
+/**
+ * Ray picking against the scene's triangles. Each model gets a triangle BVH
+ * built on the picker's own thread, so imports and frames never wait for it;
+ * objects are found through a top-level BVH over their world bounds, rebuilt
+ * on the next pick after any transform changed.
+ */
+class OdysseyPicker {
+public:
+    OdysseyPicker();
+    ~OdysseyPicker();
+    OdysseyPicker(const OdysseyPicker& odysseyPicker) = delete;
+    OdysseyPicker(OdysseyPicker&& odysseyPicker) = delete;
+    OdysseyPicker& operator=(const OdysseyPicker& odysseyPicker) = delete;
+    OdysseyPicker& operator=(OdysseyPicker&& odysseyPicker) = delete;
+
+public:
+    // Queues the model's BVH build; models already known are ignored.
+    void addModel(const std::shared_ptr<OdysseyModel>& model);
+    // Objects whose model BVH is not built yet cannot be hit.
+    std::optional<OdysseyPickResult> pick(const std::vector<OdysseyObject>& objects, const OdysseyRay& ray);
+    size_t getPendingCount() const;
+
+private:
+    struct ModelBvh {
+        std::shared_ptr<OdysseyModel> model{};
+        OdysseyBvh bvh{};
+        std::atomic<bool> ready{false};
+    };
+
+private:
+    void workerLoop();
+    void buildTopLevel(const std::vector<OdysseyObject>& objects);
+
+private:
+    std::unordered_map<const OdysseyModel*, std::shared_ptr<ModelBvh>> m_models{};
+    // Top-level primitives index m_instances, which index the object list.
+    OdysseyBvh m_topLevel{};
+    std::vector<uint32_t> m_instances{};
+    std::vector<const ModelBvh*> m_instanceBvhs{};
+    uint64_t m_topLevelTransformVersion{~0ULL};
+    size_t m_topLevelObjectCount{0};
+    size_t m_topLevelReadyCount{0};
+    std::atomic<size_t> m_readyCount{0};
+
+    std::thread m_worker{};
+    mutable std::mutex m_mutex{};
+    std::condition_variable m_wakeup{};
+    std::deque<std::shared_ptr<ModelBvh>> m_queue{};
+    bool m_stopping{false};
+};
+
+}  // namespace odyssey
\ No newline at end of file
@@ -19,6 +19,8 @@ class OdysseyDevice;
 struct PipelineConfigInfo {
     PipelineConfigInfo() = default;
 
+    std::vector<vk::VertexInputBindingDescription> bindingDescriptions{};
+    std::vector<vk::VertexInputAttributeDescription> attributeDescriptions{};
     vk::PipelineViewportStateCreateInfo viewportInfo{};
     vk::PipelineInputAssemblyStateCreateInfo inputAssemblyInfo{};
     vk::PipelineRasterizationStateCreateInfo rasterizationInfo{};
@@ -31,6 +33,42 @@ struct PipelineConfigInfo {
     vk::PipelineLayout pipelineLayout{nullptr};
     vk::RenderPass renderPass{nullptr};
     uint32_t subpass{0};
+    std::vector<vk::SpecializationMapEntry> specializationEntries{};
+    std::vector<uint8_t> specializationData{};
+};
+
+enum class OdysseyLightingModel : uint32_t {
+    UNLIT,
+    LAMBERT,
+    HALF_LAMBERT
+};
+
+enum class OdysseyDebugView : uint32_t {
+    NONE,
+    NORMAL,
+    UV
+};
+
+/**
+ * Everything that selects a specialized pipeline. Options are baked into the
+ * shaders as specialization constants, so unused branches are compiled out.
+ * With runtimeBranching set the same SPIR-V is instead built as an uber-shader
+ * that reads the options from push constants at draw time.
+ */
+struct PipelineVariant {
+    vk::PrimitiveTopology primitiveTopology{vk::PrimitiveTopology::eTriangleList};
+    float lineWidth{1.0F};
+    OdysseyLightingModel lightingModel{OdysseyLightingModel::LAMBERT};
+    OdysseyDebugView debugView{OdysseyDebugView::NONE};
+    glm::vec3 directionToLight{1.0F, -3.0F, -1.0F};
+    bool runtimeBranching{false};
+    // Meshes dither out as they cross-fade into impostors. Set by the render
+    // system while impostors are on, since a shader that may discard loses
+    // early depth testing on most GPUs.
+    bool impostorFade{false};
+
+    bool operator==(const PipelineVariant& other) const;
+    void specialize(PipelineConfigInfo& config) const;
 };
 
 class OdysseyPipeline {
@@ -46,11 +84,11 @@ public:
 
 public:
     static PipelineConfigInfo defaultPipelineConfigInfo(vk::PrimitiveTopology primitiveTopology = vk::PrimitiveTopology::eTriangleList, float lineWidth = 1.0F);
-    void bind(const vk::CommandBuffer& buffer);
+    static std::vector<char> readFile(const std::string& path);
+    void bind(const vk::CommandBuffer& buffer) const;
 
 private:
     void createGraphicsPipeline(const std::string& vertShaderPath, const std::string& fragShaderPath, const PipelineConfigInfo& config);
-    static std::vector<char> readFile(const std::string& path);
     vk::ShaderModule createShaderModule(const std::vector<char>& code);
 
 private:
@@ -60,4 +98,39 @@ private:
     vk::ShaderModule fragShaderModule{};
 };
 
-}  // namespace odyssey
\ No newline at end of file
+class OdysseyComputePipeline {
+public:
+    OdysseyComputePipeline(OdysseyDevice* device, const std::string& compShaderPath, vk::PipelineLayout pipelineLayout);
+    ~OdysseyComputePipeline();
+
+    OdysseyComputePipeline() = delete;
+    OdysseyComputePipeline(const OdysseyComputePipeline& odysseyComputePipeline) = delete;
+    OdysseyComputePipeline(OdysseyComputePipeline&& odysseyComputePipeline) = delete;
+    OdysseyComputePipeline& operator=(const OdysseyComputePipeline& odysseyComputePipeline) = delete;
+    OdysseyComputePipeline& operator=(OdysseyComputePipeline&& odysseyComputePipeline) = delete;
+
+public:
+    void bind(const vk::CommandBuffer& buffer) const;
+
+private:
+    OdysseyDevice* m_device;
+    vk::Pipeline m_computePipeline{};
+    vk::ShaderModule compShaderModule{};
+};
+
+}  // namespace odyssey
+
+namespace std {
+template <>
+struct hash<odyssey::PipelineVariant> {
+    size_t operator()(const odyssey::PipelineVariant& variant) const {
+        auto value = (hash<uint32_t>()(static_cast<uint32_t>(variant.primitiveTopology)) ^ (hash<float>()(variant.lineWidth) << 1)) >> 1;
+        value ^= hash<uint32_t>()(static_cast<uint32_t>(variant.lightingModel)) << 1;
+        value ^= hash<uint32_t>()(static_cast<uint32_t>(variant.debugView)) << 2;
+        value ^= hash<glm::vec3>()(variant.directionToLight) << 1;
+        value ^= hash<bool>()(variant.runtimeBranching) << 3;
+        value ^= hash<bool>()(variant.impostorFade) << 4;
+        return value;
+    }
+};
+}  // namespace std
\ No newline at end of file
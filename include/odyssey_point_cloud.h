@@ -0,0 +1,130 @@
+#pragma once
+
+/**
+ * @file odyssey_point_cloud.h
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "odyssey_camera.h"
+#include "odyssey_header.h"
+#include "odyssey_stream_residency.h"
+
+namespace odyssey {
+
+class OdysseyDevice;
+
+/**
+ * Level-of-detail octree written by OdysseyPointCloudConverter: the header,
+ * every node's points, then the node table, so a file of any size opens by
+ * reading the header and the table alone. Leaves hold all of their points
+ * and inner nodes a subsample of their children's, at most one per cell of a
+ * SAMPLE_GRID grid over the node; children replace their parent when drawn.
+ */
+struct OdysseyPointCloudFile {
+    static constexpr std::array<char, 8> MAGIC{'O', 'D', 'Y', 'P', 'C', 'L', 'D', '\0'};
+    static constexpr uint32_t VERSION{1};
+    static constexpr uint32_t SAMPLE_GRID{128};
+
+    struct Point {
+        // Relative to Header::origin.
+        glm::vec3 position{0.0F};
+        // RGBA8.
+        uint32_t color{0xFFFFFFFF};
+
+        static std::vector<vk::VertexInputBindingDescription> getBindingDescriptions();
+        static std::vector<vk::VertexInputAttributeDescription> getAttributeDescriptions();
+    };
+
+    struct Header {
+        std::array<char, 8> magic{MAGIC};
+        uint32_t version{VERSION};
+        uint32_t nodeCount{0};
+        uint64_t pointCount{0};
+        uint64_t nodeTableOffset{0};
+        glm::dvec3 origin{0.0};
+        // Side of the root cube, which starts at origin.
+        double size{0.0};
+    };
+
+    struct Node {
+        // Cube, relative to Header::origin.
+        glm::vec3 min{0.0F};
+        float size{0.0F};
+        uint64_t pointOffset{0};
+        uint32_t pointCount{0};
+        // Children are contiguous from firstChild, one per set bit of
+        // childMask in octant order.
+        uint32_t firstChild{0};
+        uint32_t childMask{0};
+        uint32_t padding{0};
+    };
+};
+
+/**
+ * Streams an OdysseyPointCloudFile into a fixed budget of points on the GPU.
+ * Each frame the octree is refined, largest projected nodes first, while
+ * their point spacing would exceed a pixel and the children fit the budget;
+ * nodes still missing are read by OdysseyStreamResidency's I/O thread and
+ * drawn from the next frame on, their parent standing in until then. Least recently
+ * drawn nodes are evicted to make room.
+ */
+class OdysseyPointCloud {
+public:
+    struct Draw {
+        vk::Buffer buffer{};
+        uint32_t pointCount{0};
+    };
+
+public:
+    // Scaled and moved so the root cube spans size units around center.
+    OdysseyPointCloud(OdysseyDevice* device, const std::string& path, size_t pointBudget, const glm::vec3& center, float size);
+    ~OdysseyPointCloud();
+    OdysseyPointCloud() = delete;
+    OdysseyPointCloud(const OdysseyPointCloud& odysseyPointCloud) = delete;
+    OdysseyPointCloud(OdysseyPointCloud&& odysseyPointCloud) = delete;
+    OdysseyPointCloud& operator=(const OdysseyPointCloud& odysseyPointCloud) = delete;
+    OdysseyPointCloud& operator=(OdysseyPointCloud&& odysseyPointCloud) = delete;
+
+public:
+    // Outside a render pass: records copies for nodes the I/O thread has
+    // read, then picks this frame's draws and requests what they lack.
+    void update(vk::CommandBuffer commandBuffer, const OdysseyCamera& camera, vk::Extent2D extent, size_t frameIndex);
+    const std::vector<Draw>& getDraws() const;
+    // Cloud to world: position * scale + offset, with scale in w.
+    const glm::vec4& getPlacement() const;
+    uint64_t getPointCount() const;
+
+public:
+    // Nodes copied to the GPU per frame, which bounds the staging memory.
+    static constexpr size_t MAX_UPLOADS_PER_FRAME{16};
+    // Refinement stops once a node's points are this close on screen.
+    static constexpr float MAX_POINT_SPACING_PIXELS{1.5F};
+
+private:
+    bool makeRoom(uint64_t size, size_t frameIndex);
+    void select(const OdysseyCamera& camera, vk::Extent2D extent);
+    float projectedSpacing(uint32_t node, const glm::vec3& cameraPosition, float pixelsPerUnit) const;
+    bool isVisible(uint32_t node, const std::array<glm::vec4, 6>& planes) const;
+    glm::vec4 getWorldSphere(uint32_t node) const;
+
+private:
+    OdysseyPointCloudFile::Header m_header{};
+    std::vector<OdysseyPointCloudFile::Node> m_nodes{};
+    std::unique_ptr<OdysseyStreamResidency> m_residency{};
+    std::vector<uint64_t> m_lastDrawn{};
+    size_t m_pointBudget{0};
+    glm::vec4 m_placement{0.0F, 0.0F, 0.0F, 1.0F};
+    uint64_t m_frame{0};
+    std::vector<Draw> m_draws{};
+    double m_openTime{0.0};
+    bool m_firstDrawn{false};
+};
+
+}  // namespace odyssey
\ No newline at end of file
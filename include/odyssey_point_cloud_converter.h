@@ -0,0 +1,85 @@
+#pragma once
+
+/**
+ * @file odyssey_point_cloud_converter.h
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "odyssey_point_cloud.h"
+
+namespace odyssey {
+
+/**
+ * Builds an OdysseyPointCloudFile from an ASCII "x y z [r g b]" point list of
+ * any size, in bounded memory. A first pass finds the bounds, a second sorts
+ * the points into chunk files, one per cell of a grid small enough for each
+ * to fit in memory; chunks are then built into subtrees one at a time, and
+ * the levels above them from their roots' points, depth first, so only the
+ * nodes on the current path are held at once.
+ */
+class OdysseyPointCloudConverter {
+public:
+    OdysseyPointCloudConverter() = default;
+    ~OdysseyPointCloudConverter() = default;
+    OdysseyPointCloudConverter(const OdysseyPointCloudConverter& odysseyPointCloudConverter) = delete;
+    OdysseyPointCloudConverter(OdysseyPointCloudConverter&& odysseyPointCloudConverter) = delete;
+    OdysseyPointCloudConverter& operator=(const OdysseyPointCloudConverter& odysseyPointCloudConverter) = delete;
+    OdysseyPointCloudConverter& operator=(OdysseyPointCloudConverter&& odysseyPointCloudConverter) = delete;
+
+public:
+    // Temporary chunks go next to outputPath. Returns the points read.
+    uint64_t convert(const std::string& inputPath, const std::string& outputPath);
+
+public:
+    // Points a chunk is sized for; chunks that end up above
+    // MAX_CHUNK_POINTS are split again before being built.
+    static constexpr uint64_t CHUNK_POINTS{4 << 20};
+    static constexpr uint64_t MAX_CHUNK_POINTS{16 << 20};
+    // Levels of the chunk grid, at most 8^4 chunk files.
+    static constexpr uint32_t MAX_CHUNK_LEVEL{4};
+    static constexpr size_t MAX_LEAF_POINTS{32768};
+    static constexpr uint32_t MAX_LEVEL{20};
+    // Points buffered per chunk file before an append.
+    static constexpr size_t FLUSH_POINTS{1024};
+
+private:
+    using Point = OdysseyPointCloudFile::Point;
+
+    struct BuildNode {
+        OdysseyPointCloudFile::Node node{};
+        std::array<int32_t, 8> children{-1, -1, -1, -1, -1, -1, -1, -1};
+    };
+
+    struct Subtree {
+        int32_t node{-1};
+        // The root's points, which its parent is sampled from.
+        std::vector<Point> points{};
+    };
+
+private:
+    std::optional<Subtree> buildUpper(const glm::vec3& min, float size, uint32_t level, const glm::uvec3& cell);
+    std::optional<Subtree> buildChunk(const std::filesystem::path& path, const glm::vec3& min, float size, uint32_t level);
+    Subtree buildInMemory(std::vector<Point> points, const glm::vec3& min, float size, uint32_t level);
+    Subtree addInner(std::vector<std::optional<Subtree>>& children, const glm::vec3& min, float size);
+    int32_t writeNode(const std::vector<Point>& points, const glm::vec3& min, float size);
+    void writeNodeTable();
+    std::filesystem::path getChunkPath(const glm::uvec3& cell) const;
+
+private:
+    std::filesystem::path m_tempDirectory{};
+    std::ofstream m_output{};
+    OdysseyPointCloudFile::Header m_header{};
+    uint32_t m_chunkLevel{0};
+    std::vector<BuildNode> m_nodes{};
+};
+
+}  // namespace odyssey
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+
+/**
+ * @file odyssey_profiler.h
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace odyssey {
+
+/**
+ * Process-wide timeline of named phases and counters. Phases may be recorded
+ * from any thread; the report lists them in start order with the thread that
+ * ran them, so overlapping work is visible at a glance. Histograms collect
+ * repeated timings, such as frame intervals, into fixed buckets.
+ */
+class OdysseyProfiler {
+public:
+    class Scope {
+    public:
+        explicit Scope(std::string name);
+        ~Scope();
+        Scope(const Scope& scope) = delete;
+        Scope(Scope&& scope) = delete;
+        Scope& operator=(const Scope& scope) = delete;
+        Scope& operator=(Scope&& scope) = delete;
+
+    private:
+        std::string m_name;
+        double m_start;
+    };
+
+public:
+    static OdysseyProfiler& instance();
+
+    OdysseyProfiler(const OdysseyProfiler& odysseyProfiler) = delete;
+    OdysseyProfiler(OdysseyProfiler&& odysseyProfiler) = delete;
+    OdysseyProfiler& operator=(const OdysseyProfiler& odysseyProfiler) = delete;
+    OdysseyProfiler& operator=(OdysseyProfiler&& odysseyProfiler) = delete;
+
+public:
+    double now() const;
+    void recordPhase(const std::string& name, double start, double end);
+    void setCounter(const std::string& name, double value);
+    void addCounter(const std::string& name, double value);
+    double getCounter(const std::string& name) const;
+    void addSample(const std::string& name, double milliseconds);
+    std::string report() const;
+    std::string histogramReport() const;
+
+public:
+    // Upper bounds (ms) of the histogram buckets, with one more past the last.
+    static constexpr std::array<double, 10> HISTOGRAM_BOUNDS{1.0, 2.0, 4.0, 8.0, 16.0, 33.0, 50.0, 100.0, 250.0, 1000.0};
+
+private:
+    OdysseyProfiler();
+    ~OdysseyProfiler() = default;
+
+private:
+    struct Phase {
+        std::string name;
+        double start;
+        double end;
+        std::thread::id thread;
+    };
+
+    struct Histogram {
+        std::array<uint64_t, HISTOGRAM_BOUNDS.size() + 1> counts{};
+        uint64_t count{0};
+        double total{0.0};
+        double max{0.0};
+    };
+
+private:
+    std::chrono::steady_clock::time_point m_origin{};
+    std::thread::id m_mainThread{};
+    mutable std::mutex m_mutex{};
+    std::vector<Phase> m_phases{};
+    std::map<std::string, double> m_counters{};
+    std::map<std::string, Histogram> m_histograms{};
+};
+
+}  // namespace odyssey
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+/**
+ * @file odyssey_redraw_scheduler.h
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <string>
+
+namespace odyssey {
+
+enum OdysseyDirtyFlag : uint32_t {
+    DIRTY_NONE = 0,
+    DIRTY_SCENE = 1 << 0,
+    DIRTY_CAMERA = 1 << 1,
+    DIRTY_WINDOW = 1 << 2,
+    DIRTY_ANIMATION = 1 << 3,
+    DIRTY_IDLE = 1 << 4
+};
+
+struct OdysseyRedrawPolicy {
+    // 0 leaves the frame rate uncapped.
+    uint32_t maxFps{0};
+    // Seconds between redraws while nothing is dirty, 0 to stay idle.
+    uint32_t idleRefresh{0};
+    // Redraw every frame regardless of damage, as the old render loop did.
+    bool continuous{false};
+};
+
+/**
+ * Decides when a frame is drawn. Changes mark the scheduler dirty and set a
+ * deadline no earlier than the frame-rate cap allows; the thread that owns
+ * the scheduler sleeps until then and calls fire(), which hands the
+ * accumulated flags to the draw callback, so any number of changes between
+ * two frames costs one redraw and an unchanged scene costs none.
+ */
+class OdysseyRedrawScheduler {
+public:
+    using DrawCallback = std::function<bool(uint32_t dirtyFlags)>;
+    using Clock = std::chrono::steady_clock;
+
+public:
+    OdysseyRedrawScheduler(const OdysseyRedrawPolicy& policy, DrawCallback drawCallback);
+    ~OdysseyRedrawScheduler() = default;
+
+    OdysseyRedrawScheduler() = delete;
+    OdysseyRedrawScheduler(const OdysseyRedrawScheduler& odysseyRedrawScheduler) = delete;
+    OdysseyRedrawScheduler(OdysseyRedrawScheduler&& odysseyRedrawScheduler) = delete;
+    OdysseyRedrawScheduler& operator=(const OdysseyRedrawScheduler& odysseyRedrawScheduler) = delete;
+    OdysseyRedrawScheduler& operator=(OdysseyRedrawScheduler&& odysseyRedrawScheduler) = delete;
+
+public:
+    void markDirty(uint32_t dirtyFlags);
+    void setAnimating(bool animating);
+    bool isAnimating() const;
+    // When fire() should next be called; empty while there is nothing to do.
+    std::optional<Clock::time_point> getDeadline() const;
+    void fire();
+    std::string report() const;
+
+private:
+    void schedule(Clock::time_point deadline);
+    void scheduleNext();
+    void updateCounters();
+
+private:
+    OdysseyRedrawPolicy m_policy{};
+    DrawCallback m_drawCallback{};
+    std::optional<Clock::time_point> m_deadline{};
+    Clock::time_point m_lastFrame{};
+    uint32_t m_dirtyFlags{DIRTY_NONE};
+    bool m_animating{false};
+    std::deque<Clock::time_point> m_frames{};
+    std::deque<Clock::time_point> m_wakeups{};
+    uint64_t m_coalescedRequests{0};
+    double m_frameTime{0.0};
+};
+
+}  // namespace odyssey
\ No newline at end of file
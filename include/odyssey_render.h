@@ -6,18 +6,38 @@
  * @date 2023-04-21
  */
 
+#include <array>
+#include <deque>
+#include <future>
 #include <memory>
+#include <string>
 #include <vector>
 
+#include "odyssey_command_pools.h"
 #include "odyssey_device.h"
+#include "odyssey_dynamic_resolution.h"
 #include "odyssey_header.h"
+#include "odyssey_swap_chain.h"
 #include "odyssey_window.h"
 
 namespace odyssey {
 
+// Every phase uses a render pass compatible with getSwapChainRenderPass(), so
+// the same pipelines and framebuffers serve all of them. With dynamic
+// resolution the phases render into the offscreen target instead, and leave
+// its color readable by upscale() where they would otherwise present.
+enum class OdysseyRenderPassPhase {
+    // Clears, draws and presents in one pass.
+    WHOLE,
+    // Clears and keeps color and depth for a LAST pass later in the frame.
+    FIRST,
+    // Loads what the FIRST pass left and presents.
+    LAST
+};
+
 class OdysseyRender {
 public:
-    OdysseyRender(OdysseyWindow* window, OdysseyDevice* device);
+    OdysseyRender(OdysseyWindow* window, OdysseyDevice* device, const OdysseyLatencyPolicy& latencyPolicy, bool sampledDepth = false, const OdysseyResolutionPolicy& resolutionPolicy = {});
     ~OdysseyRender();
 
     OdysseyRender() = delete;
@@ -27,27 +47,112 @@ public:
     OdysseyRender& operator=(OdysseyRender&& odysseyRender) = delete;
 
 public:
+    // The window's size as last reported to whichever thread renders; the
+    // swap chain follows it at the next beginFrame().
+    void setWindowExtent(vk::Extent2D windowExtent);
+    vk::Extent2D getWindowExtent() const;
+    uint64_t getFrameCount() const;
     const vk::RenderPass& getSwapChainRenderPass() const;
     bool isFrameInProgress() const;
     vk::CommandBuffer getCurrentCommandBuffer() const;
+    size_t getFrameIndex() const;
     float getAspectRatio() const;
+    // What the scene is rendered at: the swap chain extent, or this frame's
+    // corner of the offscreen target with dynamic resolution.
+    vk::Extent2D getExtent() const;
+    vk::Image getSwapChainImage() const;
+    vk::ImageView getSwapChainImageView() const;
+    vk::Image getDepthImage() const;
+    vk::ImageView getDepthImageView() const;
+    bool hasSampledDepth() const;
+    bool hasDynamicResolution() const;
+    // This frame's offscreen color target; only with dynamic resolution.
+    vk::Image getSceneColorImage() const;
+    vk::ImageView getSceneColorImageView() const;
+    float getRenderScale() const;
+    uint64_t getRenderPassVersion() const;
+    std::string getLatencyReport() const;
+    double getLastGpuFrameTime() const;
+    double getAverageGpuFrameTime() const;
 
 public:
     vk::CommandBuffer beginFrame();
     void endFrame();
-    void beginSwapChainRenderPass(vk::CommandBuffer commandBuffer);
+    void beginSwapChainRenderPass(vk::CommandBuffer commandBuffer, OdysseyRenderPassPhase phase = OdysseyRenderPassPhase::WHOLE, vk::SubpassContents contents = vk::SubpassContents::eInline);
     void endSwapChainRenderPass(vk::CommandBuffer commandBuffer);
+    // A begun secondary buffer for the current frame's swap chain render pass,
+    // from the pool of threadIndex (OdysseyThreadPool::getThreadIndex()).
+    // Safe to call from several threads with different indices.
+    vk::CommandBuffer beginSecondaryCommandBuffer(size_t threadIndex);
+    // With dynamic resolution: clears the swap chain image, draws the scene
+    // color over it and presents, in a render pass of its own.
+    void upscale(vk::CommandBuffer commandBuffer);
+    void markInputSampled(double inputTime);
 
 private:
+    bool needsRecreate() const;
     void recreateSwapChain();
-    void createCommandBuffers();
-    void freeCommandBuffers();
+    void releaseRetiredSwapChains();
+    void waitForFrame(size_t frame);
+    void waitForSwapChain();
+    void createRenderPasses();
+    void destroyRenderPasses();
+    vk::RenderPass createRenderPass(OdysseyRenderPassPhase phase, bool offscreen) const;
+    void createDynamicResolution();
+    vk::Framebuffer getSceneFramebuffer() const;
+    void createCommandPools();
+    void setViewportAndScissor(vk::CommandBuffer commandBuffer) const;
+    void createTimestampPool();
+    void readTimestamps(size_t frame);
+
+private:
+    struct RetiredSwapChain {
+        std::unique_ptr<OdysseySwapChain> swapChain{};
+        uint64_t retireFrame{};
+    };
+
+    struct LatencyStats {
+        double total{0.0};
+        double max{0.0};
+        uint64_t count{0};
+
+        void add(double latency);
+    };
 
 private:
-    OdysseyWindow* m_window{};
+    vk::Extent2D m_windowExtent{};
     OdysseyDevice* m_device{};
+    OdysseyLatencyPolicy m_latencyPolicy{};
+    std::unique_ptr<OdysseyCommandPools> m_commandPools{};
+    // The primary buffer each frame in flight was last given.
     std::vector<vk::CommandBuffer> m_commandBuffers{};
+    bool m_sampledDepth{false};
+    vk::RenderPass m_renderPass{};
+    vk::RenderPass m_firstRenderPass{};
+    vk::RenderPass m_lastRenderPass{};
+    // The same phases on the offscreen target, with dynamic resolution.
+    vk::RenderPass m_offscreenRenderPass{};
+    vk::RenderPass m_offscreenFirstRenderPass{};
+    vk::RenderPass m_offscreenLastRenderPass{};
+    OdysseyResolutionPolicy m_resolutionPolicy{};
+    std::unique_ptr<OdysseyDynamicResolution> m_dynamicResolution{};
+    vk::Format m_colorFormat{vk::Format::eUndefined};
+    uint64_t m_renderPassVersion{0};
     std::unique_ptr<OdysseySwapChain> m_swapChain{};
+    std::deque<RetiredSwapChain> m_retiredSwapChains{};
+    uint64_t m_frameCount{0};
+    bool m_outOfDate{false};
+    // Profiler timestamps (ms); negative when nothing is pending.
+    std::array<double, OdysseySwapChain::MAX_FRAMES_IN_FLIGHT> m_submitTimes{-1.0, -1.0, -1.0};
+    double m_inputTime{-1.0};
+    LatencyStats m_inputToSubmit{};
+    LatencyStats m_submitToComplete{};
+    // Two timestamps per frame in flight, bracketing its command buffer.
+    vk::QueryPool m_timestampPool{};
+    std::array<bool, OdysseySwapChain::MAX_FRAMES_IN_FLIGHT> m_timestampsPending{};
+    LatencyStats m_gpuFrameTime{};
+    double m_lastGpuFrameTime{0.0};
+    std::future<void> m_swapChainReady{};
     uint32_t m_currentImageIndex{};
     bool m_isFrameStarted{false};
 };
@@ -0,0 +1,165 @@
+#pragma once
+
+/**
+ * @file odyssey_render_graph.h
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "odyssey_header.h"
+
+namespace odyssey {
+
+class OdysseyDevice;
+
+using RenderGraphResource = uint32_t;
+
+enum class RenderGraphAccess {
+    COLOR_ATTACHMENT,
+    DEPTH_ATTACHMENT,
+    DEPTH_READ,
+    SAMPLED,
+    STORAGE_READ,
+    STORAGE_WRITE,
+    TRANSFER_SRC,
+    TRANSFER_DST
+};
+
+struct RenderGraphImageInfo {
+    vk::Format format{vk::Format::eUndefined};
+    vk::Extent2D extent{};
+    vk::ImageUsageFlags usage{};
+    // Every aspect of format: barriers must name the stencil of a packed depth
+    // format too, while transient views only see its depth.
+    vk::ImageAspectFlags aspect{vk::ImageAspectFlagBits::eColor};
+};
+
+struct RenderGraphUse {
+    RenderGraphResource resource{};
+    RenderGraphAccess access{};
+    // Set when a VkRenderPass performs the layout transition itself; the graph
+    // then emits no barrier for this use and only tracks the resulting layout.
+    vk::ImageLayout renderPassFinalLayout{vk::ImageLayout::eUndefined};
+};
+
+struct RenderGraphPassInfo {
+    std::string name{};
+    std::vector<RenderGraphUse> reads{};
+    std::vector<RenderGraphUse> writes{};
+    bool sideEffects{false};
+    std::function<void(vk::CommandBuffer)> execute{};
+};
+
+/**
+ * Frame graph over the passes of one frame. Passes declare what they read and
+ * write; compile() drops passes that do not contribute to an imported image,
+ * derives the barriers and layout transitions between the remaining ones and
+ * places transient images with disjoint lifetimes in the same memory.
+ *
+ * Every frame slot has its own transient images and memory, so a frame never
+ * writes what one still in flight reads; execute() picks the slot's images.
+ */
+class OdysseyRenderGraph {
+public:
+    OdysseyRenderGraph(OdysseyDevice* device, size_t framesInFlight);
+    ~OdysseyRenderGraph();
+
+    OdysseyRenderGraph() = delete;
+    OdysseyRenderGraph(const OdysseyRenderGraph& odysseyRenderGraph) = delete;
+    OdysseyRenderGraph(OdysseyRenderGraph&& odysseyRenderGraph) = delete;
+    OdysseyRenderGraph& operator=(const OdysseyRenderGraph& odysseyRenderGraph) = delete;
+    OdysseyRenderGraph& operator=(OdysseyRenderGraph&& odysseyRenderGraph) = delete;
+
+public:
+    RenderGraphResource createImage(const std::string& name, const RenderGraphImageInfo& info);
+    RenderGraphResource importImage(const std::string& name, const RenderGraphImageInfo& info, vk::ImageLayout initialLayout, vk::ImageLayout finalLayout);
+    void bindImage(RenderGraphResource resource, vk::Image image, vk::ImageView view);
+    void addPass(RenderGraphPassInfo pass);
+    void compile();
+    void execute(vk::CommandBuffer commandBuffer, size_t frameIndex);
+    void reset();
+    std::string dump() const;
+
+public:
+    vk::Image getImage(RenderGraphResource resource) const;
+    vk::ImageView getImageView(RenderGraphResource resource) const;
+    // Summed over every frame slot.
+    vk::DeviceSize getTransientMemorySize() const;
+    // Compiled passes [first, last] the resource is used in, -1 when unused.
+    std::pair<int, int> getLifetime(RenderGraphResource resource) const;
+    // The memory block a transient was placed in, -1 for imported images.
+    int getMemoryBlock(RenderGraphResource resource) const;
+
+private:
+    struct Resource {
+        std::string name{};
+        RenderGraphImageInfo info{};
+        bool imported{false};
+        vk::ImageLayout initialLayout{vk::ImageLayout::eUndefined};
+        vk::ImageLayout finalLayout{vk::ImageLayout::eUndefined};
+        // The frame slot's, while it executes.
+        vk::Image image{};
+        vk::ImageView view{};
+        // Transients only, one per frame slot.
+        std::vector<vk::Image> images{};
+        std::vector<vk::ImageView> views{};
+        int firstPass{-1};
+        int lastPass{-1};
+        int memoryBlock{-1};
+        vk::DeviceSize memorySize{0};
+    };
+
+    struct Barrier {
+        RenderGraphResource resource{};
+        vk::ImageLayout oldLayout{};
+        vk::ImageLayout newLayout{};
+        vk::PipelineStageFlags srcStage{};
+        vk::AccessFlags srcAccess{};
+        vk::PipelineStageFlags dstStage{};
+        vk::AccessFlags dstAccess{};
+    };
+
+    struct MemoryBlock {
+        vk::DeviceSize size{0};
+        uint32_t memoryTypeBits{~0U};
+        int lastPass{-1};
+        // One per frame slot.
+        std::vector<vk::DeviceMemory> memories{};
+        std::vector<RenderGraphResource> resources{};
+    };
+
+    struct AccessInfo {
+        vk::PipelineStageFlags stage{};
+        vk::AccessFlags access{};
+        vk::ImageLayout layout{};
+        bool write{false};
+    };
+
+private:
+    static AccessInfo getAccessInfo(RenderGraphAccess access, bool write);
+    void cullPasses();
+    void computeLifetimes();
+    void allocateTransients();
+    void checkAliasing() const;
+    void buildBarriers();
+    void destroyTransients();
+    void recordBarriers(vk::CommandBuffer commandBuffer, const std::vector<Barrier>& barriers) const;
+
+private:
+    OdysseyDevice* m_device{};
+    size_t m_framesInFlight{1};
+    std::vector<Resource> m_resources{};
+    std::vector<RenderGraphPassInfo> m_passes{};
+    std::vector<size_t> m_compiledPasses{};
+    std::vector<std::vector<Barrier>> m_passBarriers{};
+    std::vector<Barrier> m_finalBarriers{};
+    std::vector<MemoryBlock> m_memoryBlocks{};
+    bool m_compiled{false};
+};
+
+}  // namespace odyssey
\ No newline at end of file
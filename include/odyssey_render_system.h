@@ -6,21 +6,65 @@
  * @date 2023-04-21
  */
 
+#include <array>
+#include <functional>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
+#include "odyssey_buffer.h"
 #include "odyssey_camera.h"
+#include "odyssey_clustered_lights.h"
+#include "odyssey_command_pools.h"
+#include "odyssey_culling.h"
+#include "odyssey_depth_pyramid.h"
+#include "odyssey_descriptors.h"
+#include "odyssey_draw_queue.h"
+#include "odyssey_geometry_pool.h"
 #include "odyssey_header.h"
+#include "odyssey_impostors.h"
+#include "odyssey_mesh_stream.h"
 #include "odyssey_object.h"
 #include "odyssey_pipeline.h"
+#include "odyssey_point_cloud.h"
 
 namespace odyssey {
 
 class OdysseyDevice;
 
 struct PushConstantData {
-    glm::mat4 transform{1.F};
-    glm::mat4 normal{1.F};
+    // (lighting model, debug view) when the pipeline branches at runtime.
+    glm::vec4 options{};
+};
+
+// Must match the Global block in shader.vert; one per frame in flight, in a
+// ring bound with dynamic offsets.
+struct GlobalData {
+    glm::mat4 view{1.F};
+    glm::mat4 projection{1.F};
+    glm::mat4 projectionView{1.F};
+    // World space, w = 1.
+    glm::vec4 cameraPosition{0.0F, 0.0F, 0.0F, 1.0F};
+    // This frame's point lights and their clusters, read by shader.frag.
+    glm::vec4 clusterScale{0.0F};
+    glm::uvec4 lightInfo{0U};
+};
+
+// Per-object data, read as an instance-rate vertex binding by shader.vert and
+// impostor.vert, and as a storage buffer by cull.comp and occlusion.comp.
+// Matrices stay in the transform storage buffers, indexed by transformIndex.
+struct InstanceData {
+    // World-space center and radius; a negative radius is never culled.
+    glm::vec4 boundingSphere{0.0F, 0.0F, 0.0F, -1.0F};
+    uint32_t meshIndex{0};
+    uint32_t transformIndex{0};
+    // Share of the pixels drawn, dithered, while cross-fading with an
+    // impostor.
+    float fade{1.0F};
+    uint32_t padding{0};
+
+    static std::vector<vk::VertexInputBindingDescription> getBindingDescriptions();
+    static std::vector<vk::VertexInputAttributeDescription> getAttributeDescriptions();
 };
 
 class OdysseyRenderSystem {
@@ -34,16 +78,261 @@ public:
     OdysseyRenderSystem& operator=(OdysseyRenderSystem&& odysseyRenderSystem) = default;
 
 public:
-    void renderObjects(vk::CommandBuffer commandBuffer, std::vector<OdysseyObject>& objects, OdysseyCamera* camera);
+    void prepareObjects(vk::CommandBuffer commandBuffer, std::vector<OdysseyObject>& objects, OdysseyCamera* camera, size_t frameIndex);
+    void renderObjects(vk::CommandBuffer commandBuffer, std::vector<OdysseyObject>& objects, OdysseyCamera* camera, size_t frameIndex, vk::Extent2D extent);
+    // Occlusion culling, after renderObjects has drawn last frame's visible
+    // objects: depthView must be in eDepthStencilReadOnlyOptimal.
+    void buildDepthPyramid(vk::CommandBuffer commandBuffer, size_t frameIndex, vk::ImageView depthView, vk::Extent2D depthExtent);
+    void cullOccluded(vk::CommandBuffer commandBuffer, OdysseyCamera* camera, size_t frameIndex);
+    void renderLateObjects(vk::CommandBuffer commandBuffer, size_t frameIndex);
+    // Outside the scene pass, before renderObjects: bins this frame's point
+    // lights into the camera's clusters. No lights leaves only the
+    // directional light.
+    void cullLights(vk::CommandBuffer commandBuffer, const std::vector<OdysseyPointLight>& lights, OdysseyCamera* camera, vk::Extent2D extent, size_t frameIndex);
+    // Inside the scene pass, after renderObjects has written this frame's
+    // globals; pointCloud->update must have run for the frame.
+    void renderPointCloud(vk::CommandBuffer commandBuffer, const OdysseyPointCloud& pointCloud, size_t frameIndex);
+    // Likewise, with the scene pipeline; meshStream->update must have run.
+    void renderMeshStream(vk::CommandBuffer commandBuffer, const OdysseyMeshStream& meshStream, size_t frameIndex);
+    // After any edit to the objects or their models: drops cached draws and
+    // the GPU-driven path's uploaded instances.
+    void markSceneChanged();
+    void setBatching(bool batching);
+    void setCulling(bool culling);
+    // Rebuilds every object's matrices each frame, one object at a time,
+    // instead of only the dirty ones in SIMD batches; for benchmarking.
+    void setPerObjectTransforms(bool perObjectTransforms);
+    bool setGpuDriven(bool gpuDriven);
+    bool isGpuDriven() const;
+    bool setOcclusionCulling(bool occlusionCulling);
+    bool isOcclusionCulling() const;
+    // Records draws into secondary buffers from beginSecondary, in parallel,
+    // and executes them from the primary; the render pass must then be begun
+    // with eSecondaryCommandBuffers. An empty function records inline.
+    void setParallelRecording(std::function<vk::CommandBuffer(size_t threadIndex)> beginSecondary);
+    bool isParallelRecording() const;
+    // Keeps each frame's draws in secondary buffers and replays them while
+    // the scene, and the camera where culling or sorting depends on it, stay
+    // unchanged. Needs the render pass begun with eSecondaryCommandBuffers.
+    void setCommandCaching(bool commandCaching);
+    bool isCommandCaching() const;
+    // Objects farther than distance from the camera are drawn as impostors,
+    // cross-fading over the next IMPOSTOR_FADE_BAND of it; 0 turns them off.
+    // Only the CPU path draws impostors.
+    void setImpostorDistance(float distance);
+    const OdysseyImpostors* getImpostors() const;
+
+public:
+    // Draws per secondary command buffer.
+    static constexpr size_t RECORD_GRAIN_SIZE{2048};
+    static constexpr float IMPOSTOR_FADE_BAND{0.1F};
+    void setVariant(const PipelineVariant& variant);
+    const PipelineVariant& getVariant() const;
+
+private:
+    struct Batch {
+        const OdysseyModel* model{};
+        uint32_t firstInstance{};
+        uint32_t instanceCount{};
+        // Drawn from the model's impostor atlas rather than its mesh.
+        bool impostor{false};
+
+        bool operator==(const Batch& batch) const = default;
+    };
+
+    // What a frame's cached commands were recorded from.
+    struct CommandCacheKey {
+        uint64_t sceneVersion{~0ULL};
+        uint64_t transformVersion{~0ULL};
+        // Zero when the commands do not depend on the camera.
+        uint64_t cameraVersion{~0ULL};
+        uint64_t recordVersion{~0ULL};
+        vk::Extent2D extent{};
+
+        bool operator==(const CommandCacheKey& commandCacheKey) const = default;
+    };
+
+    struct CommandCache {
+        CommandCacheKey key{};
+        bool recorded{false};
+        // Draws in recorded order, so objects that moved without changing
+        // which draws are made keep their commands.
+        std::vector<Batch> draws{};
+        // Secondary buffers per draw list, as executed.
+        std::array<std::vector<vk::CommandBuffer>, 2> lists{};
+    };
+
+    // Must match the push constant block in impostor.vert.
+    struct ImpostorPushConstantData {
+        glm::vec4 sphere{};
+        glm::vec4 options{};
+    };
+
+    struct CullPushConstantData {
+        glm::vec4 frustumPlanes[6]{};
+        uint32_t objectCount{0};
+        uint32_t useVisibility{0};
+    };
+
+    // Must match the push constant block in occlusion.comp.
+    struct OcclusionPushConstantData {
+        glm::mat4 view{1.F};
+        glm::vec4 frustum{};
+        glm::vec4 projection{};
+        glm::vec2 pyramidSize{};
+        float zNear{0.0F};
+        float zFar{0.0F};
+        uint32_t objectCount{0};
+        uint32_t occlusion{0};
+    };
+
+    // Indices into the count buffer, which occlusion culling extends from a
+    // single draw count.
+    enum DrawCountIndex : uint32_t {
+        EARLY_DRAWS,
+        LATE_DRAWS,
+        FRUSTUM_VISIBLE,
+        OCCLUDED,
+        DRAW_COUNT_SIZE
+    };
+
+    struct IndirectFrame {
+        std::unique_ptr<OdysseyBuffer> meshes{};
+        std::unique_ptr<OdysseyBuffer> commands{};
+        std::unique_ptr<OdysseyBuffer> count{};
+        std::unique_ptr<OdysseyBuffer> countReadback{};
+        vk::DescriptorSet descriptorSet{};
+        vk::DescriptorSet occlusionDescriptorSet{};
+        vk::Buffer instanceBuffer{};
+        vk::Buffer visibilityBuffer{};
+        vk::ImageView pyramidView{};
+        bool occlusionSetDirty{true};
+        bool countsPending{false};
+        uint64_t geometryVersion{~0ULL};
+        // The instance buffer is only rewritten when these change.
+        uint64_t sceneVersion{~0ULL};
+        uint64_t transformVersion{~0ULL};
+        uint32_t objectCount{0};
+    };
 
 private:
     void createPipelineLayout();
-    std::unique_ptr<OdysseyPipeline> createPipeline(const std::string& vertShaderPath, const std::string& fragShaderPath, vk::PrimitiveTopology primitiveTopology, float lineWidth, vk::RenderPass renderPass);
+    void createCullResources();
+    void createOcclusionResources();
+    void createGlobalResources();
+    void bindScenePipeline(vk::CommandBuffer commandBuffer, size_t frameIndex);
+    void bindImpostorPipeline(vk::CommandBuffer commandBuffer, size_t frameIndex);
+    void updateGlobals(OdysseyCamera* camera, size_t frameIndex);
+    void updateTransforms();
+    void uploadTransforms(vk::CommandBuffer commandBuffer, size_t frameIndex);
+    void updateTransformBuffers(size_t transformCount);
+    void cullObjects(std::vector<OdysseyObject>& objects, OdysseyCamera* camera);
+    void renderBatches(vk::CommandBuffer commandBuffer, std::vector<OdysseyObject>& objects, OdysseyCamera* camera, size_t frameIndex);
+    uint32_t getModelId(const OdysseyModel* model);
+    bool replay(vk::CommandBuffer commandBuffer, size_t frameIndex, const CommandCacheKey& key);
+    bool replayDraws(vk::CommandBuffer commandBuffer, size_t frameIndex);
+    void record(vk::CommandBuffer commandBuffer, size_t frameIndex, uint32_t list, size_t count, const std::function<void(vk::CommandBuffer commandBuffer, size_t begin, size_t end)>& function);
+    vk::CommandBuffer beginSecondary(size_t frameIndex);
+    void renderIndirect(vk::CommandBuffer commandBuffer, size_t frameIndex, uint32_t list);
+    void uploadInstances(IndirectFrame& frame, const std::vector<OdysseyObject>& objects, size_t frameIndex);
+    void updateIndirectFrame(IndirectFrame& frame, OdysseyBuffer* instanceBuffer, uint32_t objectCount);
+    void updateOcclusionFrame(IndirectFrame& frame, size_t frameIndex);
+    void updateVisibilityBuffer(vk::CommandBuffer commandBuffer, uint32_t objectCount);
+    void readOcclusionCounts(IndirectFrame& frame);
+    const OdysseyPipeline* getPipeline(const PipelineVariant& variant);
+    const OdysseyPipeline* getImpostorPipeline(const PipelineVariant& variant);
+    OdysseyBuffer* getInstanceBuffer(size_t frameIndex, size_t instanceCount);
+    std::unique_ptr<OdysseyPipeline> createPipeline(const std::string& vertShaderPath, const std::string& fragShaderPath, const PipelineVariant& variant, vk::RenderPass renderPass, const std::vector<vk::VertexInputBindingDescription>& bindingDescriptions, const std::vector<vk::VertexInputAttributeDescription>& attributeDescriptions, vk::PipelineLayout pipelineLayout = {});
 
 private:
     OdysseyDevice* m_device;
+    vk::RenderPass m_renderPass{};
     vk::PipelineLayout m_pipelineLayout{};
-    std::unique_ptr<OdysseyPipeline> m_pipelineLine{};
+    // Set 0 of the scene pipeline: the global ring and the transforms, all
+    // shared by every frame in flight.
+    std::unique_ptr<OdysseyDescriptorSetLayout> m_globalSetLayout{};
+    std::unique_ptr<OdysseyDescriptorPool> m_globalDescriptorPool{};
+    vk::DescriptorSet m_globalDescriptorSet{};
+    std::unique_ptr<OdysseyBuffer> m_globalBuffer{};
+    // Device-local copies of the transform store's matrices, updated from a
+    // staging buffer per frame in flight.
+    std::unique_ptr<OdysseyBuffer> m_modelMatrices{};
+    std::unique_ptr<OdysseyBuffer> m_normalMatrices{};
+    std::vector<std::unique_ptr<OdysseyBuffer>> m_transformStagingBuffers{};
+    uint64_t m_uploadedTransformVersion{~0ULL};
+    std::vector<uint32_t> m_updatedTransforms{};
+    std::vector<vk::BufferCopy> m_matrixCopies{};
+    std::vector<vk::BufferCopy> m_normalCopies{};
+    // Its buffers are bindings 3 and 4 of the global set.
+    std::unique_ptr<OdysseyClusteredLights> m_clusteredLights{};
+    PipelineVariant m_variant{};
+    std::unordered_map<PipelineVariant, std::unique_ptr<OdysseyPipeline>> m_pipelines{};
+    // Created on first use; shares m_pipelineLayout, the push constants
+    // carrying the cloud's placement.
+    std::unique_ptr<OdysseyPipeline> m_pointPipeline{};
+    // The single instance every mesh stream chunk is drawn as, pointing at
+    // the stream's transform slot.
+    std::unique_ptr<OdysseyBuffer> m_streamInstanceBuffer{};
+    uint32_t m_streamTransformIndex{~0U};
+    bool m_batching{true};
+    std::vector<std::unique_ptr<OdysseyBuffer>> m_instanceBuffers{};
+    std::unordered_map<const OdysseyModel*, uint32_t> m_batchIndices{};
+    std::vector<Batch> m_batches{};
+    // One entry per object when not batching.
+    std::vector<Batch> m_draws{};
+    // Batches or draws in sorted order, as recorded.
+    std::vector<Batch> m_orderedDraws{};
+    float m_impostorDistance{0.0F};
+    std::unique_ptr<OdysseyImpostors> m_impostors{};
+    // Set 1 is the model's atlas.
+    vk::PipelineLayout m_impostorPipelineLayout{};
+    std::unordered_map<PipelineVariant, std::unique_ptr<OdysseyPipeline>> m_impostorPipelines{};
+    std::unordered_map<const OdysseyModel*, uint32_t> m_impostorBatchIndices{};
+    std::vector<Batch> m_impostorBatches{};
+    // Per object, the mesh's share of the cross-fade; 1 without impostors.
+    std::vector<float> m_fades{};
+    // Dense ids for the model field of sort keys, in order of first use.
+    std::unordered_map<const OdysseyModel*, uint32_t> m_modelIds{};
+    OdysseyDrawQueue m_drawQueue{};
+    bool m_culling{true};
+    OdysseyCuller m_culler{};
+    bool m_perObjectTransforms{false};
+
+    bool m_gpuDriven{false};
+    std::unique_ptr<OdysseyGeometryPool> m_geometryPool{};
+    std::unique_ptr<OdysseyDescriptorSetLayout> m_cullSetLayout{};
+    std::unique_ptr<OdysseyDescriptorPool> m_cullDescriptorPool{};
+    vk::PipelineLayout m_cullPipelineLayout{};
+    std::unique_ptr<OdysseyComputePipeline> m_cullPipeline{};
+    std::vector<IndirectFrame> m_indirectFrames{};
+
+    bool m_occlusionCulling{false};
+    // Per object, nonzero when it passed occlusion culling last frame. Shared
+    // by every frame in flight, since each frame builds on the one before.
+    std::unique_ptr<OdysseyBuffer> m_visibility{};
+    std::unique_ptr<OdysseyDepthPyramid> m_depthPyramid{};
+    std::unique_ptr<OdysseyDescriptorSetLayout> m_occlusionSetLayout{};
+    std::unique_ptr<OdysseyDescriptorPool> m_occlusionDescriptorPool{};
+    vk::PipelineLayout m_occlusionPipelineLayout{};
+    std::unique_ptr<OdysseyComputePipeline> m_occlusionPipeline{};
+
+    std::function<vk::CommandBuffer(size_t threadIndex)> m_beginSecondary{};
+    std::vector<vk::CommandBuffer> m_secondaryCommandBuffers{};
+
+    bool m_commandCaching{false};
+    // Not reset with the frame's other pools, so its buffers survive until
+    // the frame records again.
+    std::unique_ptr<OdysseyCommandPools> m_cachedCommandPools{};
+    std::vector<CommandCache> m_commandCaches{};
+    // Bumped by markSceneChanged() and when instance data changes meaning;
+    // m_recordVersion when recorded commands would differ for the same scene
+    // (pipeline, bound buffers).
+    uint64_t m_sceneVersion{0};
+    uint64_t m_recordVersion{0};
+    // Set by renderObjects for the rest of the frame.
+    CommandCacheKey m_frameKey{};
+    vk::Extent2D m_extent{};
+    bool m_replaying{false};
 };
 
 }  // namespace odyssey
\ No newline at end of file
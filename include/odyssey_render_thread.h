@@ -0,0 +1,135 @@
+#pragma once
+
+/**
+ * @file odyssey_render_thread.h
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <semaphore>
+#include <string>
+#include <thread>
+
+#include "odyssey_header.h"
+#include "odyssey_keyboard_event.h"
+#include "odyssey_redraw_scheduler.h"
+#include "odyssey_spsc_queue.h"
+
+namespace odyssey {
+
+enum class OdysseyRenderCommandType {
+    // The window is now extent in size.
+    RESIZE,
+    // The window needs repainting.
+    EXPOSE,
+    // Camera input.
+    KEY,
+    // Pick the object under position, in normalized device coordinates.
+    PICK,
+    // Import the model at path into the scene.
+    LOAD_OBJECT,
+    // Print the redraw and timing reports.
+    REPORT
+};
+
+struct OdysseyRenderCommand {
+    OdysseyRenderCommandType type{};
+    // When the UI thread queued it, as OdysseyProfiler::now().
+    double time{0.0};
+    vk::Extent2D extent{};
+    OdysseyKeyboardEventType key{};
+    glm::vec2 position{0.0F};
+    std::string path{};
+};
+
+struct OdysseyPickSnapshot {
+    // Picks so far; the rest describes the latest one.
+    uint64_t count{0};
+    bool hit{false};
+    unsigned objectId{0};
+    uint32_t triangle{0};
+    glm::vec3 position{0.0F};
+    double time{0.0};
+    // Model BVHs still building, which a miss may be down to.
+    size_t pending{0};
+};
+
+// What the UI thread may know of the renderer, as of the last frame drawn.
+struct OdysseySceneSnapshot {
+    uint64_t frame{0};
+    glm::vec3 cameraPosition{0.0F};
+    size_t objectCount{0};
+    size_t lightCount{0};
+    float renderScale{1.0F};
+    double cpuFrameTime{0.0};
+    double gpuFrameTime{0.0};
+    OdysseyPickSnapshot pick{};
+};
+
+/**
+ * Runs the redraw scheduler on a thread of its own, so frames neither wait
+ * for the Qt event loop nor hold it up. The UI thread hands over input,
+ * resizes and scene edits as commands through a lock-free single-producer
+ * single-consumer queue; the render thread applies them between frames and
+ * publishes a snapshot at the end of each frame through a triple buffer, so
+ * neither side ever blocks on the other.
+ */
+class OdysseyRenderThread {
+public:
+    // Called on the render thread for every command, in submission order.
+    using CommandCallback = std::function<void(OdysseyRenderCommand& command)>;
+
+public:
+    OdysseyRenderThread(OdysseyRedrawScheduler* scheduler, CommandCallback commandCallback);
+    ~OdysseyRenderThread();
+
+    OdysseyRenderThread() = delete;
+    OdysseyRenderThread(const OdysseyRenderThread& odysseyRenderThread) = delete;
+    OdysseyRenderThread(OdysseyRenderThread&& odysseyRenderThread) = delete;
+    OdysseyRenderThread& operator=(const OdysseyRenderThread& odysseyRenderThread) = delete;
+    OdysseyRenderThread& operator=(OdysseyRenderThread&& odysseyRenderThread) = delete;
+
+public:
+    // Everything the scheduler draws must be set up before start(), and left
+    // to the render thread until stop() returns.
+    void start();
+    void stop();
+    // UI thread only. Waits, without locking, only while the queue is full.
+    void submit(OdysseyRenderCommand command);
+    // UI thread only: the newest snapshot published so far.
+    const OdysseySceneSnapshot& getSnapshot();
+    // Render thread only, at a frame boundary.
+    void publish(const OdysseySceneSnapshot& snapshot);
+
+public:
+    static constexpr size_t COMMAND_CAPACITY{1024};
+
+private:
+    void run();
+
+private:
+    // Set in m_middle when the slot it names has not been read yet.
+    static constexpr uint32_t FRESH{4};
+
+private:
+    OdysseyRedrawScheduler* m_scheduler{};
+    CommandCallback m_commandCallback{};
+    OdysseySpscQueue<OdysseyRenderCommand> m_commands{COMMAND_CAPACITY};
+    // Released once per command and by stop(); run() drops what is left
+    // before it drains the queue, so permits do not pile up while it is busy.
+    std::counting_semaphore<> m_wakeup{0};
+    std::atomic<bool> m_stopping{false};
+    std::thread m_thread{};
+    // The render thread writes m_back and swaps it into m_middle; the UI
+    // thread swaps m_front for m_middle when that is fresh.
+    std::array<OdysseySceneSnapshot, 3> m_snapshots{};
+    std::atomic<uint32_t> m_middle{1};
+    uint32_t m_back{0};
+    uint32_t m_front{2};
+};
+
+}  // namespace odyssey
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+
+/**
+ * @file odyssey_scene_graph.h
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include <string>
+#include <vector>
+
+#include "odyssey_header.h"
+#include "odyssey_object.h"
+
+namespace odyssey {
+
+/**
+ * Node hierarchy kept as a depth-first array: every node is followed by its
+ * subtree, so world matrices are propagated in one forward pass that jumps
+ * over subtrees with nothing dirty. Moving a node costs its subtree plus one
+ * step per sibling subtree on the way, not the whole scene.
+ *
+ * Object transforms attached to a node are placed in its frame in
+ * OdysseyTransformStore, so they are rebuilt with the other dirty slots.
+ */
+class OdysseySceneGraph {
+public:
+    OdysseySceneGraph() = default;
+    ~OdysseySceneGraph() = default;
+    OdysseySceneGraph(const OdysseySceneGraph& odysseySceneGraph) = delete;
+    OdysseySceneGraph(OdysseySceneGraph&& odysseySceneGraph) = delete;
+    OdysseySceneGraph& operator=(const OdysseySceneGraph& odysseySceneGraph) = delete;
+    OdysseySceneGraph& operator=(OdysseySceneGraph&& odysseySceneGraph) = delete;
+
+public:
+    // Adds a node as the last child of parent, or as the last root for
+    // INVALID_NODE. The returned handle stays valid as the array shifts;
+    // adding to the last subtree never shifts it.
+    uint32_t addNode(uint32_t parent, const std::string& name, const glm::mat4& localMatrix);
+    // The transform must stay attached for as long as it lives.
+    void attach(uint32_t node, const TransformComponent& transform);
+    void setLocalMatrix(uint32_t node, const glm::mat4& localMatrix);
+
+    const glm::mat4& getLocalMatrix(uint32_t node) const;
+    // Valid after update().
+    const glm::mat4& getWorldMatrix(uint32_t node) const;
+    const std::string& getName(uint32_t node) const;
+    uint32_t getParent(uint32_t node) const;
+    size_t getNodeCount() const;
+
+    // Returns the number of nodes whose world matrix changed.
+    size_t update();
+
+public:
+    static constexpr uint32_t INVALID_NODE{~0U};
+
+private:
+    void markDirty(uint32_t position);
+
+private:
+    // Indexed by position in depth-first order; parents are positions too.
+    std::vector<uint32_t> m_parents{};
+    std::vector<uint32_t> m_subtreeSizes{};
+    std::vector<glm::mat4> m_localMatrices{};
+    std::vector<glm::mat4> m_worldMatrices{};
+    // The node's own matrix changed, and it or a descendant did.
+    std::vector<uint8_t> m_localDirty{};
+    std::vector<uint8_t> m_subtreeDirty{};
+    // Whether update() recomputed the node; only read for visited parents.
+    std::vector<uint8_t> m_changed{};
+    // Transform store frame, created on first attach.
+    std::vector<uint32_t> m_frames{};
+    std::vector<std::vector<uint32_t>> m_attachments{};
+    std::vector<std::string> m_names{};
+    std::vector<uint32_t> m_handles{};
+    // Indexed by handle.
+    std::vector<uint32_t> m_positions{};
+};
+
+}  // namespace odyssey
\ No newline at end of file
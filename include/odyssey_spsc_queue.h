@@ -0,0 +1,84 @@
+#pragma once
+
+/**
+ * @file odyssey_spsc_queue.h
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace odyssey {
+
+/**
+ * Bounded lock-free queue for exactly one producer thread and one consumer
+ * thread. Each side owns one index and only reads the other's, so push() and
+ * pop() are wait-free; the release store of an index publishes the slot it
+ * passes over. The indices sit on separate cache lines so the two threads do
+ * not invalidate each other's line on every operation.
+ */
+template <typename T>
+class OdysseySpscQueue {
+public:
+    // Rounded up to a power of two.
+    explicit OdysseySpscQueue(size_t capacity) : m_slots(std::bit_ceil((std::max)(capacity, size_t{2}))), m_mask(m_slots.size() - 1) {
+    }
+    ~OdysseySpscQueue() = default;
+
+    OdysseySpscQueue() = delete;
+    OdysseySpscQueue(const OdysseySpscQueue& odysseySpscQueue) = delete;
+    OdysseySpscQueue(OdysseySpscQueue&& odysseySpscQueue) = delete;
+    OdysseySpscQueue& operator=(const OdysseySpscQueue& odysseySpscQueue) = delete;
+    OdysseySpscQueue& operator=(OdysseySpscQueue&& odysseySpscQueue) = delete;
+
+public:
+    // Producer only. False, leaving value untouched, when the queue is full.
+    bool push(T& value) {
+        auto tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == m_slots.size()) {
+            return false;
+        }
+        m_slots[tail & m_mask] = std::move(value);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only.
+    std::optional<T> pop() {
+        auto head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return std::nullopt;
+        }
+        std::optional<T> value{std::move(m_slots[head & m_mask])};
+        // Leaves nothing behind that the producer would free on its next
+        // lap, such as a moved-from string's buffer.
+        m_slots[head & m_mask] = T{};
+        m_head.store(head + 1, std::memory_order_release);
+        return value;
+    }
+
+    size_t capacity() const {
+        return m_slots.size();
+    }
+
+private:
+    // Not std::hardware_destructive_interference_size, which not every
+    // standard library provides and GCC warns about using in headers.
+    static constexpr size_t CACHE_LINE{64};
+
+private:
+    std::vector<T> m_slots{};
+    size_t m_mask{};
+    // Next slot to pop, written by the consumer.
+    alignas(CACHE_LINE) std::atomic<size_t> m_head{0};
+    // Next slot to push, written by the producer.
+    alignas(CACHE_LINE) std::atomic<size_t> m_tail{0};
+};
+
+}  // namespace odyssey
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+/**
+ * @file odyssey_static_batcher.h
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "odyssey_object.h"
+
+namespace odyssey {
+
+class OdysseyDevice;
+
+/**
+ * Merges the small meshes of objects that never move into combined vertex
+ * and index buffers, pre-transformed to world space. Every object is drawn
+ * with the same pipeline and models carry no materials, so objects are only
+ * grouped by the cell of a uniform grid their bounds are centered in; each
+ * cell becomes one model, drawn and culled like any other object. The merged
+ * objects are kept, and a triangle picked on a cell maps back to its object
+ * through the cell's ID ranges.
+ */
+class OdysseyStaticBatcher {
+public:
+    struct Source {
+        const OdysseyObject* object{};
+        // In the object's own model.
+        uint32_t triangle{0};
+    };
+
+public:
+    explicit OdysseyStaticBatcher(OdysseyDevice* device);
+    ~OdysseyStaticBatcher() = default;
+    OdysseyStaticBatcher() = delete;
+    OdysseyStaticBatcher(const OdysseyStaticBatcher& odysseyStaticBatcher) = delete;
+    OdysseyStaticBatcher(OdysseyStaticBatcher&& odysseyStaticBatcher) = delete;
+    OdysseyStaticBatcher& operator=(const OdysseyStaticBatcher& odysseyStaticBatcher) = delete;
+    OdysseyStaticBatcher& operator=(OdysseyStaticBatcher&& odysseyStaticBatcher) = delete;
+
+public:
+    // The objects' matrices must be up to date. Returns what to draw in
+    // their place: an object per cell, and every object that could not be
+    // merged, without a model or above OdysseyModel::MAX_MERGEABLE_VERTICES.
+    std::vector<OdysseyObject> merge(std::vector<OdysseyObject> objects);
+    // Nothing for models that are not cells.
+    std::optional<Source> findSource(const OdysseyModel* model, uint32_t triangle) const;
+    size_t getMergedCount() const;
+    size_t getCellCount() const;
+
+public:
+    // Along the longest side of the merged objects' bounds.
+    static constexpr uint32_t CELLS_PER_AXIS{8};
+
+private:
+    struct Cell {
+        // The first triangle of each merged object, ascending, and the
+        // object's index in m_sources.
+        std::vector<uint32_t> firstTriangles{};
+        std::vector<uint32_t> sources{};
+    };
+
+private:
+    OdysseyDevice* m_device{};
+    std::vector<OdysseyObject> m_sources{};
+    std::unordered_map<const OdysseyModel*, Cell> m_cells{};
+};
+
+}  // namespace odyssey
\ No newline at end of file
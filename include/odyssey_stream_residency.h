@@ -0,0 +1,116 @@
+#pragma once
+
+/**
+ * @file odyssey_stream_residency.h
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "odyssey_buffer.h"
+#include "odyssey_header.h"
+
+namespace odyssey {
+
+class OdysseyDevice;
+
+/**
+ * GPU residency of the items of a file streamed in pieces, each a byte range
+ * read whole into a buffer of its own. The owner decides every frame which
+ * items it wants; a dedicated I/O thread reads them, most wanted first, and
+ * upload() copies what has been read. Buffers that are evicted, and staging
+ * buffers, are kept until their frame slot comes round again.
+ *
+ * Item state is only touched by the thread that renders; the I/O thread
+ * sees the request and loaded queues alone.
+ */
+class OdysseyStreamResidency {
+public:
+    enum class State {
+        UNLOADED,
+        REQUESTED,
+        RESIDENT
+    };
+
+    struct Range {
+        uint64_t offset{0};
+        uint64_t size{0};
+    };
+
+    // Called for each item read before it is uploaded; false leaves it
+    // unloaded, to be requested again when next wanted.
+    using AdmitCallback = std::function<bool(uint32_t item, uint64_t size)>;
+
+public:
+    // Buffers are created with usage and made visible to readAccess at the
+    // vertex input stage.
+    OdysseyStreamResidency(OdysseyDevice* device, const std::string& path, std::vector<Range> ranges, vk::BufferUsageFlags usage, vk::AccessFlags readAccess);
+    ~OdysseyStreamResidency();
+    OdysseyStreamResidency() = delete;
+    OdysseyStreamResidency(const OdysseyStreamResidency& odysseyStreamResidency) = delete;
+    OdysseyStreamResidency(OdysseyStreamResidency&& odysseyStreamResidency) = delete;
+    OdysseyStreamResidency& operator=(const OdysseyStreamResidency& odysseyStreamResidency) = delete;
+    OdysseyStreamResidency& operator=(OdysseyStreamResidency&& odysseyStreamResidency) = delete;
+
+public:
+    // Once the frame's fence has been waited on.
+    void beginFrame(size_t frameIndex);
+    // Replaces the requests not read yet with those of items, most wanted
+    // last, that are neither resident nor being read.
+    void request(const std::vector<uint32_t>& items);
+    // Outside a render pass: copies up to maxUploads items read so far.
+    void upload(vk::CommandBuffer commandBuffer, size_t frameIndex, size_t maxUploads, const AdmitCallback& admit);
+    void evict(uint32_t item, size_t frameIndex);
+    State getState(uint32_t item) const;
+    vk::Buffer getBuffer(uint32_t item) const;
+    uint64_t getSize(uint32_t item) const;
+    uint64_t getResidentBytes() const;
+    size_t getResidentCount() const;
+    uint64_t getEvictionCount() const;
+    size_t getPendingCount();
+    uint64_t getBytesRead();
+    double getReadSeconds();
+
+private:
+    struct Item {
+        State state{State::UNLOADED};
+        std::unique_ptr<OdysseyBuffer> buffer{};
+    };
+
+private:
+    void ioLoop();
+
+private:
+    OdysseyDevice* m_device{};
+    std::string m_path{};
+    std::vector<Range> m_ranges{};
+    vk::BufferUsageFlags m_usage{};
+    vk::AccessFlags m_readAccess{};
+    std::vector<Item> m_items{};
+    uint64_t m_residentBytes{0};
+    size_t m_residentCount{0};
+    uint64_t m_evictionCount{0};
+    // Freed once their frame comes round again.
+    std::vector<std::vector<std::unique_ptr<OdysseyBuffer>>> m_retired{};
+
+    std::thread m_ioThread{};
+    std::mutex m_mutex{};
+    std::condition_variable m_wakeup{};
+    // Most wanted last.
+    std::vector<uint32_t> m_requests{};
+    std::vector<std::pair<uint32_t, std::vector<char>>> m_loaded{};
+    uint64_t m_bytesRead{0};
+    double m_readSeconds{0.0};
+    bool m_stopping{false};
+};
+
+}  // namespace odyssey
\ No newline at end of file
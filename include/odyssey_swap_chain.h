@@ -14,9 +14,22 @@ namespace odyssey {
 
 class OdysseyDevice;
 
+/**
+ * Trade-off between latency and throughput for one station. Fewer frames in
+ * flight and a CPU wait before input sampling shorten input-to-photon time;
+ * more frames and swap chain images keep the GPU busy.
+ */
+struct OdysseyLatencyPolicy {
+    uint32_t framesInFlight{2};
+    vk::PresentModeKHR presentMode{vk::PresentModeKHR::eMailbox};
+    // 0 picks minImageCount + 1.
+    uint32_t imageCount{0};
+    bool waitBeforeInput{false};
+};
+
 class OdysseySwapChain {
 public:
-    OdysseySwapChain(OdysseyDevice* device, int width, int height);
+    OdysseySwapChain(OdysseyDevice* device, vk::RenderPass renderPass, int width, int height, const OdysseyLatencyPolicy& policy, bool sampledDepth, OdysseySwapChain* previous = nullptr);
     ~OdysseySwapChain();
 
     OdysseySwapChain() = delete;
@@ -29,33 +42,52 @@ public:
     const vk::Format& getSwapChainImageFormat() const;
     size_t getImageCount() const;
     vk::Extent2D getSwapChainExtent() const;
+    vk::Extent2D getWindowExtent() const;
     const vk::Framebuffer& getFrameBuffer(size_t index) const;
+    const vk::Image& getImage(size_t index) const;
     const vk::ImageView& getImageView(size_t index) const;
+    const vk::Image& getDepthImage(size_t index) const;
+    const vk::ImageView& getDepthImageView(size_t index) const;
     const vk::RenderPass& getRenderPass() const;
     uint32_t getWidth() const;
     uint32_t getHeight() const;
     float getExtentAspectRatio() const;
+    size_t getCurrentFrame() const;
+    size_t getFramesInFlight() const;
+    size_t getPreviousFrame() const;
+    vk::PresentModeKHR getPresentMode() const;
+    bool isSuboptimal() const;
+    void waitForFrame(size_t frame) const;
     uint32_t acquireNextImage();
     void submitCommandBuffers(const vk::CommandBuffer& buffers, uint32_t imageIndex);
 
+public:
+    static vk::SurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<vk::SurfaceFormatKHR>& availableFormats);
+    static vk::Format findDepthFormat(const OdysseyDevice* device);
+    // Every aspect of a depth format, for barriers; views only need depth.
+    static vk::ImageAspectFlags getDepthAspect(vk::Format depthFormat);
+
 private:
-    void createSwapChain();
-    void createRenderPass();
+    void createSwapChain(OdysseySwapChain* previous);
     void createDepthResources();
+    bool supportsLazilyAllocatedDepth(vk::Format depthFormat, vk::Extent2D extent) const;
+    void reportDepthMemory(vk::Format depthFormat, vk::ImageUsageFlags usage, bool lazilyAllocated) const;
     void createFrameBuffers();
-    void createSyncObjects();
+    void createSyncObjects(OdysseySwapChain* previous);
 
 private:
-    static vk::SurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<vk::SurfaceFormatKHR>& availableFormats);
-    static vk::PresentModeKHR chooseSwapPresentMode(const std::vector<vk::PresentModeKHR>& availablePresentModes);
+    static vk::PresentModeKHR chooseSwapPresentMode(const std::vector<vk::PresentModeKHR>& availablePresentModes, vk::PresentModeKHR preferredPresentMode);
     vk::Extent2D chooseSwapExtent(const vk::SurfaceCapabilitiesKHR& capabilities);
-    vk::Format findDepthFormat() const;
 
 public:
-    static constexpr int MAX_FRAMES_IN_FLIGHT{2};
+    static constexpr size_t MAX_FRAMES_IN_FLIGHT{3};
 
 private:
     OdysseyDevice* m_device{};
+    OdysseyLatencyPolicy m_policy{};
+    size_t m_framesInFlight{2};
+    bool m_sampledDepth{false};
+    vk::PresentModeKHR m_presentMode{};
     vk::Extent2D m_windowExtent{};
     vk::Format m_swapChainImageFormat{};
     vk::Extent2D m_swapChainExtent{};
@@ -72,6 +104,7 @@ private:
     std::vector<vk::Fence> m_inFlightFences{};
     std::vector<vk::Fence> m_imagesInFlight{};
     size_t m_currentFrame{0};
+    bool m_suboptimal{false};
 };
 
 }  // namespace odyssey
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+/**
+ * @file odyssey_thread_pool.h
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace odyssey {
+
+/**
+ * Fixed set of worker threads shared by every per-frame job. parallelFor
+ * splits a range into chunks and runs them on the workers and the calling
+ * thread, returning once every chunk has finished.
+ */
+class OdysseyThreadPool {
+public:
+    static OdysseyThreadPool& instance();
+
+    OdysseyThreadPool(const OdysseyThreadPool& odysseyThreadPool) = delete;
+    OdysseyThreadPool(OdysseyThreadPool&& odysseyThreadPool) = delete;
+    OdysseyThreadPool& operator=(const OdysseyThreadPool& odysseyThreadPool) = delete;
+    OdysseyThreadPool& operator=(OdysseyThreadPool&& odysseyThreadPool) = delete;
+
+public:
+    void parallelFor(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)>& function);
+    size_t getThreadCount() const;
+    // 1 to getThreadCount() - 1 on the workers and 0 on any other thread, so
+    // per-thread resources can be indexed by it while only one thread at a
+    // time calls parallelFor.
+    static size_t getThreadIndex();
+
+private:
+    OdysseyThreadPool();
+    ~OdysseyThreadPool();
+
+private:
+    void workerLoop(size_t threadIndex);
+
+private:
+    std::vector<std::thread> m_workers{};
+    std::mutex m_mutex{};
+    std::condition_variable m_wakeup{};
+    std::deque<std::function<void()>> m_tasks{};
+    bool m_stopping{false};
+};
+
+}  // namespace odyssey
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+
+/**
+ * @file odyssey_transform_store.h
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include "odyssey_header.h"
+
+namespace odyssey {
+
+/**
+ * Process-wide structure-of-arrays storage for object transforms. Setting a
+ * component marks its slot dirty; update() rebuilds the cached world and
+ * normal matrices of dirty slots only, four at a time with SSE, so objects
+ * that do not move cost nothing per frame.
+ *
+ * A slot may be placed in a parent frame, a matrix owned by whoever created
+ * it (the scene graph), which then applies on top of the slot's own
+ * transform. Changing a frame does not dirty the slots in it; the owner
+ * marks them.
+ */
+class OdysseyTransformStore {
+public:
+    static OdysseyTransformStore& instance();
+
+    OdysseyTransformStore(const OdysseyTransformStore& odysseyTransformStore) = delete;
+    OdysseyTransformStore(OdysseyTransformStore&& odysseyTransformStore) = delete;
+    OdysseyTransformStore& operator=(const OdysseyTransformStore& odysseyTransformStore) = delete;
+    OdysseyTransformStore& operator=(OdysseyTransformStore&& odysseyTransformStore) = delete;
+
+public:
+    // New slots hold the identity transform and are dirty; destroyed slots
+    // are reused.
+    uint32_t create();
+    void destroy(uint32_t index);
+
+    void setTranslation(uint32_t index, const glm::vec3& translation);
+    void setRotation(uint32_t index, const glm::vec3& rotation);
+    void setScale(uint32_t index, const glm::vec3& scale);
+    glm::vec3 getTranslation(uint32_t index) const;
+    glm::vec3 getRotation(uint32_t index) const;
+    glm::vec3 getScale(uint32_t index) const;
+    void markDirty(uint32_t index);
+
+    uint32_t createFrame();
+    void setFrame(uint32_t frame, const glm::mat4& matrix);
+    // INVALID_INDEX places the slot back in world space.
+    void setParentFrame(uint32_t index, uint32_t frame);
+
+    // Valid for every slot after update() or rebuildAll().
+    const glm::mat4& getMatrix(uint32_t index) const;
+    const glm::mat3x4& getNormalMatrix(uint32_t index) const;
+    // Indexed by slot, free slots included, for uploading as a whole.
+    const std::vector<glm::mat4>& getMatrices() const;
+    const std::vector<glm::mat3x4>& getNormalMatrices() const;
+
+    // Returns the number of slots rebuilt.
+    size_t update();
+    // Rebuilds every slot one at a time with scalar sin and cos, regardless of
+    // dirty flags: the per-object path update() replaces, kept for comparison.
+    size_t rebuildAll();
+    size_t getCount() const;
+    size_t getDirtyCount() const;
+    // Changes whenever update() or rebuildAll() rebuilt any matrix.
+    uint64_t getVersion() const;
+    // Slots the last update() rebuilt, so copies of the matrices can follow
+    // one version to the next; empty after rebuildAll(), which rebuilt all.
+    const std::vector<uint32_t>& getUpdatedIndices() const;
+
+    // Rotation is Tait-Bryan YXZ in radians, as in lve's TransformComponent.
+    static glm::mat4 composeMatrix(const glm::vec3& translation, const glm::vec3& rotation, const glm::vec3& scale);
+    static glm::mat3x4 composeNormalMatrix(const glm::vec3& rotation, const glm::vec3& scale);
+
+public:
+    // Dirty slots per parallelFor chunk; fewer are rebuilt on the calling thread.
+    static constexpr size_t PARALLEL_GRAIN_SIZE{16384};
+    static constexpr uint32_t INVALID_INDEX{~0U};
+
+private:
+    OdysseyTransformStore() = default;
+    ~OdysseyTransformStore() = default;
+
+private:
+    void applyParentFrame(uint32_t index);
+    void rebuildRange(const uint32_t* indices, size_t count);
+
+private:
+    std::vector<float> m_translationX{};
+    std::vector<float> m_translationY{};
+    std::vector<float> m_translationZ{};
+    std::vector<float> m_rotationX{};
+    std::vector<float> m_rotationY{};
+    std::vector<float> m_rotationZ{};
+    std::vector<float> m_scaleX{};
+    std::vector<float> m_scaleY{};
+    std::vector<float> m_scaleZ{};
+    std::vector<glm::mat4> m_matrices{};
+    std::vector<glm::mat3x4> m_normalMatrices{};
+    std::vector<uint32_t> m_parentFrames{};
+    std::vector<glm::mat4> m_frames{};
+    // Inverse transpose of each frame's upper 3x3, for normal matrices.
+    std::vector<glm::mat3> m_frameNormals{};
+    // A flag per slot keeps each dirty slot in m_dirtyIndices once.
+    std::vector<uint8_t> m_dirty{};
+    std::vector<uint32_t> m_dirtyIndices{};
+    std::vector<uint32_t> m_updatedIndices{};
+    std::vector<uint32_t> m_freeIndices{};
+    uint64_t m_version{0};
+};
+
+}  // namespace odyssey
\ No newline at end of file
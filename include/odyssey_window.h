@@ -7,6 +7,7 @@
  */
 
 #include <QMouseEvent>
+#include <QResizeEvent>
 #include <QWindow>
 #include <functional>
 
@@ -33,17 +34,20 @@ public:
 
 public:
     void setMouseCallback(const std::function<void(const OdysseyMouseEvent&)>& callback);
+    void setResizeCallback(const std::function<void(vk::Extent2D)>& callback);
 
 private:
     virtual void mouseDoubleClickEvent(QMouseEvent* event) override;
     virtual void mousePressEvent(QMouseEvent* event) override;
     virtual void mouseMoveEvent(QMouseEvent* event) override;
+    virtual void resizeEvent(QResizeEvent* event) override;
 
 private:
     static void screenToWorld(int screenX, int screenY, int width, int height, float& worldX, float& worldY);
 
 private:
     std::function<void(const OdysseyMouseEvent&)> mouseCallback{};
+    std::function<void(vk::Extent2D)> resizeCallback{};
 };
 
 }  // namespace odyssey
\ No newline at end of file
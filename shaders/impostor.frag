@@ -0,0 +1,97 @@
+#version 450
+
+layout(location = 0) in vec2 frag_uv;
+layout(location = 1) in vec3 frag_position;
+layout(location = 2) flat in vec3 frag_toCamera;
+layout(location = 3) flat in float frag_radius;
+layout(location = 4) flat in float frag_fade;
+layout(location = 5) flat in uint frag_transform;
+
+layout(location = 0) out vec4 outColor;
+
+layout(set = 0, binding = 0) uniform Global {
+    mat4 view;
+    mat4 projection;
+    mat4 projectionView;
+    vec4 cameraPosition;
+} globals;
+
+layout(std430, set = 0, binding = 2) readonly buffer NormalTransforms {
+    mat3x4 normals[];
+};
+
+layout(set = 1, binding = 0) uniform sampler2D colorAtlas;
+layout(set = 1, binding = 1) uniform sampler2D normalDepthAtlas;
+
+layout(push_constant) uniform Push {
+    vec4 sphere;
+    vec4 options;
+} push;
+
+// Must match PipelineVariant::specialize.
+layout(constant_id = 0) const uint LIGHTING_MODEL = 1;
+layout(constant_id = 1) const uint DEBUG_VIEW = 0;
+layout(constant_id = 2) const bool RUNTIME_BRANCHING = false;
+layout(constant_id = 3) const float LIGHT_X = 1.0;
+layout(constant_id = 4) const float LIGHT_Y = -3.0;
+layout(constant_id = 5) const float LIGHT_Z = -1.0;
+
+const uint LIGHTING_UNLIT = 0;
+const uint LIGHTING_LAMBERT = 1;
+const uint LIGHTING_HALF_LAMBERT = 2;
+
+const uint DEBUG_VIEW_NONE = 0;
+const uint DEBUG_VIEW_NORMAL = 1;
+const uint DEBUG_VIEW_UV = 2;
+
+// Must match shader.frag.
+const float BAYER[16] = float[](
+    0.5 / 16.0, 8.5 / 16.0, 2.5 / 16.0, 10.5 / 16.0,
+    12.5 / 16.0, 4.5 / 16.0, 14.5 / 16.0, 6.5 / 16.0,
+    3.5 / 16.0, 11.5 / 16.0, 1.5 / 16.0, 9.5 / 16.0,
+    15.5 / 16.0, 7.5 / 16.0, 13.5 / 16.0, 5.5 / 16.0);
+
+void main() {
+    // The complement of the mesh's dither, for a fade of 1 - the mesh's.
+    uvec2 pixel = uvec2(gl_FragCoord.xy) % 4;
+    if (BAYER[pixel.y * 4 + pixel.x] < 1.0 - frag_fade) {
+        discard;
+    }
+    vec4 color = texture(colorAtlas, frag_uv);
+    if (color.a < 0.5) {
+        discard;
+    }
+    vec4 normalDepth = texture(normalDepthAtlas, frag_uv);
+
+    // Baked depth runs across the bounding sphere, 0.5 at its center, which
+    // the quad passes through.
+    vec3 position = frag_position + frag_toCamera * (1.0 - 2.0 * normalDepth.a) * frag_radius;
+    vec4 clip = globals.projectionView * vec4(position, 1.0);
+    gl_FragDepth = clip.z / clip.w;
+
+    vec3 normalWorldSpace = normalize(mat3(normals[frag_transform]) * (normalDepth.xyz * 2.0 - 1.0));
+    uint lightingModel = LIGHTING_MODEL;
+    uint debugView = DEBUG_VIEW;
+    if (RUNTIME_BRANCHING) {
+        lightingModel = uint(push.options.x);
+        debugView = uint(push.options.y);
+    }
+    if (debugView == DEBUG_VIEW_NORMAL) {
+        outColor = vec4(normalWorldSpace * 0.5 + 0.5, 1.0);
+        return;
+    }
+    if (debugView == DEBUG_VIEW_UV) {
+        outColor = vec4(frag_uv, 0.0, 1.0);
+        return;
+    }
+
+    vec3 directionToLight = normalize(vec3(LIGHT_X, LIGHT_Y, LIGHT_Z));
+    float lightIntensity = 1.0;
+    if (lightingModel == LIGHTING_LAMBERT) {
+        lightIntensity = max(dot(normalWorldSpace, directionToLight), 0);
+    } else if (lightingModel == LIGHTING_HALF_LAMBERT) {
+        lightIntensity = dot(normalWorldSpace, directionToLight) * 0.5 + 0.5;
+        lightIntensity *= lightIntensity;
+    }
+    outColor = vec4(lightIntensity * color.rgb, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#version 450
+
+layout(location = 4) in uint instanceTransform;
+layout(location = 5) in float instanceFade;
+
+layout(location = 0) out vec2 frag_uv;
+layout(location = 1) out vec3 frag_position;
+layout(location = 2) flat out vec3 frag_toCamera;
+layout(location = 3) flat out float frag_radius;
+layout(location = 4) flat out float frag_fade;
+layout(location = 5) flat out uint frag_transform;
+
+// Must match GlobalData.
+layout(set = 0, binding = 0) uniform Global {
+    mat4 view;
+    mat4 projection;
+    mat4 projectionView;
+    vec4 cameraPosition;
+} globals;
+
+layout(std430, set = 0, binding = 1) readonly buffer Transforms {
+    mat4 models[];
+};
+
+layout(push_constant) uniform Push {
+    vec4 sphere; // object-space center and radius the atlas was baked around
+    vec4 options; // (lighting model, debug view) when RUNTIME_BRANCHING
+} push;
+
+// Must match OdysseyImpostors::FRAMES_PER_AXIS.
+const float FRAMES_PER_AXIS = 8.0;
+
+// Two triangles of a quad, corners in [-1, 1].
+const vec2 CORNERS[6] = vec2[](
+    vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(1.0, 1.0),
+    vec2(-1.0, -1.0), vec2(1.0, 1.0), vec2(-1.0, 1.0));
+
+// Must match OdysseyImpostors::octahedralEncode and octahedralDecode.
+vec2 octahedralEncode(vec3 n) {
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    vec2 p = n.xy;
+    if (n.z < 0.0) {
+        p = (1.0 - abs(p.yx)) * vec2(p.x >= 0.0 ? 1.0 : -1.0, p.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return p * 0.5 + 0.5;
+}
+
+vec3 octahedralDecode(vec2 uv) {
+    vec2 p = uv * 2.0 - 1.0;
+    vec3 n = vec3(p, 1.0 - abs(p.x) - abs(p.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+void main() {
+    mat4 model = models[instanceTransform];
+    vec3 center = (model * vec4(push.sphere.xyz, 1.0)).xyz;
+    float radius = push.sphere.w * max(length(model[0].xyz), max(length(model[1].xyz), length(model[2].xyz)));
+    vec3 toCamera = normalize(globals.cameraPosition.xyz - center);
+
+    // The frame baked from nearest the direction the camera sees the object
+    // from, in object space.
+    mat3 basis = mat3(model);
+    vec3 objectDirection = normalize(inverse(basis) * toCamera);
+    vec2 cell = min(floor(octahedralEncode(objectDirection) * FRAMES_PER_AXIS), vec2(FRAMES_PER_AXIS - 1.0));
+    vec3 frameDirection = octahedralDecode((cell + 0.5) / FRAMES_PER_AXIS);
+    vec3 frameUp = abs(frameDirection.y) > 0.99 ? vec3(0.0, 0.0, 1.0) : vec3(0.0, 1.0, 0.0);
+
+    // Facing the camera, turned so the frame's up stays up; falls back to
+    // the frame's own right when the camera looks along that up.
+    vec3 up = normalize(basis * frameUp);
+    vec3 right = cross(-toCamera, up);
+    if (dot(right, right) < 1e-6) {
+        right = basis * cross(-frameDirection, frameUp);
+    }
+    right = normalize(right);
+    up = cross(right, -toCamera);
+
+    vec2 corner = CORNERS[gl_VertexIndex];
+    frag_position = center + (right * corner.x + up * corner.y) * radius;
+    frag_uv = (cell + vec2(0.5 + 0.5 * corner.x, 0.5 - 0.5 * corner.y)) / FRAMES_PER_AXIS;
+    frag_toCamera = toCamera;
+    frag_radius = radius;
+    frag_fade = instanceFade;
+    frag_transform = instanceTransform;
+    gl_Position = globals.projectionView * vec4(frag_position, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+#version 450
+
+layout(location = 0) in vec3 frag_color;
+layout(location = 1) in vec3 frag_normal;
+
+layout(location = 0) out vec4 outColor;
+layout(location = 1) out vec4 outNormalDepth;
+
+void main() {
+    // Alpha marks coverage; the atlas is cleared to transparent.
+    outColor = vec4(frag_color, 1.0);
+    outNormalDepth = vec4(normalize(frag_normal) * 0.5 + 0.5, gl_FragCoord.z);
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#version 450
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 color;
+layout(location = 2) in vec3 normal;
+layout(location = 3) in vec2 uv;
+
+layout(location = 0) out vec3 frag_color;
+layout(location = 1) out vec3 frag_normal;
+
+// Must match OdysseyImpostors::BakePushConstantData.
+layout(push_constant) uniform Push {
+    mat4 projectionView; // object space to one frame of the atlas
+} push;
+
+void main() {
+    gl_Position = push.projectionView * vec4(position, 1.0);
+    frag_color = color;
+    // Unlit and in object space; impostor.frag lights it with the instance's
+    // normal matrix.
+    frag_normal = normal;
+}
\ No newline at end of file
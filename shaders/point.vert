@@ -0,0 +1,26 @@
+#version 450
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec4 color;
+
+layout(location = 0) out vec3 frag_color;
+
+// Must match GlobalData.
+layout(set = 0, binding = 0) uniform Global {
+    mat4 view;
+    mat4 projection;
+    mat4 projectionView;
+    vec4 cameraPosition;
+} globals;
+
+layout(push_constant) uniform Push {
+    vec4 placement; // cloud to world: position * w + xyz
+} push;
+
+void main() {
+    vec3 world = position * push.placement.w + push.placement.xyz;
+    gl_Position = globals.projectionView * vec4(world, 1.0);
+    // The device does not enable largePoints.
+    gl_PointSize = 1.0;
+    frag_color = color.rgb;
+}
\ No newline at end of file
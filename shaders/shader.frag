@@ -1,13 +1,88 @@
 #version 450
 
 layout(location = 0) in vec3 frag_color;
+layout(location = 1) flat in float frag_fade;
+layout(location = 2) in vec3 frag_position;
+layout(location = 3) in vec3 frag_normal;
+layout(location = 4) in vec3 frag_albedo;
 layout(location = 0) out vec4 outColor;
 
+// Must match GlobalData.
+layout(set = 0, binding = 0) uniform Global {
+    mat4 view;
+    mat4 projection;
+    mat4 projectionView;
+    vec4 cameraPosition;
+    vec4 clusterScale; // (clusters per pixel in x and y, slice scale, slice bias)
+    uvec4 lightInfo; // (light count, first light, first cluster word, unused)
+} globals;
+
+// Must match OdysseyPointLight.
+struct PointLight {
+    vec4 positionRadius;
+    vec4 color;
+};
+
+layout(std430, set = 0, binding = 3) readonly buffer Lights {
+    PointLight lights[];
+};
+
+// Written by light_cull.comp: per cluster, a count and the light indices.
+layout(std430, set = 0, binding = 4) readonly buffer Clusters {
+    uint clusters[];
+};
+
 layout(push_constant) uniform Push {
-    mat4 transform; // projection * view * model
-    mat4 normal;
+    vec4 options;
 } push;
 
+// See PipelineVariant::impostorFade.
+layout(constant_id = 6) const bool IMPOSTOR_FADE = false;
+
+// Must match OdysseyClusteredLights.
+const uint CLUSTERS_X = 16;
+const uint CLUSTERS_Y = 9;
+const uint CLUSTERS_Z = 24;
+const uint CLUSTER_STRIDE = 256;
+
+// Ordered 4x4 dither thresholds in (0, 1).
+const float BAYER[16] = float[](
+    0.5 / 16.0, 8.5 / 16.0, 2.5 / 16.0, 10.5 / 16.0,
+    12.5 / 16.0, 4.5 / 16.0, 14.5 / 16.0, 6.5 / 16.0,
+    3.5 / 16.0, 11.5 / 16.0, 1.5 / 16.0, 9.5 / 16.0,
+    15.5 / 16.0, 7.5 / 16.0, 13.5 / 16.0, 5.5 / 16.0);
+
+// Lambert with a smooth falloff to zero at each light's radius, over the
+// lights binned into this fragment's cluster only.
+vec3 pointLighting() {
+    if (globals.lightInfo.x == 0 || frag_albedo == vec3(0.0)) {
+        return vec3(0.0);
+    }
+    float viewDepth = (globals.view * vec4(frag_position, 1.0)).z;
+    uvec2 tile = min(uvec2(gl_FragCoord.xy * globals.clusterScale.xy), uvec2(CLUSTERS_X - 1, CLUSTERS_Y - 1));
+    uint slice = uint(clamp(log(max(viewDepth, 1e-4)) * globals.clusterScale.z + globals.clusterScale.w, 0.0, float(CLUSTERS_Z - 1)));
+    uint base = globals.lightInfo.z + ((slice * CLUSTERS_Y + tile.y) * CLUSTERS_X + tile.x) * CLUSTER_STRIDE;
+    uint count = clusters[base];
+    vec3 normal = normalize(frag_normal);
+    vec3 radiance = vec3(0.0);
+    for (uint i = 0; i < count; ++i) {
+        PointLight light = lights[globals.lightInfo.y + clusters[base + 1 + i]];
+        vec3 toLight = light.positionRadius.xyz - frag_position;
+        float distance = length(toLight);
+        float falloff = clamp(1.0 - distance / light.positionRadius.w, 0.0, 1.0);
+        radiance += light.color.rgb * (falloff * falloff * max(dot(normal, toLight / max(distance, 1e-4)), 0.0));
+    }
+    return radiance * frag_albedo;
+}
+
 void main() {
-    outColor = vec4(frag_color, 1.0);
+    // Fading out into an impostor: keeps the pixels impostor.frag drops, so
+    // the two cover each pixel exactly once without blending.
+    if (IMPOSTOR_FADE) {
+        uvec2 pixel = uvec2(gl_FragCoord.xy) % 4;
+        if (BAYER[pixel.y * 4 + pixel.x] >= frag_fade) {
+            discard;
+        }
+    }
+    outColor = vec4(frag_color + pointLighting(), 1.0);
 }
\ No newline at end of file
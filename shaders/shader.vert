@@ -4,19 +4,91 @@ layout(location = 0) in vec3 position;
 layout(location = 1) in vec3 color;
 layout(location = 2) in vec3 normal;
 layout(location = 3) in vec2 uv;
+layout(location = 4) in uint instanceTransform;
+layout(location = 5) in float instanceFade;
 
 layout(location = 0) out vec3 frag_color;
+layout(location = 1) flat out float frag_fade;
+layout(location = 2) out vec3 frag_position;
+layout(location = 3) out vec3 frag_normal;
+// What point lights shade; black where they do not apply.
+layout(location = 4) out vec3 frag_albedo;
+
+// Must match GlobalData. One slot per frame in flight, picked by the dynamic
+// offset, so cached command buffers stay valid as the camera moves.
+layout(set = 0, binding = 0) uniform Global {
+    mat4 view;
+    mat4 projection;
+    mat4 projectionView;
+    vec4 cameraPosition;
+    vec4 clusterScale;
+    uvec4 lightInfo;
+} globals;
+
+// Indexed by transform slot, mirroring OdysseyTransformStore.
+layout(std430, set = 0, binding = 1) readonly buffer Transforms {
+    mat4 models[];
+};
+
+layout(std430, set = 0, binding = 2) readonly buffer NormalTransforms {
+    mat3x4 normals[];
+};
 
 layout(push_constant) uniform Push {
-    mat4 transform; // projection * view * model
-    mat4 normal;
+    vec4 options; // (lighting model, debug view) when RUNTIME_BRANCHING
 } push;
 
-const vec3 DIRECTION_TO_LIGHT = normalize(vec3(1.0, -3.0, -1.0));
+// Must match PipelineVariant::specialize.
+layout(constant_id = 0) const uint LIGHTING_MODEL = 1;
+layout(constant_id = 1) const uint DEBUG_VIEW = 0;
+layout(constant_id = 2) const bool RUNTIME_BRANCHING = false;
+layout(constant_id = 3) const float LIGHT_X = 1.0;
+layout(constant_id = 4) const float LIGHT_Y = -3.0;
+layout(constant_id = 5) const float LIGHT_Z = -1.0;
+
+const uint LIGHTING_UNLIT = 0;
+const uint LIGHTING_LAMBERT = 1;
+const uint LIGHTING_HALF_LAMBERT = 2;
+
+const uint DEBUG_VIEW_NONE = 0;
+const uint DEBUG_VIEW_NORMAL = 1;
+const uint DEBUG_VIEW_UV = 2;
 
 void main() {
-    gl_Position = push.transform * vec4(position, 1.0);
-    vec3 normalWorldSpace = normalize(mat3(push.normal) * normal);
-    float lightIntensity = max(dot(normalWorldSpace, DIRECTION_TO_LIGHT), 0);
+    vec4 positionWorldSpace = models[instanceTransform] * vec4(position, 1.0);
+    gl_Position = globals.projectionView * positionWorldSpace;
+    vec3 normalWorldSpace = normalize(mat3(normals[instanceTransform]) * normal);
+    frag_fade = instanceFade;
+    frag_position = positionWorldSpace.xyz;
+    frag_normal = normalWorldSpace;
+    frag_albedo = vec3(0.0);
+
+    uint lightingModel = LIGHTING_MODEL;
+    uint debugView = DEBUG_VIEW;
+    if (RUNTIME_BRANCHING) {
+        lightingModel = uint(push.options.x);
+        debugView = uint(push.options.y);
+    }
+
+    if (debugView == DEBUG_VIEW_NORMAL) {
+        frag_color = normalWorldSpace * 0.5 + 0.5;
+        return;
+    }
+    if (debugView == DEBUG_VIEW_UV) {
+        frag_color = vec3(uv, 0.0);
+        return;
+    }
+
+    vec3 directionToLight = normalize(vec3(LIGHT_X, LIGHT_Y, LIGHT_Z));
+    float lightIntensity = 1.0;
+    if (lightingModel == LIGHTING_LAMBERT) {
+        lightIntensity = max(dot(normalWorldSpace, directionToLight), 0);
+    } else if (lightingModel == LIGHTING_HALF_LAMBERT) {
+        lightIntensity = dot(normalWorldSpace, directionToLight) * 0.5 + 0.5;
+        lightIntensity *= lightIntensity;
+    }
     frag_color = lightIntensity * color;
+    if (lightingModel != LIGHTING_UNLIT) {
+        frag_albedo = color;
+    }
 }
\ No newline at end of file
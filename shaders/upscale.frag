@@ -0,0 +1,16 @@
+#version 450
+
+layout(location = 0) in vec2 frag_uv;
+layout(location = 0) out vec4 outColor;
+
+layout(set = 0, binding = 0) uniform sampler2D scene;
+
+// Must match OdysseyDynamicResolution::PushConstantData.
+layout(push_constant) uniform Push {
+    vec2 uvScale; // the rendered corner of the target
+    vec2 uvMax;   // half a texel inside it, so filtering never reads past it
+} push;
+
+void main() {
+    outColor = vec4(texture(scene, min(frag_uv * push.uvScale, push.uvMax)).rgb, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#version 450
+
+layout(location = 0) out vec2 frag_uv;
+
+void main() {
+    // (0, 0), (2, 0) and (0, 2): one triangle whose [0, 1] corner covers the
+    // screen, with uv 0 at the top-left like the image it samples.
+    frag_uv = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+    gl_Position = vec4(frag_uv * 2.0 - 1.0, 0.0, 1.0);
+}
\ No newline at end of file
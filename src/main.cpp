@@ -8,10 +8,25 @@
 #include <QWidget>
 
 #include "odyssey.h"
+#include "odyssey_mesh_stream.h"
+#include "odyssey_options.h"
+#include "odyssey_point_cloud_converter.h"
+#include "odyssey_profiler.h"
 #include "odyssey_window.h"
 
 int main(int argc, char* argv[]) {
+    odyssey::OdysseyProfiler::instance();
     QApplication app(argc, argv);
-    odyssey::Odyssey odysseyApp;
+    auto options = odyssey::OdysseyOptions::parse(app.arguments());
+    if (!options.convertPointsPath.empty()) {
+        odyssey::OdysseyPointCloudConverter converter{};
+        converter.convert(options.convertPointsPath, options.convertPointsPath + ".octree");
+        return 0;
+    }
+    if (!options.convertMeshPath.empty()) {
+        odyssey::OdysseyMeshStream::convert(options.convertMeshPath, options.convertMeshPath + ".mstream");
+        return 0;
+    }
+    odyssey::Odyssey odysseyApp(options);
     return app.exec();
 }
\ No newline at end of file
@@ -10,40 +10,93 @@
 #include <QIcon>
 #include <QKeyEvent>
 #include <QPaintEvent>
-#include <QResizeEvent>
 #include <QString>
+#include <QTimer>
 #include <QUrl>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
 #include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <utility>
 
 #include "odyssey_camera.h"
 #include "odyssey_device.h"
+#include "odyssey_profiler.h"
 #include "odyssey_render.h"
 #include "odyssey_render_system.h"
+#include "odyssey_swap_chain.h"
+#include "odyssey_thread_pool.h"
 #include "odyssey_window.h"
 #include "ui_odyssey.h"
 
 namespace odyssey {
 
-Odyssey::Odyssey() : m_window(new OdysseyWindow()), ui(new Ui::Odyssey) {
+namespace {
+
+// Between the camera and the test grid.
+const glm::vec3 ASSEMBLY_POSITION{0.0F, 0.0F, 4.0F};
+
+// Light counts benchmarked in turn by --light-sweep.
+constexpr std::array<uint32_t, 4> LIGHT_SWEEP{10, 100, 1000, 10000};
+constexpr float LIGHT_RADIUS{0.6F};
+constexpr float LIGHT_ORBIT{0.25F};
+
+// The UI heartbeat, only run while measuring: often enough to time a 60 Hz
+// event loop.
+constexpr std::chrono::milliseconds HEARTBEAT_MEASURING{16};
+// Snapshots published faster than this are shown once, at its end.
+constexpr std::chrono::milliseconds STATUS_INTERVAL{250};
+
+}  // namespace
+
+Odyssey::Odyssey(const OdysseyOptions& options) : m_window(new OdysseyWindow()), ui(new Ui::Odyssey), m_options(options) {
+    // Assimp builds its importer and post-processing registries on construction;
+    // do that off the UI thread and hand the importer over on the first import.
+    m_importerReady = std::async(std::launch::async, []() {
+        OdysseyProfiler::Scope scope("assimp");
+        return std::make_unique<Assimp::Importer>();
+    });
+    m_picker = std::make_unique<OdysseyPicker>();
     setupUI();
     setupEngine();
+    setupTestScene();
+    setupLights(m_options.lightSweep ? LIGHT_SWEEP.front() : m_options.lightCount);
+    setupScheduler();
+    setupHeartbeat();
     setupEvent();
     setupSignalsSlots();
     show();
+    m_renderThread->start();
 }
 
 Odyssey::~Odyssey() {
+    // The window outlives this body and may still report events.
+    m_window->setMouseCallback({});
+    m_window->setResizeCallback({});
+    m_renderThread->stop();
+    // The render thread's last frames may still be reading the buffers and
+    // images released below.
+    m_device->device().waitIdle();
+    delete m_scheduler;
+    // Owns transient images and memory.
+    m_renderGraph.reset();
+    // Holds models, which must go while the device is alive.
+    m_picker.reset();
+    m_staticBatcher.reset();
+    m_pointCloud.reset();
+    m_meshStream.reset();
     for (auto& object : m_objects) {
         object.model.reset();
     }
 }
 
 void Odyssey::paintEvent([[maybe_unused]] QPaintEvent* event) {
-    draw();
-}
-
-void Odyssey::resizeEvent([[maybe_unused]] QResizeEvent* event) {
-    draw();
+    m_renderThread->submit({.type = OdysseyRenderCommandType::EXPOSE});
 }
 
 void Odyssey::keyPressEvent(QKeyEvent* event) {
@@ -73,39 +126,296 @@ void Odyssey::keyPressEvent(QKeyEvent* event) {
         case Qt::Key_Right:
             type = OdysseyKeyboardEventType::RIGHT;
             break;
+        default:
+            return;
+    }
+    m_renderThread->submit({.type = OdysseyRenderCommandType::KEY, .time = OdysseyProfiler::instance().now(), .key = type});
+}
+
+void Odyssey::handleCommand(OdysseyRenderCommand& command) {
+    switch (command.type) {
+        case OdysseyRenderCommandType::RESIZE:
+            // The scheduler coalesces dirty marks, so a drag that produces
+            // dozens of resize events still rebuilds the swap chain once per
+            // presented frame.
+            m_render->setWindowExtent(command.extent);
+            m_scheduler->markDirty(DIRTY_WINDOW);
+            break;
+        case OdysseyRenderCommandType::EXPOSE:
+            m_scheduler->markDirty(DIRTY_WINDOW);
+            break;
+        case OdysseyRenderCommandType::KEY:
+            // Applied at the start of the next frame so input-to-submit covers
+            // the time the event waited in the queue and for the frame as well
+            // as the recording itself.
+            m_pendingInput.push_back({command.key, command.time});
+            m_scheduler->markDirty(DIRTY_CAMERA);
+            break;
+        case OdysseyRenderCommandType::PICK:
+            pickObject(command.position.x, command.position.y);
+            break;
+        case OdysseyRenderCommandType::LOAD_OBJECT:
+            loadObject(command.path);
+            break;
+        case OdysseyRenderCommandType::REPORT:
+            std::cout << m_scheduler->report() << OdysseyProfiler::instance().histogramReport() << std::flush;
+            break;
+    }
+}
+
+bool Odyssey::draw() {
+    auto commandBuffer = m_render->beginFrame();
+    if (!commandBuffer) {
+        // The swap chain was out of date; a minimized window waits for the
+        // resize that restores it instead.
+        auto extent = m_render->getWindowExtent();
+        if (extent.width > 0 && extent.height > 0) {
+            m_scheduler->markDirty(DIRTY_WINDOW);
+        }
+        return false;
+    }
+    sampleInput();
+    animateTestScene();
+    animateLights();
+    updateSceneGraph();
+    if (m_render->getRenderPassVersion() != m_renderPassVersion) {
+        m_renderPassVersion = m_render->getRenderPassVersion();
+        auto variant = m_renderSystem->getVariant();
+        delete m_renderSystem;
+        createRenderSystem(variant);
+    }
+    auto cpuStart = std::chrono::steady_clock::now();
+    auto aspect = m_render->getAspectRatio();
+    m_camera->setPerspectiveProjection(glm::radians(50.0F), aspect, 0.1F, 10.0F);
+    m_renderGraph->bindImage(m_backbuffer, m_render->getSwapChainImage(), m_render->getSwapChainImageView());
+    m_renderGraph->bindImage(m_depth, m_render->getDepthImage(), m_render->getDepthImageView());
+    if (m_render->hasDynamicResolution()) {
+        m_renderGraph->bindImage(m_sceneColor, m_render->getSceneColorImage(), m_render->getSceneColorImageView());
+    }
+    m_renderGraph->execute(commandBuffer, m_render->getFrameIndex());
+    m_render->endFrame();
+    auto now = std::chrono::steady_clock::now();
+    m_cpuFrameTime = std::chrono::duration<double, std::milli>(now - cpuStart).count();
+    if (m_lastDrawnFrame != std::chrono::steady_clock::time_point{}) {
+        OdysseyProfiler::instance().addSample("render frame (ms)", std::chrono::duration<double, std::milli>(now - m_lastDrawnFrame).count());
     }
+    m_lastDrawnFrame = now;
+    publishSnapshot();
+    recordFirstFrame();
+    recordBenchmarkFrame();
+    return true;
 }
 
-void Odyssey::draw() {
-    if (auto commandBuffer = m_render->beginFrame()) {
-        auto aspect = m_render->getAspectRatio();
-        m_camera->setPerspectiveProjection(glm::radians(50.0F), aspect, 0.1F, 10.0F);
-        m_render->beginSwapChainRenderPass(commandBuffer);
-        m_renderSystem->renderObjects(commandBuffer, m_objects, m_camera);
-        m_render->endSwapChainRenderPass(commandBuffer);
-        m_render->endFrame();
-        update();
+void Odyssey::publishSnapshot() {
+    OdysseySceneSnapshot snapshot{};
+    snapshot.frame = m_render->getFrameCount();
+    snapshot.cameraPosition = glm::vec3(glm::inverse(m_camera->getView())[3]);
+    snapshot.objectCount = m_objects.size();
+    snapshot.lightCount = m_lights.size();
+    snapshot.renderScale = m_render->getRenderScale();
+    snapshot.cpuFrameTime = m_cpuFrameTime;
+    snapshot.gpuFrameTime = m_render->getLastGpuFrameTime();
+    snapshot.pick = m_lastPick;
+    m_renderThread->publish(snapshot);
+    // At most one status update queued at a time; it shows the latest
+    // snapshot, whichever frame queued it.
+    if (!m_statusQueued.exchange(true, std::memory_order_acq_rel)) {
+        QMetaObject::invokeMethod(this, [this]() { showStatus(); }, Qt::QueuedConnection);
+    }
+}
+
+void Odyssey::sampleInput() {
+    if (m_pendingInput.empty()) {
+        return;
+    }
+    m_render->markInputSampled(m_pendingInput.front().time);
+    for (const auto& input : m_pendingInput) {
+        keyboardCallback(input.type);
+    }
+    m_pendingInput.clear();
+}
+
+void Odyssey::recordFirstFrame() {
+    if (m_firstFramePresented) {
+        return;
+    }
+    m_firstFramePresented = true;
+    auto& profiler = OdysseyProfiler::instance();
+    profiler.recordPhase("time to first frame", 0.0, profiler.now());
+    if (m_options.startupReport) {
+        std::cout << profiler.report() << std::flush;
+    }
+}
+
+void Odyssey::recordBenchmarkFrame() {
+    if (m_options.benchmarkFrames == 0) {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (m_lastFrameTime != std::chrono::steady_clock::time_point{}) {
+        m_benchmarkFrameTimes.push_back(std::chrono::duration<double, std::milli>(now - m_lastFrameTime).count());
+        m_benchmarkCpuTimes.push_back(m_cpuFrameTime);
+        m_benchmarkGpuTimes.push_back(m_render->getLastGpuFrameTime());
+        m_benchmarkScales.push_back(m_render->getRenderScale());
+        m_benchmarkReplayedFrames += OdysseyProfiler::instance().getCounter("commands replayed") > 0.0 ? 1 : 0;
+    }
+    m_lastFrameTime = now;
+    if (m_benchmarkFrameTimes.size() < m_options.benchmarkFrames) {
+        return;
+    }
+    if (m_options.lightSweep) {
+        auto average = [](const std::vector<double>& times) {
+            return std::accumulate(times.begin(), times.end(), 0.0) / static_cast<double>(times.size());
+        };
+        std::cout << "Lights " << m_lights.size() << ": frame avg " << average(m_benchmarkFrameTimes) << " ms, "
+                  << "GPU avg " << average(m_benchmarkGpuTimes) << " ms" << std::endl;
+        if (++m_lightSweepStep < LIGHT_SWEEP.size()) {
+            setupLights(LIGHT_SWEEP[m_lightSweepStep]);
+            m_benchmarkFrameTimes.clear();
+            m_benchmarkCpuTimes.clear();
+            m_benchmarkGpuTimes.clear();
+            m_benchmarkScales.clear();
+            m_benchmarkReplayedFrames = 0;
+            return;
+        }
+    }
+    auto [minTime, maxTime] = std::minmax_element(m_benchmarkFrameTimes.begin(), m_benchmarkFrameTimes.end());
+    auto average = std::accumulate(m_benchmarkFrameTimes.begin(), m_benchmarkFrameTimes.end(), 0.0) / static_cast<double>(m_benchmarkFrameTimes.size());
+    std::cout << "Benchmark (" << (m_options.variant.runtimeBranching ? "uber-shader" : "specialized") << "): "
+              << m_benchmarkFrameTimes.size() << " frames, "
+              << "avg " << average << " ms, "
+              << "min " << *minTime << " ms, "
+              << "max " << *maxTime << " ms" << std::endl;
+    auto cpuAverage = std::accumulate(m_benchmarkCpuTimes.begin(), m_benchmarkCpuTimes.end(), 0.0) / static_cast<double>(m_benchmarkCpuTimes.size());
+    auto& profiler = OdysseyProfiler::instance();
+    std::cout << "CPU record and submit avg " << cpuAverage << " ms, "
+              << profiler.getCounter("instances") << " objects in "
+              << profiler.getCounter("draw calls") << " draw calls" << std::endl;
+    if (m_renderSystem->isCommandCaching()) {
+        std::cout << "Command cache replayed " << m_benchmarkReplayedFrames << " of " << m_benchmarkFrameTimes.size() << " frames" << std::endl;
+    }
+    std::cout << "Scene graph " << profiler.getCounter("scene graph (ms)") << " ms, "
+              << profiler.getCounter("scene graph nodes changed") << " of "
+              << m_sceneGraph.getNodeCount() << " nodes changed" << std::endl;
+    if (m_staticBatcher->getMergedCount() > 0) {
+        std::cout << "Static batching merged " << m_staticBatcher->getMergedCount() << " objects into "
+                  << m_staticBatcher->getCellCount() << " cells" << std::endl;
+    }
+    if (const auto* impostors = m_renderSystem->getImpostors()) {
+        std::cout << "Impostors " << profiler.getCounter("impostors") << " drawn, "
+                  << impostors->getAtlasCount() << " atlases, bakes recorded in "
+                  << impostors->getBakeTime() << " ms" << std::endl;
+    }
+    if (m_pointCloud) {
+        std::cout << "Point cloud " << profiler.getCounter("point cloud points drawn") << " of "
+                  << m_pointCloud->getPointCount() << " points in "
+                  << profiler.getCounter("point cloud nodes drawn") << " nodes, "
+                  << profiler.getCounter("point cloud resident points") << " resident, "
+                  << profiler.getCounter("point cloud loads pending") << " loads pending, "
+                  << profiler.getCounter("point cloud MB read") << " MB read, "
+                  << "first points after " << profiler.getCounter("point cloud first points (ms)") << " ms" << std::endl;
     }
+    if (m_meshStream) {
+        std::cout << "Mesh stream " << m_meshStream->getResidentCount() << " of "
+                  << m_meshStream->getChunkCount() << " chunks resident ("
+                  << profiler.getCounter("mesh stream resident MB") << " MB), "
+                  << profiler.getCounter("mesh stream chunks drawn") << " drawn, "
+                  << m_meshStream->getEvictionCount() << " evictions, "
+                  << profiler.getCounter("mesh stream MB read") << " MB read at "
+                  << profiler.getCounter("mesh stream read MB/s") << " MB/s" << std::endl;
+    }
+    std::cout << "Transforms " << profiler.getCounter("transforms (ms)") << " ms, "
+              << profiler.getCounter("transforms rebuilt") << " rebuilt "
+              << (m_options.perObjectTransforms ? "one object at a time" : "in SIMD batches, dirty only") << std::endl;
+    if (!m_renderSystem->isGpuDriven()) {
+        std::cout << "Culling " << profiler.getCounter("culling (ms)") << " ms, "
+                  << profiler.getCounter("visible objects") << " visible, "
+                  << profiler.getCounter("culled objects") << " culled" << std::endl;
+        std::cout << "Draw recording " << profiler.getCounter("draw recording (ms)") << " ms, "
+                  << (m_renderSystem->isParallelRecording() ? "secondary buffers on " + std::to_string(OdysseyThreadPool::instance().getThreadCount()) + " threads" : std::string("inline")) << std::endl;
+        std::cout << "Draw sort " << profiler.getCounter("draw sort (ms)") << " ms, "
+                  << profiler.getCounter("binds") << " binds after sorting, "
+                  << profiler.getCounter("binds unsorted") << " before ("
+                  << profiler.getCounter("model changes unsorted") << " model changes in submission order)" << std::endl;
+    }
+    if (m_renderSystem->isOcclusionCulling()) {
+        std::cout << "Occlusion " << profiler.getCounter("occlusion early draws") << " early and "
+                  << profiler.getCounter("occlusion late draws") << " late draws, "
+                  << profiler.getCounter("occluded objects") << " occluded ("
+                  << profiler.getCounter("occluded fraction") * 100.0 << "% of those in the frustum)" << std::endl;
+    }
+    std::cout << "GPU frame avg " << m_render->getAverageGpuFrameTime() << " ms" << std::endl;
+    if (m_render->hasDynamicResolution()) {
+        auto [minScale, maxScale] = std::minmax_element(m_benchmarkScales.begin(), m_benchmarkScales.end());
+        std::cout << "Dynamic resolution scale " << m_render->getRenderScale() << ", "
+                  << "avg " << std::accumulate(m_benchmarkScales.begin(), m_benchmarkScales.end(), 0.0) / static_cast<double>(m_benchmarkScales.size()) << ", "
+                  << "min " << *minScale << ", max " << *maxScale << " for a "
+                  << m_options.resolution.targetFrameTime << " ms GPU target" << std::endl;
+    }
+    std::cout << m_render->getLatencyReport() << profiler.histogramReport() << std::flush;
+    m_options.benchmarkFrames = 0;
+    // Widgets belong to the UI thread.
+    QMetaObject::invokeMethod(this, [this]() { close(); }, Qt::QueuedConnection);
 }
 
 void Odyssey::importObject() {
+    // The dialog blocks only the UI thread; the render thread goes on drawing
+    // until the model is handed over.
     auto filePath = QFileDialog::getOpenFileName(this, "导入", "", "*.obj");
     if (!filePath.isEmpty())
-        loadObject(filePath.toStdString());
+        m_renderThread->submit({.type = OdysseyRenderCommandType::LOAD_OBJECT, .path = filePath.toStdString()});
 }
 
 void Odyssey::keyboardCallback([[maybe_unused]] const OdysseyKeyboardEventType& event) {
 }
 
 void Odyssey::loadObject(const std::string& filePath) {
-    std::shared_ptr<OdysseyModel> model = OdysseyModel::createModelFromFile(m_device, filePath);
-    auto object = OdysseyObject::createObject();
-    object.model = model;
-    object.transform.translation = {0.0F, 0.0F, 1.0F};
-    m_objects.push_back(std::move(object));
+    if (m_importerReady.valid()) {
+        m_importer = m_importerReady.get();
+    }
+    // Every node of the file becomes a scene graph node under one root, and
+    // each node with meshes an object in that node's frame. Nothing moves an
+    // imported file, so its objects are static.
+    auto nodes = OdysseyModel::createNodesFromFile(m_device, filePath, m_importer.get());
+    auto root = m_sceneGraph.addNode(OdysseySceneGraph::INVALID_NODE, filePath, glm::translate(glm::mat4(1.0F), glm::vec3(0.0F, 0.0F, 1.0F)));
+    std::vector<uint32_t> handles{};
+    handles.reserve(nodes.size());
+    std::vector<OdysseyObject> objects{};
+    for (auto& node : nodes) {
+        auto parent = node.parent == OdysseyModel::INVALID_NODE ? root : handles[node.parent];
+        handles.push_back(m_sceneGraph.addNode(parent, node.name, node.localMatrix));
+        if (node.model) {
+            auto object = OdysseyObject::createObject();
+            object.model = std::move(node.model);
+            m_sceneGraph.attach(handles.back(), object.transform);
+            objects.push_back(std::move(object));
+        }
+    }
+    addStaticObjects(std::move(objects));
+    m_scheduler->markDirty(DIRTY_SCENE);
+}
+
+void Odyssey::addStaticObjects(std::vector<OdysseyObject> objects) {
+    auto first = m_objects.size();
+    if (m_options.staticBatching) {
+        // Merging bakes the objects' current matrices into the vertices.
+        m_sceneGraph.update();
+        OdysseyTransformStore::instance().update();
+        objects = m_staticBatcher->merge(std::move(objects));
+    }
+    m_objects.reserve(m_objects.size() + objects.size());
+    for (auto& object : objects) {
+        m_objects.push_back(std::move(object));
+    }
+    // Picking BVHs build in the background from here on.
+    for (auto i = first; i < m_objects.size(); ++i) {
+        m_picker->addModel(m_objects[i].model);
+    }
+    m_renderSystem->markSceneChanged();
 }
 
 void Odyssey::setupUI() {
+    OdysseyProfiler::Scope scope("ui");
     setWindowIcon(QIcon(":/icon/odyssey.ico"));
     ui->setupUi(this);
     auto* wrapper = QWidget::createWindowContainer(m_window, this);
@@ -114,11 +424,485 @@ void Odyssey::setupUI() {
 }
 
 void Odyssey::setupEngine() {
-    m_device = new OdysseyDevice(m_window->getSurfaceInfo());
-    m_render = new OdysseyRender(m_window, m_device);
-    m_renderSystem = new OdysseyRenderSystem(m_device, m_render->getSwapChainRenderPass());
+    {
+        OdysseyProfiler::Scope scope("device");
+        m_device = new OdysseyDevice(m_window->getSurfaceInfo());
+    }
+    {
+        OdysseyProfiler::Scope scope("render pass");
+        // The depth pyramid for occlusion culling samples the depth attachment.
+        m_render = new OdysseyRender(m_window, m_device, m_options.latency, m_options.occlusionCulling, m_options.resolution);
+    }
+    {
+        // Overlaps with the swap chain and depth resources being created by OdysseyRender.
+        OdysseyProfiler::Scope scope("pipelines");
+        createRenderSystem(m_options.variant);
+        m_device->savePipelineCache();
+    }
     m_camera = new OdysseyCamera();
     m_camera->setViewDirection(glm::vec3(0.0F), glm::vec3(0.0F, 0.0F, 1.0F));
+    m_staticBatcher = std::make_unique<OdysseyStaticBatcher>(m_device);
+    if (!m_options.pointCloudPath.empty()) {
+        // In front of the camera and well inside the far plane.
+        m_pointCloud = std::make_unique<OdysseyPointCloud>(m_device, m_options.pointCloudPath, m_options.pointBudget, glm::vec3(0.0F, 0.0F, 4.0F), 3.0F);
+    }
+    if (!m_options.meshStreamPath.empty()) {
+        m_meshStream = std::make_unique<OdysseyMeshStream>(m_device, m_options.meshStreamPath, m_options.streamBudget, m_options.streamRadius, glm::vec3(0.0F, 0.0F, 4.0F), 3.0F);
+    }
+    setupRenderGraph();
+}
+
+void Odyssey::createRenderSystem(const PipelineVariant& variant) {
+    m_renderSystem = new OdysseyRenderSystem(m_device, m_render->getSwapChainRenderPass());
+    m_renderSystem->setVariant(variant);
+    m_renderSystem->setBatching(m_options.batching);
+    m_renderSystem->setCulling(m_options.culling);
+    m_renderSystem->setPerObjectTransforms(m_options.perObjectTransforms);
+    m_renderSystem->setCommandCaching(m_options.commandCaching);
+    m_renderSystem->setImpostorDistance(m_options.impostorDistance);
+    if (m_options.gpuDriven && !m_renderSystem->setGpuDriven(true)) {
+        std::cerr << "GPU-driven rendering needs drawIndirectFirstInstance; falling back to CPU batching." << std::endl;
+    }
+    if (m_options.parallelRecording) {
+        m_renderSystem->setParallelRecording([this](size_t threadIndex) {
+            return m_render->beginSecondaryCommandBuffer(threadIndex);
+        });
+    }
+    if (m_options.occlusionCulling && !(m_render->hasSampledDepth() && m_renderSystem->setOcclusionCulling(true))) {
+        std::cerr << "Occlusion culling needs GPU-driven rendering and a sampleable depth format; culling against the frustum only." << std::endl;
+    }
+}
+
+void Odyssey::setupTestScene() {
+    if (m_options.testSceneObjects == 0 && !m_options.interiorScene && m_options.assemblyParts == 0) {
+        return;
+    }
+    OdysseyProfiler::Scope scope("test scene");
+    m_renderSystem->markSceneChanged();
+    if (m_options.interiorScene) {
+        setupInteriorWalls();
+    }
+    if (m_options.assemblyParts > 0) {
+        setupAssembly();
+    }
+    if (m_options.testSceneObjects == 0) {
+        return;
+    }
+    auto model = m_options.modelPath.empty() ? OdysseyModel::createCubeModel(m_device) : OdysseyModel::createModelFromFile(m_device, m_options.modelPath);
+    // Every object shares one model, laid out on a cube grid in front of the camera.
+    auto side = static_cast<uint32_t>(std::ceil(std::cbrt(static_cast<double>(m_options.testSceneObjects))));
+    auto spacing = 4.0F / static_cast<float>(side);
+    m_testSceneFirst = m_objects.size();
+    m_objects.reserve(m_objects.size() + m_options.testSceneObjects);
+    for (uint32_t i = 0; i < m_options.testSceneObjects; ++i) {
+        auto x = i % side;
+        auto y = (i / side) % side;
+        auto z = i / (side * side);
+        auto object = OdysseyObject::createObject();
+        object.model = model;
+        object.transform.setTranslation({(static_cast<float>(x) + 0.5F) * spacing - 2.0F, (static_cast<float>(y) + 0.5F) * spacing - 2.0F, static_cast<float>(z) * spacing + 5.0F});
+        object.transform.setScale(glm::vec3(spacing * 0.5F));
+        m_objects.push_back(std::move(object));
+    }
+}
+
+void Odyssey::setupAssembly() {
+    // A square of parts, each its own node, under one node in front of the
+    // test grid; spinning the assembly moves every part with it. A static
+    // assembly stays put and its parts go to the static batcher.
+    auto cube = OdysseyModel::createCubeModel(m_device);
+    auto assemblyNode = m_sceneGraph.addNode(OdysseySceneGraph::INVALID_NODE, "assembly", glm::translate(glm::mat4(1.0F), ASSEMBLY_POSITION));
+    auto side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(m_options.assemblyParts))));
+    auto spacing = 2.0F / static_cast<float>(side);
+    std::vector<OdysseyObject> parts{};
+    parts.reserve(m_options.assemblyParts);
+    for (uint32_t i = 0; i < m_options.assemblyParts; ++i) {
+        glm::vec3 position{(static_cast<float>(i % side) + 0.5F) * spacing - 1.0F, (static_cast<float>(i / side) + 0.5F) * spacing - 1.0F, 0.0F};
+        auto node = m_sceneGraph.addNode(assemblyNode, "part", glm::translate(glm::mat4(1.0F), position));
+        auto object = OdysseyObject::createObject();
+        object.model = cube;
+        object.transform.setScale(glm::vec3(spacing * 0.4F));
+        m_sceneGraph.attach(node, object.transform);
+        parts.push_back(std::move(object));
+    }
+    if (m_options.staticAssembly) {
+        addStaticObjects(std::move(parts));
+        return;
+    }
+    m_assemblyNode = assemblyNode;
+    m_objects.reserve(m_objects.size() + parts.size());
+    for (auto& part : parts) {
+        m_objects.push_back(std::move(part));
+    }
+}
+
+void Odyssey::animateTestScene() {
+    if (m_options.movingObjects == 0 && m_assemblyNode == OdysseySceneGraph::INVALID_NODE) {
+        return;
+    }
+    ++m_animationFrame;
+    if (m_assemblyNode != OdysseySceneGraph::INVALID_NODE) {
+        auto angle = static_cast<float>(m_animationFrame) * 0.01F;
+        m_sceneGraph.setLocalMatrix(m_assemblyNode, glm::rotate(glm::translate(glm::mat4(1.0F), ASSEMBLY_POSITION), angle, glm::vec3(0.0F, 1.0F, 0.0F)));
+    }
+    if (m_options.testSceneObjects == 0) {
+        return;
+    }
+    // Only these objects are dirty each frame; the rest of the grid keeps its
+    // cached matrices.
+    auto count = (std::min)(static_cast<size_t>(m_options.movingObjects), m_objects.size() - m_testSceneFirst);
+    for (size_t i = 0; i < count; ++i) {
+        auto angle = static_cast<float>(m_animationFrame) * 0.02F + static_cast<float>(i) * 0.1F;
+        m_objects[m_testSceneFirst + i].transform.setRotation({angle * 0.5F, angle, 0.0F});
+    }
+}
+
+void Odyssey::setupLights(uint32_t count) {
+    // Scattered through the test grid's volume, the same for every run.
+    std::mt19937 random{0};
+    std::uniform_real_distribution<float> across{-2.0F, 2.0F};
+    std::uniform_real_distribution<float> unit{0.0F, 1.0F};
+    m_lights.resize(count);
+    m_lightOrbits.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        m_lightOrbits[i] = {across(random), across(random), across(random) + 7.0F, unit(random) * glm::two_pi<float>()};
+        m_lights[i].positionRadius = {glm::vec3(m_lightOrbits[i]), LIGHT_RADIUS};
+        m_lights[i].color = {glm::vec3(0.2F) + 0.8F * glm::vec3(unit(random), unit(random), unit(random)), 1.0F};
+    }
+}
+
+void Odyssey::animateLights() {
+    if (m_lights.empty()) {
+        return;
+    }
+    ++m_lightFrame;
+    auto time = static_cast<float>(m_lightFrame) * 0.02F;
+    for (size_t i = 0; i < m_lights.size(); ++i) {
+        const auto& orbit = m_lightOrbits[i];
+        auto angle = time + orbit.w;
+        m_lights[i].positionRadius = {glm::vec3(orbit) + LIGHT_ORBIT * glm::vec3(std::cos(angle), std::sin(angle), 0.0F), LIGHT_RADIUS};
+    }
+}
+
+void Odyssey::updateSceneGraph() {
+    auto start = std::chrono::steady_clock::now();
+    auto changed = m_sceneGraph.update();
+    auto& profiler = OdysseyProfiler::instance();
+    profiler.setCounter("scene graph (ms)", std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    profiler.setCounter("scene graph nodes changed", static_cast<double>(changed));
+}
+
+void Odyssey::setupInteriorWalls() {
+    // Two walls across the view, each with a doorway, so most of the grid
+    // behind them is hidden: the first in front of the grid, the second
+    // through its middle with the doorway off to one side.
+    auto cube = OdysseyModel::createCubeModel(m_device);
+    auto addBox = [this, &cube](glm::vec3 minCorner, glm::vec3 maxCorner) {
+        auto object = OdysseyObject::createObject();
+        object.model = cube;
+        object.transform.setTranslation((minCorner + maxCorner) * 0.5F);
+        object.transform.setScale(maxCorner - minCorner);
+        m_objects.push_back(std::move(object));
+    };
+    auto addWall = [&addBox](float z, float doorwayX) {
+        constexpr float HALF_SIZE{6.0F};
+        constexpr float HALF_DOORWAY{0.4F};
+        constexpr float HALF_THICKNESS{0.1F};
+        addBox({-HALF_SIZE, -HALF_SIZE, z - HALF_THICKNESS}, {doorwayX - HALF_DOORWAY, HALF_SIZE, z + HALF_THICKNESS});
+        addBox({doorwayX + HALF_DOORWAY, -HALF_SIZE, z - HALF_THICKNESS}, {HALF_SIZE, HALF_SIZE, z + HALF_THICKNESS});
+        addBox({doorwayX - HALF_DOORWAY, -HALF_SIZE, z - HALF_THICKNESS}, {doorwayX + HALF_DOORWAY, -HALF_DOORWAY, z + HALF_THICKNESS});
+        addBox({doorwayX - HALF_DOORWAY, HALF_DOORWAY, z - HALF_THICKNESS}, {doorwayX + HALF_DOORWAY, HALF_SIZE, z + HALF_THICKNESS});
+    };
+    addWall(4.0F, 0.0F);
+    addWall(7.0F, 1.2F);
+}
+
+void Odyssey::setupRenderGraph() {
+    m_renderGraph = std::make_unique<OdysseyRenderGraph>(m_device, OdysseySwapChain::MAX_FRAMES_IN_FLIGHT);
+    m_backbuffer = m_renderGraph->importImage("backbuffer", {.usage = vk::ImageUsageFlagBits::eColorAttachment, .aspect = vk::ImageAspectFlagBits::eColor}, vk::ImageLayout::eUndefined, vk::ImageLayout::ePresentSrcKHR);
+    auto depthFormat = OdysseySwapChain::findDepthFormat(m_device);
+    m_depth = m_renderGraph->importImage("depth", {.format = depthFormat, .usage = vk::ImageUsageFlagBits::eDepthStencilAttachment, .aspect = OdysseySwapChain::getDepthAspect(depthFormat)}, vk::ImageLayout::eUndefined, vk::ImageLayout::eUndefined);
+    // With dynamic resolution the scene goes to an offscreen target, upscaled
+    // into the backbuffer by the last pass; otherwise straight to the backbuffer.
+    m_sceneColor = m_backbuffer;
+    if (m_render->hasDynamicResolution()) {
+        m_sceneColor = m_renderGraph->importImage("scene color", {.usage = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled, .aspect = vk::ImageAspectFlagBits::eColor}, vk::ImageLayout::eUndefined, vk::ImageLayout::eShaderReadOnlyOptimal);
+    }
+    m_renderGraph->addPass({
+        .name = "gpu cull",
+        .sideEffects = true,
+        .execute = [this](vk::CommandBuffer commandBuffer) {
+            m_renderSystem->prepareObjects(commandBuffer, m_objects, m_camera, m_render->getFrameIndex());
+        },
+    });
+    if (m_pointCloud) {
+        m_renderGraph->addPass({
+            .name = "point streaming",
+            .sideEffects = true,
+            .execute = [this](vk::CommandBuffer commandBuffer) {
+                m_pointCloud->update(commandBuffer, *m_camera, m_render->getExtent(), m_render->getFrameIndex());
+            },
+        });
+    }
+    if (m_options.lightCount > 0 || m_options.lightSweep) {
+        m_renderGraph->addPass({
+            .name = "light culling",
+            .sideEffects = true,
+            .execute = [this](vk::CommandBuffer commandBuffer) {
+                m_renderSystem->cullLights(commandBuffer, m_lights, m_camera, m_render->getExtent(), m_render->getFrameIndex());
+            },
+        });
+    }
+    if (m_meshStream) {
+        // After the gpu cull pass, which updates the stream's transform.
+        m_renderGraph->addPass({
+            .name = "mesh streaming",
+            .sideEffects = true,
+            .execute = [this](vk::CommandBuffer commandBuffer) {
+                m_meshStream->update(commandBuffer, *m_camera, m_render->getFrameIndex());
+            },
+        });
+    }
+    if (m_renderSystem->isOcclusionCulling()) {
+        setupOcclusionPasses();
+    } else {
+        m_renderGraph->addPass({
+            .name = "scene",
+            .writes = {
+                {m_sceneColor, RenderGraphAccess::COLOR_ATTACHMENT, getSceneColorLayout()},
+                {m_depth, RenderGraphAccess::DEPTH_ATTACHMENT, vk::ImageLayout::eDepthStencilAttachmentOptimal},
+            },
+            .execute = [this](vk::CommandBuffer commandBuffer) {
+                m_render->beginSwapChainRenderPass(commandBuffer, OdysseyRenderPassPhase::WHOLE, getSceneContents());
+                m_renderSystem->renderObjects(commandBuffer, m_objects, m_camera, m_render->getFrameIndex(), m_render->getExtent());
+                renderStreamedGeometry(commandBuffer);
+                m_render->endSwapChainRenderPass(commandBuffer);
+            },
+        });
+    }
+    if (m_render->hasDynamicResolution()) {
+        m_renderGraph->addPass({
+            .name = "upscale",
+            .reads = {
+                {m_sceneColor, RenderGraphAccess::SAMPLED},
+            },
+            .writes = {
+                {m_backbuffer, RenderGraphAccess::COLOR_ATTACHMENT, vk::ImageLayout::ePresentSrcKHR},
+            },
+            .execute = [this](vk::CommandBuffer commandBuffer) {
+                m_render->upscale(commandBuffer);
+            },
+        });
+    }
+    m_renderGraph->compile();
+    if (m_options.dumpRenderGraph) {
+        std::cout << m_renderGraph->dump() << std::flush;
+        checkTransientAliasing();
+    }
+}
+
+void Odyssey::checkTransientAliasing() {
+    // The frame's graph only imports images, so a chain of transients stands
+    // in for post-processing: a and c are never alive together and should
+    // share memory, b overlaps both and should not.
+    OdysseyRenderGraph graph(m_device, OdysseySwapChain::MAX_FRAMES_IN_FLIGHT);
+    RenderGraphImageInfo info{
+        .format = vk::Format::eR8G8B8A8Unorm,
+        .extent = {256, 256},
+        .usage = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled,
+    };
+    auto a = graph.createImage("a", info);
+    auto b = graph.createImage("b", info);
+    auto c = graph.createImage("c", info);
+    graph.addPass({.name = "write a", .writes = {{a, RenderGraphAccess::COLOR_ATTACHMENT}}});
+    graph.addPass({.name = "a to b", .reads = {{a, RenderGraphAccess::SAMPLED}}, .writes = {{b, RenderGraphAccess::COLOR_ATTACHMENT}}});
+    graph.addPass({.name = "b to c", .reads = {{b, RenderGraphAccess::SAMPLED}}, .writes = {{c, RenderGraphAccess::COLOR_ATTACHMENT}}});
+    graph.addPass({.name = "read c", .reads = {{c, RenderGraphAccess::SAMPLED}}, .sideEffects = true});
+    graph.compile();
+    std::cout << graph.dump() << std::flush;
+    auto expected = graph.getLifetime(a) == std::pair{0, 1} && graph.getLifetime(b) == std::pair{1, 2} && graph.getLifetime(c) == std::pair{2, 3};
+    expected = expected && graph.getMemoryBlock(a) == graph.getMemoryBlock(c) && graph.getMemoryBlock(a) != graph.getMemoryBlock(b);
+    if (!expected) {
+        throw std::runtime_error("Render graph transient lifetimes or aliasing are wrong.");
+    }
+}
+
+void Odyssey::setupOcclusionPasses() {
+    // Last frame's visible objects are drawn first, their depth reduced to a
+    // pyramid, and everything else tested against it; only what turns out
+    // visible is drawn in the second half of the split render pass.
+    m_renderGraph->addPass({
+        .name = "scene",
+        .writes = {
+            {m_sceneColor, RenderGraphAccess::COLOR_ATTACHMENT, vk::ImageLayout::eColorAttachmentOptimal},
+            {m_depth, RenderGraphAccess::DEPTH_ATTACHMENT, vk::ImageLayout::eDepthStencilAttachmentOptimal},
+        },
+        .execute = [this](vk::CommandBuffer commandBuffer) {
+            m_render->beginSwapChainRenderPass(commandBuffer, OdysseyRenderPassPhase::FIRST, getSceneContents());
+            m_renderSystem->renderObjects(commandBuffer, m_objects, m_camera, m_render->getFrameIndex(), m_render->getExtent());
+            m_render->endSwapChainRenderPass(commandBuffer);
+        },
+    });
+    m_renderGraph->addPass({
+        .name = "depth pyramid",
+        .reads = {
+            {m_depth, RenderGraphAccess::DEPTH_READ},
+        },
+        .sideEffects = true,
+        .execute = [this](vk::CommandBuffer commandBuffer) {
+            m_renderSystem->buildDepthPyramid(commandBuffer, m_render->getFrameIndex(), m_render->getDepthImageView(), m_render->getExtent());
+        },
+    });
+    m_renderGraph->addPass({
+        .name = "occlusion cull",
+        .sideEffects = true,
+        .execute = [this](vk::CommandBuffer commandBuffer) {
+            m_renderSystem->cullOccluded(commandBuffer, m_camera, m_render->getFrameIndex());
+        },
+    });
+    m_renderGraph->addPass({
+        .name = "scene late",
+        .reads = {
+            {m_sceneColor, RenderGraphAccess::COLOR_ATTACHMENT, getSceneColorLayout()},
+            {m_depth, RenderGraphAccess::DEPTH_ATTACHMENT},
+        },
+        .writes = {
+            {m_sceneColor, RenderGraphAccess::COLOR_ATTACHMENT, getSceneColorLayout()},
+            {m_depth, RenderGraphAccess::DEPTH_ATTACHMENT},
+        },
+        .execute = [this](vk::CommandBuffer commandBuffer) {
+            m_render->beginSwapChainRenderPass(commandBuffer, OdysseyRenderPassPhase::LAST, getSceneContents());
+            m_renderSystem->renderLateObjects(commandBuffer, m_render->getFrameIndex());
+            renderStreamedGeometry(commandBuffer);
+            m_render->endSwapChainRenderPass(commandBuffer);
+        },
+    });
+}
+
+vk::ImageLayout Odyssey::getSceneColorLayout() const {
+    return m_render->hasDynamicResolution() ? vk::ImageLayout::eShaderReadOnlyOptimal : vk::ImageLayout::ePresentSrcKHR;
+}
+
+vk::SubpassContents Odyssey::getSceneContents() const {
+    return m_renderSystem->isParallelRecording() || m_renderSystem->isCommandCaching() ? vk::SubpassContents::eSecondaryCommandBuffers : vk::SubpassContents::eInline;
+}
+
+void Odyssey::renderStreamedGeometry(vk::CommandBuffer commandBuffer) {
+    if (!m_pointCloud && !m_meshStream) {
+        return;
+    }
+    auto secondary = getSceneContents() == vk::SubpassContents::eSecondaryCommandBuffers;
+    // Parallel recording has finished with this thread's pool by now.
+    auto drawCommandBuffer = secondary ? m_render->beginSecondaryCommandBuffer(0) : commandBuffer;
+    if (m_meshStream) {
+        m_renderSystem->renderMeshStream(drawCommandBuffer, *m_meshStream, m_render->getFrameIndex());
+    }
+    if (m_pointCloud) {
+        m_renderSystem->renderPointCloud(drawCommandBuffer, *m_pointCloud, m_render->getFrameIndex());
+    }
+    if (secondary) {
+        drawCommandBuffer.end();
+        commandBuffer.executeCommands(drawCommandBuffer);
+    }
+}
+
+void Odyssey::setupScheduler() {
+    auto policy = m_options.redraw;
+    // Frame timings are only meaningful when frames are drawn back to back.
+    policy.continuous = policy.continuous || m_options.benchmarkFrames > 0 || m_options.movingObjects > 0 || m_options.assemblyParts > 0;
+    // Point cloud nodes and mesh chunks arrive from I/O threads between frames.
+    policy.continuous = policy.continuous || m_pointCloud != nullptr || m_meshStream != nullptr;
+    // So do the point lights.
+    policy.continuous = policy.continuous || !m_lights.empty();
+    m_scheduler = new OdysseyRedrawScheduler(policy, [this]([[maybe_unused]] uint32_t dirtyFlags) {
+        return draw();
+    });
+    m_renderThread = std::make_unique<OdysseyRenderThread>(m_scheduler, [this](OdysseyRenderCommand& command) {
+        handleCommand(command);
+    });
+    if (m_options.redrawReport) {
+        m_redrawReportTimer = new QTimer(this);
+        connect(m_redrawReportTimer, &QTimer::timeout, this, [this]() {
+            m_renderThread->submit({.type = OdysseyRenderCommandType::REPORT});
+        });
+        m_redrawReportTimer->start(std::chrono::minutes(1));
+    }
+}
+
+void Odyssey::setupHeartbeat() {
+    m_statusTimer = new QTimer(this);
+    m_statusTimer->setSingleShot(true);
+    connect(m_statusTimer, &QTimer::timeout, this, &Odyssey::showStatus);
+    if (m_options.benchmarkFrames == 0 && !m_options.redrawReport && m_options.uiStall == 0) {
+        // The status bar follows published snapshots, so an idle window has
+        // nothing to wake for.
+        return;
+    }
+    m_heartbeatTimer = new QTimer(this);
+    m_heartbeatTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_heartbeatTimer, &QTimer::timeout, this, &Odyssey::heartbeat);
+    m_heartbeatTimer->start(HEARTBEAT_MEASURING);
+}
+
+void Odyssey::heartbeat() {
+    auto now = std::chrono::steady_clock::now();
+    if (m_lastHeartbeat != std::chrono::steady_clock::time_point{}) {
+        OdysseyProfiler::instance().addSample("ui tick (ms)", std::chrono::duration<double, std::milli>(now - m_lastHeartbeat).count());
+    }
+    m_lastHeartbeat = now;
+    if (m_options.uiStall > 0 && now - m_lastStall >= std::chrono::seconds(1)) {
+        // Stands in for a layout pass or a modal dialog: the render frame
+        // histogram should not move while the UI tick one does.
+        m_lastStall = now;
+        std::this_thread::sleep_for(std::chrono::milliseconds(m_options.uiStall));
+    }
+}
+
+void Odyssey::showStatus() {
+    auto now = std::chrono::steady_clock::now();
+    auto wait = m_lastStatus + STATUS_INTERVAL - now;
+    if (wait > std::chrono::steady_clock::duration::zero()) {
+        // Still queued, so the render thread posts nothing more until then.
+        if (!m_statusTimer->isActive()) {
+            m_statusTimer->start(std::chrono::ceil<std::chrono::milliseconds>(wait));
+        }
+        return;
+    }
+    m_lastStatus = now;
+    // Before the read, so a snapshot published after it queues another update.
+    m_statusQueued.exchange(false, std::memory_order_acq_rel);
+    const auto& snapshot = m_renderThread->getSnapshot();
+    if (snapshot.frame == 0) {
+        return;
+    }
+    auto message = QString("Frame %1 | %2 objects, %3 lights | camera (%4, %5, %6) | CPU %7 ms, GPU %8 ms")
+                       .arg(snapshot.frame)
+                       .arg(snapshot.objectCount)
+                       .arg(snapshot.lightCount)
+                       .arg(snapshot.cameraPosition.x, 0, 'f', 2)
+                       .arg(snapshot.cameraPosition.y, 0, 'f', 2)
+                       .arg(snapshot.cameraPosition.z, 0, 'f', 2)
+                       .arg(snapshot.cpuFrameTime, 0, 'f', 2)
+                       .arg(snapshot.gpuFrameTime, 0, 'f', 2);
+    if (m_options.resolution.targetFrameTime > 0.0) {
+        message += QString(" | scale %1").arg(static_cast<double>(snapshot.renderScale), 0, 'f', 3);
+    }
+    const auto& pick = snapshot.pick;
+    if (pick.hit) {
+        message += QString(" | picked object %1, triangle %2 at (%3, %4, %5) in %6 ms")
+                       .arg(pick.objectId)
+                       .arg(pick.triangle)
+                       .arg(pick.position.x, 0, 'f', 2)
+                       .arg(pick.position.y, 0, 'f', 2)
+                       .arg(pick.position.z, 0, 'f', 2)
+                       .arg(pick.time, 0, 'f', 3);
+    } else if (pick.count > 0) {
+        message += QString(" | picked nothing in %1 ms").arg(pick.time, 0, 'f', 3);
+        if (pick.pending > 0) {
+            message += QString(", %1 model BVHs still building").arg(pick.pending);
+        }
+    }
+    ui->statusbar->showMessage(message);
 }
 
 void Odyssey::setupEvent() {
@@ -126,9 +910,42 @@ void Odyssey::setupEvent() {
     m_window->setMouseCallback([this](OdysseyMouseEvent event) {
         if (event.type == OdysseyMouseEventType::LEFT_DOUBLE) {
         } else if (event.type == OdysseyMouseEventType::LEFT) {
+            m_renderThread->submit({.type = OdysseyRenderCommandType::PICK, .position = {event.position.worldX, event.position.worldY}});
         } else if (event.type == OdysseyMouseEventType::RIGHT) {
         }
     });
+    m_window->setResizeCallback([this](vk::Extent2D extent) {
+        m_renderThread->submit({.type = OdysseyRenderCommandType::RESIZE, .extent = extent});
+    });
+}
+
+void Odyssey::pickObject(float ndcX, float ndcY) {
+    if (m_camera == nullptr) {
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    auto result = m_picker->pick(m_objects, m_camera->getRay(ndcX, ndcY));
+    auto time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    OdysseyPickSnapshot pick{.count = m_lastPick.count + 1, .time = time};
+    if (result) {
+        // A hit on a static batch cell belongs to the object merged into it.
+        const auto* object = &m_objects[result->objectIndex];
+        auto triangle = result->triangle;
+        if (auto source = m_staticBatcher->findSource(object->model.get(), triangle)) {
+            object = source->object;
+            triangle = source->triangle;
+        }
+        pick.hit = true;
+        pick.objectId = object->getId();
+        pick.triangle = triangle;
+        pick.position = result->position;
+    } else {
+        pick.pending = m_picker->getPendingCount();
+    }
+    m_lastPick = pick;
+    OdysseyProfiler::instance().setCounter("pick (ms)", time);
+    // Shown without waiting for a frame, which an idle scene may not draw.
+    publishSnapshot();
 }
 
 void Odyssey::setupSignalsSlots() {
@@ -0,0 +1,106 @@
+/**
+ * @file odyssey_buffer.cpp
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include "odyssey_buffer.h"
+
+#include <cstring>
+
+#include "odyssey_device.h"
+
+namespace odyssey {
+
+OdysseyBuffer::OdysseyBuffer(OdysseyDevice* device, vk::DeviceSize instanceSize, uint32_t instanceCount, vk::BufferUsageFlags usageFlags, vk::MemoryPropertyFlags memoryPropertyFlags, vk::DeviceSize minOffsetAlignment)
+    : m_device(device), m_instanceCount(instanceCount), m_instanceSize(instanceSize), m_usageFlags(usageFlags), m_memoryPropertyFlags(memoryPropertyFlags) {
+    m_alignmentSize = getAlignment(instanceSize, minOffsetAlignment);
+    m_bufferSize = m_alignmentSize * instanceCount;
+    m_device->createBuffer(m_bufferSize, usageFlags, memoryPropertyFlags, m_buffer, m_memory);
+}
+
+OdysseyBuffer::~OdysseyBuffer() {
+    unmap();
+    m_device->device().destroyBuffer(m_buffer);
+    m_device->device().freeMemory(m_memory);
+}
+
+void OdysseyBuffer::map(vk::DeviceSize size, vk::DeviceSize offset) {
+    m_mapped = m_device->device().mapMemory(m_memory, offset, size);
+}
+
+void OdysseyBuffer::unmap() {
+    if (m_mapped) {
+        m_device->device().unmapMemory(m_memory);
+        m_mapped = nullptr;
+    }
+}
+
+void OdysseyBuffer::writeToBuffer(const void* data, vk::DeviceSize size, vk::DeviceSize offset) {
+    if (size == VK_WHOLE_SIZE) {
+        memcpy(m_mapped, data, m_bufferSize);
+    } else {
+        memcpy(static_cast<char*>(m_mapped) + offset, data, size);
+    }
+}
+
+void OdysseyBuffer::flush(vk::DeviceSize size, vk::DeviceSize offset) {
+    if (m_memoryPropertyFlags & vk::MemoryPropertyFlagBits::eHostCoherent) {
+        return;
+    }
+    vk::MappedMemoryRange mappedRange{};
+    mappedRange
+        .setMemory(m_memory)
+        .setOffset(offset)
+        .setSize(size);
+    m_device->device().flushMappedMemoryRanges(mappedRange);
+}
+
+void OdysseyBuffer::writeToIndex(const void* data, uint32_t index) {
+    writeToBuffer(data, m_instanceSize, index * m_alignmentSize);
+}
+
+void OdysseyBuffer::flushIndex(uint32_t index) {
+    flush(m_alignmentSize, index * m_alignmentSize);
+}
+
+vk::DescriptorBufferInfo OdysseyBuffer::descriptorInfo(vk::DeviceSize size, vk::DeviceSize offset) const {
+    return {m_buffer, offset, size};
+}
+
+vk::DescriptorBufferInfo OdysseyBuffer::descriptorInfoForIndex(uint32_t index) const {
+    return descriptorInfo(m_alignmentSize, index * m_alignmentSize);
+}
+
+vk::Buffer OdysseyBuffer::getBuffer() const {
+    return m_buffer;
+}
+
+void* OdysseyBuffer::getMappedMemory() const {
+    return m_mapped;
+}
+
+uint32_t OdysseyBuffer::getInstanceCount() const {
+    return m_instanceCount;
+}
+
+vk::DeviceSize OdysseyBuffer::getInstanceSize() const {
+    return m_instanceSize;
+}
+
+vk::DeviceSize OdysseyBuffer::getAlignmentSize() const {
+    return m_alignmentSize;
+}
+
+vk::DeviceSize OdysseyBuffer::getBufferSize() const {
+    return m_bufferSize;
+}
+
+vk::DeviceSize OdysseyBuffer::getAlignment(vk::DeviceSize instanceSize, vk::DeviceSize minOffsetAlignment) {
+    if (minOffsetAlignment > 0) {
+        return (instanceSize + minOffsetAlignment - 1) & ~(minOffsetAlignment - 1);
+    }
+    return instanceSize;
+}
+
+}  // namespace odyssey
\ No newline at end of file
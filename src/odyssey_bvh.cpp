@@ -0,0 +1,186 @@
+/**
+ * @file odyssey_bvh.cpp
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include "odyssey_bvh.h"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace odyssey {
+
+namespace {
+
+constexpr int BIN_COUNT{16};
+
+}  // namespace
+
+void OdysseyAabb::grow(const glm::vec3& point) {
+    min = glm::min(min, point);
+    max = glm::max(max, point);
+}
+
+void OdysseyAabb::grow(const OdysseyAabb& aabb) {
+    min = glm::min(min, aabb.min);
+    max = glm::max(max, aabb.max);
+}
+
+float OdysseyAabb::area() const {
+    auto extent = max - min;
+    if (extent.x < 0.0F) {
+        return 0.0F;
+    }
+    return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+}
+
+OdysseyAabb OdysseyAabb::transformed(const glm::mat4& matrix) const {
+    // Arvo: each output axis takes the smaller and larger product per input axis.
+    OdysseyAabb result{};
+    result.min = glm::vec3(matrix[3]);
+    result.max = result.min;
+    for (int column = 0; column < 3; ++column) {
+        auto a = glm::vec3(matrix[column]) * min[column];
+        auto b = glm::vec3(matrix[column]) * max[column];
+        result.min += glm::min(a, b);
+        result.max += glm::max(a, b);
+    }
+    return result;
+}
+
+void OdysseyBvh::build(const std::vector<OdysseyAabb>& bounds) {
+    m_nodes.clear();
+    m_primitives.resize(bounds.size());
+    if (bounds.empty()) {
+        return;
+    }
+    std::vector<glm::vec3> centroids(bounds.size());
+    for (uint32_t i = 0; i < bounds.size(); ++i) {
+        m_primitives[i] = i;
+        centroids[i] = (bounds[i].min + bounds[i].max) * 0.5F;
+    }
+    // A binary tree over n leaves has at most 2n - 1 nodes.
+    m_nodes.reserve(2 * bounds.size());
+    m_nodes.push_back({{}, 0, {}, static_cast<uint32_t>(bounds.size())});
+    // (node, depth) pairs still to split.
+    std::vector<std::pair<uint32_t, uint32_t>> pending{{0, 1}};
+    while (!pending.empty()) {
+        auto [nodeIndex, depth] = pending.back();
+        pending.pop_back();
+        auto childCount = m_nodes.size();
+        subdivide(nodeIndex, depth, bounds, centroids);
+        if (m_nodes.size() > childCount) {
+            pending.emplace_back(static_cast<uint32_t>(childCount), depth + 1);
+            pending.emplace_back(static_cast<uint32_t>(childCount + 1), depth + 1);
+        }
+    }
+}
+
+bool OdysseyBvh::empty() const {
+    return m_nodes.empty();
+}
+
+OdysseyAabb OdysseyBvh::getBounds() const {
+    if (m_nodes.empty()) {
+        return {};
+    }
+    return {m_nodes[0].min, m_nodes[0].max};
+}
+
+size_t OdysseyBvh::getNodeCount() const {
+    return m_nodes.size();
+}
+
+float OdysseyBvh::intersectNode(const Node& node, const glm::vec3& origin, const glm::vec3& inverseDirection, float tMax) {
+    auto t0 = (node.min - origin) * inverseDirection;
+    auto t1 = (node.max - origin) * inverseDirection;
+    auto tNear = glm::min(t0, t1);
+    auto tFar = glm::max(t0, t1);
+    auto enter = (std::max)({tNear.x, tNear.y, tNear.z, 0.0F});
+    auto exit = (std::min)({tFar.x, tFar.y, tFar.z, tMax});
+    return enter <= exit ? enter : NO_HIT;
+}
+
+void OdysseyBvh::subdivide(uint32_t nodeIndex, uint32_t depth, const std::vector<OdysseyAabb>& bounds, const std::vector<glm::vec3>& centroids) {
+    auto first = m_nodes[nodeIndex].first;
+    auto count = m_nodes[nodeIndex].count;
+    OdysseyAabb nodeBounds{};
+    OdysseyAabb centroidBounds{};
+    for (auto i = first; i < first + count; ++i) {
+        nodeBounds.grow(bounds[m_primitives[i]]);
+        centroidBounds.grow(centroids[m_primitives[i]]);
+    }
+    m_nodes[nodeIndex].min = nodeBounds.min;
+    m_nodes[nodeIndex].max = nodeBounds.max;
+    // Every inner node puts at most one far child on the traversal stack.
+    if (count <= 2 || depth >= MAX_DEPTH) {
+        return;
+    }
+
+    struct Bin {
+        OdysseyAabb bounds{};
+        uint32_t count{0};
+    };
+    auto bestCost = std::numeric_limits<float>::infinity();
+    int bestAxis{-1};
+    int bestSplit{0};
+    auto extent = centroidBounds.max - centroidBounds.min;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (extent[axis] <= 0.0F) {
+            continue;
+        }
+        std::array<Bin, BIN_COUNT> bins{};
+        auto scale = static_cast<float>(BIN_COUNT) / extent[axis];
+        for (auto i = first; i < first + count; ++i) {
+            auto primitive = m_primitives[i];
+            auto bin = (std::min)(static_cast<int>((centroids[primitive][axis] - centroidBounds.min[axis]) * scale), BIN_COUNT - 1);
+            bins[bin].bounds.grow(bounds[primitive]);
+            ++bins[bin].count;
+        }
+        // Sweep from the right for the right-hand areas, then from the left
+        // to cost every plane between bins.
+        std::array<float, BIN_COUNT - 1> rightArea{};
+        std::array<uint32_t, BIN_COUNT - 1> rightCount{};
+        OdysseyAabb right{};
+        uint32_t rightSum{0};
+        for (int bin = BIN_COUNT - 1; bin > 0; --bin) {
+            right.grow(bins[bin].bounds);
+            rightSum += bins[bin].count;
+            rightArea[bin - 1] = right.area();
+            rightCount[bin - 1] = rightSum;
+        }
+        OdysseyAabb left{};
+        uint32_t leftSum{0};
+        for (int split = 0; split < BIN_COUNT - 1; ++split) {
+            left.grow(bins[split].bounds);
+            leftSum += bins[split].count;
+            auto cost = static_cast<float>(leftSum) * left.area() + static_cast<float>(rightCount[split]) * rightArea[split];
+            if (leftSum > 0 && rightCount[split] > 0 && cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = split;
+            }
+        }
+    }
+    // Splitting must beat intersecting every primitive here, unless the leaf
+    // would be too large to scan.
+    auto leafCost = static_cast<float>(count) * nodeBounds.area();
+    if (bestAxis < 0 || (bestCost >= leafCost && count <= MAX_LEAF_SIZE)) {
+        return;
+    }
+    auto scale = static_cast<float>(BIN_COUNT) / extent[bestAxis];
+    auto middle = std::partition(m_primitives.begin() + first, m_primitives.begin() + first + count, [&](uint32_t primitive) {
+        auto bin = (std::min)(static_cast<int>((centroids[primitive][bestAxis] - centroidBounds.min[bestAxis]) * scale), BIN_COUNT - 1);
+        return bin <= bestSplit;
+    });
+    auto leftCount = static_cast<uint32_t>(middle - (m_primitives.begin() + first));
+    auto leftChild = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.push_back({{}, first, {}, leftCount});
+    m_nodes.push_back({{}, first + leftCount, {}, count - leftCount});
+    m_nodes[nodeIndex].first = leftChild;
+    m_nodes[nodeIndex].count = 0;
+}
+
+}  // namespace odyssey
\ No newline at end of file
@@ -9,6 +9,7 @@
 namespace odyssey {
 
 void OdysseyCamera::setOrthographicProjection(float left, float right, float top, float bottom, float nearValue, float farValue) {
+    auto previous = m_projectionMat;
     m_projectionMat = glm::mat4{1.0F};
     m_projectionMat[0][0] = 2.0F / (right - left);
     m_projectionMat[1][1] = 2.0F / (bottom - top);
@@ -16,22 +17,26 @@ void OdysseyCamera::setOrthographicProjection(float left, float right, float top
     m_projectionMat[3][0] = -(right + left) / (right - left);
     m_projectionMat[3][1] = -(bottom + top) / (bottom - top);
     m_projectionMat[3][2] = -nearValue / (farValue - nearValue);
+    updateVersion(previous, m_projectionMat);
 }
 
 void OdysseyCamera::setPerspectiveProjection(float fovY, float aspect, float nearValue, float farValue) {
     const float TAN_HALF_FOV_Y = std::tanf(fovY / 2.0F);
+    auto previous = m_projectionMat;
     m_projectionMat = glm::mat4{0.0F};
     m_projectionMat[0][0] = 1.0F / (aspect * TAN_HALF_FOV_Y);
     m_projectionMat[1][1] = 1.0F / (TAN_HALF_FOV_Y);
     m_projectionMat[2][2] = farValue / (farValue - nearValue);
     m_projectionMat[2][3] = 1.0F;
     m_projectionMat[3][2] = -(farValue * nearValue) / (farValue - nearValue);
+    updateVersion(previous, m_projectionMat);
 }
 
 void OdysseyCamera::setViewDirection(glm::vec3 position, glm::vec3 direction, glm::vec3 up) {
     const glm::vec3 W{glm::normalize(direction)};
     const glm::vec3 U{glm::normalize(glm::cross(W, up))};
     const glm::vec3 V{glm::cross(W, U)};
+    auto previous = m_viewMat;
     m_viewMat = glm::mat4{1.0F};
     m_viewMat[0][0] = U.x;
     m_viewMat[1][0] = U.y;
@@ -45,6 +50,7 @@ void OdysseyCamera::setViewDirection(glm::vec3 position, glm::vec3 direction, gl
     m_viewMat[3][0] = -glm::dot(U, position);
     m_viewMat[3][1] = -glm::dot(V, position);
     m_viewMat[3][2] = -glm::dot(W, position);
+    updateVersion(previous, m_viewMat);
 }
 
 void OdysseyCamera::setViewTarget(glm::vec3 position, glm::vec3 target, glm::vec3 up) {
@@ -61,6 +67,7 @@ void OdysseyCamera::setViewYXZ(glm::vec3 position, glm::vec3 rotation) {
     const glm::vec3 U{(C1 * C3 + S1 * S2 * S3), (C2 * S3), (C1 * S2 * S3 - C3 * S1)};
     const glm::vec3 V{(C3 * S1 * S2 - C1 * S3), (C2 * C3), (C1 * C3 * S2 + S1 * S3)};
     const glm::vec3 W{(C2 * S1), (-S2), (C1 * C2)};
+    auto previous = m_viewMat;
     m_viewMat = glm::mat4{1.0F};
     m_viewMat[0][0] = U.x;
     m_viewMat[1][0] = U.y;
@@ -74,6 +81,7 @@ void OdysseyCamera::setViewYXZ(glm::vec3 position, glm::vec3 rotation) {
     m_viewMat[3][0] = -glm::dot(U, position);
     m_viewMat[3][1] = -glm::dot(V, position);
     m_viewMat[3][2] = -glm::dot(W, position);
+    updateVersion(previous, m_viewMat);
 }
 
 const glm::mat4& OdysseyCamera::getProjection() const {
@@ -84,4 +92,24 @@ const glm::mat4& OdysseyCamera::getView() const {
     return m_viewMat;
 }
 
+uint64_t OdysseyCamera::getVersion() const {
+    return m_version;
+}
+
+OdysseyRay OdysseyCamera::getRay(float ndcX, float ndcY) const {
+    // Clip depth runs from 0 at the near plane to 1 at the far plane.
+    auto inverse = glm::inverse(m_projectionMat * m_viewMat);
+    auto nearPoint = inverse * glm::vec4(ndcX, ndcY, 0.0F, 1.0F);
+    auto farPoint = inverse * glm::vec4(ndcX, ndcY, 1.0F, 1.0F);
+    auto origin = glm::vec3(nearPoint) / nearPoint.w;
+    return {origin, glm::vec3(farPoint) / farPoint.w - origin};
+}
+
+void OdysseyCamera::updateVersion(const glm::mat4& previous, const glm::mat4& current) {
+    // Setters run every frame with mostly unchanged arguments.
+    if (current != previous) {
+        ++m_version;
+    }
+}
+
 }  // namespace odyssey
\ No newline at end of file
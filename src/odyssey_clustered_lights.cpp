@@ -0,0 +1,128 @@
+/**
+ * @file odyssey_clustered_lights.cpp
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include "odyssey_clustered_lights.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "odyssey_device.h"
+#include "odyssey_swap_chain.h"
+
+namespace odyssey {
+
+OdysseyClusteredLights::OdysseyClusteredLights(OdysseyDevice* device) : m_device(device) {
+    constexpr auto frameCount = static_cast<uint32_t>(OdysseySwapChain::MAX_FRAMES_IN_FLIGHT);
+    m_frames.resize(frameCount);
+    m_lightBuffer = std::make_unique<OdysseyBuffer>(
+        m_device,
+        sizeof(OdysseyPointLight),
+        frameCount * MAX_LIGHTS,
+        vk::BufferUsageFlagBits::eStorageBuffer,
+        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+    m_lightBuffer->map();
+    m_clusterBuffer = std::make_unique<OdysseyBuffer>(
+        m_device,
+        sizeof(uint32_t),
+        frameCount * CLUSTER_COUNT * CLUSTER_STRIDE,
+        vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst,
+        vk::MemoryPropertyFlagBits::eDeviceLocal);
+    // shader.frag reads the counts before any frame has culled.
+    auto commandBuffer = m_device->beginSingleTimeCommands();
+    commandBuffer.fillBuffer(m_clusterBuffer->getBuffer(), 0, VK_WHOLE_SIZE, 0);
+    m_device->endSingleTimeCommands(commandBuffer);
+
+    m_setLayout = OdysseyDescriptorSetLayout::Builder(m_device)
+                      .addBinding(0, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eCompute)
+                      .addBinding(1, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eCompute)
+                      .build();
+    m_descriptorPool = OdysseyDescriptorPool::Builder(m_device)
+                           .setMaxSets(1)
+                           .addPoolSize(vk::DescriptorType::eStorageBuffer, 2)
+                           .build();
+    auto lightInfo = getLightBufferInfo();
+    auto clusterInfo = getClusterBufferInfo();
+    if (!OdysseyDescriptorWriter(*m_setLayout, *m_descriptorPool).writeBuffer(0, &lightInfo).writeBuffer(1, &clusterInfo).build(m_descriptorSet)) {
+        throw std::runtime_error("Failed to allocate light culling descriptor set.");
+    }
+
+    vk::PushConstantRange pushConstantRange{};
+    pushConstantRange
+        .setStageFlags(vk::ShaderStageFlagBits::eCompute)
+        .setOffset(0)
+        .setSize(sizeof(PushConstantData));
+    auto setLayout = m_setLayout->getDescriptorSetLayout();
+    vk::PipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo
+        .setSetLayouts(setLayout)
+        .setPushConstantRanges(pushConstantRange);
+    m_pipelineLayout = m_device->device().createPipelineLayout(pipelineLayoutInfo);
+    m_pipeline = std::make_unique<OdysseyComputePipeline>(m_device, "shaders/light_cull.comp.spv", m_pipelineLayout);
+}
+
+OdysseyClusteredLights::~OdysseyClusteredLights() {
+    m_pipeline.reset();
+    m_device->device().destroyPipelineLayout(m_pipelineLayout);
+    m_descriptorPool.reset();
+    m_setLayout.reset();
+    m_clusterBuffer.reset();
+    m_lightBuffer.reset();
+}
+
+void OdysseyClusteredLights::cull(vk::CommandBuffer commandBuffer, const std::vector<OdysseyPointLight>& lights, const OdysseyCamera& camera, vk::Extent2D extent, size_t frameIndex) {
+    auto& frame = m_frames.at(frameIndex);
+    auto lightCount = static_cast<uint32_t>((std::min)(lights.size(), static_cast<size_t>(MAX_LIGHTS)));
+    frame.lightInfo = {lightCount, static_cast<uint32_t>(frameIndex) * MAX_LIGHTS, static_cast<uint32_t>(frameIndex) * CLUSTER_COUNT * CLUSTER_STRIDE, 0U};
+    if (lightCount == 0 || extent.width == 0 || extent.height == 0) {
+        frame.lightInfo.x = 0;
+        return;
+    }
+    // The frame's fence has been waited on, so nothing reads its slots.
+    m_lightBuffer->writeToBuffer(lights.data(), lightCount * sizeof(OdysseyPointLight), frame.lightInfo.y * sizeof(OdysseyPointLight));
+
+    const auto& projection = camera.getProjection();
+    auto zNear = -projection[3][2] / projection[2][2];
+    auto zFar = projection[3][2] / (1.0F - projection[2][2]);
+    auto logDepthRange = std::log(zFar / zNear);
+    frame.clusterScale = {
+        static_cast<float>(CLUSTERS_X) / static_cast<float>(extent.width),
+        static_cast<float>(CLUSTERS_Y) / static_cast<float>(extent.height),
+        static_cast<float>(CLUSTERS_Z) / logDepthRange,
+        -static_cast<float>(CLUSTERS_Z) * std::log(zNear) / logDepthRange,
+    };
+
+    PushConstantData push{};
+    push.view = camera.getView();
+    push.projection = {projection[0][0], projection[1][1], zNear, zFar};
+    push.lightCount = lightCount;
+    push.firstLight = frame.lightInfo.y;
+    push.firstCluster = frame.lightInfo.z;
+    m_pipeline->bind(commandBuffer);
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_pipelineLayout, 0, m_descriptorSet, nullptr);
+    commandBuffer.pushConstants<PushConstantData>(m_pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, push);
+    commandBuffer.dispatch((CLUSTER_COUNT + 63) / 64, 1, 1);
+
+    vk::MemoryBarrier cullBarrier{};
+    cullBarrier
+        .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eShaderRead);
+    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eFragmentShader, {}, cullBarrier, nullptr, nullptr);
+}
+
+const OdysseyClusteredLights::FrameInfo& OdysseyClusteredLights::getFrameInfo(size_t frameIndex) const {
+    return m_frames.at(frameIndex);
+}
+
+vk::DescriptorBufferInfo OdysseyClusteredLights::getLightBufferInfo() const {
+    return m_lightBuffer->descriptorInfo();
+}
+
+vk::DescriptorBufferInfo OdysseyClusteredLights::getClusterBufferInfo() const {
+    return m_clusterBuffer->descriptorInfo();
+}
+
+}  // namespace odyssey
\ No newline at end of file
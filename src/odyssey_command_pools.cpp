@@ -0,0 +1,62 @@
+/**
+ * @file odyssey_command_pools.cpp
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include "odyssey_command_pools.h"
+
+#include "odyssey_device.h"
+
+namespace odyssey {
+
+OdysseyCommandPools::OdysseyCommandPools(OdysseyDevice* device, size_t frameCount, size_t threadCount, vk::CommandPoolCreateFlags flags) : m_device(device), m_threadCount(threadCount), m_pools(frameCount * threadCount) {
+    vk::CommandPoolCreateInfo poolInfo{};
+    poolInfo
+        .setFlags(flags)
+        .setQueueFamilyIndex(m_device->findPhysicalQueueFamilies().graphicsFamily);
+    for (auto& pool : m_pools) {
+        pool.pool = m_device->device().createCommandPool(poolInfo);
+    }
+}
+
+OdysseyCommandPools::~OdysseyCommandPools() {
+    // Destroying a pool frees every buffer allocated from it.
+    for (auto& pool : m_pools) {
+        m_device->device().destroyCommandPool(pool.pool);
+    }
+}
+
+void OdysseyCommandPools::reset(size_t frameIndex) {
+    for (size_t thread = 0; thread < m_threadCount; ++thread) {
+        auto& pool = m_pools[frameIndex * m_threadCount + thread];
+        if (pool.usedPrimaries == 0 && pool.usedSecondaries == 0) {
+            continue;
+        }
+        m_device->device().resetCommandPool(pool.pool);
+        pool.usedPrimaries = 0;
+        pool.usedSecondaries = 0;
+    }
+}
+
+vk::CommandBuffer OdysseyCommandPools::allocate(size_t frameIndex, size_t threadIndex, vk::CommandBufferLevel level) {
+    auto& pool = m_pools[frameIndex * m_threadCount + threadIndex];
+    auto primary = level == vk::CommandBufferLevel::ePrimary;
+    auto& buffers = primary ? pool.primaries : pool.secondaries;
+    auto& used = primary ? pool.usedPrimaries : pool.usedSecondaries;
+    if (used == buffers.size()) {
+        vk::CommandBufferAllocateInfo allocInfo{};
+        allocInfo
+            .setLevel(level)
+            .setCommandPool(pool.pool)
+            .setCommandBufferCount(1);
+        buffers.push_back(m_device->device().allocateCommandBuffers(allocInfo).front());
+    }
+    return buffers[used++];
+}
+
+size_t OdysseyCommandPools::getThreadCount() const {
+    return m_threadCount;
+}
+
+}  // namespace odyssey
\ No newline at end of file
@@ -0,0 +1,226 @@
+/**
+ * @file odyssey_culling.cpp
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include "odyssey_culling.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <limits>
+
+#include "odyssey_thread_pool.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define ODYSSEY_CULLING_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define ODYSSEY_TARGET_AVX
+#else
+#define ODYSSEY_TARGET_AVX __attribute__((target("avx")))
+#endif
+#endif
+
+namespace odyssey {
+
+namespace {
+
+// Every kernel reads whole SIMD lanes, so the arrays are padded to this many
+// entries with spheres that are always visible.
+constexpr size_t SIMD_WIDTH{8};
+
+struct SphereArrays {
+    const float* x;
+    const float* y;
+    const float* z;
+    const float* radius;
+    uint8_t* visible;
+};
+
+#if defined(ODYSSEY_CULLING_X86)
+
+bool hasAvx() {
+#if defined(_MSC_VER)
+    int info[4]{};
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    // The OS must also save the upper halves of the ymm registers.
+    return osxsave && avx && (_xgetbv(0) & 0x6) == 0x6;
+#else
+    return __builtin_cpu_supports("avx");
+#endif
+}
+
+size_t storeMask(uint8_t* visible, size_t index, size_t end, unsigned mask, unsigned width) {
+    for (unsigned lane = 0; lane < width; ++lane) {
+        visible[index + lane] = static_cast<uint8_t>((mask >> lane) & 1U);
+    }
+    if (index + width > end) {
+        mask &= (1U << (end - index)) - 1U;
+    }
+    return static_cast<size_t>(std::popcount(mask));
+}
+
+size_t cullSse(const SphereArrays& spheres, const OdysseyFrustum& frustum, size_t begin, size_t end) {
+    __m128 planeX[6]{};
+    __m128 planeY[6]{};
+    __m128 planeZ[6]{};
+    __m128 planeW[6]{};
+    for (size_t p = 0; p < frustum.planes.size(); ++p) {
+        planeX[p] = _mm_set1_ps(frustum.planes[p].x);
+        planeY[p] = _mm_set1_ps(frustum.planes[p].y);
+        planeZ[p] = _mm_set1_ps(frustum.planes[p].z);
+        planeW[p] = _mm_set1_ps(frustum.planes[p].w);
+    }
+    const auto signMask = _mm_set1_ps(-0.0F);
+    size_t visibleCount{0};
+    for (auto i = begin; i < end; i += 4) {
+        auto x = _mm_loadu_ps(spheres.x + i);
+        auto y = _mm_loadu_ps(spheres.y + i);
+        auto z = _mm_loadu_ps(spheres.z + i);
+        auto negativeRadius = _mm_xor_ps(_mm_loadu_ps(spheres.radius + i), signMask);
+        auto inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (size_t p = 0; p < frustum.planes.size(); ++p) {
+            auto distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[p], x), _mm_mul_ps(planeY[p], y)), _mm_add_ps(_mm_mul_ps(planeZ[p], z), planeW[p]));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negativeRadius));
+        }
+        visibleCount += storeMask(spheres.visible, i, end, static_cast<unsigned>(_mm_movemask_ps(inside)), 4);
+    }
+    return visibleCount;
+}
+
+ODYSSEY_TARGET_AVX size_t cullAvx(const SphereArrays& spheres, const OdysseyFrustum& frustum, size_t begin, size_t end) {
+    __m256 planeX[6]{};
+    __m256 planeY[6]{};
+    __m256 planeZ[6]{};
+    __m256 planeW[6]{};
+    for (size_t p = 0; p < frustum.planes.size(); ++p) {
+        planeX[p] = _mm256_set1_ps(frustum.planes[p].x);
+        planeY[p] = _mm256_set1_ps(frustum.planes[p].y);
+        planeZ[p] = _mm256_set1_ps(frustum.planes[p].z);
+        planeW[p] = _mm256_set1_ps(frustum.planes[p].w);
+    }
+    const auto signMask = _mm256_set1_ps(-0.0F);
+    size_t visibleCount{0};
+    for (auto i = begin; i < end; i += 8) {
+        auto x = _mm256_loadu_ps(spheres.x + i);
+        auto y = _mm256_loadu_ps(spheres.y + i);
+        auto z = _mm256_loadu_ps(spheres.z + i);
+        auto negativeRadius = _mm256_xor_ps(_mm256_loadu_ps(spheres.radius + i), signMask);
+        auto inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (size_t p = 0; p < frustum.planes.size(); ++p) {
+            auto distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(planeX[p], x), _mm256_mul_ps(planeY[p], y)), _mm256_add_ps(_mm256_mul_ps(planeZ[p], z), planeW[p]));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negativeRadius, _CMP_GE_OQ));
+        }
+        visibleCount += storeMask(spheres.visible, i, end, static_cast<unsigned>(_mm256_movemask_ps(inside)), 8);
+    }
+    return visibleCount;
+}
+
+#else
+
+size_t cullScalar(const SphereArrays& spheres, const OdysseyFrustum& frustum, size_t begin, size_t end) {
+    size_t visibleCount{0};
+    for (auto i = begin; i < end; ++i) {
+        bool visible{true};
+        for (const auto& plane : frustum.planes) {
+            if (plane.x * spheres.x[i] + plane.y * spheres.y[i] + plane.z * spheres.z[i] + plane.w < -spheres.radius[i]) {
+                visible = false;
+                break;
+            }
+        }
+        spheres.visible[i] = visible ? 1 : 0;
+        visibleCount += visible ? 1 : 0;
+    }
+    return visibleCount;
+}
+
+#endif
+
+}  // namespace
+
+OdysseyFrustum OdysseyFrustum::fromMatrix(const glm::mat4& projectionView) {
+    // Gribb-Hartmann: each plane is a sum or difference of rows of the
+    // clip matrix. GLM is column-major, so row i is m[0][i] .. m[3][i], and
+    // clip depth is [0, w], which makes the near plane row 2 on its own.
+    auto row = [&projectionView](int i) {
+        return glm::vec4(projectionView[0][i], projectionView[1][i], projectionView[2][i], projectionView[3][i]);
+    };
+    OdysseyFrustum frustum{};
+    frustum.planes = {
+        row(3) + row(0),
+        row(3) - row(0),
+        row(3) + row(1),
+        row(3) - row(1),
+        row(2),
+        row(3) - row(2),
+    };
+    for (auto& plane : frustum.planes) {
+        auto length = glm::length(glm::vec3(plane));
+        if (length > 0.0F) {
+            plane /= length;
+        }
+    }
+    return frustum;
+}
+
+void OdysseyCuller::resize(size_t count) {
+    m_count = count;
+    auto padded = (count + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+    m_centerX.resize(padded, 0.0F);
+    m_centerY.resize(padded, 0.0F);
+    m_centerZ.resize(padded, 0.0F);
+    m_radius.resize(padded, std::numeric_limits<float>::infinity());
+    m_visible.resize(padded, 1);
+}
+
+void OdysseyCuller::setSphere(size_t index, const glm::vec3& center, float radius) {
+    m_centerX[index] = center.x;
+    m_centerY[index] = center.y;
+    m_centerZ[index] = center.z;
+    // An infinite radius passes every plane test without a separate branch.
+    m_radius[index] = radius < 0.0F ? std::numeric_limits<float>::infinity() : radius;
+}
+
+size_t OdysseyCuller::cull(const OdysseyFrustum& frustum) {
+    if (m_count <= PARALLEL_GRAIN_SIZE) {
+        m_visibleCount = cullRange(frustum, 0, m_count);
+        return m_visibleCount;
+    }
+    std::atomic<size_t> visibleCount{0};
+    OdysseyThreadPool::instance().parallelFor(m_count, PARALLEL_GRAIN_SIZE, [this, &frustum, &visibleCount](size_t begin, size_t end) {
+        visibleCount += cullRange(frustum, begin, end);
+    });
+    m_visibleCount = visibleCount;
+    return m_visibleCount;
+}
+
+bool OdysseyCuller::isVisible(size_t index) const {
+    return m_visible[index] != 0;
+}
+
+size_t OdysseyCuller::getCount() const {
+    return m_count;
+}
+
+size_t OdysseyCuller::getVisibleCount() const {
+    return m_visibleCount;
+}
+
+size_t OdysseyCuller::cullRange(const OdysseyFrustum& frustum, size_t begin, size_t end) {
+    SphereArrays spheres{m_centerX.data(), m_centerY.data(), m_centerZ.data(), m_radius.data(), m_visible.data()};
+#if defined(ODYSSEY_CULLING_X86)
+    // Chunks start on multiples of PARALLEL_GRAIN_SIZE, so every range is
+    // lane-aligned and may run past end into the padding.
+    static const bool avx = hasAvx();
+    return avx ? cullAvx(spheres, frustum, begin, end) : cullSse(spheres, frustum, begin, end);
+#else
+    return cullScalar(spheres, frustum, begin, end);
+#endif
+}
+
+}  // namespace odyssey
\ No newline at end of file
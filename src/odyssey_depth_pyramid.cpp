@@ -0,0 +1,226 @@
+/**
+ * @file odyssey_depth_pyramid.cpp
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include "odyssey_depth_pyramid.h"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+#include "odyssey_device.h"
+#include "odyssey_swap_chain.h"
+
+namespace odyssey {
+
+OdysseyDepthPyramid::OdysseyDepthPyramid(OdysseyDevice* device) : m_device(device) {
+    vk::SamplerCreateInfo samplerInfo{};
+    samplerInfo
+        .setMagFilter(vk::Filter::eNearest)
+        .setMinFilter(vk::Filter::eNearest)
+        .setMipmapMode(vk::SamplerMipmapMode::eNearest)
+        .setAddressModeU(vk::SamplerAddressMode::eClampToEdge)
+        .setAddressModeV(vk::SamplerAddressMode::eClampToEdge)
+        .setAddressModeW(vk::SamplerAddressMode::eClampToEdge)
+        .setMinLod(0.0F)
+        .setMaxLod(VK_LOD_CLAMP_NONE);
+    m_sampler = m_device->device().createSampler(samplerInfo);
+
+    m_setLayout = OdysseyDescriptorSetLayout::Builder(m_device)
+                      .addBinding(0, vk::DescriptorType::eCombinedImageSampler, vk::ShaderStageFlagBits::eCompute)
+                      .addBinding(1, vk::DescriptorType::eStorageImage, vk::ShaderStageFlagBits::eCompute)
+                      .build();
+    constexpr auto maxSets = static_cast<uint32_t>(OdysseySwapChain::MAX_FRAMES_IN_FLIGHT) * MAX_LEVELS;
+    m_descriptorPool = OdysseyDescriptorPool::Builder(m_device)
+                           .setMaxSets(maxSets)
+                           .setPoolFlags(vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet)
+                           .addPoolSize(vk::DescriptorType::eCombinedImageSampler, maxSets)
+                           .addPoolSize(vk::DescriptorType::eStorageImage, maxSets)
+                           .build();
+
+    vk::PushConstantRange pushConstantRange{};
+    pushConstantRange
+        .setStageFlags(vk::ShaderStageFlagBits::eCompute)
+        .setOffset(0)
+        .setSize(sizeof(PushConstantData));
+    auto setLayout = m_setLayout->getDescriptorSetLayout();
+    vk::PipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo
+        .setSetLayouts(setLayout)
+        .setPushConstantRanges(pushConstantRange);
+    m_pipelineLayout = m_device->device().createPipelineLayout(pipelineLayoutInfo);
+    m_pipeline = std::make_unique<OdysseyComputePipeline>(m_device, "shaders/depth_pyramid.comp.spv", m_pipelineLayout);
+}
+
+OdysseyDepthPyramid::~OdysseyDepthPyramid() {
+    for (auto& frame : m_frames) {
+        destroyFrame(frame);
+    }
+    m_pipeline.reset();
+    m_device->device().destroyPipelineLayout(m_pipelineLayout);
+    m_descriptorPool.reset();
+    m_setLayout.reset();
+    m_device->device().destroySampler(m_sampler);
+}
+
+void OdysseyDepthPyramid::build(vk::CommandBuffer commandBuffer, size_t frameIndex, vk::ImageView depthView, vk::Extent2D depthExtent) {
+    if (m_frames.size() <= frameIndex) {
+        m_frames.resize(frameIndex + 1);
+    }
+    // The caller has waited on this frame's fence, so its pyramid is idle and
+    // can be replaced when the swap chain changed size.
+    auto& frame = m_frames[frameIndex];
+    vk::Extent2D extent{(std::max)((depthExtent.width + 1) / 2, 1U), (std::max)((depthExtent.height + 1) / 2, 1U)};
+    if (frame.extent != extent) {
+        destroyFrame(frame);
+        createFrame(frame, extent);
+    }
+    if (frame.depthView != depthView) {
+        writeLevel(frame.levels[0], depthView, vk::ImageLayout::eDepthStencilReadOnlyOptimal);
+        frame.depthView = depthView;
+    }
+
+    // Last frame's contents are not needed, so every level starts undefined.
+    vk::ImageMemoryBarrier startBarrier{};
+    startBarrier
+        .setOldLayout(vk::ImageLayout::eUndefined)
+        .setNewLayout(vk::ImageLayout::eGeneral)
+        .setSrcAccessMask({})
+        .setDstAccessMask(vk::AccessFlagBits::eShaderWrite)
+        .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+        .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+        .setImage(frame.image);
+    startBarrier.subresourceRange
+        .setAspectMask(vk::ImageAspectFlagBits::eColor)
+        .setBaseMipLevel(0)
+        .setLevelCount(VK_REMAINING_MIP_LEVELS)
+        .setBaseArrayLayer(0)
+        .setLayerCount(1);
+    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eComputeShader, {}, nullptr, nullptr, startBarrier);
+
+    m_pipeline->bind(commandBuffer);
+    auto sourceExtent = depthExtent;
+    for (uint32_t i = 0; i < frame.levels.size(); ++i) {
+        const auto& level = frame.levels[i];
+        PushConstantData push{};
+        push.sourceSize = {static_cast<int>(sourceExtent.width), static_cast<int>(sourceExtent.height)};
+        push.destinationSize = {static_cast<int>(level.extent.width), static_cast<int>(level.extent.height)};
+        commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_pipelineLayout, 0, level.descriptorSet, nullptr);
+        commandBuffer.pushConstants<PushConstantData>(m_pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, push);
+        commandBuffer.dispatch((level.extent.width + 7) / 8, (level.extent.height + 7) / 8, 1);
+
+        // The next level reads this one; after the last level the culling
+        // shader reads all of them.
+        vk::ImageMemoryBarrier levelBarrier{startBarrier};
+        levelBarrier
+            .setOldLayout(vk::ImageLayout::eGeneral)
+            .setNewLayout(vk::ImageLayout::eGeneral)
+            .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+            .setDstAccessMask(vk::AccessFlagBits::eShaderRead);
+        levelBarrier.subresourceRange
+            .setBaseMipLevel(i)
+            .setLevelCount(1);
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader, {}, nullptr, nullptr, levelBarrier);
+        sourceExtent = level.extent;
+    }
+}
+
+vk::DescriptorImageInfo OdysseyDepthPyramid::descriptorInfo(size_t frameIndex) const {
+    return {m_sampler, m_frames.at(frameIndex).view, vk::ImageLayout::eGeneral};
+}
+
+vk::ImageView OdysseyDepthPyramid::getImageView(size_t frameIndex) const {
+    return frameIndex < m_frames.size() ? m_frames[frameIndex].view : vk::ImageView{};
+}
+
+vk::Extent2D OdysseyDepthPyramid::getExtent(size_t frameIndex) const {
+    return frameIndex < m_frames.size() ? m_frames[frameIndex].extent : vk::Extent2D{};
+}
+
+void OdysseyDepthPyramid::createFrame(Frame& frame, vk::Extent2D extent) {
+    auto levelCount = (std::min)(static_cast<uint32_t>(std::bit_width((std::max)(extent.width, extent.height))), MAX_LEVELS);
+    vk::ImageCreateInfo imageInfo{};
+    imageInfo
+        .setImageType(vk::ImageType::e2D)
+        .setMipLevels(levelCount)
+        .setArrayLayers(1)
+        .setFormat(vk::Format::eR32Sfloat)
+        .setTiling(vk::ImageTiling::eOptimal)
+        .setInitialLayout(vk::ImageLayout::eUndefined)
+        .setUsage(vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eStorage)
+        .setSharingMode(vk::SharingMode::eExclusive)
+        .setSamples(vk::SampleCountFlagBits::e1)
+        .setExtent({extent.width, extent.height, 1});
+    frame.image = m_device->device().createImage(imageInfo);
+    auto memoryRequirements = m_device->device().getImageMemoryRequirements(frame.image);
+    vk::MemoryAllocateInfo allocateInfo{};
+    allocateInfo
+        .setAllocationSize(memoryRequirements.size)
+        .setMemoryTypeIndex(m_device->findMemoryType(memoryRequirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal));
+    frame.memory = m_device->device().allocateMemory(allocateInfo);
+    m_device->device().bindImageMemory(frame.image, frame.memory, 0);
+
+    auto createView = [this, &frame](uint32_t baseLevel, uint32_t levels) {
+        vk::ImageViewCreateInfo viewInfo{};
+        viewInfo
+            .setImage(frame.image)
+            .setViewType(vk::ImageViewType::e2D)
+            .setFormat(vk::Format::eR32Sfloat);
+        viewInfo.subresourceRange
+            .setAspectMask(vk::ImageAspectFlagBits::eColor)
+            .setBaseMipLevel(baseLevel)
+            .setLevelCount(levels)
+            .setBaseArrayLayer(0)
+            .setLayerCount(1);
+        return m_device->device().createImageView(viewInfo);
+    };
+    frame.view = createView(0, levelCount);
+    frame.extent = extent;
+    frame.levels.resize(levelCount);
+    for (uint32_t i = 0; i < levelCount; ++i) {
+        auto& level = frame.levels[i];
+        level.view = createView(i, 1);
+        level.extent = vk::Extent2D{(std::max)(extent.width >> i, 1U), (std::max)(extent.height >> i, 1U)};
+        if (i > 0) {
+            writeLevel(level, frame.levels[i - 1].view, vk::ImageLayout::eGeneral);
+        }
+    }
+    frame.depthView = nullptr;
+}
+
+void OdysseyDepthPyramid::destroyFrame(Frame& frame) {
+    std::vector<vk::DescriptorSet> descriptorSets{};
+    for (auto& level : frame.levels) {
+        if (level.descriptorSet) {
+            descriptorSets.push_back(level.descriptorSet);
+        }
+        m_device->device().destroyImageView(level.view);
+    }
+    if (!descriptorSets.empty()) {
+        m_descriptorPool->freeDescriptors(descriptorSets);
+    }
+    if (frame.view) {
+        m_device->device().destroyImageView(frame.view);
+        m_device->device().destroyImage(frame.image);
+        m_device->device().freeMemory(frame.memory);
+    }
+    frame = Frame{};
+}
+
+void OdysseyDepthPyramid::writeLevel(Level& level, vk::ImageView source, vk::ImageLayout sourceLayout) {
+    vk::DescriptorImageInfo sourceInfo{m_sampler, source, sourceLayout};
+    vk::DescriptorImageInfo destinationInfo{nullptr, level.view, vk::ImageLayout::eGeneral};
+    OdysseyDescriptorWriter writer(*m_setLayout, *m_descriptorPool);
+    writer
+        .writeImage(0, &sourceInfo)
+        .writeImage(1, &destinationInfo);
+    if (level.descriptorSet) {
+        writer.overwrite(level.descriptorSet);
+    } else if (!writer.build(level.descriptorSet)) {
+        throw std::runtime_error("Failed to allocate depth pyramid descriptor set.");
+    }
+}
+
+}  // namespace odyssey
\ No newline at end of file
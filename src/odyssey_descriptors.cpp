@@ -0,0 +1,148 @@
+/**
+ * @file odyssey_descriptors.cpp
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include "odyssey_descriptors.h"
+
+#include <stdexcept>
+
+#include "odyssey_device.h"
+
+namespace odyssey {
+
+OdysseyDescriptorSetLayout::Builder& OdysseyDescriptorSetLayout::Builder::addBinding(uint32_t binding, vk::DescriptorType descriptorType, vk::ShaderStageFlags stageFlags, uint32_t count) {
+    if (m_bindings.contains(binding)) {
+        throw std::runtime_error("Descriptor binding already in use.");
+    }
+    vk::DescriptorSetLayoutBinding layoutBinding{};
+    layoutBinding
+        .setBinding(binding)
+        .setDescriptorType(descriptorType)
+        .setDescriptorCount(count)
+        .setStageFlags(stageFlags);
+    m_bindings[binding] = layoutBinding;
+    return *this;
+}
+
+std::unique_ptr<OdysseyDescriptorSetLayout> OdysseyDescriptorSetLayout::Builder::build() const {
+    return std::make_unique<OdysseyDescriptorSetLayout>(m_device, m_bindings);
+}
+
+OdysseyDescriptorSetLayout::OdysseyDescriptorSetLayout(OdysseyDevice* device, const std::unordered_map<uint32_t, vk::DescriptorSetLayoutBinding>& bindings) : m_device(device), m_bindings(bindings) {
+    std::vector<vk::DescriptorSetLayoutBinding> setLayoutBindings{};
+    for (const auto& [binding, layoutBinding] : bindings) {
+        setLayoutBindings.push_back(layoutBinding);
+    }
+    vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutInfo{};
+    descriptorSetLayoutInfo
+        .setBindingCount(static_cast<uint32_t>(setLayoutBindings.size()))
+        .setBindings(setLayoutBindings);
+    m_descriptorSetLayout = m_device->device().createDescriptorSetLayout(descriptorSetLayoutInfo);
+}
+
+OdysseyDescriptorSetLayout::~OdysseyDescriptorSetLayout() {
+    m_device->device().destroyDescriptorSetLayout(m_descriptorSetLayout);
+}
+
+vk::DescriptorSetLayout OdysseyDescriptorSetLayout::getDescriptorSetLayout() const {
+    return m_descriptorSetLayout;
+}
+
+OdysseyDescriptorPool::Builder& OdysseyDescriptorPool::Builder::addPoolSize(vk::DescriptorType descriptorType, uint32_t count) {
+    m_poolSizes.push_back({descriptorType, count});
+    return *this;
+}
+
+OdysseyDescriptorPool::Builder& OdysseyDescriptorPool::Builder::setPoolFlags(vk::DescriptorPoolCreateFlags flags) {
+    m_poolFlags = flags;
+    return *this;
+}
+
+OdysseyDescriptorPool::Builder& OdysseyDescriptorPool::Builder::setMaxSets(uint32_t count) {
+    m_maxSets = count;
+    return *this;
+}
+
+std::unique_ptr<OdysseyDescriptorPool> OdysseyDescriptorPool::Builder::build() const {
+    return std::make_unique<OdysseyDescriptorPool>(m_device, m_maxSets, m_poolFlags, m_poolSizes);
+}
+
+OdysseyDescriptorPool::OdysseyDescriptorPool(OdysseyDevice* device, uint32_t maxSets, vk::DescriptorPoolCreateFlags poolFlags, const std::vector<vk::DescriptorPoolSize>& poolSizes) : m_device(device) {
+    vk::DescriptorPoolCreateInfo descriptorPoolInfo{};
+    descriptorPoolInfo
+        .setPoolSizeCount(static_cast<uint32_t>(poolSizes.size()))
+        .setPoolSizes(poolSizes)
+        .setMaxSets(maxSets)
+        .setFlags(poolFlags);
+    m_descriptorPool = m_device->device().createDescriptorPool(descriptorPoolInfo);
+}
+
+OdysseyDescriptorPool::~OdysseyDescriptorPool() {
+    m_device->device().destroyDescriptorPool(m_descriptorPool);
+}
+
+bool OdysseyDescriptorPool::allocateDescriptorSet(vk::DescriptorSetLayout descriptorSetLayout, vk::DescriptorSet& descriptorSet) const {
+    vk::DescriptorSetAllocateInfo allocInfo{};
+    allocInfo
+        .setDescriptorPool(m_descriptorPool)
+        .setDescriptorSetCount(1)
+        .setSetLayouts(descriptorSetLayout);
+    // Pool exhaustion is reported to the caller rather than thrown, so a
+    // pool manager can allocate a new pool and retry.
+    auto result = m_device->device().allocateDescriptorSets(&allocInfo, &descriptorSet);
+    return result == vk::Result::eSuccess;
+}
+
+void OdysseyDescriptorPool::freeDescriptors(const std::vector<vk::DescriptorSet>& descriptorSets) const {
+    m_device->device().freeDescriptorSets(m_descriptorPool, descriptorSets);
+}
+
+void OdysseyDescriptorPool::resetPool() {
+    m_device->device().resetDescriptorPool(m_descriptorPool);
+}
+
+OdysseyDescriptorWriter::OdysseyDescriptorWriter(OdysseyDescriptorSetLayout& setLayout, OdysseyDescriptorPool& pool) : m_setLayout(setLayout), m_pool(pool) {
+}
+
+OdysseyDescriptorWriter& OdysseyDescriptorWriter::writeBuffer(uint32_t binding, const vk::DescriptorBufferInfo* bufferInfo) {
+    const auto& bindingDescription = m_setLayout.m_bindings.at(binding);
+    vk::WriteDescriptorSet write{};
+    write
+        .setDescriptorType(bindingDescription.descriptorType)
+        .setDstBinding(binding)
+        .setPBufferInfo(bufferInfo)
+        .setDescriptorCount(1);
+    m_writes.push_back(write);
+    return *this;
+}
+
+OdysseyDescriptorWriter& OdysseyDescriptorWriter::writeImage(uint32_t binding, const vk::DescriptorImageInfo* imageInfo) {
+    const auto& bindingDescription = m_setLayout.m_bindings.at(binding);
+    vk::WriteDescriptorSet write{};
+    write
+        .setDescriptorType(bindingDescription.descriptorType)
+        .setDstBinding(binding)
+        .setPImageInfo(imageInfo)
+        .setDescriptorCount(1);
+    m_writes.push_back(write);
+    return *this;
+}
+
+bool OdysseyDescriptorWriter::build(vk::DescriptorSet& set) {
+    if (!m_pool.allocateDescriptorSet(m_setLayout.getDescriptorSetLayout(), set)) {
+        return false;
+    }
+    overwrite(set);
+    return true;
+}
+
+void OdysseyDescriptorWriter::overwrite(const vk::DescriptorSet& set) {
+    for (auto& write : m_writes) {
+        write.setDstSet(set);
+    }
+    m_pool.m_device->device().updateDescriptorSets(m_writes, nullptr);
+}
+
+}  // namespace odyssey
\ No newline at end of file
@@ -6,7 +6,9 @@
 
 #include "odyssey_device.h"
 
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <stdexcept>
 #include <string>
 #include <unordered_set>
@@ -25,11 +27,14 @@ OdysseyDevice::OdysseyDevice(const vk::Win32SurfaceCreateInfoKHR& surfaceInfo) {
     pickPhysicalDevice();
     createLogicalDevice();
     createCommandPool();
+    createPipelineCache();
 }
 #endif
 
 OdysseyDevice::~OdysseyDevice() {
     m_device.waitIdle();
+    savePipelineCache();
+    m_device.destroyPipelineCache(m_pipelineCache);
     m_device.destroyCommandPool(m_commandPool);
     m_device.destroy();
     if (m_enableValidationLayers) {
@@ -121,6 +126,10 @@ const vk::CommandPool& OdysseyDevice::getCommandPool() const {
     return m_commandPool;
 }
 
+const vk::PipelineCache& OdysseyDevice::getPipelineCache() const {
+    return m_pipelineCache;
+}
+
 void OdysseyDevice::createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties, vk::Buffer& buffer, vk::DeviceMemory& memory) {
     vk::BufferCreateInfo bufferInfo{};
     bufferInfo
@@ -178,7 +187,8 @@ void OdysseyDevice::createInstance() {
     vk::ApplicationInfo appInfo{};
     appInfo
         .setPApplicationName("Odyssey")
-        .setPEngineName("No Engine");
+        .setPEngineName("No Engine")
+        .setApiVersion(VK_API_VERSION_1_2);
 
     auto extensions = getRequiredExtensions();
 
@@ -218,6 +228,7 @@ void OdysseyDevice::pickPhysicalDevice() {
     for (const auto& device : devices) {
         if (isPhysicalDeviceSuitable(device)) {
             m_physical = device;
+            m_properties = device.getProperties();
             return;
         }
     }
@@ -245,15 +256,30 @@ void OdysseyDevice::createLogicalDevice() {
         queueCreateInfo.setQueueFamilyIndex(indices.presentFamily);
         queueCreateInfos.push_back(queueCreateInfo);
     }
+    // Indirect drawing features are optional; renderers check the supports*()
+    // queries and fall back to CPU-recorded draws when they are missing.
+    auto supportedFeatures = m_physical.getFeatures();
     vk::PhysicalDeviceFeatures deviceFeatures{};
-    deviceFeatures.setSamplerAnisotropy(true);
+    deviceFeatures
+        .setSamplerAnisotropy(true)
+        .setMultiDrawIndirect(supportedFeatures.multiDrawIndirect)
+        .setDrawIndirectFirstInstance(supportedFeatures.drawIndirectFirstInstance);
+    m_multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+    m_drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance;
+    vk::PhysicalDeviceVulkan12Features vulkan12Features{};
+    if (m_properties.apiVersion >= VK_API_VERSION_1_2) {
+        auto supportedFeatures2 = m_physical.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+        m_drawIndirectCount = supportedFeatures2.get<vk::PhysicalDeviceVulkan12Features>().drawIndirectCount;
+        vulkan12Features.setDrawIndirectCount(m_drawIndirectCount);
+    }
     vk::DeviceCreateInfo deviceCreateInfo{};
     deviceCreateInfo
         .setQueueCreateInfoCount(static_cast<uint32_t>(queueCreateInfos.size()))
         .setQueueCreateInfos(queueCreateInfos)
         .setEnabledExtensionCount(static_cast<uint32_t>(m_deviceExtensions.size()))
         .setPEnabledExtensionNames(m_deviceExtensions)
-        .setPEnabledFeatures(&deviceFeatures);
+        .setPEnabledFeatures(&deviceFeatures)
+        .setPNext(m_properties.apiVersion >= VK_API_VERSION_1_2 ? &vulkan12Features : nullptr);
     m_device = m_physical.createDevice(deviceCreateInfo);
     m_graphicsQueue = m_device.getQueue(indices.graphicsFamily, 0);
     m_presentQueue = m_device.getQueue(indices.presentFamily, 0);
@@ -268,6 +294,28 @@ void OdysseyDevice::createCommandPool() {
     m_commandPool = m_device.createCommandPool(poolInfo);
 }
 
+void OdysseyDevice::createPipelineCache() {
+    // The driver validates the header and ignores data from another device or driver version.
+    std::ifstream file(PIPELINE_CACHE_PATH, std::ios::binary);
+    std::vector<char> data{};
+    if (file.is_open()) {
+        data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    vk::PipelineCacheCreateInfo cacheInfo{};
+    cacheInfo
+        .setInitialDataSize(data.size())
+        .setPInitialData(data.data());
+    m_pipelineCache = m_device.createPipelineCache(cacheInfo);
+}
+
+void OdysseyDevice::savePipelineCache() const {
+    auto data = m_device.getPipelineCacheData(m_pipelineCache);
+    std::ofstream file(PIPELINE_CACHE_PATH, std::ios::binary | std::ios::trunc);
+    if (file.is_open()) {
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+}
+
 bool OdysseyDevice::checkValidationLayerSupport() {
     auto availableLayers = vk::enumerateInstanceLayerProperties();
     for (const auto& layerName : m_validationLayers_) {
@@ -380,6 +428,36 @@ uint32_t OdysseyDevice::findMemoryType(uint32_t type_filter, vk::MemoryPropertyF
     return 0;
 }
 
+bool OdysseyDevice::supportsMemoryProperties(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const {
+    auto memoryProperties = m_physical.getMemoryProperties();
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i) {
+        if ((typeFilter & (1U << i)) && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const vk::PhysicalDeviceProperties& OdysseyDevice::getProperties() const {
+    return m_properties;
+}
+
+vk::FormatProperties OdysseyDevice::getFormatProperties(vk::Format format) const {
+    return m_physical.getFormatProperties(format);
+}
+
+bool OdysseyDevice::supportsMultiDrawIndirect() const {
+    return m_multiDrawIndirect;
+}
+
+bool OdysseyDevice::supportsDrawIndirectFirstInstance() const {
+    return m_drawIndirectFirstInstance;
+}
+
+bool OdysseyDevice::supportsDrawIndirectCount() const {
+    return m_drawIndirectCount;
+}
+
 #if !defined(NODEBUG)
 
 VKAPI_ATTR VkBool32 VKAPI_CALL OdysseyDevice::debugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity, VkDebugUtilsMessageTypeFlagsEXT messageType, const VkDebugUtilsMessengerCallbackDataEXT* callbackData, [[maybe_unused]] void* userData) {
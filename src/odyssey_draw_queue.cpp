@@ -0,0 +1,75 @@
+/**
+ * @file odyssey_draw_queue.cpp
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include "odyssey_draw_queue.h"
+
+#include <algorithm>
+#include <array>
+
+namespace odyssey {
+
+void OdysseyDrawQueue::clear() {
+    m_packets.clear();
+}
+
+void OdysseyDrawQueue::reserve(size_t count) {
+    m_packets.reserve(count);
+}
+
+void OdysseyDrawQueue::push(uint64_t key, uint32_t index) {
+    m_packets.push_back({key, index});
+}
+
+void OdysseyDrawQueue::sort() {
+    constexpr size_t DIGIT_BITS{8};
+    constexpr size_t DIGITS{64 / DIGIT_BITS};
+    constexpr size_t BUCKETS{size_t{1} << DIGIT_BITS};
+    if (m_packets.size() < 2) {
+        return;
+    }
+    // All eight histograms come from one read of the keys. A digit every key
+    // shares, such as the pipeline and material bytes while those are unused,
+    // would move every packet to where it already is, so its pass is skipped.
+    std::array<std::array<uint32_t, BUCKETS>, DIGITS> histograms{};
+    for (const auto& packet : m_packets) {
+        for (size_t digit = 0; digit < DIGITS; ++digit) {
+            ++histograms[digit][(packet.key >> (digit * DIGIT_BITS)) & (BUCKETS - 1)];
+        }
+    }
+    m_scratch.resize(m_packets.size());
+    for (size_t digit = 0; digit < DIGITS; ++digit) {
+        auto& histogram = histograms[digit];
+        auto shift = digit * DIGIT_BITS;
+        if (histogram[(m_packets.front().key >> shift) & (BUCKETS - 1)] == m_packets.size()) {
+            continue;
+        }
+        uint32_t offset{0};
+        for (auto& count : histogram) {
+            auto bucketSize = count;
+            count = offset;
+            offset += bucketSize;
+        }
+        for (const auto& packet : m_packets) {
+            m_scratch[histogram[(packet.key >> shift) & (BUCKETS - 1)]++] = packet;
+        }
+        m_packets.swap(m_scratch);
+    }
+}
+
+const std::vector<OdysseyDrawPacket>& OdysseyDrawQueue::getPackets() const {
+    return m_packets;
+}
+
+uint64_t OdysseyDrawQueue::makeKey(uint32_t pipeline, uint32_t material, uint32_t model, float depth) {
+    constexpr auto DEPTH_MAX = (uint64_t{1} << DEPTH_BITS) - 1;
+    auto quantizedDepth = static_cast<uint64_t>(std::clamp(depth, 0.0F, 1.0F) * static_cast<float>(DEPTH_MAX));
+    uint64_t key = pipeline & ((1U << PIPELINE_BITS) - 1);
+    key = (key << MATERIAL_BITS) | (material & ((1U << MATERIAL_BITS) - 1));
+    key = (key << MODEL_BITS) | (model & ((1U << MODEL_BITS) - 1));
+    return (key << DEPTH_BITS) | quantizedDepth;
+}
+
+}  // namespace odyssey
\ No newline at end of file
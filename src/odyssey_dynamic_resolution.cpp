@@ -0,0 +1,204 @@
+/**
+ * @file odyssey_dynamic_resolution.cpp
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include "odyssey_dynamic_resolution.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+
+#include "odyssey_device.h"
+#include "odyssey_profiler.h"
+#include "odyssey_swap_chain.h"
+
+namespace odyssey {
+
+OdysseyDynamicResolution::OdysseyDynamicResolution(OdysseyDevice* device, const OdysseyResolutionPolicy& policy, vk::Format colorFormat, bool sampledDepth, vk::RenderPass renderPass, vk::RenderPass presentRenderPass)
+    : m_device(device), m_policy(policy), m_colorFormat(colorFormat), m_depthFormat(OdysseySwapChain::findDepthFormat(device)), m_sampledDepth(sampledDepth), m_renderPass(renderPass), m_targetScale(policy.maxScale), m_scale(policy.maxScale) {
+    m_frames.resize(OdysseySwapChain::MAX_FRAMES_IN_FLIGHT);
+    vk::SamplerCreateInfo samplerInfo{};
+    samplerInfo
+        .setMagFilter(vk::Filter::eLinear)
+        .setMinFilter(vk::Filter::eLinear)
+        .setMipmapMode(vk::SamplerMipmapMode::eNearest)
+        .setAddressModeU(vk::SamplerAddressMode::eClampToEdge)
+        .setAddressModeV(vk::SamplerAddressMode::eClampToEdge)
+        .setAddressModeW(vk::SamplerAddressMode::eClampToEdge)
+        .setMinLod(0.0F)
+        .setMaxLod(0.0F);
+    m_sampler = m_device->device().createSampler(samplerInfo);
+    m_setLayout = OdysseyDescriptorSetLayout::Builder(m_device)
+                      .addBinding(0, vk::DescriptorType::eCombinedImageSampler, vk::ShaderStageFlagBits::eFragment)
+                      .build();
+    constexpr auto maxSets = static_cast<uint32_t>(OdysseySwapChain::MAX_FRAMES_IN_FLIGHT);
+    m_descriptorPool = OdysseyDescriptorPool::Builder(m_device)
+                           .setMaxSets(maxSets)
+                           .addPoolSize(vk::DescriptorType::eCombinedImageSampler, maxSets)
+                           .build();
+    createPipeline(presentRenderPass);
+    OdysseyProfiler::instance().setCounter("render scale", m_scale);
+}
+
+OdysseyDynamicResolution::~OdysseyDynamicResolution() {
+    for (auto& frame : m_frames) {
+        destroyFrame(frame);
+    }
+    m_pipeline.reset();
+    m_device->device().destroyPipelineLayout(m_pipelineLayout);
+    m_descriptorPool.reset();
+    m_setLayout.reset();
+    m_device->device().destroySampler(m_sampler);
+}
+
+void OdysseyDynamicResolution::beginFrame(size_t frameIndex, vk::Extent2D presentExtent) {
+    auto& frame = m_frames.at(frameIndex);
+    auto scaled = [&presentExtent](float scale, bool roundUp) {
+        auto toPixels = [roundUp](float value) {
+            return static_cast<uint32_t>(roundUp ? std::ceil(value) : std::round(value));
+        };
+        return vk::Extent2D{
+            (std::max)(toPixels(static_cast<float>(presentExtent.width) * scale), 1U),
+            (std::max)(toPixels(static_cast<float>(presentExtent.height) * scale), 1U),
+        };
+    };
+    // The frame's fence has been waited on, so its targets are idle.
+    auto targetExtent = scaled(m_policy.maxScale, true);
+    if (frame.targetExtent != targetExtent) {
+        destroyFrame(frame);
+        createFrame(frame, targetExtent);
+    }
+    frame.scale = m_scale;
+    auto extent = scaled(m_scale, false);
+    frame.extent = vk::Extent2D{(std::min)(extent.width, targetExtent.width), (std::min)(extent.height, targetExtent.height)};
+}
+
+void OdysseyDynamicResolution::update(size_t frameIndex, double gpuFrameTime) {
+    if (frameIndex >= m_frames.size() || gpuFrameTime <= 0.0) {
+        return;
+    }
+    // GPU time is taken to follow the pixel count, the square of the scale
+    // the measured frame was rendered at.
+    auto measured = m_frames[frameIndex].scale * static_cast<float>(std::sqrt(m_policy.targetFrameTime / gpuFrameTime));
+    m_targetScale = std::clamp(m_targetScale + (measured - m_targetScale) * SMOOTHING, m_policy.minScale, m_policy.maxScale);
+    m_scale = std::clamp(std::round(m_targetScale / SCALE_STEP) * SCALE_STEP, m_policy.minScale, m_policy.maxScale);
+    OdysseyProfiler::instance().setCounter("render scale", m_scale);
+}
+
+void OdysseyDynamicResolution::upscale(vk::CommandBuffer commandBuffer, size_t frameIndex) {
+    const auto& frame = m_frames.at(frameIndex);
+    glm::vec2 targetSize{static_cast<float>(frame.targetExtent.width), static_cast<float>(frame.targetExtent.height)};
+    glm::vec2 size{static_cast<float>(frame.extent.width), static_cast<float>(frame.extent.height)};
+    PushConstantData push{};
+    push.uvScale = size / targetSize;
+    push.uvMax = (size - 0.5F) / targetSize;
+    m_pipeline->bind(commandBuffer);
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_pipelineLayout, 0, frame.descriptorSet, nullptr);
+    commandBuffer.pushConstants<PushConstantData>(m_pipelineLayout, vk::ShaderStageFlagBits::eFragment, 0, push);
+    commandBuffer.draw(3, 1, 0, 0);
+}
+
+float OdysseyDynamicResolution::getScale() const {
+    return m_scale;
+}
+
+vk::Extent2D OdysseyDynamicResolution::getExtent(size_t frameIndex) const {
+    return m_frames.at(frameIndex).extent;
+}
+
+vk::Framebuffer OdysseyDynamicResolution::getFramebuffer(size_t frameIndex) const {
+    return m_frames.at(frameIndex).framebuffer;
+}
+
+vk::Image OdysseyDynamicResolution::getColorImage(size_t frameIndex) const {
+    return m_frames.at(frameIndex).colorImage;
+}
+
+vk::ImageView OdysseyDynamicResolution::getColorImageView(size_t frameIndex) const {
+    return m_frames.at(frameIndex).colorView;
+}
+
+vk::Image OdysseyDynamicResolution::getDepthImage(size_t frameIndex) const {
+    return m_frames.at(frameIndex).depthImage;
+}
+
+vk::ImageView OdysseyDynamicResolution::getDepthImageView(size_t frameIndex) const {
+    return m_frames.at(frameIndex).depthView;
+}
+
+void OdysseyDynamicResolution::createFrame(Frame& frame, vk::Extent2D targetExtent) {
+    m_device->createImage(targetExtent.width, targetExtent.height, m_colorFormat, vk::ImageTiling::eOptimal, vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled, vk::MemoryPropertyFlagBits::eDeviceLocal, frame.colorImage, frame.colorMemory);
+    frame.colorView = m_device->createImageView(frame.colorImage, m_colorFormat, vk::ImageAspectFlagBits::eColor);
+    // The depth pyramid samples depth when occlusion culling is on.
+    vk::ImageUsageFlags depthUsage = vk::ImageUsageFlagBits::eDepthStencilAttachment;
+    if (m_sampledDepth) {
+        depthUsage |= vk::ImageUsageFlagBits::eSampled;
+    }
+    m_device->createImage(targetExtent.width, targetExtent.height, m_depthFormat, vk::ImageTiling::eOptimal, depthUsage, vk::MemoryPropertyFlagBits::eDeviceLocal, frame.depthImage, frame.depthMemory);
+    frame.depthView = m_device->createImageView(frame.depthImage, m_depthFormat, vk::ImageAspectFlagBits::eDepth);
+
+    std::array<vk::ImageView, 2> attachments{frame.colorView, frame.depthView};
+    vk::FramebufferCreateInfo framebufferInfo{};
+    framebufferInfo
+        .setRenderPass(m_renderPass)
+        .setAttachments(attachments)
+        .setWidth(targetExtent.width)
+        .setHeight(targetExtent.height)
+        .setLayers(1);
+    frame.framebuffer = m_device->device().createFramebuffer(framebufferInfo);
+    frame.targetExtent = targetExtent;
+
+    vk::DescriptorImageInfo colorInfo{m_sampler, frame.colorView, vk::ImageLayout::eShaderReadOnlyOptimal};
+    OdysseyDescriptorWriter writer(*m_setLayout, *m_descriptorPool);
+    writer.writeImage(0, &colorInfo);
+    // Sets outlive the images, so a resize only points them at the new ones.
+    if (frame.descriptorSet) {
+        writer.overwrite(frame.descriptorSet);
+    } else if (!writer.build(frame.descriptorSet)) {
+        throw std::runtime_error("Failed to allocate upscale descriptor set.");
+    }
+}
+
+void OdysseyDynamicResolution::destroyFrame(Frame& frame) {
+    if (frame.framebuffer) {
+        m_device->device().destroyFramebuffer(frame.framebuffer);
+        m_device->device().destroyImageView(frame.colorView);
+        m_device->device().destroyImage(frame.colorImage);
+        m_device->device().freeMemory(frame.colorMemory);
+        m_device->device().destroyImageView(frame.depthView);
+        m_device->device().destroyImage(frame.depthImage);
+        m_device->device().freeMemory(frame.depthMemory);
+    }
+    frame = Frame{.descriptorSet = frame.descriptorSet};
+}
+
+void OdysseyDynamicResolution::createPipeline(vk::RenderPass presentRenderPass) {
+    vk::PushConstantRange pushConstantRange{};
+    pushConstantRange
+        .setStageFlags(vk::ShaderStageFlagBits::eFragment)
+        .setOffset(0)
+        .setSize(sizeof(PushConstantData));
+    auto setLayout = m_setLayout->getDescriptorSetLayout();
+    vk::PipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo
+        .setSetLayouts(setLayout)
+        .setPushConstantRanges(pushConstantRange);
+    m_pipelineLayout = m_device->device().createPipelineLayout(pipelineLayoutInfo);
+
+    // One triangle over the whole screen, built from the vertex index.
+    auto config = OdysseyPipeline::defaultPipelineConfigInfo();
+    config.bindingDescriptions.clear();
+    config.attributeDescriptions.clear();
+    config.rasterizationInfo.setCullMode(vk::CullModeFlagBits::eNone);
+    config.depthStencilInfo
+        .setDepthTestEnable(false)
+        .setDepthWriteEnable(false);
+    config.renderPass = presentRenderPass;
+    config.pipelineLayout = m_pipelineLayout;
+    m_pipeline = std::make_unique<OdysseyPipeline>(m_device, "shaders/upscale.vert.spv", "shaders/upscale.frag.spv", config);
+}
+
+}  // namespace odyssey
\ No newline at end of file
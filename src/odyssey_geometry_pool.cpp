@@ -0,0 +1,99 @@
+/**
+ * @file odyssey_geometry_pool.cpp
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include "odyssey_geometry_pool.h"
+
+#include <algorithm>
+#include <bit>
+
+#include "odyssey_device.h"
+
+namespace odyssey {
+
+OdysseyGeometryPool::OdysseyGeometryPool(OdysseyDevice* device) : m_device(device) {
+}
+
+uint32_t OdysseyGeometryPool::addModel(const std::shared_ptr<OdysseyModel>& model) {
+    if (auto iter = m_meshIndices.find(model.get()); iter != m_meshIndices.end()) {
+        return iter->second;
+    }
+    if (!model->hasIndexBuffer()) {
+        m_meshIndices.emplace(model.get(), INVALID_MESH);
+        return INVALID_MESH;
+    }
+    reserve(m_vertexCount + model->getVertexCount(), m_indexCount + model->getIndexCount());
+
+    auto commandBuffer = m_device->beginSingleTimeCommands();
+    vk::BufferCopy vertexRegion{};
+    vertexRegion
+        .setDstOffset(m_vertexCount * sizeof(OdysseyModel::Vertex))
+        .setSize(model->getVertexCount() * sizeof(OdysseyModel::Vertex));
+    commandBuffer.copyBuffer(model->getVertexBuffer(), m_vertexBuffer->getBuffer(), vertexRegion);
+    vk::BufferCopy indexRegion{};
+    indexRegion
+        .setDstOffset(m_indexCount * sizeof(uint32_t))
+        .setSize(model->getIndexCount() * sizeof(uint32_t));
+    commandBuffer.copyBuffer(model->getIndexBuffer(), m_indexBuffer->getBuffer(), indexRegion);
+    m_device->endSingleTimeCommands(commandBuffer);
+
+    auto meshIndex = static_cast<uint32_t>(m_meshes.size());
+    m_meshes.push_back({model->getIndexCount(), m_indexCount, static_cast<int32_t>(m_vertexCount), 0});
+    m_models.push_back(model);
+    m_meshIndices.emplace(model.get(), meshIndex);
+    m_vertexCount += model->getVertexCount();
+    m_indexCount += model->getIndexCount();
+    ++m_version;
+    return meshIndex;
+}
+
+void OdysseyGeometryPool::bind(vk::CommandBuffer commandBuffer) const {
+    if (!m_vertexBuffer) {
+        return;
+    }
+    commandBuffer.bindVertexBuffers(0, m_vertexBuffer->getBuffer(), {0});
+    commandBuffer.bindIndexBuffer(m_indexBuffer->getBuffer(), 0, vk::IndexType::eUint32);
+}
+
+const std::vector<OdysseyMeshRange>& OdysseyGeometryPool::getMeshes() const {
+    return m_meshes;
+}
+
+uint64_t OdysseyGeometryPool::getVersion() const {
+    return m_version;
+}
+
+void OdysseyGeometryPool::reserve(uint32_t vertexCount, uint32_t indexCount) {
+    auto grow = [this](std::unique_ptr<OdysseyBuffer>& buffer, vk::DeviceSize elementSize, uint32_t used, uint32_t required, vk::BufferUsageFlags usage) {
+        if (buffer && buffer->getInstanceCount() >= required) {
+            return;
+        }
+        auto replacement = createBuffer(m_device, elementSize, std::bit_ceil((std::max)(required, 1024U)), usage);
+        if (buffer && used > 0) {
+            // Draws recorded against the old buffer may still be in flight.
+            m_device->device().waitIdle();
+            auto commandBuffer = m_device->beginSingleTimeCommands();
+            vk::BufferCopy region{};
+            region.setSize(used * elementSize);
+            commandBuffer.copyBuffer(buffer->getBuffer(), replacement->getBuffer(), region);
+            m_device->endSingleTimeCommands(commandBuffer);
+        }
+        buffer = std::move(replacement);
+        ++m_version;
+    };
+    grow(m_vertexBuffer, sizeof(OdysseyModel::Vertex), m_vertexCount, vertexCount, vk::BufferUsageFlagBits::eVertexBuffer);
+    grow(m_indexBuffer, sizeof(uint32_t), m_indexCount, indexCount, vk::BufferUsageFlagBits::eIndexBuffer);
+}
+
+std::unique_ptr<OdysseyBuffer> OdysseyGeometryPool::createBuffer(OdysseyDevice* device, vk::DeviceSize elementSize, uint32_t capacity, vk::BufferUsageFlags usage) {
+    return std::make_unique<OdysseyBuffer>(
+        device,
+        elementSize,
+        capacity,
+        usage | vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst,
+        vk::MemoryPropertyFlagBits::eDeviceLocal);
+}
+
+}  // namespace odyssey
\ No newline at end of file
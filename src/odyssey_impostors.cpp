@@ -0,0 +1,310 @@
+/**
+ * @file odyssey_impostors.cpp
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include "odyssey_impostors.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+#include "odyssey_device.h"
+#include "odyssey_swap_chain.h"
+
+namespace odyssey {
+
+namespace {
+
+constexpr uint32_t ATLAS_SIZE{OdysseyImpostors::FRAMES_PER_AXIS * OdysseyImpostors::FRAME_SIZE};
+
+}  // namespace
+
+OdysseyImpostors::OdysseyImpostors(OdysseyDevice* device) : m_device(device) {
+    m_retired.resize(OdysseySwapChain::MAX_FRAMES_IN_FLIGHT);
+    createRenderPass();
+    createBakeResources();
+}
+
+OdysseyImpostors::~OdysseyImpostors() {
+    for (auto& [model, images] : m_atlases) {
+        destroyAtlas(images);
+    }
+    for (auto& retired : m_retired) {
+        for (auto& images : retired) {
+            destroyAtlas(images);
+        }
+    }
+    m_descriptorPool.reset();
+    m_setLayout.reset();
+    m_device->device().destroySampler(m_sampler);
+    m_bakePipeline.reset();
+    m_device->device().destroyPipelineLayout(m_bakePipelineLayout);
+    m_device->device().destroyImageView(m_depthView);
+    m_device->device().destroyImage(m_depthImage);
+    m_device->device().freeMemory(m_depthMemory);
+    m_device->device().destroyRenderPass(m_renderPass);
+}
+
+void OdysseyImpostors::beginFrame(size_t frameIndex) {
+    for (auto& images : m_retired[frameIndex]) {
+        destroyAtlas(images);
+    }
+    m_retired[frameIndex].clear();
+    // Frames still in flight may sample them.
+    for (auto iter = m_atlases.begin(); iter != m_atlases.end();) {
+        if (iter->second.model.expired()) {
+            m_retired[frameIndex].push_back(std::move(iter->second));
+            iter = m_atlases.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+}
+
+void OdysseyImpostors::prepare(vk::CommandBuffer commandBuffer, const std::vector<OdysseyObject>& objects, uint64_t sceneVersion) {
+    // Models only come and go with the scene, and beginFrame() has already
+    // retired the atlases of those destroyed.
+    if (m_sceneVersion == sceneVersion) {
+        return;
+    }
+    m_sceneVersion = sceneVersion;
+    auto start = std::chrono::steady_clock::now();
+    const OdysseyModel* lastModel{nullptr};
+    for (const auto& object : objects) {
+        const auto* model = object.model.get();
+        if (!model || model == lastModel) {
+            continue;
+        }
+        lastModel = model;
+        if (m_atlases.contains(model) || model->getBounds().radius <= 0.0F || m_atlases.size() >= MAX_ATLASES) {
+            continue;
+        }
+        auto& images = m_atlases[model];
+        images.model = object.model;
+        bake(commandBuffer, model, images);
+    }
+    m_bakeTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+const OdysseyImpostors::Atlas* OdysseyImpostors::findAtlas(const OdysseyModel* model) const {
+    auto iter = m_atlases.find(model);
+    return iter != m_atlases.end() ? &iter->second.atlas : nullptr;
+}
+
+vk::DescriptorSetLayout OdysseyImpostors::getSetLayout() const {
+    return m_setLayout->getDescriptorSetLayout();
+}
+
+size_t OdysseyImpostors::getAtlasCount() const {
+    return m_atlases.size();
+}
+
+double OdysseyImpostors::getBakeTime() const {
+    return m_bakeTime;
+}
+
+glm::vec2 OdysseyImpostors::octahedralEncode(const glm::vec3& direction) {
+    auto n = direction / (std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z));
+    glm::vec2 p{n.x, n.y};
+    if (n.z < 0.0F) {
+        p = (1.0F - glm::abs(glm::vec2(p.y, p.x))) * glm::vec2(p.x >= 0.0F ? 1.0F : -1.0F, p.y >= 0.0F ? 1.0F : -1.0F);
+    }
+    return p * 0.5F + 0.5F;
+}
+
+glm::vec3 OdysseyImpostors::octahedralDecode(const glm::vec2& uv) {
+    auto p = uv * 2.0F - 1.0F;
+    glm::vec3 n{p.x, p.y, 1.0F - std::abs(p.x) - std::abs(p.y)};
+    auto t = (std::max)(-n.z, 0.0F);
+    n.x += n.x >= 0.0F ? -t : t;
+    n.y += n.y >= 0.0F ? -t : t;
+    return glm::normalize(n);
+}
+
+void OdysseyImpostors::createRenderPass() {
+    m_depthFormat = OdysseySwapChain::findDepthFormat(m_device);
+    std::array<vk::AttachmentDescription, 3> attachments{};
+    for (uint32_t i = 0; i < 2; ++i) {
+        attachments[i]
+            .setFormat(i == 0 ? COLOR_FORMAT : NORMAL_DEPTH_FORMAT)
+            .setSamples(vk::SampleCountFlagBits::e1)
+            .setLoadOp(vk::AttachmentLoadOp::eClear)
+            .setStoreOp(vk::AttachmentStoreOp::eStore)
+            .setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
+            .setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
+            .setInitialLayout(vk::ImageLayout::eUndefined)
+            .setFinalLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
+    }
+    attachments[2]
+        .setFormat(m_depthFormat)
+        .setSamples(vk::SampleCountFlagBits::e1)
+        .setLoadOp(vk::AttachmentLoadOp::eClear)
+        .setStoreOp(vk::AttachmentStoreOp::eDontCare)
+        .setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
+        .setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
+        .setInitialLayout(vk::ImageLayout::eUndefined)
+        .setFinalLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal);
+    std::array<vk::AttachmentReference, 2> colorReferences{
+        vk::AttachmentReference{0, vk::ImageLayout::eColorAttachmentOptimal},
+        vk::AttachmentReference{1, vk::ImageLayout::eColorAttachmentOptimal},
+    };
+    vk::AttachmentReference depthReference{2, vk::ImageLayout::eDepthStencilAttachmentOptimal};
+
+    vk::SubpassDescription subpass{};
+    subpass
+        .setPipelineBindPoint(vk::PipelineBindPoint::eGraphics)
+        .setColorAttachments(colorReferences)
+        .setPDepthStencilAttachment(&depthReference);
+
+    // The shared depth image is reused by every bake; the atlases are
+    // sampled by the scene passes recorded after the bakes.
+    std::array<vk::SubpassDependency, 2> dependencies{};
+    dependencies[0]
+        .setSrcSubpass(VK_SUBPASS_EXTERNAL)
+        .setSrcStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eLateFragmentTests)
+        .setSrcAccessMask(vk::AccessFlagBits::eDepthStencilAttachmentWrite)
+        .setDstSubpass(0)
+        .setDstStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eEarlyFragmentTests)
+        .setDstAccessMask(vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentWrite);
+    dependencies[1]
+        .setSrcSubpass(0)
+        .setSrcStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput)
+        .setSrcAccessMask(vk::AccessFlagBits::eColorAttachmentWrite)
+        .setDstSubpass(VK_SUBPASS_EXTERNAL)
+        .setDstStageMask(vk::PipelineStageFlagBits::eFragmentShader)
+        .setDstAccessMask(vk::AccessFlagBits::eShaderRead);
+
+    vk::RenderPassCreateInfo renderPassInfo{};
+    renderPassInfo
+        .setAttachments(attachments)
+        .setSubpasses(subpass)
+        .setDependencies(dependencies);
+    m_renderPass = m_device->device().createRenderPass(renderPassInfo);
+}
+
+void OdysseyImpostors::createBakeResources() {
+    m_device->createImage(ATLAS_SIZE, ATLAS_SIZE, m_depthFormat, vk::ImageTiling::eOptimal, vk::ImageUsageFlagBits::eDepthStencilAttachment, vk::MemoryPropertyFlagBits::eDeviceLocal, m_depthImage, m_depthMemory);
+    m_depthView = m_device->createImageView(m_depthImage, m_depthFormat, vk::ImageAspectFlagBits::eDepth);
+
+    vk::PushConstantRange pushConstantRange{};
+    pushConstantRange
+        .setStageFlags(vk::ShaderStageFlagBits::eVertex)
+        .setOffset(0)
+        .setSize(sizeof(BakePushConstantData));
+    vk::PipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.setPushConstantRanges(pushConstantRange);
+    m_bakePipelineLayout = m_device->device().createPipelineLayout(pipelineLayoutInfo);
+
+    auto config = OdysseyPipeline::defaultPipelineConfigInfo();
+    std::array<vk::PipelineColorBlendAttachmentState, 2> blendAttachments{config.colorBlendAttachment, config.colorBlendAttachment};
+    config.colorBlendInfo.setAttachments(blendAttachments);
+    config.renderPass = m_renderPass;
+    config.pipelineLayout = m_bakePipelineLayout;
+    m_bakePipeline = std::make_unique<OdysseyPipeline>(m_device, "shaders/impostor_bake.vert.spv", "shaders/impostor_bake.frag.spv", config);
+
+    vk::SamplerCreateInfo samplerInfo{};
+    samplerInfo
+        .setMagFilter(vk::Filter::eLinear)
+        .setMinFilter(vk::Filter::eLinear)
+        .setMipmapMode(vk::SamplerMipmapMode::eNearest)
+        .setAddressModeU(vk::SamplerAddressMode::eClampToEdge)
+        .setAddressModeV(vk::SamplerAddressMode::eClampToEdge)
+        .setAddressModeW(vk::SamplerAddressMode::eClampToEdge)
+        .setMinLod(0.0F)
+        .setMaxLod(0.0F);
+    m_sampler = m_device->device().createSampler(samplerInfo);
+    m_setLayout = OdysseyDescriptorSetLayout::Builder(m_device)
+                      .addBinding(0, vk::DescriptorType::eCombinedImageSampler, vk::ShaderStageFlagBits::eFragment)
+                      .addBinding(1, vk::DescriptorType::eCombinedImageSampler, vk::ShaderStageFlagBits::eFragment)
+                      .build();
+    // Atlases of destroyed models give their sets back.
+    m_descriptorPool = OdysseyDescriptorPool::Builder(m_device)
+                           .setPoolFlags(vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet)
+                           .setMaxSets(MAX_ATLASES)
+                           .addPoolSize(vk::DescriptorType::eCombinedImageSampler, MAX_ATLASES * 2)
+                           .build();
+}
+
+void OdysseyImpostors::bake(vk::CommandBuffer commandBuffer, const OdysseyModel* model, AtlasImages& images) {
+    auto usage = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled;
+    m_device->createImage(ATLAS_SIZE, ATLAS_SIZE, COLOR_FORMAT, vk::ImageTiling::eOptimal, usage, vk::MemoryPropertyFlagBits::eDeviceLocal, images.colorImage, images.colorMemory);
+    images.colorView = m_device->createImageView(images.colorImage, COLOR_FORMAT, vk::ImageAspectFlagBits::eColor);
+    m_device->createImage(ATLAS_SIZE, ATLAS_SIZE, NORMAL_DEPTH_FORMAT, vk::ImageTiling::eOptimal, usage, vk::MemoryPropertyFlagBits::eDeviceLocal, images.normalDepthImage, images.normalDepthMemory);
+    images.normalDepthView = m_device->createImageView(images.normalDepthImage, NORMAL_DEPTH_FORMAT, vk::ImageAspectFlagBits::eColor);
+
+    std::array<vk::ImageView, 3> views{images.colorView, images.normalDepthView, m_depthView};
+    vk::FramebufferCreateInfo framebufferInfo{};
+    framebufferInfo
+        .setRenderPass(m_renderPass)
+        .setAttachments(views)
+        .setWidth(ATLAS_SIZE)
+        .setHeight(ATLAS_SIZE)
+        .setLayers(1);
+    images.framebuffer = m_device->device().createFramebuffer(framebufferInfo);
+
+    const auto& bounds = model->getBounds();
+    std::array<vk::ClearValue, 3> clearValues{};
+    clearValues[0].setColor({0.0F, 0.0F, 0.0F, 0.0F});
+    clearValues[1].setColor({0.0F, 0.0F, 0.0F, 1.0F});
+    clearValues[2].setDepthStencil({1.0F, 0});
+    vk::RenderPassBeginInfo renderPassInfo{};
+    renderPassInfo
+        .setRenderPass(m_renderPass)
+        .setFramebuffer(images.framebuffer)
+        .setRenderArea({{0, 0}, {ATLAS_SIZE, ATLAS_SIZE}})
+        .setClearValues(clearValues);
+
+    commandBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
+    m_bakePipeline->bind(commandBuffer);
+    model->bind(commandBuffer);
+    // Orthographic over the bounding sphere, near plane on its surface, so
+    // depth 0.5 is the plane through the center; Vulkan's 0..1 depth range
+    // is asked for explicitly. Y is flipped, so up in the frame is up in the
+    // atlas, as impostor.vert expects.
+    auto radius = bounds.radius;
+    auto projection = glm::orthoRH_ZO(-radius, radius, -radius, radius, 0.0F, 2.0F * radius);
+    projection[1][1] *= -1.0F;
+    for (uint32_t y = 0; y < FRAMES_PER_AXIS; ++y) {
+        for (uint32_t x = 0; x < FRAMES_PER_AXIS; ++x) {
+            auto direction = octahedralDecode((glm::vec2(x, y) + 0.5F) / static_cast<float>(FRAMES_PER_AXIS));
+            auto up = std::abs(direction.y) > 0.99F ? glm::vec3(0.0F, 0.0F, 1.0F) : glm::vec3(0.0F, 1.0F, 0.0F);
+            BakePushConstantData push{};
+            push.projectionView = projection * glm::lookAt(bounds.center + direction * radius, bounds.center, up);
+            vk::Viewport viewport{static_cast<float>(x * FRAME_SIZE), static_cast<float>(y * FRAME_SIZE), static_cast<float>(FRAME_SIZE), static_cast<float>(FRAME_SIZE), 0.0F, 1.0F};
+            vk::Rect2D scissor{{static_cast<int32_t>(x * FRAME_SIZE), static_cast<int32_t>(y * FRAME_SIZE)}, {FRAME_SIZE, FRAME_SIZE}};
+            commandBuffer.setViewport(0, viewport);
+            commandBuffer.setScissor(0, scissor);
+            commandBuffer.pushConstants<BakePushConstantData>(m_bakePipelineLayout, vk::ShaderStageFlagBits::eVertex, 0, push);
+            model->draw(commandBuffer, 1, 0);
+        }
+    }
+    commandBuffer.endRenderPass();
+
+    vk::DescriptorImageInfo colorInfo{m_sampler, images.colorView, vk::ImageLayout::eShaderReadOnlyOptimal};
+    vk::DescriptorImageInfo normalDepthInfo{m_sampler, images.normalDepthView, vk::ImageLayout::eShaderReadOnlyOptimal};
+    if (!OdysseyDescriptorWriter(*m_setLayout, *m_descriptorPool).writeImage(0, &colorInfo).writeImage(1, &normalDepthInfo).build(images.atlas.descriptorSet)) {
+        throw std::runtime_error("Failed to allocate an impostor descriptor set.");
+    }
+    images.atlas.sphere = {bounds.center, radius};
+}
+
+void OdysseyImpostors::destroyAtlas(AtlasImages& images) {
+    if (images.atlas.descriptorSet) {
+        m_descriptorPool->freeDescriptors({images.atlas.descriptorSet});
+    }
+    m_device->device().destroyImageView(images.colorView);
+    m_device->device().destroyImage(images.colorImage);
+    m_device->device().freeMemory(images.colorMemory);
+    m_device->device().destroyImageView(images.normalDepthView);
+    m_device->device().destroyImage(images.normalDepthImage);
+    m_device->device().freeMemory(images.normalDepthMemory);
+    if (images.framebuffer) {
+        m_device->device().destroyFramebuffer(images.framebuffer);
+    }
+}
+
+}  // namespace odyssey
\ No newline at end of file
@@ -0,0 +1,253 @@
+/**
+ * @file odyssey_mesh_stream.cpp
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include "odyssey_mesh_stream.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "odyssey_bvh.h"
+#include "odyssey_culling.h"
+#include "odyssey_profiler.h"
+#include "odyssey_transform_store.h"
+
+namespace odyssey {
+
+uint64_t OdysseyMeshStreamFile::Chunk::getSize() const {
+    return vertexCount * sizeof(OdysseyModel::Vertex) + indexCount * sizeof(uint32_t);
+}
+
+OdysseyMeshStream::OdysseyMeshStream(OdysseyDevice* device, const std::string& path, uint64_t memoryBudget, float loadRadius, const glm::vec3& center, float size) : m_memoryBudget(memoryBudget), m_loadRadius(loadRadius) {
+    std::ifstream file(path, std::ios::binary);
+    OdysseyMeshStreamFile::Header header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != OdysseyMeshStreamFile::MAGIC || header.version != OdysseyMeshStreamFile::VERSION) {
+        throw std::runtime_error("Not a mesh stream: " + path);
+    }
+    m_chunks.resize(header.chunkCount);
+    file.seekg(static_cast<std::streamoff>(header.chunkTableOffset));
+    if (!file.read(reinterpret_cast<char*>(m_chunks.data()), static_cast<std::streamsize>(m_chunks.size() * sizeof(OdysseyMeshStreamFile::Chunk)))) {
+        throw std::runtime_error("Failed to read the chunk table of " + path);
+    }
+    m_wanted.resize(m_chunks.size());
+
+    auto& transforms = OdysseyTransformStore::instance();
+    m_transformIndex = transforms.create();
+    auto extent = header.max - header.min;
+    auto scale = size / (std::max)({extent.x, extent.y, extent.z, 1e-6F});
+    transforms.setScale(m_transformIndex, glm::vec3(scale));
+    transforms.setTranslation(m_transformIndex, center - (header.min + header.max) * 0.5F * scale);
+
+    std::vector<OdysseyStreamResidency::Range> ranges{};
+    ranges.reserve(m_chunks.size());
+    for (const auto& chunk : m_chunks) {
+        ranges.push_back({chunk.offset, chunk.getSize()});
+    }
+    m_residency = std::make_unique<OdysseyStreamResidency>(
+        device,
+        path,
+        std::move(ranges),
+        vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndexBuffer,
+        vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead);
+}
+
+OdysseyMeshStream::~OdysseyMeshStream() {
+    m_residency.reset();
+    OdysseyTransformStore::instance().destroy(m_transformIndex);
+}
+
+void OdysseyMeshStream::convert(const std::string& modelPath, const std::string& outputPath) {
+    OdysseyModel::Builder builder{};
+    builder.loadModel(modelPath);
+    if (builder.indices.empty()) {
+        for (uint32_t index = 0; index < builder.vertices.size(); ++index) {
+            builder.indices.push_back(index);
+        }
+    }
+    auto triangleCount = builder.indices.size() / 3;
+    if (triangleCount == 0) {
+        throw std::runtime_error("No triangles in " + modelPath);
+    }
+
+    // Cubic cells; models are mostly surfaces, so the cells they pass
+    // through grow with the square of the cells per axis.
+    OdysseyAabb bounds{};
+    for (const auto& vertex : builder.vertices) {
+        bounds.grow(vertex.position);
+    }
+    auto extent = bounds.max - bounds.min;
+    auto cellsPerAxis = static_cast<uint32_t>(std::clamp(std::ceil(std::sqrt(static_cast<double>(triangleCount) / CHUNK_TRIANGLES)), 1.0, 256.0));
+    auto cellSize = (std::max)({extent.x, extent.y, extent.z, 1e-6F}) / static_cast<float>(cellsPerAxis);
+    std::vector<std::pair<uint64_t, uint32_t>> cellTriangles(triangleCount);
+    for (uint32_t triangle = 0; triangle < triangleCount; ++triangle) {
+        glm::vec3 centroid{0.0F};
+        for (uint32_t corner = 0; corner < 3; ++corner) {
+            centroid += builder.vertices[builder.indices[triangle * 3 + corner]].position / 3.0F;
+        }
+        auto cell = glm::min(glm::uvec3((centroid - bounds.min) / cellSize), glm::uvec3(cellsPerAxis - 1));
+        cellTriangles[triangle] = {cell.x + static_cast<uint64_t>(cellsPerAxis) * (cell.y + static_cast<uint64_t>(cellsPerAxis) * cell.z), triangle};
+    }
+    std::sort(cellTriangles.begin(), cellTriangles.end());
+
+    std::ofstream output(outputPath, std::ios::binary | std::ios::trunc);
+    if (!output) {
+        throw std::runtime_error("Failed to create " + outputPath);
+    }
+    OdysseyMeshStreamFile::Header header{};
+    header.min = bounds.min;
+    header.max = bounds.max;
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    std::vector<OdysseyMeshStreamFile::Chunk> chunks{};
+    std::vector<OdysseyModel::Vertex> vertices{};
+    std::vector<uint32_t> indices{};
+    std::unordered_map<uint32_t, uint32_t> remap{};
+    size_t begin{0};
+    while (begin < cellTriangles.size()) {
+        auto end = begin;
+        vertices.clear();
+        indices.clear();
+        remap.clear();
+        OdysseyAabb chunkBounds{};
+        for (; end < cellTriangles.size() && cellTriangles[end].first == cellTriangles[begin].first; ++end) {
+            for (uint32_t corner = 0; corner < 3; ++corner) {
+                auto source = builder.indices[cellTriangles[end].second * 3 + corner];
+                auto [iter, inserted] = remap.emplace(source, static_cast<uint32_t>(vertices.size()));
+                if (inserted) {
+                    vertices.push_back(builder.vertices[source]);
+                    chunkBounds.grow(builder.vertices[source].position);
+                }
+                indices.push_back(iter->second);
+            }
+        }
+        OdysseyMeshStreamFile::Chunk chunk{};
+        chunk.min = chunkBounds.min;
+        chunk.max = chunkBounds.max;
+        chunk.offset = static_cast<uint64_t>(output.tellp());
+        chunk.vertexCount = static_cast<uint32_t>(vertices.size());
+        chunk.indexCount = static_cast<uint32_t>(indices.size());
+        output.write(reinterpret_cast<const char*>(vertices.data()), static_cast<std::streamsize>(vertices.size() * sizeof(OdysseyModel::Vertex)));
+        output.write(reinterpret_cast<const char*>(indices.data()), static_cast<std::streamsize>(indices.size() * sizeof(uint32_t)));
+        chunks.push_back(chunk);
+        begin = end;
+    }
+    header.chunkCount = static_cast<uint32_t>(chunks.size());
+    header.chunkTableOffset = static_cast<uint64_t>(output.tellp());
+    output.write(reinterpret_cast<const char*>(chunks.data()), static_cast<std::streamsize>(chunks.size() * sizeof(OdysseyMeshStreamFile::Chunk)));
+    output.seekp(0);
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!output) {
+        throw std::runtime_error("Failed to write " + outputPath);
+    }
+    std::cout << "Wrote " << triangleCount << " triangles from " << modelPath << " as " << chunks.size() << " chunks to " << outputPath << std::endl;
+}
+
+void OdysseyMeshStream::update(vk::CommandBuffer commandBuffer, const OdysseyCamera& camera, size_t frameIndex) {
+    m_residency->beginFrame(frameIndex);
+    auto cameraPosition = glm::vec3(glm::inverse(camera.getView())[3]);
+    select(cameraPosition, frameIndex);
+    m_residency->upload(commandBuffer, frameIndex, MAX_UPLOADS_PER_FRAME, [this](uint32_t chunk, [[maybe_unused]] uint64_t size) {
+        // No longer wanted since it was requested; select() has kept the
+        // budget for those that still are.
+        return static_cast<bool>(m_wanted[chunk]);
+    });
+
+    m_draws.clear();
+    const auto& matrix = OdysseyTransformStore::instance().getMatrix(m_transformIndex);
+    auto frustum = OdysseyFrustum::fromMatrix(camera.getProjection() * camera.getView());
+    for (uint32_t chunk = 0; chunk < m_chunks.size(); ++chunk) {
+        if (m_residency->getState(chunk) != OdysseyStreamResidency::State::RESIDENT) {
+            continue;
+        }
+        const auto& fileChunk = m_chunks[chunk];
+        auto bounds = OdysseyAabb{fileChunk.min, fileChunk.max}.transformed(matrix);
+        auto center = (bounds.min + bounds.max) * 0.5F;
+        auto radius = glm::length(bounds.max - center);
+        auto visible = std::all_of(frustum.planes.begin(), frustum.planes.end(), [&center, radius](const glm::vec4& plane) {
+            return glm::dot(glm::vec3(plane), center) + plane.w >= -radius;
+        });
+        if (visible) {
+            m_draws.push_back({m_residency->getBuffer(chunk), fileChunk.vertexCount * sizeof(OdysseyModel::Vertex), fileChunk.indexCount});
+        }
+    }
+
+    auto& profiler = OdysseyProfiler::instance();
+    profiler.setCounter("mesh stream chunks drawn", static_cast<double>(m_draws.size()));
+    profiler.setCounter("mesh stream resident chunks", static_cast<double>(m_residency->getResidentCount()));
+    profiler.setCounter("mesh stream resident MB", static_cast<double>(m_residency->getResidentBytes()) / (1024.0 * 1024.0));
+    profiler.setCounter("mesh stream evictions", static_cast<double>(m_residency->getEvictionCount()));
+    profiler.setCounter("mesh stream loads pending", static_cast<double>(m_residency->getPendingCount()));
+    auto megabytesRead = static_cast<double>(m_residency->getBytesRead()) / (1024.0 * 1024.0);
+    auto readSeconds = m_residency->getReadSeconds();
+    profiler.setCounter("mesh stream MB read", megabytesRead);
+    profiler.setCounter("mesh stream read MB/s", readSeconds > 0.0 ? megabytesRead / readSeconds : 0.0);
+}
+
+const std::vector<OdysseyMeshStream::Draw>& OdysseyMeshStream::getDraws() const {
+    return m_draws;
+}
+
+uint32_t OdysseyMeshStream::getTransformIndex() const {
+    return m_transformIndex;
+}
+
+size_t OdysseyMeshStream::getChunkCount() const {
+    return m_chunks.size();
+}
+
+size_t OdysseyMeshStream::getResidentCount() const {
+    return m_residency->getResidentCount();
+}
+
+uint64_t OdysseyMeshStream::getEvictionCount() const {
+    return m_residency->getEvictionCount();
+}
+
+void OdysseyMeshStream::select(const glm::vec3& cameraPosition, size_t frameIndex) {
+    const auto& matrix = OdysseyTransformStore::instance().getMatrix(m_transformIndex);
+    // Resident chunks compete at a discount, so they stay until they are
+    // HYSTERESIS times farther than the chunk that would replace them.
+    std::vector<std::pair<float, uint32_t>> candidates{};
+    for (uint32_t chunk = 0; chunk < m_chunks.size(); ++chunk) {
+        const auto& fileChunk = m_chunks[chunk];
+        auto bounds = OdysseyAabb{fileChunk.min, fileChunk.max}.transformed(matrix);
+        auto distance = glm::length(cameraPosition - glm::clamp(cameraPosition, bounds.min, bounds.max));
+        m_wanted[chunk] = false;
+        if (m_residency->getState(chunk) == OdysseyStreamResidency::State::RESIDENT) {
+            distance /= HYSTERESIS;
+        }
+        if (distance <= m_loadRadius) {
+            candidates.emplace_back(distance, chunk);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    uint64_t wantedBytes{0};
+    for (const auto& candidate : candidates) {
+        auto size = m_chunks[candidate.second].getSize();
+        if (wantedBytes + size <= m_memoryBudget) {
+            wantedBytes += size;
+            m_wanted[candidate.second] = true;
+        }
+    }
+
+    for (uint32_t chunk = 0; chunk < m_chunks.size(); ++chunk) {
+        if (m_residency->getState(chunk) == OdysseyStreamResidency::State::RESIDENT && !m_wanted[chunk]) {
+            m_residency->evict(chunk, frameIndex);
+        }
+    }
+    // Nearest last.
+    std::vector<uint32_t> requests{};
+    for (auto iter = candidates.rbegin(); iter != candidates.rend(); ++iter) {
+        if (m_wanted[iter->second]) {
+            requests.push_back(iter->second);
+        }
+    }
+    m_residency->request(requests);
+}
+
+}  // namespace odyssey
\ No newline at end of file
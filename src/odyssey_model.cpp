@@ -6,18 +6,28 @@
 
 #include "odyssey_model.h"
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <cstring>
+#include <stdexcept>
 #include <unordered_map>
+#include <utility>
 
 #include "odyssey_device.h"
 
 namespace odyssey {
 
-OdysseyModel::OdysseyModel(OdysseyDevice* device, const Builder& builder) : m_device(device) {
+OdysseyModel::OdysseyModel(OdysseyDevice* device, const Builder& builder) : m_device(device), m_bounds(computeBounds(builder.vertices)), m_indices(builder.indices) {
     createVertexBuffer(builder.vertices);
     createIndexBuffer(builder.indices);
+    m_positions.reserve(builder.vertices.size());
+    for (const auto& vertex : builder.vertices) {
+        m_positions.push_back(vertex.position);
+    }
+    if (builder.vertices.size() <= MAX_MERGEABLE_VERTICES) {
+        m_vertices = builder.vertices;
+    }
 }
 
 OdysseyModel::~OdysseyModel() {
@@ -30,12 +40,56 @@ OdysseyModel::~OdysseyModel() {
     }
 }
 
-std::shared_ptr<OdysseyModel> OdysseyModel::createModelFromFile(OdysseyDevice* device, const std::string& filepath) {
+std::shared_ptr<OdysseyModel> OdysseyModel::createModelFromFile(OdysseyDevice* device, const std::string& filepath, Assimp::Importer* importer) {
     Builder builder{};
-    builder.loadModel(filepath);
+    builder.loadModel(filepath, importer);
     return std::make_shared<OdysseyModel>(device, builder);
 }
 
+std::shared_ptr<OdysseyModel> OdysseyModel::createCubeModel(OdysseyDevice* device) {
+    Builder builder{};
+    builder.loadCube();
+    return std::make_shared<OdysseyModel>(device, builder);
+}
+
+std::vector<OdysseyModel::Node> OdysseyModel::createNodesFromFile(OdysseyDevice* device, const std::string& filepath, Assimp::Importer* importer) {
+    std::unique_ptr<Assimp::Importer> ownedImporter{};
+    if (importer == nullptr) {
+        ownedImporter = std::make_unique<Assimp::Importer>();
+        importer = ownedImporter.get();
+    }
+    const auto* scene = importer->ReadFile(filepath, aiProcess_Triangulate | aiProcess_FlipUVs);
+    if (scene == nullptr || scene->mRootNode == nullptr) {
+        throw std::runtime_error("Failed to load " + filepath + ": " + importer->GetErrorString());
+    }
+    std::vector<Node> nodes{};
+    // Explicit stack of (node, parent index); children are pushed in reverse
+    // so they come out in file order.
+    std::vector<std::pair<const aiNode*, uint32_t>> stack{{scene->mRootNode, INVALID_NODE}};
+    while (!stack.empty()) {
+        auto [source, parent] = stack.back();
+        stack.pop_back();
+        // aiMatrix4x4 is row-major.
+        const auto& m = source->mTransformation;
+        Node node{};
+        node.name = source->mName.C_Str();
+        node.parent = parent;
+        node.localMatrix = glm::mat4{{m.a1, m.b1, m.c1, m.d1}, {m.a2, m.b2, m.c2, m.d2}, {m.a3, m.b3, m.c3, m.d3}, {m.a4, m.b4, m.c4, m.d4}};
+        Builder builder{};
+        builder.loadNodeMeshes(source, scene);
+        if (!builder.vertices.empty()) {
+            node.model = std::make_shared<OdysseyModel>(device, builder);
+        }
+        auto index = static_cast<uint32_t>(nodes.size());
+        nodes.push_back(std::move(node));
+        for (auto i = source->mNumChildren; i > 0; --i) {
+            stack.emplace_back(source->mChildren[i - 1], index);
+        }
+    }
+    importer->FreeScene();
+    return nodes;
+}
+
 void OdysseyModel::bind(vk::CommandBuffer& commandBuffer) const {
     std::array<vk::Buffer, 1> buffers{m_vertexBuffer};
     commandBuffer.bindVertexBuffers(0, buffers, {0});
@@ -44,12 +98,83 @@ void OdysseyModel::bind(vk::CommandBuffer& commandBuffer) const {
     }
 }
 
-void OdysseyModel::draw(vk::CommandBuffer& commandBuffer) const {
+void OdysseyModel::draw(vk::CommandBuffer& commandBuffer, uint32_t instanceCount, uint32_t firstInstance) const {
     if (m_hasIndexBuffer) {
-        commandBuffer.drawIndexed(m_indexCount, 1, 0, 0, 0);
+        commandBuffer.drawIndexed(m_indexCount, instanceCount, 0, 0, firstInstance);
     } else {
-        commandBuffer.draw(m_vertexCount, 1, 0, 0);
+        commandBuffer.draw(m_vertexCount, instanceCount, 0, firstInstance);
+    }
+}
+
+vk::Buffer OdysseyModel::getVertexBuffer() const {
+    return m_vertexBuffer;
+}
+
+vk::Buffer OdysseyModel::getIndexBuffer() const {
+    return m_indexBuffer;
+}
+
+uint32_t OdysseyModel::getVertexCount() const {
+    return m_vertexCount;
+}
+
+uint32_t OdysseyModel::getIndexCount() const {
+    return m_indexCount;
+}
+
+bool OdysseyModel::hasIndexBuffer() const {
+    return m_hasIndexBuffer;
+}
+
+const OdysseyModel::Bounds& OdysseyModel::getBounds() const {
+    return m_bounds;
+}
+
+const std::vector<glm::vec3>& OdysseyModel::getPositions() const {
+    return m_positions;
+}
+
+const std::vector<uint32_t>& OdysseyModel::getIndices() const {
+    return m_indices;
+}
+
+const std::vector<OdysseyModel::Vertex>& OdysseyModel::getVertices() const {
+    return m_vertices;
+}
+
+uint32_t OdysseyModel::getTriangleCount() const {
+    return static_cast<uint32_t>((m_indices.empty() ? m_positions.size() : m_indices.size()) / 3);
+}
+
+std::array<uint32_t, 3> OdysseyModel::getTriangle(uint32_t triangle) const {
+    auto first = triangle * 3;
+    if (m_indices.empty()) {
+        return {first, first + 1, first + 2};
+    }
+    return {m_indices[first], m_indices[first + 1], m_indices[first + 2]};
+}
+
+OdysseyModel::Bounds OdysseyModel::computeBounds(const std::vector<Vertex>& vertices) {
+    Bounds bounds{};
+    if (vertices.empty()) {
+        return bounds;
     }
+    bounds.min = vertices.front().position;
+    bounds.max = vertices.front().position;
+    for (const auto& vertex : vertices) {
+        bounds.min = glm::min(bounds.min, vertex.position);
+        bounds.max = glm::max(bounds.max, vertex.position);
+    }
+    // Centred on the box, with the radius taken from the vertices rather than
+    // the box corners, which is tighter for anything but a box.
+    bounds.center = 0.5F * (bounds.min + bounds.max);
+    float radiusSquared{0.0F};
+    for (const auto& vertex : vertices) {
+        auto offset = vertex.position - bounds.center;
+        radiusSquared = (std::max)(radiusSquared, glm::dot(offset, offset));
+    }
+    bounds.radius = glm::sqrt(radiusSquared);
+    return bounds;
 }
 
 void OdysseyModel::createVertexBuffer(const std::vector<Vertex>& vertices) {
@@ -68,7 +193,7 @@ void OdysseyModel::createVertexBuffer(const std::vector<Vertex>& vertices) {
     m_device->device().unmapMemory(stagingBufferMemory);
     m_device->createBuffer(
         bufferSize,
-        vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
+        vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
         vk::MemoryPropertyFlagBits::eDeviceLocal,
         m_vertexBuffer,
         m_vertexBufferMemory);
@@ -96,7 +221,7 @@ void OdysseyModel::createIndexBuffer(const std::vector<uint32_t>& indices) {
     m_device->device().unmapMemory(stagingBufferMemory);
     m_device->createBuffer(
         bufferSize,
-        vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
+        vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
         vk::MemoryPropertyFlagBits::eDeviceLocal,
         m_indexBuffer,
         m_indexBufferMemory);
@@ -127,17 +252,57 @@ std::vector<vk::VertexInputAttributeDescription> OdysseyModel::Vertex::getAttrib
     return attributeDescriptions;
 }
 
-void OdysseyModel::Builder::loadModel(const std::string& filepath) {
-    Assimp::Importer importer;
-    const auto* scene = importer.ReadFile(filepath, aiProcess_Triangulate | aiProcess_FlipUVs);
+void OdysseyModel::Builder::loadModel(const std::string& filepath, Assimp::Importer* importer) {
+    std::unique_ptr<Assimp::Importer> ownedImporter{};
+    if (importer == nullptr) {
+        ownedImporter = std::make_unique<Assimp::Importer>();
+        importer = ownedImporter.get();
+    }
+    const auto* scene = importer->ReadFile(filepath, aiProcess_Triangulate | aiProcess_FlipUVs);
     processNode(scene->mRootNode, scene);
+    importer->FreeScene();
 }
 
-void OdysseyModel::Builder::processNode(const aiNode* node, const aiScene* scene) {
+void OdysseyModel::Builder::loadCube() {
+    // Unit cube centred on the origin, one flat-shaded face per axis direction.
+    const std::array<glm::vec3, 6> normals{{
+        {1.0F, 0.0F, 0.0F},
+        {-1.0F, 0.0F, 0.0F},
+        {0.0F, 1.0F, 0.0F},
+        {0.0F, -1.0F, 0.0F},
+        {0.0F, 0.0F, 1.0F},
+        {0.0F, 0.0F, -1.0F},
+    }};
+    vertices.clear();
+    indices.clear();
+    for (const auto& normal : normals) {
+        auto tangent = glm::abs(normal.y) > 0.5F ? glm::vec3(1.0F, 0.0F, 0.0F) : glm::vec3(0.0F, 1.0F, 0.0F);
+        auto bitangent = glm::cross(normal, tangent);
+        auto base = static_cast<uint32_t>(vertices.size());
+        const std::array<glm::vec2, 4> corners{{{-1.0F, -1.0F}, {1.0F, -1.0F}, {1.0F, 1.0F}, {-1.0F, 1.0F}}};
+        for (const auto& corner : corners) {
+            Vertex vertex{};
+            vertex.position = 0.5F * (normal + corner.x * tangent + corner.y * bitangent);
+            vertex.color = glm::abs(normal) * 0.5F + 0.5F;
+            vertex.normal = normal;
+            vertex.uv = corner * 0.5F + 0.5F;
+            vertices.push_back(vertex);
+        }
+        for (auto index : {0U, 1U, 2U, 0U, 2U, 3U}) {
+            indices.push_back(base + index);
+        }
+    }
+}
+
+void OdysseyModel::Builder::loadNodeMeshes(const aiNode* node, const aiScene* scene) {
     for (uint32_t i = 0; i < node->mNumMeshes; ++i) {
         auto* mesh = scene->mMeshes[node->mMeshes[i]];
         processMesh(mesh);
     }
+}
+
+void OdysseyModel::Builder::processNode(const aiNode* node, const aiScene* scene) {
+    loadNodeMeshes(node, scene);
     for (uint32_t i = 0; i < node->mNumChildren; ++i) {
         processNode(node->mChildren[i], scene);
     }
@@ -6,62 +6,66 @@
 
 #include "odyssey_object.h"
 
+#include <utility>
+
 namespace odyssey {
 
-glm::mat4 TransformComponent::mat4() {
-    const float C3 = glm::cos(rotation.z);
-    const float S3 = glm::sin(rotation.z);
-    const float C2 = glm::cos(rotation.x);
-    const float S2 = glm::sin(rotation.x);
-    const float C1 = glm::cos(rotation.y);
-    const float S1 = glm::sin(rotation.y);
-    return glm::mat4{
-        {
-            scale.x * (C1 * C3 + S1 * S2 * S3),
-            scale.x * (C2 * S3),
-            scale.x * (C1 * S2 * S3 - C3 * S1),
-            0.0F,
-        },
-        {
-            scale.y * (C3 * S1 * S2 - C1 * S3),
-            scale.y * (C2 * C3),
-            scale.y * (C1 * C3 * S2 + S1 * S3),
-            0.0F,
-        },
-        {
-            scale.z * (C2 * S1),
-            scale.z * (-S2),
-            scale.z * (C1 * C2),
-            0.0F,
-        },
-        {translation.x, translation.y, translation.z, 1.0F}};
+TransformComponent::TransformComponent() : m_index(OdysseyTransformStore::instance().create()) {
+}
+
+TransformComponent::~TransformComponent() {
+    if (m_index != OdysseyTransformStore::INVALID_INDEX) {
+        OdysseyTransformStore::instance().destroy(m_index);
+    }
+}
+
+TransformComponent::TransformComponent(TransformComponent&& transformComponent) noexcept : m_index(std::exchange(transformComponent.m_index, OdysseyTransformStore::INVALID_INDEX)) {
+}
+
+TransformComponent& TransformComponent::operator=(TransformComponent&& transformComponent) noexcept {
+    if (this != &transformComponent) {
+        if (m_index != OdysseyTransformStore::INVALID_INDEX) {
+            OdysseyTransformStore::instance().destroy(m_index);
+        }
+        m_index = std::exchange(transformComponent.m_index, OdysseyTransformStore::INVALID_INDEX);
+    }
+    return *this;
+}
+
+void TransformComponent::setTranslation(const glm::vec3& translation) {
+    OdysseyTransformStore::instance().setTranslation(m_index, translation);
+}
+
+void TransformComponent::setRotation(const glm::vec3& rotation) {
+    OdysseyTransformStore::instance().setRotation(m_index, rotation);
+}
+
+void TransformComponent::setScale(const glm::vec3& scale) {
+    OdysseyTransformStore::instance().setScale(m_index, scale);
+}
+
+glm::vec3 TransformComponent::getTranslation() const {
+    return OdysseyTransformStore::instance().getTranslation(m_index);
+}
+
+glm::vec3 TransformComponent::getRotation() const {
+    return OdysseyTransformStore::instance().getRotation(m_index);
+}
+
+glm::vec3 TransformComponent::getScale() const {
+    return OdysseyTransformStore::instance().getScale(m_index);
+}
+
+const glm::mat4& TransformComponent::mat4() const {
+    return OdysseyTransformStore::instance().getMatrix(m_index);
+}
+
+const glm::mat3x4& TransformComponent::normal() const {
+    return OdysseyTransformStore::instance().getNormalMatrix(m_index);
 }
 
-glm::mat3 TransformComponent::normal() {
-    const float C3 = glm::cos(rotation.z);
-    const float S3 = glm::sin(rotation.z);
-    const float C2 = glm::cos(rotation.x);
-    const float S2 = glm::sin(rotation.x);
-    const float C1 = glm::cos(rotation.y);
-    const float S1 = glm::sin(rotation.y);
-    glm::vec3 inverseScale = 1.0F / scale;
-    return glm::mat3{
-        {
-            inverseScale.x * (C1 * C3 + S1 * S2 * S3),
-            inverseScale.x * (C2 * S3),
-            inverseScale.x * (C1 * S2 * S3 - C3 * S1),
-        },
-        {
-            inverseScale.y * (C3 * S1 * S2 - C1 * S3),
-            inverseScale.y * (C2 * C3),
-            inverseScale.y * (C1 * C3 * S2 + S1 * S3),
-        },
-        {
-            inverseScale.z * (C2 * S1),
-            inverseScale.z * (-S2),
-            inverseScale.z * (C1 * C2),
-        },
-    };
+uint32_t TransformComponent::getIndex() const {
+    return m_index;
 }
 
 OdysseyObject::OdysseyObject(unsigned id) : m_id(id) {
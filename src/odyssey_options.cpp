@@ -0,0 +1,148 @@
+/**
+ * @file odyssey_options.cpp
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include "odyssey_options.h"
+
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <algorithm>
+
+#include "odyssey_clustered_lights.h"
+
+namespace odyssey {
+
+OdysseyOptions OdysseyOptions::parse(const QStringList& arguments) {
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption lightingOption("lighting", "Lighting model: unlit, lambert or half-lambert.", "model", "lambert");
+    QCommandLineOption debugViewOption("debug-view", "Debug view: none, normal or uv.", "view", "none");
+    QCommandLineOption uberShaderOption("uber-shader", "Branch on pipeline options at runtime instead of specializing.");
+    QCommandLineOption benchmarkFramesOption("benchmark-frames", "Render the given number of frames, print frame timings and quit.", "frames", "0");
+    QCommandLineOption startupReportOption("startup-report", "Print a phase-by-phase startup timeline once the first frame is presented.");
+    QCommandLineOption dumpRenderGraphOption("dump-render-graph", "Print the compiled render graph and check transient aliasing on a sample one.");
+    QCommandLineOption latencyOption("latency", "Latency preset: low, balanced or throughput.", "preset", "balanced");
+    QCommandLineOption framesInFlightOption("frames-in-flight", "Frames the CPU may record ahead of the GPU (1-3).", "frames");
+    QCommandLineOption presentModeOption("present-mode", "Preferred present mode: fifo, fifo-relaxed, mailbox or immediate.", "mode");
+    QCommandLineOption swapChainImagesOption("swapchain-images", "Swap chain image count, 0 for the driver minimum plus one.", "images");
+    QCommandLineOption waitBeforeInputOption("wait-before-input", "Wait for the previous frame on the CPU before sampling input.");
+    QCommandLineOption maxFpsOption("max-fps", "Cap the frame rate, 0 for uncapped.", "fps", "0");
+    QCommandLineOption idleRefreshOption("idle-refresh", "Redraw every given number of seconds while nothing changes, 0 to stay idle.", "seconds", "0");
+    QCommandLineOption continuousOption("continuous", "Redraw every frame even when nothing changed.");
+    QCommandLineOption redrawReportOption("redraw-report", "Print frames and wakeups per minute and UI and render timing histograms once a minute.");
+    QCommandLineOption uiStallOption("ui-stall", "Block the UI thread for the given milliseconds once a second.", "milliseconds", "0");
+    QCommandLineOption testSceneOption("test-scene", "Fill the scene with the given number of copies of one model.", "objects", "0");
+    QCommandLineOption modelOption("model", "Model for the test scene, a unit cube when not given.", "path");
+    QCommandLineOption noBatchingOption("no-batching", "Issue one draw per object instead of one instanced draw per model.");
+    QCommandLineOption gpuDrivenOption("gpu-driven", "Build draws on the GPU with a compute pass and multi-draw indirect.");
+    QCommandLineOption noCullingOption("no-culling", "Draw every object instead of culling against the view frustum.");
+    QCommandLineOption noParallelRecordingOption("no-parallel-recording", "Record every draw on the UI thread instead of into secondary command buffers on all cores.");
+    QCommandLineOption noCommandCacheOption("no-command-cache", "Record draws every frame instead of replaying them while the scene is unchanged.");
+    QCommandLineOption perObjectTransformsOption("per-object-transforms", "Rebuild every object's matrices each frame instead of only those that moved.");
+    QCommandLineOption movingObjectsOption("moving-objects", "Spin the given number of test scene objects every frame.", "objects", "0");
+    QCommandLineOption assemblyOption("assembly", "Add a spinning assembly node with the given number of child parts to the scene graph.", "parts", "0");
+    QCommandLineOption staticAssemblyOption("static-assembly", "Keep the assembly still and its parts static, so static batching can merge them.");
+    QCommandLineOption noStaticBatchingOption("no-static-batching", "Draw static objects one by one instead of merging them into pre-transformed batches per spatial cell.");
+    QCommandLineOption pointsOption("points", "Stream a point cloud octree built with --convert-points into the scene.", "path");
+    QCommandLineOption pointBudgetOption("point-budget", "Millions of point cloud points kept on the GPU.", "millions", "8");
+    QCommandLineOption convertPointsOption("convert-points", "Convert an ASCII x y z [r g b] point list to <path>.octree and quit.", "path");
+    QCommandLineOption meshStreamOption("mesh-stream", "Stream a chunked mesh built with --convert-mesh into the scene.", "path");
+    QCommandLineOption streamBudgetOption("stream-budget", "Megabytes of mesh stream chunks kept on the GPU.", "megabytes", "512");
+    QCommandLineOption streamRadiusOption("stream-radius", "Load mesh stream chunks within this distance of the camera.", "distance", "4");
+    QCommandLineOption convertMeshOption("convert-mesh", "Split a model into spatial chunks in <path>.mstream and quit.", "path");
+    QCommandLineOption impostorsOption("impostors", "Draw objects farther than the given distance as octahedral impostors, 0 for never.", "distance", "0");
+    QCommandLineOption lightsOption("lights", "Add the given number of moving point lights, shaded with clustered forward lighting.", "lights", "0");
+    QCommandLineOption lightSweepOption("light-sweep", "With --benchmark-frames, benchmark 10, 100, 1000 and 10000 point lights in turn.");
+    QCommandLineOption dynamicResolutionOption("dynamic-resolution", "Render offscreen at a scale steered towards the given GPU frame time and upscale, 0 for native resolution.", "milliseconds", "0");
+    QCommandLineOption minScaleOption("min-scale", "Smallest dynamic resolution scale per axis.", "scale", "0.5");
+    QCommandLineOption maxScaleOption("max-scale", "Largest dynamic resolution scale per axis.", "scale", "1");
+    QCommandLineOption occlusionOption("occlusion", "Cull occluded objects against a depth pyramid on the GPU; implies --gpu-driven.");
+    QCommandLineOption interiorOption("interior", "Put walls with a doorway between the camera and the test scene.");
+    parser.addOptions({lightingOption, debugViewOption, uberShaderOption, benchmarkFramesOption, startupReportOption, dumpRenderGraphOption, latencyOption, framesInFlightOption, presentModeOption, swapChainImagesOption, waitBeforeInputOption, maxFpsOption, idleRefreshOption, continuousOption, redrawReportOption, uiStallOption, testSceneOption, modelOption, noBatchingOption, gpuDrivenOption, noCullingOption, occlusionOption, interiorOption, noParallelRecordingOption, noCommandCacheOption, perObjectTransformsOption, movingObjectsOption, assemblyOption, staticAssemblyOption, noStaticBatchingOption, pointsOption, pointBudgetOption, convertPointsOption, meshStreamOption, streamBudgetOption, streamRadiusOption, convertMeshOption, impostorsOption, lightsOption, lightSweepOption, dynamicResolutionOption, minScaleOption, maxScaleOption});
+    parser.process(arguments);
+
+    OdysseyOptions options{};
+    auto lighting = parser.value(lightingOption);
+    if (lighting == "unlit") {
+        options.variant.lightingModel = OdysseyLightingModel::UNLIT;
+    } else if (lighting == "half-lambert") {
+        options.variant.lightingModel = OdysseyLightingModel::HALF_LAMBERT;
+    }
+    auto debugView = parser.value(debugViewOption);
+    if (debugView == "normal") {
+        options.variant.debugView = OdysseyDebugView::NORMAL;
+    } else if (debugView == "uv") {
+        options.variant.debugView = OdysseyDebugView::UV;
+    }
+    options.variant.runtimeBranching = parser.isSet(uberShaderOption);
+    options.benchmarkFrames = parser.value(benchmarkFramesOption).toUInt();
+    options.startupReport = parser.isSet(startupReportOption);
+    options.dumpRenderGraph = parser.isSet(dumpRenderGraphOption);
+
+    auto latency = parser.value(latencyOption);
+    if (latency == "low") {
+        options.latency = {.framesInFlight = 1, .presentMode = vk::PresentModeKHR::eMailbox, .imageCount = 0, .waitBeforeInput = true};
+    } else if (latency == "throughput") {
+        options.latency = {.framesInFlight = 3, .presentMode = vk::PresentModeKHR::eFifo, .imageCount = 3, .waitBeforeInput = false};
+    }
+    if (parser.isSet(framesInFlightOption)) {
+        options.latency.framesInFlight = std::clamp(parser.value(framesInFlightOption).toUInt(), 1U, static_cast<uint32_t>(OdysseySwapChain::MAX_FRAMES_IN_FLIGHT));
+    }
+    if (parser.isSet(presentModeOption)) {
+        auto presentMode = parser.value(presentModeOption);
+        if (presentMode == "fifo") {
+            options.latency.presentMode = vk::PresentModeKHR::eFifo;
+        } else if (presentMode == "fifo-relaxed") {
+            options.latency.presentMode = vk::PresentModeKHR::eFifoRelaxed;
+        } else if (presentMode == "immediate") {
+            options.latency.presentMode = vk::PresentModeKHR::eImmediate;
+        } else {
+            options.latency.presentMode = vk::PresentModeKHR::eMailbox;
+        }
+    }
+    if (parser.isSet(swapChainImagesOption)) {
+        options.latency.imageCount = parser.value(swapChainImagesOption).toUInt();
+    }
+    if (parser.isSet(waitBeforeInputOption)) {
+        options.latency.waitBeforeInput = true;
+    }
+
+    options.redraw.maxFps = parser.value(maxFpsOption).toUInt();
+    options.redraw.idleRefresh = parser.value(idleRefreshOption).toUInt();
+    options.redraw.continuous = parser.isSet(continuousOption);
+    options.redrawReport = parser.isSet(redrawReportOption);
+    options.uiStall = parser.value(uiStallOption).toUInt();
+
+    options.testSceneObjects = parser.value(testSceneOption).toUInt();
+    options.modelPath = parser.value(modelOption).toStdString();
+    options.batching = !parser.isSet(noBatchingOption);
+    options.occlusionCulling = parser.isSet(occlusionOption);
+    options.gpuDriven = parser.isSet(gpuDrivenOption) || options.occlusionCulling;
+    options.culling = !parser.isSet(noCullingOption);
+    options.interiorScene = parser.isSet(interiorOption);
+    options.parallelRecording = !parser.isSet(noParallelRecordingOption);
+    options.commandCaching = !parser.isSet(noCommandCacheOption);
+    options.perObjectTransforms = parser.isSet(perObjectTransformsOption);
+    options.movingObjects = parser.value(movingObjectsOption).toUInt();
+    options.assemblyParts = parser.value(assemblyOption).toUInt();
+    options.staticAssembly = parser.isSet(staticAssemblyOption);
+    options.staticBatching = !parser.isSet(noStaticBatchingOption);
+    options.pointCloudPath = parser.value(pointsOption).toStdString();
+    options.pointBudget = static_cast<uint64_t>((std::max)(parser.value(pointBudgetOption).toDouble(), 0.1) * 1'000'000.0);
+    options.convertPointsPath = parser.value(convertPointsOption).toStdString();
+    options.meshStreamPath = parser.value(meshStreamOption).toStdString();
+    options.streamBudget = static_cast<uint64_t>(parser.value(streamBudgetOption).toUInt()) << 20;
+    options.streamRadius = parser.value(streamRadiusOption).toFloat();
+    options.convertMeshPath = parser.value(convertMeshOption).toStdString();
+    options.impostorDistance = (std::max)(parser.value(impostorsOption).toFloat(), 0.0F);
+    options.lightCount = (std::min)(parser.value(lightsOption).toUInt(), OdysseyClusteredLights::MAX_LIGHTS);
+    options.lightSweep = parser.isSet(lightSweepOption) && options.benchmarkFrames > 0;
+    options.resolution.targetFrameTime = (std::max)(parser.value(dynamicResolutionOption).toDouble(), 0.0);
+    options.resolution.minScale = std::clamp(parser.value(minScaleOption).toFloat(), 0.1F, 2.0F);
+    options.resolution.maxScale = std::clamp(parser.value(maxScaleOption).toFloat(), options.resolution.minScale, 2.0F);
+    return options;
+}
+
+}  // namespace odyssey
\ No newline at end of file
@@ -0,0 +1,152 @@
+/**
+ * @file odyssey_picker.cpp
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include "odyssey_picker.h"
+
+namespace odyssey {
+
+namespace {
+
+// Moller-Trumbore, two-sided; returns the distance along the ray or NO_HIT.
+float intersectTriangle(const OdysseyRay& ray, const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2) {
+    auto edge1 = p1 - p0;
+    auto edge2 = p2 - p0;
+    auto p = glm::cross(ray.direction, edge2);
+    auto determinant = glm::dot(edge1, p);
+    if (determinant == 0.0F) {
+        return OdysseyBvh::NO_HIT;
+    }
+    auto inverseDeterminant = 1.0F / determinant;
+    auto s = ray.origin - p0;
+    auto u = glm::dot(s, p) * inverseDeterminant;
+    if (u < 0.0F || u > 1.0F) {
+        return OdysseyBvh::NO_HIT;
+    }
+    auto q = glm::cross(s, edge1);
+    auto v = glm::dot(ray.direction, q) * inverseDeterminant;
+    if (v < 0.0F || u + v > 1.0F) {
+        return OdysseyBvh::NO_HIT;
+    }
+    auto t = glm::dot(edge2, q) * inverseDeterminant;
+    return t > 0.0F ? t : OdysseyBvh::NO_HIT;
+}
+
+}  // namespace
+
+OdysseyPicker::OdysseyPicker() : m_worker(&OdysseyPicker::workerLoop, this) {
+}
+
+OdysseyPicker::~OdysseyPicker() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wakeup.notify_all();
+    m_worker.join();
+}
+
+void OdysseyPicker::addModel(const std::shared_ptr<OdysseyModel>& model) {
+    if (!model || m_models.contains(model.get())) {
+        return;
+    }
+    auto entry = std::make_shared<ModelBvh>();
+    entry->model = model;
+    m_models.emplace(model.get(), entry);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(std::move(entry));
+    }
+    m_wakeup.notify_one();
+}
+
+std::optional<OdysseyPickResult> OdysseyPicker::pick(const std::vector<OdysseyObject>& objects, const OdysseyRay& ray) {
+    // Matrices are those of the last frame drawn, which is what was clicked.
+    auto transformVersion = OdysseyTransformStore::instance().getVersion();
+    auto readyCount = m_readyCount.load();
+    if (transformVersion != m_topLevelTransformVersion || objects.size() != m_topLevelObjectCount || readyCount != m_topLevelReadyCount) {
+        buildTopLevel(objects);
+        m_topLevelTransformVersion = transformVersion;
+        m_topLevelObjectCount = objects.size();
+        m_topLevelReadyCount = readyCount;
+    }
+
+    std::optional<OdysseyPickResult> result{};
+    auto tMax = OdysseyBvh::NO_HIT;
+    m_topLevel.traverse(ray, tMax, [this, &objects, &ray, &result](uint32_t instance, float& instanceMax) {
+        auto objectIndex = m_instances[instance];
+        const auto* modelBvh = m_instanceBvhs[instance];
+        const auto& model = *modelBvh->model;
+        const auto& positions = model.getPositions();
+        // An affine transform keeps distances along the ray, so hits in
+        // object space compare directly with tMax.
+        auto inverse = glm::inverse(objects[objectIndex].transform.mat4());
+        OdysseyRay localRay{glm::vec3(inverse * glm::vec4(ray.origin, 1.0F)), glm::vec3(inverse * glm::vec4(ray.direction, 0.0F))};
+        modelBvh->bvh.traverse(localRay, instanceMax, [&model, &positions, &localRay, &ray, &result, objectIndex](uint32_t triangle, float& triangleMax) {
+            auto corners = model.getTriangle(triangle);
+            auto t = intersectTriangle(localRay, positions[corners[0]], positions[corners[1]], positions[corners[2]]);
+            if (t < triangleMax) {
+                triangleMax = t;
+                result = OdysseyPickResult{objectIndex, triangle, ray.origin + ray.direction * t, t};
+            }
+        });
+    });
+    return result;
+}
+
+size_t OdysseyPicker::getPendingCount() const {
+    return m_models.size() - m_readyCount.load();
+}
+
+void OdysseyPicker::workerLoop() {
+    while (true) {
+        std::shared_ptr<ModelBvh> entry{};
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeup.wait(lock, [this]() {
+                return m_stopping || !m_queue.empty();
+            });
+            if (m_stopping) {
+                return;
+            }
+            entry = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+        const auto& model = *entry->model;
+        const auto& positions = model.getPositions();
+        std::vector<OdysseyAabb> bounds(model.getTriangleCount());
+        for (uint32_t triangle = 0; triangle < bounds.size(); ++triangle) {
+            for (auto corner : model.getTriangle(triangle)) {
+                bounds[triangle].grow(positions[corner]);
+            }
+        }
+        entry->bvh.build(bounds);
+        entry->ready.store(true, std::memory_order_release);
+        ++m_readyCount;
+    }
+}
+
+void OdysseyPicker::buildTopLevel(const std::vector<OdysseyObject>& objects) {
+    m_instances.clear();
+    m_instanceBvhs.clear();
+    std::vector<OdysseyAabb> bounds{};
+    for (size_t i = 0; i < objects.size(); ++i) {
+        const auto& object = objects[i];
+        if (!object.model) {
+            continue;
+        }
+        addModel(object.model);
+        const auto& modelBvh = m_models[object.model.get()];
+        if (!modelBvh->ready.load(std::memory_order_acquire) || modelBvh->bvh.empty()) {
+            continue;
+        }
+        bounds.push_back(modelBvh->bvh.getBounds().transformed(object.transform.mat4()));
+        m_instances.push_back(static_cast<uint32_t>(i));
+        m_instanceBvhs.push_back(modelBvh.get());
+    }
+    m_topLevel.build(bounds);
+}
+
+}  // namespace odyssey
\ No newline at end of file
@@ -6,6 +6,7 @@
 
 #include "odyssey_pipeline.h"
 
+#include <cstddef>
 #include <cstring>
 #include <fstream>
 #include <stdexcept>
@@ -28,6 +29,9 @@ OdysseyPipeline::~OdysseyPipeline() {
 PipelineConfigInfo OdysseyPipeline::defaultPipelineConfigInfo(vk::PrimitiveTopology primitiveTopology, float lineWidth) {
     PipelineConfigInfo config{};
 
+    config.bindingDescriptions = OdysseyModel::Vertex::getBindingDescriptions();
+    config.attributeDescriptions = OdysseyModel::Vertex::getAttributeDescriptions();
+
     config.viewportInfo
         .setViewportCount(1)
         .setPViewports(nullptr)
@@ -94,7 +98,7 @@ PipelineConfigInfo OdysseyPipeline::defaultPipelineConfigInfo(vk::PrimitiveTopol
     return config;
 }
 
-void OdysseyPipeline::bind(const vk::CommandBuffer& buffer) {
+void OdysseyPipeline::bind(const vk::CommandBuffer& buffer) const {
     buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, m_graphicsPipeline);
 }
 
@@ -104,26 +108,33 @@ void OdysseyPipeline::createGraphicsPipeline(const std::string& vertShaderPath,
     vertShaderModule = createShaderModule(vertShaderCode);
     fragShaderModule = createShaderModule(fragShaderCode);
 
+    vk::SpecializationInfo specializationInfo{};
+    specializationInfo
+        .setMapEntries(config.specializationEntries)
+        .setDataSize(config.specializationData.size())
+        .setPData(config.specializationData.data());
+    const auto* pSpecializationInfo = config.specializationEntries.empty() ? nullptr : &specializationInfo;
+
     vk::PipelineShaderStageCreateInfo vertShaderStageInfo;
     vertShaderStageInfo
         .setStage(vk::ShaderStageFlagBits::eVertex)
         .setModule(vertShaderModule)
-        .setPName("main");
+        .setPName("main")
+        .setPSpecializationInfo(pSpecializationInfo);
 
     vk::PipelineShaderStageCreateInfo fragShaderStageInfo;
     fragShaderStageInfo
         .setStage(vk::ShaderStageFlagBits::eFragment)
         .setModule(fragShaderModule)
-        .setPName("main");
+        .setPName("main")
+        .setPSpecializationInfo(pSpecializationInfo);
 
     vk::PipelineVertexInputStateCreateInfo vertexInputInfo;
-    auto bindingDescriptions = OdysseyModel::Vertex::getBindingDescriptions();
-    auto attributeDescriptions = OdysseyModel::Vertex::getAttributeDescriptions();
     vertexInputInfo
-        .setVertexBindingDescriptionCount(static_cast<uint32_t>(bindingDescriptions.size()))
-        .setVertexBindingDescriptions(bindingDescriptions)
-        .setVertexAttributeDescriptionCount(static_cast<uint32_t>(attributeDescriptions.size()))
-        .setVertexAttributeDescriptions(attributeDescriptions);
+        .setVertexBindingDescriptionCount(static_cast<uint32_t>(config.bindingDescriptions.size()))
+        .setVertexBindingDescriptions(config.bindingDescriptions)
+        .setVertexAttributeDescriptionCount(static_cast<uint32_t>(config.attributeDescriptions.size()))
+        .setVertexAttributeDescriptions(config.attributeDescriptions);
 
     std::array<vk::PipelineShaderStageCreateInfo, 2> shaderStages{vertShaderStageInfo, fragShaderStageInfo};
 
@@ -144,7 +155,7 @@ void OdysseyPipeline::createGraphicsPipeline(const std::string& vertShaderPath,
         .setSubpass(config.subpass)
         .setBasePipelineIndex(-1)
         .setBasePipelineHandle(nullptr);
-    m_graphicsPipeline = m_device->device().createGraphicsPipeline(nullptr, pipelineInfo).value;
+    m_graphicsPipeline = m_device->device().createGraphicsPipeline(m_device->getPipelineCache(), pipelineInfo).value;
 }
 
 std::vector<char> OdysseyPipeline::readFile(const std::string& path) {
@@ -167,4 +178,72 @@ vk::ShaderModule OdysseyPipeline::createShaderModule(const std::vector<char>& co
     return m_device->device().createShaderModule(createInfo);
 }
 
+OdysseyComputePipeline::OdysseyComputePipeline(OdysseyDevice* device, const std::string& compShaderPath, vk::PipelineLayout pipelineLayout) : m_device(device) {
+    auto compShaderCode = OdysseyPipeline::readFile(compShaderPath);
+    vk::ShaderModuleCreateInfo createInfo{};
+    createInfo.setCodeSize(compShaderCode.size());
+    createInfo.pCode = reinterpret_cast<const uint32_t*>(compShaderCode.data());
+    compShaderModule = m_device->device().createShaderModule(createInfo);
+
+    vk::PipelineShaderStageCreateInfo compShaderStageInfo;
+    compShaderStageInfo
+        .setStage(vk::ShaderStageFlagBits::eCompute)
+        .setModule(compShaderModule)
+        .setPName("main");
+
+    vk::ComputePipelineCreateInfo pipelineInfo;
+    pipelineInfo
+        .setStage(compShaderStageInfo)
+        .setLayout(pipelineLayout)
+        .setBasePipelineIndex(-1)
+        .setBasePipelineHandle(nullptr);
+    m_computePipeline = m_device->device().createComputePipeline(m_device->getPipelineCache(), pipelineInfo).value;
+}
+
+OdysseyComputePipeline::~OdysseyComputePipeline() {
+    m_device->device().destroyShaderModule(compShaderModule);
+    m_device->device().destroyPipeline(m_computePipeline);
+}
+
+void OdysseyComputePipeline::bind(const vk::CommandBuffer& buffer) const {
+    buffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_computePipeline);
+}
+
+bool PipelineVariant::operator==(const PipelineVariant& other) const {
+    return primitiveTopology == other.primitiveTopology && lineWidth == other.lineWidth && lightingModel == other.lightingModel && debugView == other.debugView && directionToLight == other.directionToLight && runtimeBranching == other.runtimeBranching && impostorFade == other.impostorFade;
+}
+
+void PipelineVariant::specialize(PipelineConfigInfo& config) const {
+    // Must match the constant_id layout in shader.vert and shader.frag.
+    struct SpecializationData {
+        uint32_t lightingModel;
+        uint32_t debugView;
+        VkBool32 runtimeBranching;
+        float lightX;
+        float lightY;
+        float lightZ;
+        VkBool32 impostorFade;
+    };
+    SpecializationData data{
+        static_cast<uint32_t>(lightingModel),
+        static_cast<uint32_t>(debugView),
+        runtimeBranching ? VK_TRUE : VK_FALSE,
+        directionToLight.x,
+        directionToLight.y,
+        directionToLight.z,
+        impostorFade ? VK_TRUE : VK_FALSE,
+    };
+    config.specializationEntries = {
+        {0, offsetof(SpecializationData, lightingModel), sizeof(uint32_t)},
+        {1, offsetof(SpecializationData, debugView), sizeof(uint32_t)},
+        {2, offsetof(SpecializationData, runtimeBranching), sizeof(VkBool32)},
+        {3, offsetof(SpecializationData, lightX), sizeof(float)},
+        {4, offsetof(SpecializationData, lightY), sizeof(float)},
+        {5, offsetof(SpecializationData, lightZ), sizeof(float)},
+        {6, offsetof(SpecializationData, impostorFade), sizeof(VkBool32)},
+    };
+    config.specializationData.resize(sizeof(SpecializationData));
+    memcpy(config.specializationData.data(), &data, sizeof(SpecializationData));
+}
+
 }  // namespace odyssey
\ No newline at end of file
@@ -0,0 +1,226 @@
+/**
+ * @file odyssey_point_cloud.cpp
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include "odyssey_point_cloud.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <fstream>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+
+#include "odyssey_culling.h"
+#include "odyssey_profiler.h"
+
+namespace odyssey {
+
+std::vector<vk::VertexInputBindingDescription> OdysseyPointCloudFile::Point::getBindingDescriptions() {
+    std::vector<vk::VertexInputBindingDescription> bindingDescriptions(1);
+    bindingDescriptions.at(0)
+        .setBinding(0)
+        .setStride(sizeof(Point))
+        .setInputRate(vk::VertexInputRate::eVertex);
+    return bindingDescriptions;
+}
+
+std::vector<vk::VertexInputAttributeDescription> OdysseyPointCloudFile::Point::getAttributeDescriptions() {
+    std::vector<vk::VertexInputAttributeDescription> attributeDescriptions{};
+    attributeDescriptions.push_back({0, 0, vk::Format::eR32G32B32Sfloat, static_cast<uint32_t>(offsetof(Point, position))});
+    attributeDescriptions.push_back({1, 0, vk::Format::eR8G8B8A8Unorm, static_cast<uint32_t>(offsetof(Point, color))});
+    return attributeDescriptions;
+}
+
+OdysseyPointCloud::OdysseyPointCloud(OdysseyDevice* device, const std::string& path, size_t pointBudget, const glm::vec3& center, float size) : m_pointBudget(pointBudget) {
+    m_openTime = OdysseyProfiler::instance().now();
+    std::ifstream file(path, std::ios::binary);
+    if (!file.read(reinterpret_cast<char*>(&m_header), sizeof(m_header)) || m_header.magic != OdysseyPointCloudFile::MAGIC || m_header.version != OdysseyPointCloudFile::VERSION) {
+        throw std::runtime_error("Not a point cloud octree: " + path);
+    }
+    m_nodes.resize(m_header.nodeCount);
+    file.seekg(static_cast<std::streamoff>(m_header.nodeTableOffset));
+    if (m_nodes.empty() || !file.read(reinterpret_cast<char*>(m_nodes.data()), static_cast<std::streamsize>(m_nodes.size() * sizeof(OdysseyPointCloudFile::Node)))) {
+        throw std::runtime_error("Failed to read the node table of " + path);
+    }
+    auto scale = size / m_nodes[0].size;
+    m_placement = glm::vec4(center - (m_nodes[0].min + m_nodes[0].size * 0.5F) * scale, scale);
+    std::vector<OdysseyStreamResidency::Range> ranges{};
+    ranges.reserve(m_nodes.size());
+    for (const auto& node : m_nodes) {
+        ranges.push_back({node.pointOffset, node.pointCount * sizeof(OdysseyPointCloudFile::Point)});
+    }
+    m_lastDrawn.resize(m_nodes.size());
+    m_residency = std::make_unique<OdysseyStreamResidency>(device, path, std::move(ranges), vk::BufferUsageFlagBits::eVertexBuffer, vk::AccessFlagBits::eVertexAttributeRead);
+}
+
+OdysseyPointCloud::~OdysseyPointCloud() = default;
+
+void OdysseyPointCloud::update(vk::CommandBuffer commandBuffer, const OdysseyCamera& camera, vk::Extent2D extent, size_t frameIndex) {
+    ++m_frame;
+    m_residency->beginFrame(frameIndex);
+    m_residency->upload(commandBuffer, frameIndex, MAX_UPLOADS_PER_FRAME, [this, frameIndex](uint32_t node, uint64_t size) {
+        // Nodes that no longer fit are requested again when next wanted.
+        if (!makeRoom(size, frameIndex)) {
+            return false;
+        }
+        m_lastDrawn[node] = m_frame;
+        return true;
+    });
+    select(camera, extent);
+
+    size_t drawnPoints{0};
+    for (const auto& draw : m_draws) {
+        drawnPoints += draw.pointCount;
+    }
+    if (!m_firstDrawn && !m_draws.empty()) {
+        m_firstDrawn = true;
+        auto& profiler = OdysseyProfiler::instance();
+        auto now = profiler.now();
+        profiler.recordPhase("point cloud first draw", m_openTime, now);
+        profiler.setCounter("point cloud first points (ms)", now - m_openTime);
+    }
+    auto& profiler = OdysseyProfiler::instance();
+    profiler.setCounter("point cloud nodes drawn", static_cast<double>(m_draws.size()));
+    profiler.setCounter("point cloud points drawn", static_cast<double>(drawnPoints));
+    profiler.setCounter("point cloud resident points", static_cast<double>(m_residency->getResidentBytes() / sizeof(OdysseyPointCloudFile::Point)));
+    profiler.setCounter("point cloud loads pending", static_cast<double>(m_residency->getPendingCount()));
+    profiler.setCounter("point cloud MB read", static_cast<double>(m_residency->getBytesRead()) / (1024.0 * 1024.0));
+}
+
+const std::vector<OdysseyPointCloud::Draw>& OdysseyPointCloud::getDraws() const {
+    return m_draws;
+}
+
+const glm::vec4& OdysseyPointCloud::getPlacement() const {
+    return m_placement;
+}
+
+uint64_t OdysseyPointCloud::getPointCount() const {
+    return m_header.pointCount;
+}
+
+bool OdysseyPointCloud::makeRoom(uint64_t size, size_t frameIndex) {
+    auto fits = [this, size]() {
+        return m_residency->getResidentBytes() + size <= m_pointBudget * sizeof(OdysseyPointCloudFile::Point);
+    };
+    if (fits()) {
+        return true;
+    }
+    // Least recently drawn first; nodes drawn last frame stay.
+    std::vector<uint32_t> candidates{};
+    for (uint32_t node = 0; node < m_nodes.size(); ++node) {
+        if (m_residency->getState(node) == OdysseyStreamResidency::State::RESIDENT && m_lastDrawn[node] + 1 < m_frame) {
+            candidates.push_back(node);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [this](uint32_t a, uint32_t b) {
+        return m_lastDrawn[a] < m_lastDrawn[b];
+    });
+    for (auto node : candidates) {
+        if (fits()) {
+            break;
+        }
+        m_residency->evict(node, frameIndex);
+    }
+    return fits();
+}
+
+void OdysseyPointCloud::select(const OdysseyCamera& camera, vk::Extent2D extent) {
+    m_draws.clear();
+    auto frustum = OdysseyFrustum::fromMatrix(camera.getProjection() * camera.getView());
+    auto cameraPosition = glm::vec3(glm::inverse(camera.getView())[3]);
+    auto pixelsPerUnit = camera.getProjection()[1][1] * static_cast<float>(extent.height) * 0.5F;
+
+    // Largest spacing first, so the budget goes where it shows most.
+    std::vector<std::pair<float, uint32_t>> wanted{};
+    std::priority_queue<std::pair<float, uint32_t>> open{};
+    size_t drawnPoints{0};
+    auto request = [this, &wanted](uint32_t node, float spacing) {
+        if (m_residency->getState(node) != OdysseyStreamResidency::State::RESIDENT) {
+            wanted.emplace_back(spacing, node);
+        }
+    };
+    if (isVisible(0, frustum.planes)) {
+        if (m_residency->getState(0) == OdysseyStreamResidency::State::RESIDENT) {
+            open.emplace(projectedSpacing(0, cameraPosition, pixelsPerUnit), 0);
+            drawnPoints = m_nodes[0].pointCount;
+        } else {
+            request(0, projectedSpacing(0, cameraPosition, pixelsPerUnit));
+        }
+    }
+    std::vector<uint32_t> children{};
+    while (!open.empty()) {
+        auto [spacing, node] = open.top();
+        open.pop();
+        const auto& fileNode = m_nodes[node];
+        m_lastDrawn[node] = m_frame;
+        if (fileNode.childMask != 0 && spacing > MAX_POINT_SPACING_PIXELS) {
+            children.clear();
+            bool resident{true};
+            size_t childPoints{0};
+            auto childCount = static_cast<uint32_t>(std::popcount(fileNode.childMask));
+            for (auto child = fileNode.firstChild; child < fileNode.firstChild + childCount; ++child) {
+                if (!isVisible(child, frustum.planes)) {
+                    continue;
+                }
+                children.push_back(child);
+                childPoints += m_nodes[child].pointCount;
+                if (m_residency->getState(child) != OdysseyStreamResidency::State::RESIDENT) {
+                    resident = false;
+                    request(child, projectedSpacing(child, cameraPosition, pixelsPerUnit));
+                }
+            }
+            // Children replace the parent only once all of them can be drawn.
+            if (resident && drawnPoints - fileNode.pointCount + childPoints <= m_pointBudget) {
+                drawnPoints = drawnPoints - fileNode.pointCount + childPoints;
+                for (auto child : children) {
+                    open.emplace(projectedSpacing(child, cameraPosition, pixelsPerUnit), child);
+                }
+                continue;
+            }
+        }
+        m_draws.push_back({m_residency->getBuffer(node), fileNode.pointCount});
+    }
+
+    std::sort(wanted.begin(), wanted.end());
+    std::vector<uint32_t> requests{};
+    requests.reserve(wanted.size());
+    for (const auto& entry : wanted) {
+        requests.push_back(entry.second);
+    }
+    m_residency->request(requests);
+}
+
+float OdysseyPointCloud::projectedSpacing(uint32_t node, const glm::vec3& cameraPosition, float pixelsPerUnit) const {
+    auto sphere = getWorldSphere(node);
+    auto distance = glm::length(glm::vec3(sphere) - cameraPosition);
+    if (distance <= sphere.w) {
+        return std::numeric_limits<float>::infinity();
+    }
+    auto pixels = 2.0F * sphere.w / distance * pixelsPerUnit;
+    return pixels / static_cast<float>(OdysseyPointCloudFile::SAMPLE_GRID);
+}
+
+bool OdysseyPointCloud::isVisible(uint32_t node, const std::array<glm::vec4, 6>& planes) const {
+    auto sphere = getWorldSphere(node);
+    for (const auto& plane : planes) {
+        if (glm::dot(glm::vec3(plane), glm::vec3(sphere)) + plane.w < -sphere.w) {
+            return false;
+        }
+    }
+    return true;
+}
+
+glm::vec4 OdysseyPointCloud::getWorldSphere(uint32_t node) const {
+    const auto& fileNode = m_nodes[node];
+    auto scale = m_placement.w;
+    auto center = (fileNode.min + fileNode.size * 0.5F) * scale + glm::vec3(m_placement);
+    // Half the cube's diagonal.
+    return {center, fileNode.size * scale * 0.8660254F};
+}
+
+}  // namespace odyssey
\ No newline at end of file
@@ -0,0 +1,328 @@
+/**
+ * @file odyssey_point_cloud_converter.cpp
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include "odyssey_point_cloud_converter.h"
+
+#include <algorithm>
+#include <charconv>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace odyssey {
+
+namespace {
+
+// Up to six numbers separated by spaces, tabs or commas; returns how many.
+size_t parseLine(std::string_view line, std::array<double, 6>& values) {
+    size_t count{0};
+    const auto* begin = line.data();
+    const auto* end = line.data() + line.size();
+    while (begin < end && count < values.size()) {
+        while (begin < end && (*begin == ' ' || *begin == '\t' || *begin == ',' || *begin == '\r')) {
+            ++begin;
+        }
+        if (begin == end) {
+            break;
+        }
+        auto [next, error] = std::from_chars(begin, end, values[count]);
+        if (error != std::errc{}) {
+            break;
+        }
+        ++count;
+        begin = next;
+    }
+    return count;
+}
+
+uint32_t packColor(const std::array<double, 6>& values, size_t count) {
+    if (count < 6) {
+        return 0xFFFFFFFF;
+    }
+    auto channel = [&values](size_t index) {
+        return static_cast<uint32_t>(std::clamp(values[index], 0.0, 255.0));
+    };
+    return channel(3) | (channel(4) << 8) | (channel(5) << 16) | 0xFF000000;
+}
+
+uint32_t getOctant(const glm::vec3& position, const glm::vec3& center) {
+    return (position.x >= center.x ? 1U : 0U) | (position.y >= center.y ? 2U : 0U) | (position.z >= center.z ? 4U : 0U);
+}
+
+glm::vec3 getOctantMin(const glm::vec3& min, float size, uint32_t octant) {
+    auto half = size * 0.5F;
+    return min + glm::vec3((octant & 1U) ? half : 0.0F, (octant & 2U) ? half : 0.0F, (octant & 4U) ? half : 0.0F);
+}
+
+void appendPoints(const std::filesystem::path& path, std::vector<OdysseyPointCloudFile::Point>& points) {
+    if (points.empty()) {
+        return;
+    }
+    std::ofstream file(path, std::ios::binary | std::ios::app);
+    if (!file.write(reinterpret_cast<const char*>(points.data()), static_cast<std::streamsize>(points.size() * sizeof(OdysseyPointCloudFile::Point)))) {
+        throw std::runtime_error("Failed to write point chunk " + path.string());
+    }
+    points.clear();
+}
+
+}  // namespace
+
+uint64_t OdysseyPointCloudConverter::convert(const std::string& inputPath, const std::string& outputPath) {
+    std::ifstream input(inputPath);
+    if (!input) {
+        throw std::runtime_error("Failed to open point list " + inputPath);
+    }
+    std::string line{};
+    std::array<double, 6> values{};
+    glm::dvec3 boundsMin{std::numeric_limits<double>::max()};
+    glm::dvec3 boundsMax{std::numeric_limits<double>::lowest()};
+    uint64_t pointCount{0};
+    while (std::getline(input, line)) {
+        if (parseLine(line, values) < 3) {
+            continue;
+        }
+        glm::dvec3 position{values[0], values[1], values[2]};
+        boundsMin = glm::min(boundsMin, position);
+        boundsMax = glm::max(boundsMax, position);
+        ++pointCount;
+    }
+    if (pointCount == 0) {
+        throw std::runtime_error("No points in " + inputPath);
+    }
+    auto extent = boundsMax - boundsMin;
+    // Slightly larger, so the largest coordinates fall inside the last cells.
+    auto size = (std::max)({extent.x, extent.y, extent.z, 1e-6}) * 1.0001;
+    m_header.origin = boundsMin;
+    m_header.size = size;
+    m_header.pointCount = pointCount;
+    // Scans sample surfaces, so each level splits the points about four ways.
+    m_chunkLevel = 0;
+    while (m_chunkLevel < MAX_CHUNK_LEVEL && (pointCount >> (2 * m_chunkLevel)) > CHUNK_POINTS) {
+        ++m_chunkLevel;
+    }
+    std::cout << "Converting " << pointCount << " points from " << inputPath << " into " << (1U << (3 * m_chunkLevel)) << " chunks" << std::endl;
+
+    m_tempDirectory = outputPath + ".chunks";
+    std::filesystem::remove_all(m_tempDirectory);
+    std::filesystem::create_directories(m_tempDirectory);
+    auto cellsPerAxis = 1U << m_chunkLevel;
+    auto rootSize = static_cast<float>(size);
+    std::vector<std::vector<Point>> buffers(static_cast<size_t>(cellsPerAxis) * cellsPerAxis * cellsPerAxis);
+    auto getBufferPath = [this, cellsPerAxis](size_t index) {
+        auto x = static_cast<uint32_t>(index % cellsPerAxis);
+        auto y = static_cast<uint32_t>(index / cellsPerAxis % cellsPerAxis);
+        auto z = static_cast<uint32_t>(index / cellsPerAxis / cellsPerAxis);
+        return getChunkPath({x, y, z});
+    };
+    input.clear();
+    input.seekg(0);
+    while (std::getline(input, line)) {
+        auto count = parseLine(line, values);
+        if (count < 3) {
+            continue;
+        }
+        Point point{};
+        point.position = glm::vec3(glm::dvec3(values[0], values[1], values[2]) - m_header.origin);
+        point.color = packColor(values, count);
+        auto cell = glm::min(glm::uvec3(point.position / rootSize * static_cast<float>(cellsPerAxis)), glm::uvec3(cellsPerAxis - 1));
+        auto index = cell.x + cellsPerAxis * (cell.y + cellsPerAxis * cell.z);
+        auto& buffer = buffers[index];
+        buffer.push_back(point);
+        if (buffer.size() >= FLUSH_POINTS) {
+            appendPoints(getBufferPath(index), buffer);
+        }
+    }
+    for (size_t index = 0; index < buffers.size(); ++index) {
+        appendPoints(getBufferPath(index), buffers[index]);
+    }
+    buffers.clear();
+
+    m_output.open(outputPath, std::ios::binary | std::ios::trunc);
+    if (!m_output) {
+        throw std::runtime_error("Failed to create " + outputPath);
+    }
+    // Rewritten with the node table's place once it is known.
+    m_output.write(reinterpret_cast<const char*>(&m_header), sizeof(m_header));
+    m_nodes.clear();
+    auto root = buildUpper(glm::vec3(0.0F), rootSize, 0, glm::uvec3(0));
+    writeNodeTable();
+    m_output.close();
+    std::filesystem::remove_all(m_tempDirectory);
+    if (!root) {
+        throw std::runtime_error("No points in " + inputPath);
+    }
+    std::cout << "Wrote " << m_header.nodeCount << " octree nodes to " << outputPath << std::endl;
+    return pointCount;
+}
+
+std::optional<OdysseyPointCloudConverter::Subtree> OdysseyPointCloudConverter::buildUpper(const glm::vec3& min, float size, uint32_t level, const glm::uvec3& cell) {
+    if (level == m_chunkLevel) {
+        return buildChunk(getChunkPath(cell), min, size, level);
+    }
+    std::vector<std::optional<Subtree>> children(8);
+    bool empty{true};
+    for (uint32_t octant = 0; octant < 8; ++octant) {
+        glm::uvec3 childCell = cell * 2U + glm::uvec3(octant & 1U, (octant >> 1) & 1U, (octant >> 2) & 1U);
+        children[octant] = buildUpper(getOctantMin(min, size, octant), size * 0.5F, level + 1, childCell);
+        empty = empty && !children[octant];
+    }
+    if (empty) {
+        return std::nullopt;
+    }
+    return addInner(children, min, size);
+}
+
+std::optional<OdysseyPointCloudConverter::Subtree> OdysseyPointCloudConverter::buildChunk(const std::filesystem::path& path, const glm::vec3& min, float size, uint32_t level) {
+    if (!std::filesystem::exists(path)) {
+        return std::nullopt;
+    }
+    auto count = std::filesystem::file_size(path) / sizeof(Point);
+    if (count == 0) {
+        std::filesystem::remove(path);
+        return std::nullopt;
+    }
+    std::ifstream file(path, std::ios::binary);
+    if (count <= MAX_CHUNK_POINTS || level >= MAX_LEVEL) {
+        std::vector<Point> points(count);
+        file.read(reinterpret_cast<char*>(points.data()), static_cast<std::streamsize>(count * sizeof(Point)));
+        file.close();
+        std::filesystem::remove(path);
+        return buildInMemory(std::move(points), min, size, level);
+    }
+
+    // Too dense to hold at once: split into octant files and build those.
+    auto center = min + size * 0.5F;
+    std::array<std::filesystem::path, 8> childPaths{};
+    std::array<std::vector<Point>, 8> buffers{};
+    for (uint32_t octant = 0; octant < 8; ++octant) {
+        childPaths[octant] = path;
+        childPaths[octant] += "." + std::to_string(octant);
+    }
+    std::vector<Point> block(FLUSH_POINTS * 64);
+    for (uint64_t read = 0; read < count; read += block.size()) {
+        auto blockCount = (std::min)(static_cast<uint64_t>(block.size()), count - read);
+        file.read(reinterpret_cast<char*>(block.data()), static_cast<std::streamsize>(blockCount * sizeof(Point)));
+        for (uint64_t i = 0; i < blockCount; ++i) {
+            auto octant = getOctant(block[i].position, center);
+            buffers[octant].push_back(block[i]);
+            if (buffers[octant].size() >= FLUSH_POINTS) {
+                appendPoints(childPaths[octant], buffers[octant]);
+            }
+        }
+    }
+    file.close();
+    std::filesystem::remove(path);
+    std::vector<std::optional<Subtree>> children(8);
+    for (uint32_t octant = 0; octant < 8; ++octant) {
+        appendPoints(childPaths[octant], buffers[octant]);
+        children[octant] = buildChunk(childPaths[octant], getOctantMin(min, size, octant), size * 0.5F, level + 1);
+    }
+    return addInner(children, min, size);
+}
+
+OdysseyPointCloudConverter::Subtree OdysseyPointCloudConverter::buildInMemory(std::vector<Point> points, const glm::vec3& min, float size, uint32_t level) {
+    if (points.size() <= MAX_LEAF_POINTS || level >= MAX_LEVEL) {
+        auto node = writeNode(points, min, size);
+        return {node, std::move(points)};
+    }
+    auto center = min + size * 0.5F;
+    std::array<std::vector<Point>, 8> octants{};
+    for (const auto& point : points) {
+        octants[getOctant(point.position, center)].push_back(point);
+    }
+    points = std::vector<Point>{};
+    std::vector<std::optional<Subtree>> children(8);
+    for (uint32_t octant = 0; octant < 8; ++octant) {
+        if (!octants[octant].empty()) {
+            children[octant] = buildInMemory(std::move(octants[octant]), getOctantMin(min, size, octant), size * 0.5F, level + 1);
+        }
+    }
+    return addInner(children, min, size);
+}
+
+OdysseyPointCloudConverter::Subtree OdysseyPointCloudConverter::addInner(std::vector<std::optional<Subtree>>& children, const glm::vec3& min, float size) {
+    // The first point to reach each cell of the sample grid stands for it.
+    constexpr auto grid = OdysseyPointCloudFile::SAMPLE_GRID;
+    std::vector<bool> occupied(static_cast<size_t>(grid) * grid * grid);
+    std::vector<Point> samples{};
+    for (const auto& child : children) {
+        if (!child) {
+            continue;
+        }
+        for (const auto& point : child->points) {
+            auto cell = glm::min(glm::uvec3((point.position - min) / size * static_cast<float>(grid)), glm::uvec3(grid - 1));
+            auto index = cell.x + grid * (cell.y + grid * cell.z);
+            if (!occupied[index]) {
+                occupied[index] = true;
+                samples.push_back(point);
+            }
+        }
+    }
+    auto node = writeNode(samples, min, size);
+    for (uint32_t octant = 0; octant < 8; ++octant) {
+        if (children[octant]) {
+            m_nodes[node].children[octant] = children[octant]->node;
+            children[octant].reset();
+        }
+    }
+    return {node, std::move(samples)};
+}
+
+int32_t OdysseyPointCloudConverter::writeNode(const std::vector<Point>& points, const glm::vec3& min, float size) {
+    BuildNode buildNode{};
+    buildNode.node.min = min;
+    buildNode.node.size = size;
+    buildNode.node.pointOffset = static_cast<uint64_t>(m_output.tellp());
+    buildNode.node.pointCount = static_cast<uint32_t>(points.size());
+    if (!m_output.write(reinterpret_cast<const char*>(points.data()), static_cast<std::streamsize>(points.size() * sizeof(Point)))) {
+        throw std::runtime_error("Failed to write point cloud nodes");
+    }
+    m_nodes.push_back(buildNode);
+    return static_cast<int32_t>(m_nodes.size() - 1);
+}
+
+void OdysseyPointCloudConverter::writeNodeTable() {
+    if (m_nodes.empty()) {
+        return;
+    }
+    // Breadth first, so each node's children are contiguous; the root was
+    // written last.
+    std::vector<int32_t> order{static_cast<int32_t>(m_nodes.size() - 1)};
+    std::vector<OdysseyPointCloudFile::Node> table{};
+    table.reserve(m_nodes.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        const auto& buildNode = m_nodes[order[i]];
+        auto node = buildNode.node;
+        node.firstChild = static_cast<uint32_t>(order.size());
+        node.childMask = 0;
+        for (uint32_t octant = 0; octant < 8; ++octant) {
+            if (buildNode.children[octant] >= 0) {
+                node.childMask |= 1U << octant;
+                order.push_back(buildNode.children[octant]);
+            }
+        }
+        if (node.childMask == 0) {
+            node.firstChild = 0;
+        }
+        table.push_back(node);
+    }
+    m_header.nodeCount = static_cast<uint32_t>(table.size());
+    m_header.nodeTableOffset = static_cast<uint64_t>(m_output.tellp());
+    m_output.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(table.size() * sizeof(OdysseyPointCloudFile::Node)));
+    m_output.seekp(0);
+    m_output.write(reinterpret_cast<const char*>(&m_header), sizeof(m_header));
+    if (!m_output) {
+        throw std::runtime_error("Failed to write the point cloud node table");
+    }
+}
+
+std::filesystem::path OdysseyPointCloudConverter::getChunkPath(const glm::uvec3& cell) const {
+    return m_tempDirectory / (std::to_string(cell.x) + "_" + std::to_string(cell.y) + "_" + std::to_string(cell.z) + ".bin");
+}
+
+}  // namespace odyssey
\ No newline at end of file
@@ -0,0 +1,117 @@
+/**
+ * @file odyssey_profiler.cpp
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include "odyssey_profiler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+
+namespace odyssey {
+
+OdysseyProfiler::Scope::Scope(std::string name) : m_name(std::move(name)), m_start(OdysseyProfiler::instance().now()) {
+}
+
+OdysseyProfiler::Scope::~Scope() {
+    auto& profiler = OdysseyProfiler::instance();
+    profiler.recordPhase(m_name, m_start, profiler.now());
+}
+
+OdysseyProfiler& OdysseyProfiler::instance() {
+    static OdysseyProfiler profiler;
+    return profiler;
+}
+
+OdysseyProfiler::OdysseyProfiler() : m_origin(std::chrono::steady_clock::now()), m_mainThread(std::this_thread::get_id()) {
+}
+
+double OdysseyProfiler::now() const {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_origin).count();
+}
+
+void OdysseyProfiler::recordPhase(const std::string& name, double start, double end) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_phases.push_back({name, start, end, std::this_thread::get_id()});
+}
+
+void OdysseyProfiler::setCounter(const std::string& name, double value) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_counters[name] = value;
+}
+
+void OdysseyProfiler::addCounter(const std::string& name, double value) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_counters[name] += value;
+}
+
+double OdysseyProfiler::getCounter(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto iter = m_counters.find(name);
+    return iter == m_counters.end() ? 0.0 : iter->second;
+}
+
+void OdysseyProfiler::addSample(const std::string& name, double milliseconds) {
+    auto bucket = std::upper_bound(HISTOGRAM_BOUNDS.begin(), HISTOGRAM_BOUNDS.end(), milliseconds) - HISTOGRAM_BOUNDS.begin();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& histogram = m_histograms[name];
+    ++histogram.counts[static_cast<size_t>(bucket)];
+    ++histogram.count;
+    histogram.total += milliseconds;
+    histogram.max = (std::max)(histogram.max, milliseconds);
+}
+
+std::string OdysseyProfiler::report() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto phases = m_phases;
+    std::sort(phases.begin(), phases.end(), [](const Phase& lhs, const Phase& rhs) {
+        return lhs.start < rhs.start;
+    });
+    std::vector<std::thread::id> threads{m_mainThread};
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(2);
+    stream << "phase                          start(ms)    end(ms)  duration(ms)  thread\n";
+    for (const auto& phase : phases) {
+        auto iter = std::find(threads.begin(), threads.end(), phase.thread);
+        if (iter == threads.end()) {
+            iter = threads.insert(threads.end(), phase.thread);
+        }
+        auto threadIndex = std::distance(threads.begin(), iter);
+        stream << std::left << std::setw(30) << phase.name << std::right
+               << std::setw(11) << phase.start
+               << std::setw(11) << phase.end
+               << std::setw(14) << phase.end - phase.start
+               << "  " << (threadIndex == 0 ? std::string("main") : "worker " + std::to_string(threadIndex)) << "\n";
+    }
+    for (const auto& [name, value] : m_counters) {
+        stream << std::left << std::setw(30) << name << std::right << std::setw(11) << value << "\n";
+    }
+    return stream.str();
+}
+
+std::string OdysseyProfiler::histogramReport() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(2);
+    stream << std::left << std::setw(30) << "histogram" << std::right << std::setw(8) << "count" << std::setw(10) << "avg(ms)" << std::setw(10) << "max(ms)";
+    for (auto bound : HISTOGRAM_BOUNDS) {
+        stream << std::setw(8) << "<=" + std::to_string(static_cast<int>(bound));
+    }
+    stream << std::setw(8) << ">" + std::to_string(static_cast<int>(HISTOGRAM_BOUNDS.back())) << "\n";
+    for (const auto& [name, histogram] : m_histograms) {
+        stream << std::left << std::setw(30) << name << std::right
+               << std::setw(8) << histogram.count
+               << std::setw(10) << (histogram.count > 0 ? histogram.total / static_cast<double>(histogram.count) : 0.0)
+               << std::setw(10) << histogram.max;
+        for (auto count : histogram.counts) {
+            stream << std::setw(8) << count;
+        }
+        stream << "\n";
+    }
+    return stream.str();
+}
+
+}  // namespace odyssey
\ No newline at end of file
@@ -0,0 +1,120 @@
+/**
+ * @file odyssey_redraw_scheduler.cpp
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include "odyssey_redraw_scheduler.h"
+
+#include <algorithm>
+#include <array>
+#include <sstream>
+#include <utility>
+
+#include "odyssey_profiler.h"
+
+namespace odyssey {
+
+OdysseyRedrawScheduler::OdysseyRedrawScheduler(const OdysseyRedrawPolicy& policy, DrawCallback drawCallback) : m_policy(policy), m_drawCallback(std::move(drawCallback)), m_animating(policy.continuous) {
+}
+
+void OdysseyRedrawScheduler::markDirty(uint32_t dirtyFlags) {
+    if (m_dirtyFlags != DIRTY_NONE) {
+        ++m_coalescedRequests;
+    }
+    m_dirtyFlags |= dirtyFlags;
+    scheduleNext();
+}
+
+void OdysseyRedrawScheduler::setAnimating(bool animating) {
+    m_animating = animating || m_policy.continuous;
+    scheduleNext();
+}
+
+bool OdysseyRedrawScheduler::isAnimating() const {
+    return m_animating;
+}
+
+std::optional<OdysseyRedrawScheduler::Clock::time_point> OdysseyRedrawScheduler::getDeadline() const {
+    return m_deadline;
+}
+
+std::string OdysseyRedrawScheduler::report() const {
+    auto since = Clock::now() - std::chrono::minutes(1);
+    auto inLastMinute = [since](const std::deque<Clock::time_point>& times) {
+        return std::count_if(times.begin(), times.end(), [since](const auto& time) {
+            return time >= since;
+        });
+    };
+    std::ostringstream report;
+    report << "Redraw: " << inLastMinute(m_frames) << " frames/min, "
+           << inLastMinute(m_wakeups) << " wakeups/min, "
+           << m_coalescedRequests << " requests coalesced, "
+           << "last CPU frame " << m_frameTime << " ms\n";
+    return report.str();
+}
+
+void OdysseyRedrawScheduler::schedule(Clock::time_point deadline) {
+    if (m_deadline && *m_deadline <= deadline) {
+        return;
+    }
+    m_deadline = deadline;
+}
+
+void OdysseyRedrawScheduler::scheduleNext() {
+    if (m_dirtyFlags != DIRTY_NONE || m_animating) {
+        auto interval = m_policy.maxFps > 0 ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_policy.maxFps)) : Clock::duration::zero();
+        schedule(m_lastFrame + interval);
+    } else if (m_policy.idleRefresh > 0) {
+        schedule(m_lastFrame + std::chrono::seconds(m_policy.idleRefresh));
+    } else {
+        m_deadline.reset();
+    }
+}
+
+void OdysseyRedrawScheduler::fire() {
+    m_deadline.reset();
+    auto start = Clock::now();
+    m_wakeups.push_back(start);
+    auto dirtyFlags = m_dirtyFlags | (m_animating ? DIRTY_ANIMATION : DIRTY_NONE);
+    if (dirtyFlags == DIRTY_NONE) {
+        dirtyFlags = DIRTY_IDLE;
+    }
+    m_dirtyFlags = DIRTY_NONE;
+    if (m_drawCallback(dirtyFlags)) {
+        m_lastFrame = start;
+        m_frames.push_back(start);
+        m_frameTime = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        constexpr std::array<std::pair<uint32_t, const char*>, 5> reasons{{
+            {DIRTY_SCENE, "frames (scene)"},
+            {DIRTY_CAMERA, "frames (camera)"},
+            {DIRTY_WINDOW, "frames (window)"},
+            {DIRTY_ANIMATION, "frames (animation)"},
+            {DIRTY_IDLE, "frames (idle refresh)"},
+        }};
+        for (const auto& [flag, name] : reasons) {
+            if ((dirtyFlags & flag) != 0) {
+                OdysseyProfiler::instance().addCounter(name, 1.0);
+            }
+        }
+    }
+    updateCounters();
+    scheduleNext();
+}
+
+void OdysseyRedrawScheduler::updateCounters() {
+    auto since = Clock::now() - std::chrono::minutes(1);
+    while (!m_frames.empty() && m_frames.front() < since) {
+        m_frames.pop_front();
+    }
+    while (!m_wakeups.empty() && m_wakeups.front() < since) {
+        m_wakeups.pop_front();
+    }
+    auto& profiler = OdysseyProfiler::instance();
+    profiler.setCounter("frames per minute", static_cast<double>(m_frames.size()));
+    profiler.setCounter("wakeups per minute", static_cast<double>(m_wakeups.size()));
+    profiler.setCounter("redraw requests coalesced", static_cast<double>(m_coalescedRequests));
+    profiler.setCounter("cpu frame time (ms)", m_frameTime);
+}
+
+}  // namespace odyssey
\ No newline at end of file
@@ -6,23 +6,58 @@
 
 #include "odyssey_render.h"
 
-#include "odyssey_swap_chain.h"
+#include <algorithm>
+#include <array>
+#include <sstream>
+#include <stdexcept>
+
+#include "odyssey_profiler.h"
+#include "odyssey_thread_pool.h"
 
 namespace odyssey {
 
-OdysseyRender::OdysseyRender(OdysseyWindow* window, OdysseyDevice* device) : m_window(window), m_device(device) {
-    recreateSwapChain();
-    createCommandBuffers();
+OdysseyRender::OdysseyRender(OdysseyWindow* window, OdysseyDevice* device, const OdysseyLatencyPolicy& latencyPolicy, bool sampledDepth, const OdysseyResolutionPolicy& resolutionPolicy) : m_windowExtent(window->getExtent()), m_device(device), m_latencyPolicy(latencyPolicy), m_resolutionPolicy(resolutionPolicy) {
+    auto depthFeatures = m_device->getFormatProperties(OdysseySwapChain::findDepthFormat(m_device)).optimalTilingFeatures;
+    m_sampledDepth = sampledDepth && (depthFeatures & vk::FormatFeatureFlagBits::eSampledImage);
+    createRenderPasses();
+    createDynamicResolution();
+    createCommandPools();
+    createTimestampPool();
+    // The swap chain only needs the render pass, so it is built on a worker
+    // while the caller goes on to create pipelines against the same pass.
+    m_swapChainReady = std::async(std::launch::async, [this, extent = m_windowExtent]() {
+        OdysseyProfiler::Scope scope("swap chain");
+        m_swapChain = std::make_unique<OdysseySwapChain>(m_device, m_renderPass, static_cast<int>(extent.width), static_cast<int>(extent.height), m_latencyPolicy, m_sampledDepth);
+    });
 }
 
 OdysseyRender::~OdysseyRender() {
+    waitForSwapChain();
     m_device->device().waitIdle();
+    m_retiredSwapChains.clear();
     m_swapChain.reset();
-    freeCommandBuffers();
+    m_dynamicResolution.reset();
+    m_commandPools.reset();
+    if (m_timestampPool) {
+        m_device->device().destroyQueryPool(m_timestampPool);
+    }
+    destroyRenderPasses();
 }
 
 const vk::RenderPass& OdysseyRender::getSwapChainRenderPass() const {
-    return m_swapChain->getRenderPass();
+    return m_renderPass;
+}
+
+void OdysseyRender::setWindowExtent(vk::Extent2D windowExtent) {
+    m_windowExtent = windowExtent;
+}
+
+vk::Extent2D OdysseyRender::getWindowExtent() const {
+    return m_windowExtent;
+}
+
+uint64_t OdysseyRender::getFrameCount() const {
+    return m_frameCount;
 }
 
 bool OdysseyRender::isFrameInProgress() const {
@@ -30,23 +65,131 @@ bool OdysseyRender::isFrameInProgress() const {
 }
 
 vk::CommandBuffer OdysseyRender::getCurrentCommandBuffer() const {
-    return m_commandBuffers[m_currentImageIndex];
+    return m_commandBuffers[m_swapChain->getCurrentFrame()];
+}
+
+size_t OdysseyRender::getFrameIndex() const {
+    return m_swapChain->getCurrentFrame();
 }
 
 float OdysseyRender::getAspectRatio() const {
     return m_swapChain->getExtentAspectRatio();
 }
 
+vk::Extent2D OdysseyRender::getExtent() const {
+    if (m_dynamicResolution) {
+        return m_dynamicResolution->getExtent(m_swapChain->getCurrentFrame());
+    }
+    return m_swapChain->getSwapChainExtent();
+}
+
+vk::Image OdysseyRender::getSwapChainImage() const {
+    return m_swapChain->getImage(m_currentImageIndex);
+}
+
+vk::ImageView OdysseyRender::getSwapChainImageView() const {
+    return m_swapChain->getImageView(m_currentImageIndex);
+}
+
+vk::Image OdysseyRender::getDepthImage() const {
+    if (m_dynamicResolution) {
+        return m_dynamicResolution->getDepthImage(m_swapChain->getCurrentFrame());
+    }
+    return m_swapChain->getDepthImage(m_swapChain->getCurrentFrame());
+}
+
+vk::ImageView OdysseyRender::getDepthImageView() const {
+    if (m_dynamicResolution) {
+        return m_dynamicResolution->getDepthImageView(m_swapChain->getCurrentFrame());
+    }
+    return m_swapChain->getDepthImageView(m_swapChain->getCurrentFrame());
+}
+
+bool OdysseyRender::hasSampledDepth() const {
+    return m_sampledDepth;
+}
+
+bool OdysseyRender::hasDynamicResolution() const {
+    return m_dynamicResolution != nullptr;
+}
+
+vk::Image OdysseyRender::getSceneColorImage() const {
+    return m_dynamicResolution ? m_dynamicResolution->getColorImage(m_swapChain->getCurrentFrame()) : vk::Image{};
+}
+
+vk::ImageView OdysseyRender::getSceneColorImageView() const {
+    return m_dynamicResolution ? m_dynamicResolution->getColorImageView(m_swapChain->getCurrentFrame()) : vk::ImageView{};
+}
+
+float OdysseyRender::getRenderScale() const {
+    return m_dynamicResolution ? m_dynamicResolution->getScale() : 1.0F;
+}
+
+uint64_t OdysseyRender::getRenderPassVersion() const {
+    return m_renderPassVersion;
+}
+
+std::string OdysseyRender::getLatencyReport() const {
+    auto average = [](const LatencyStats& stats) {
+        return stats.count > 0 ? stats.total / static_cast<double>(stats.count) : 0.0;
+    };
+    std::ostringstream report;
+    report << "Latency (" << m_swapChain->getFramesInFlight() << " frames in flight, " << vk::to_string(m_swapChain->getPresentMode()) << ", "
+           << m_swapChain->getImageCount() << " images" << (m_latencyPolicy.waitBeforeInput ? ", wait before input" : "") << "): "
+           << "input to submit avg " << average(m_inputToSubmit) << " ms max " << m_inputToSubmit.max << " ms (" << m_inputToSubmit.count << " samples), "
+           << "submit to GPU complete avg " << average(m_submitToComplete) << " ms max " << m_submitToComplete.max << " ms\n";
+    return report.str();
+}
+
+double OdysseyRender::getLastGpuFrameTime() const {
+    return m_lastGpuFrameTime;
+}
+
+double OdysseyRender::getAverageGpuFrameTime() const {
+    return m_gpuFrameTime.count > 0 ? m_gpuFrameTime.total / static_cast<double>(m_gpuFrameTime.count) : 0.0;
+}
+
 vk::CommandBuffer OdysseyRender::beginFrame() {
+    waitForSwapChain();
+    if (m_windowExtent.width == 0 || m_windowExtent.height == 0) {
+        // Minimized: nothing to present until the window is restored.
+        return nullptr;
+    }
+    // Resize events only schedule a redraw, so however many of them arrive
+    // between two frames the swap chain is rebuilt at most once, here.
+    if (needsRecreate()) {
+        recreateSwapChain();
+    }
+    if (m_latencyPolicy.waitBeforeInput) {
+        // Drain the previous frame so the input sampled after this returns is
+        // rendered by a GPU that is not still working through older frames.
+        waitForFrame(m_swapChain->getPreviousFrame());
+    }
+    waitForFrame(m_swapChain->getCurrentFrame());
     try {
         m_currentImageIndex = m_swapChain->acquireNextImage();
+        releaseRetiredSwapChains();
         m_isFrameStarted = true;
+        // The frame's fence has signalled, so everything recorded from its
+        // pools on any thread can be reset together.
+        auto frame = m_swapChain->getCurrentFrame();
+        if (m_dynamicResolution) {
+            m_dynamicResolution->beginFrame(frame, m_swapChain->getSwapChainExtent());
+        }
+        m_commandPools->reset(frame);
+        m_commandBuffers[frame] = m_commandPools->allocate(frame, 0, vk::CommandBufferLevel::ePrimary);
         auto commandBuffer = getCurrentCommandBuffer();
         vk::CommandBufferBeginInfo beginInfo{};
+        beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
         commandBuffer.begin(beginInfo);
+        if (m_timestampPool) {
+            auto firstQuery = static_cast<uint32_t>(m_swapChain->getCurrentFrame() * 2);
+            commandBuffer.resetQueryPool(m_timestampPool, firstQuery, 2);
+            commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, m_timestampPool, firstQuery);
+        }
         return commandBuffer;
     } catch ([[maybe_unused]] const vk::OutOfDateKHRError& e) {
-        recreateSwapChain();
+        m_outOfDate = true;
         return nullptr;
     }
 }
@@ -54,64 +197,335 @@ vk::CommandBuffer OdysseyRender::beginFrame() {
 void OdysseyRender::endFrame() {
     try {
         auto commandBuffer = getCurrentCommandBuffer();
+        if (m_timestampPool) {
+            commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, m_timestampPool, static_cast<uint32_t>(m_swapChain->getCurrentFrame() * 2 + 1));
+            m_timestampsPending[m_swapChain->getCurrentFrame()] = true;
+        }
         commandBuffer.end();
-        m_swapChain->submitCommandBuffers(commandBuffer, m_currentImageIndex);
         m_isFrameStarted = false;
+        ++m_frameCount;
+        auto now = OdysseyProfiler::instance().now();
+        if (m_inputTime >= 0.0) {
+            m_inputToSubmit.add(now - m_inputTime);
+            m_inputTime = -1.0;
+        }
+        m_submitTimes[m_swapChain->getCurrentFrame()] = now;
+        m_swapChain->submitCommandBuffers(commandBuffer, m_currentImageIndex);
     } catch ([[maybe_unused]] const vk::OutOfDateKHRError& e) {
-        recreateSwapChain();
+        // The work was submitted; only the present failed. Rebuild on the next frame.
+        m_outOfDate = true;
     }
 }
 
-void OdysseyRender::beginSwapChainRenderPass(vk::CommandBuffer commandBuffer) {
+void OdysseyRender::beginSwapChainRenderPass(vk::CommandBuffer commandBuffer, OdysseyRenderPassPhase phase, vk::SubpassContents contents) {
+    auto offscreen = m_dynamicResolution != nullptr;
+    auto renderPass = offscreen ? m_offscreenRenderPass : m_renderPass;
+    if (phase == OdysseyRenderPassPhase::FIRST) {
+        renderPass = offscreen ? m_offscreenFirstRenderPass : m_firstRenderPass;
+    } else if (phase == OdysseyRenderPassPhase::LAST) {
+        renderPass = offscreen ? m_offscreenLastRenderPass : m_lastRenderPass;
+    }
+    if (!renderPass) {
+        throw std::runtime_error("Split render passes need sampled depth.");
+    }
     vk::RenderPassBeginInfo renderPassInfo{};
     renderPassInfo
-        .setRenderPass(m_swapChain->getRenderPass())
-        .setFramebuffer(m_swapChain->getFrameBuffer(m_currentImageIndex));
+        .setRenderPass(renderPass)
+        .setFramebuffer(getSceneFramebuffer());
     renderPassInfo.renderArea
         .setOffset({0, 0})
-        .setExtent(m_swapChain->getSwapChainExtent());
+        .setExtent(getExtent());
     std::array<vk::ClearValue, 2> clearValues{};
     clearValues[0].setColor({1.0F, 1.0F, 1.0F, 1.0F});
     clearValues[1].setDepthStencil({1.0F, 0});
+    renderPassInfo
+        .setClearValueCount(static_cast<uint32_t>(clearValues.size()))
+        .setClearValues(clearValues);
+    commandBuffer.beginRenderPass(renderPassInfo, contents);
+    // Secondary buffers set their own dynamic state and are then the only
+    // thing the primary may record until the pass ends.
+    if (contents == vk::SubpassContents::eInline) {
+        setViewportAndScissor(commandBuffer);
+    }
+}
+
+void OdysseyRender::endSwapChainRenderPass(vk::CommandBuffer commandBuffer) {
+    commandBuffer.endRenderPass();
+}
+
+vk::CommandBuffer OdysseyRender::beginSecondaryCommandBuffer(size_t threadIndex) {
+    auto commandBuffer = m_commandPools->allocate(m_swapChain->getCurrentFrame(), threadIndex, vk::CommandBufferLevel::eSecondary);
+    // Every phase's render pass is compatible with m_renderPass.
+    vk::CommandBufferInheritanceInfo inheritanceInfo{};
+    inheritanceInfo
+        .setRenderPass(m_renderPass)
+        .setSubpass(0)
+        .setFramebuffer(getSceneFramebuffer());
+    vk::CommandBufferBeginInfo beginInfo{};
+    beginInfo
+        .setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit | vk::CommandBufferUsageFlagBits::eRenderPassContinue)
+        .setPInheritanceInfo(&inheritanceInfo);
+    commandBuffer.begin(beginInfo);
+    setViewportAndScissor(commandBuffer);
+    return commandBuffer;
+}
+
+void OdysseyRender::upscale(vk::CommandBuffer commandBuffer) {
+    if (!m_dynamicResolution) {
+        throw std::runtime_error("Upscaling needs dynamic resolution.");
+    }
+    auto extent = m_swapChain->getSwapChainExtent();
+    vk::RenderPassBeginInfo renderPassInfo{};
+    renderPassInfo
+        .setRenderPass(m_renderPass)
+        .setFramebuffer(m_swapChain->getFrameBuffer(m_currentImageIndex));
+    renderPassInfo.renderArea
+        .setOffset({0, 0})
+        .setExtent(extent);
+    std::array<vk::ClearValue, 2> clearValues{};
+    clearValues[0].setColor({0.0F, 0.0F, 0.0F, 1.0F});
+    clearValues[1].setDepthStencil({1.0F, 0});
     renderPassInfo
         .setClearValueCount(static_cast<uint32_t>(clearValues.size()))
         .setClearValues(clearValues);
     commandBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
+    vk::Viewport viewport{0.0F, 0.0F, static_cast<float>(extent.width), static_cast<float>(extent.height), 0.0F, 1.0F};
+    commandBuffer.setViewport(0, viewport);
+    commandBuffer.setScissor(0, vk::Rect2D{{0, 0}, extent});
+    m_dynamicResolution->upscale(commandBuffer, m_swapChain->getCurrentFrame());
+    commandBuffer.endRenderPass();
+}
+
+vk::Framebuffer OdysseyRender::getSceneFramebuffer() const {
+    if (m_dynamicResolution) {
+        return m_dynamicResolution->getFramebuffer(m_swapChain->getCurrentFrame());
+    }
+    return m_swapChain->getFrameBuffer(m_currentImageIndex);
+}
+
+void OdysseyRender::setViewportAndScissor(vk::CommandBuffer commandBuffer) const {
+    auto extent = getExtent();
     vk::Viewport viewport{};
     viewport
         .setX(0.0F)
         .setY(0.0F)
-        .setWidth(static_cast<float>(m_swapChain->getSwapChainExtent().width))
-        .setHeight(static_cast<float>(m_swapChain->getSwapChainExtent().height))
+        .setWidth(static_cast<float>(extent.width))
+        .setHeight(static_cast<float>(extent.height))
         .setMinDepth(0.0F)
         .setMaxDepth(1.0F);
-    vk::Rect2D scissor{{0, 0}, m_swapChain->getSwapChainExtent()};
+    vk::Rect2D scissor{{0, 0}, extent};
     commandBuffer.setViewport(0, viewport);
     commandBuffer.setScissor(0, scissor);
 }
 
-void OdysseyRender::endSwapChainRenderPass(vk::CommandBuffer commandBuffer) {
-    commandBuffer.endRenderPass();
+bool OdysseyRender::needsRecreate() const {
+    auto extent = m_swapChain->getWindowExtent();
+    return m_outOfDate || m_swapChain->isSuboptimal() || extent != m_windowExtent;
+}
+
+void OdysseyRender::markInputSampled(double inputTime) {
+    m_inputTime = m_inputTime >= 0.0 ? (std::min)(m_inputTime, inputTime) : inputTime;
+}
+
+void OdysseyRender::LatencyStats::add(double latency) {
+    total += latency;
+    max = (std::max)(max, latency);
+    ++count;
 }
 
 void OdysseyRender::recreateSwapChain() {
-    m_device->device().waitIdle();
-    m_swapChain.reset(nullptr);
-    m_swapChain = std::make_unique<OdysseySwapChain>(m_device, m_window->width(), m_window->height());
+    m_outOfDate = false;
+    auto colorFormat = OdysseySwapChain::chooseSwapSurfaceFormat(m_device->getSwapChainSupport().formats).format;
+    if (colorFormat != m_colorFormat) {
+        // Pipelines and framebuffers depend on the render pass, so this is the
+        // one case that still has to drain the GPU.
+        m_device->device().waitIdle();
+        m_retiredSwapChains.clear();
+        m_swapChain.reset();
+        m_dynamicResolution.reset();
+        destroyRenderPasses();
+        createRenderPasses();
+        createDynamicResolution();
+        ++m_renderPassVersion;
+    }
+    // The old swap chain is handed to the new one as oldSwapchain and kept alive
+    // until the frames already submitted to it are known to have completed.
+    auto previous = m_swapChain.get();
+    auto swapChain = std::make_unique<OdysseySwapChain>(m_device, m_renderPass, static_cast<int>(m_windowExtent.width), static_cast<int>(m_windowExtent.height), m_latencyPolicy, m_sampledDepth, previous);
+    if (previous != nullptr) {
+        m_retiredSwapChains.push_back({std::move(m_swapChain), m_frameCount});
+    }
+    m_swapChain = std::move(swapChain);
+}
+
+void OdysseyRender::releaseRetiredSwapChains() {
+    // beginFrame() has just waited on the fence of the submission made one
+    // frames-in-flight count ago, so everything up to it has retired.
+    while (!m_retiredSwapChains.empty() && m_frameCount >= m_retiredSwapChains.front().retireFrame + m_swapChain->getFramesInFlight()) {
+        m_retiredSwapChains.pop_front();
+    }
+}
+
+void OdysseyRender::waitForFrame(size_t frame) {
+    // Submit to GPU completion is only observed when the CPU waits on the
+    // fence, so with spare frames in flight the figure is an upper bound.
+    m_swapChain->waitForFrame(frame);
+    if (m_submitTimes[frame] >= 0.0) {
+        m_submitToComplete.add(OdysseyProfiler::instance().now() - m_submitTimes[frame]);
+        m_submitTimes[frame] = -1.0;
+    }
+    readTimestamps(frame);
+}
+
+void OdysseyRender::waitForSwapChain() {
+    if (m_swapChainReady.valid()) {
+        m_swapChainReady.get();
+    }
+}
+
+void OdysseyRender::createRenderPasses() {
+    m_colorFormat = OdysseySwapChain::chooseSwapSurfaceFormat(m_device->getSwapChainSupport().formats).format;
+    m_renderPass = createRenderPass(OdysseyRenderPassPhase::WHOLE, false);
+    if (m_sampledDepth) {
+        m_firstRenderPass = createRenderPass(OdysseyRenderPassPhase::FIRST, false);
+        m_lastRenderPass = createRenderPass(OdysseyRenderPassPhase::LAST, false);
+    }
+    if (m_resolutionPolicy.targetFrameTime > 0.0) {
+        m_offscreenRenderPass = createRenderPass(OdysseyRenderPassPhase::WHOLE, true);
+        if (m_sampledDepth) {
+            m_offscreenFirstRenderPass = createRenderPass(OdysseyRenderPassPhase::FIRST, true);
+            m_offscreenLastRenderPass = createRenderPass(OdysseyRenderPassPhase::LAST, true);
+        }
+    }
 }
 
-void OdysseyRender::createCommandBuffers() {
-    m_commandBuffers.resize(m_swapChain->getImageCount());
-    vk::CommandBufferAllocateInfo allocInfo{};
-    allocInfo
-        .setLevel(vk::CommandBufferLevel::ePrimary)
-        .setCommandPool(m_device->getCommandPool())
-        .setCommandBufferCount(static_cast<uint32_t>(m_commandBuffers.size()));
-    m_commandBuffers = m_device->device().allocateCommandBuffers(allocInfo);
+void OdysseyRender::destroyRenderPasses() {
+    for (auto* renderPass : {&m_renderPass, &m_firstRenderPass, &m_lastRenderPass, &m_offscreenRenderPass, &m_offscreenFirstRenderPass, &m_offscreenLastRenderPass}) {
+        if (*renderPass) {
+            m_device->device().destroyRenderPass(*renderPass);
+            *renderPass = nullptr;
+        }
+    }
 }
 
-void OdysseyRender::freeCommandBuffers() {
-    m_device->device().freeCommandBuffers(m_device->getCommandPool(), m_commandBuffers);
+vk::RenderPass OdysseyRender::createRenderPass(OdysseyRenderPassPhase phase, bool offscreen) const {
+    // Load and store operations and layouts are the only differences between
+    // phases, which keeps the passes compatible with each other. Offscreen
+    // color has the swap chain's format and is left for upscale() to sample.
+    auto load = phase == OdysseyRenderPassPhase::LAST;
+    auto colorFinalLayout = offscreen ? vk::ImageLayout::eShaderReadOnlyOptimal : vk::ImageLayout::ePresentSrcKHR;
+    vk::AttachmentDescription depthAttachment{};
+    depthAttachment
+        .setFormat(OdysseySwapChain::findDepthFormat(m_device))
+        .setSamples(vk::SampleCountFlagBits::e1)
+        .setLoadOp(load ? vk::AttachmentLoadOp::eLoad : vk::AttachmentLoadOp::eClear)
+        .setStoreOp(phase == OdysseyRenderPassPhase::FIRST ? vk::AttachmentStoreOp::eStore : vk::AttachmentStoreOp::eDontCare)
+        .setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
+        .setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
+        .setInitialLayout(load ? vk::ImageLayout::eDepthStencilAttachmentOptimal : vk::ImageLayout::eUndefined)
+        .setFinalLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal);
+    vk::AttachmentReference depthAttachmentReference;
+    depthAttachmentReference
+        .setAttachment(1)
+        .setLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal);
+
+    vk::AttachmentDescription colorAttachment;
+    colorAttachment
+        .setFormat(m_colorFormat)
+        .setSamples(vk::SampleCountFlagBits::e1)
+        .setLoadOp(load ? vk::AttachmentLoadOp::eLoad : vk::AttachmentLoadOp::eClear)
+        .setStoreOp(vk::AttachmentStoreOp::eStore)
+        .setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
+        .setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
+        .setInitialLayout(load ? vk::ImageLayout::eColorAttachmentOptimal : vk::ImageLayout::eUndefined)
+        .setFinalLayout(phase == OdysseyRenderPassPhase::FIRST ? vk::ImageLayout::eColorAttachmentOptimal : colorFinalLayout);
+    vk::AttachmentReference colorAttachmentReference;
+    colorAttachmentReference
+        .setAttachment(0)
+        .setLayout(vk::ImageLayout::eColorAttachmentOptimal);
+
+    vk::SubpassDescription subpass;
+    subpass
+        .setPipelineBindPoint(vk::PipelineBindPoint::eGraphics)
+        .setColorAttachmentCount(1)
+        .setColorAttachments(colorAttachmentReference)
+        .setPDepthStencilAttachment(&depthAttachmentReference);
+
+    vk::SubpassDependency dependency;
+    dependency
+        .setSrcSubpass(VK_SUBPASS_EXTERNAL)
+        .setSrcAccessMask(vk::AccessFlagBits::eNone)
+        .setSrcStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eEarlyFragmentTests)
+        .setDstSubpass(0)
+        .setDstStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eEarlyFragmentTests)
+        .setDstAccessMask(vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentWrite);
+    if (load) {
+        // The color written by the FIRST pass has to be visible before blending over it.
+        dependency
+            .setSrcAccessMask(vk::AccessFlagBits::eColorAttachmentWrite)
+            .setDstAccessMask(vk::AccessFlagBits::eColorAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite);
+    }
+
+    std::array<vk::AttachmentDescription, 2> attachments{colorAttachment, depthAttachment};
+
+    vk::RenderPassCreateInfo renderPassInfo;
+    renderPassInfo
+        .setAttachmentCount(static_cast<uint32_t>(attachments.size()))
+        .setAttachments(attachments)
+        .setSubpassCount(1)
+        .setSubpasses(subpass)
+        .setDependencyCount(1)
+        .setDependencies(dependency);
+    return m_device->device().createRenderPass(renderPassInfo);
+}
+
+void OdysseyRender::createDynamicResolution() {
+    if (!m_offscreenRenderPass) {
+        return;
+    }
+    auto colorFeatures = m_device->getFormatProperties(m_colorFormat).optimalTilingFeatures;
+    auto required = vk::FormatFeatureFlagBits::eColorAttachment | vk::FormatFeatureFlagBits::eSampledImage | vk::FormatFeatureFlagBits::eSampledImageFilterLinear;
+    if ((colorFeatures & required) != required) {
+        throw std::runtime_error("Dynamic resolution needs a swap chain format that can be sampled with linear filtering.");
+    }
+    m_dynamicResolution = std::make_unique<OdysseyDynamicResolution>(m_device, m_resolutionPolicy, m_colorFormat, m_sampledDepth, m_offscreenRenderPass, m_renderPass);
+}
+
+void OdysseyRender::createCommandPools() {
+    // One pool per frame for every thread that may record: the caller and the
+    // shared workers.
+    m_commandPools = std::make_unique<OdysseyCommandPools>(m_device, OdysseySwapChain::MAX_FRAMES_IN_FLIGHT, OdysseyThreadPool::instance().getThreadCount());
+    m_commandBuffers.resize(OdysseySwapChain::MAX_FRAMES_IN_FLIGHT);
+}
+
+void OdysseyRender::createTimestampPool() {
+    if (!m_device->getProperties().limits.timestampComputeAndGraphics) {
+        return;
+    }
+    vk::QueryPoolCreateInfo queryPoolInfo{};
+    queryPoolInfo
+        .setQueryType(vk::QueryType::eTimestamp)
+        .setQueryCount(static_cast<uint32_t>(2 * OdysseySwapChain::MAX_FRAMES_IN_FLIGHT));
+    m_timestampPool = m_device->device().createQueryPool(queryPoolInfo);
+}
+
+void OdysseyRender::readTimestamps(size_t frame) {
+    if (!m_timestampPool || !m_timestampsPending[frame]) {
+        return;
+    }
+    m_timestampsPending[frame] = false;
+    // The frame's fence has signalled, so the results are available.
+    std::array<uint64_t, 2> timestamps{};
+    auto result = m_device->device().getQueryPoolResults(m_timestampPool, static_cast<uint32_t>(frame * 2), 2, sizeof(timestamps), timestamps.data(), sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+    if (result != vk::Result::eSuccess || timestamps[1] < timestamps[0]) {
+        return;
+    }
+    m_lastGpuFrameTime = static_cast<double>(timestamps[1] - timestamps[0]) * m_device->getProperties().limits.timestampPeriod / 1.0e6;
+    m_gpuFrameTime.add(m_lastGpuFrameTime);
+    OdysseyProfiler::instance().setCounter("gpu frame (ms)", m_lastGpuFrameTime);
+    if (m_dynamicResolution) {
+        m_dynamicResolution->update(frame, m_lastGpuFrameTime);
+    }
 }
 
 }  // namespace odyssey
\ No newline at end of file
@@ -0,0 +1,517 @@
+/**
+ * @file odyssey_render_graph.cpp
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include "odyssey_render_graph.h"
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+#include "odyssey_device.h"
+
+namespace odyssey {
+
+OdysseyRenderGraph::OdysseyRenderGraph(OdysseyDevice* device, size_t framesInFlight) : m_device(device), m_framesInFlight(framesInFlight) {
+}
+
+OdysseyRenderGraph::~OdysseyRenderGraph() {
+    destroyTransients();
+}
+
+RenderGraphResource OdysseyRenderGraph::createImage(const std::string& name, const RenderGraphImageInfo& info) {
+    Resource resource{};
+    resource.name = name;
+    resource.info = info;
+    m_resources.push_back(resource);
+    m_compiled = false;
+    return static_cast<RenderGraphResource>(m_resources.size() - 1);
+}
+
+RenderGraphResource OdysseyRenderGraph::importImage(const std::string& name, const RenderGraphImageInfo& info, vk::ImageLayout initialLayout, vk::ImageLayout finalLayout) {
+    Resource resource{};
+    resource.name = name;
+    resource.info = info;
+    resource.imported = true;
+    resource.initialLayout = initialLayout;
+    resource.finalLayout = finalLayout;
+    m_resources.push_back(resource);
+    m_compiled = false;
+    return static_cast<RenderGraphResource>(m_resources.size() - 1);
+}
+
+void OdysseyRenderGraph::bindImage(RenderGraphResource resource, vk::Image image, vk::ImageView view) {
+    auto& target = m_resources.at(resource);
+    if (!target.imported) {
+        throw std::runtime_error("Only imported render graph images can be bound: " + target.name + ".");
+    }
+    target.image = image;
+    target.view = view;
+}
+
+void OdysseyRenderGraph::addPass(RenderGraphPassInfo pass) {
+    m_passes.push_back(std::move(pass));
+    m_compiled = false;
+}
+
+void OdysseyRenderGraph::compile() {
+    destroyTransients();
+    cullPasses();
+    computeLifetimes();
+    allocateTransients();
+    checkAliasing();
+    buildBarriers();
+    m_compiled = true;
+}
+
+void OdysseyRenderGraph::execute(vk::CommandBuffer commandBuffer, size_t frameIndex) {
+    if (!m_compiled) {
+        compile();
+    }
+    for (auto& resource : m_resources) {
+        if (!resource.images.empty()) {
+            resource.image = resource.images[frameIndex];
+            resource.view = resource.views[frameIndex];
+        }
+    }
+    for (size_t i = 0; i < m_compiledPasses.size(); ++i) {
+        recordBarriers(commandBuffer, m_passBarriers[i]);
+        const auto& pass = m_passes[m_compiledPasses[i]];
+        if (pass.execute) {
+            pass.execute(commandBuffer);
+        }
+    }
+    recordBarriers(commandBuffer, m_finalBarriers);
+}
+
+void OdysseyRenderGraph::reset() {
+    destroyTransients();
+    m_resources.clear();
+    m_passes.clear();
+    m_compiledPasses.clear();
+    m_passBarriers.clear();
+    m_finalBarriers.clear();
+    m_compiled = false;
+}
+
+std::string OdysseyRenderGraph::dump() const {
+    std::ostringstream stream;
+    vk::DeviceSize unaliasedSize{0};
+    for (const auto& resource : m_resources) {
+        unaliasedSize += resource.memorySize * m_framesInFlight;
+    }
+    stream << "render graph: " << m_compiledPasses.size() << " of " << m_passes.size() << " passes, "
+           << m_memoryBlocks.size() << " memory blocks per frame slot, " << m_framesInFlight << " slots, "
+           << getTransientMemorySize() << " bytes transient (" << unaliasedSize << " without aliasing)\n";
+    auto describe = [this](const Barrier& barrier) {
+        std::ostringstream line;
+        line << "    barrier " << m_resources[barrier.resource].name << ": "
+             << vk::to_string(barrier.oldLayout) << " -> " << vk::to_string(barrier.newLayout) << ", "
+             << vk::to_string(barrier.srcStage) << " " << vk::to_string(barrier.srcAccess) << " -> "
+             << vk::to_string(barrier.dstStage) << " " << vk::to_string(barrier.dstAccess) << "\n";
+        return line.str();
+    };
+    for (size_t i = 0; i < m_compiledPasses.size(); ++i) {
+        const auto& pass = m_passes[m_compiledPasses[i]];
+        stream << "pass " << i << " " << pass.name << (pass.sideEffects ? " (side effects)" : "") << "\n";
+        for (const auto& barrier : m_passBarriers[i]) {
+            stream << describe(barrier);
+        }
+        for (const auto& use : pass.reads) {
+            stream << "    read  " << m_resources[use.resource].name << "\n";
+        }
+        for (const auto& use : pass.writes) {
+            stream << "    write " << m_resources[use.resource].name;
+            if (use.renderPassFinalLayout != vk::ImageLayout::eUndefined) {
+                stream << " (render pass -> " << vk::to_string(use.renderPassFinalLayout) << ")";
+            }
+            stream << "\n";
+        }
+    }
+    if (!m_finalBarriers.empty()) {
+        stream << "final\n";
+        for (const auto& barrier : m_finalBarriers) {
+            stream << describe(barrier);
+        }
+    }
+    for (size_t i = 0; i < m_passes.size(); ++i) {
+        if (std::find(m_compiledPasses.begin(), m_compiledPasses.end(), i) == m_compiledPasses.end()) {
+            stream << "culled " << m_passes[i].name << "\n";
+        }
+    }
+    for (const auto& resource : m_resources) {
+        stream << "image " << resource.name << (resource.imported ? " imported" : " transient")
+               << " passes [" << resource.firstPass << ", " << resource.lastPass << "]";
+        if (resource.memoryBlock >= 0) {
+            stream << " block " << resource.memoryBlock << " " << resource.memorySize << " bytes";
+        }
+        stream << "\n";
+    }
+    return stream.str();
+}
+
+vk::Image OdysseyRenderGraph::getImage(RenderGraphResource resource) const {
+    return m_resources.at(resource).image;
+}
+
+vk::ImageView OdysseyRenderGraph::getImageView(RenderGraphResource resource) const {
+    return m_resources.at(resource).view;
+}
+
+vk::DeviceSize OdysseyRenderGraph::getTransientMemorySize() const {
+    vk::DeviceSize size{0};
+    for (const auto& block : m_memoryBlocks) {
+        size += block.size * block.memories.size();
+    }
+    return size;
+}
+
+std::pair<int, int> OdysseyRenderGraph::getLifetime(RenderGraphResource resource) const {
+    const auto& target = m_resources.at(resource);
+    return {target.firstPass, target.lastPass};
+}
+
+int OdysseyRenderGraph::getMemoryBlock(RenderGraphResource resource) const {
+    return m_resources.at(resource).memoryBlock;
+}
+
+OdysseyRenderGraph::AccessInfo OdysseyRenderGraph::getAccessInfo(RenderGraphAccess access, bool write) {
+    switch (access) {
+        case RenderGraphAccess::COLOR_ATTACHMENT:
+            return {vk::PipelineStageFlagBits::eColorAttachmentOutput,
+                    write ? vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eColorAttachmentRead : vk::AccessFlagBits::eColorAttachmentRead,
+                    vk::ImageLayout::eColorAttachmentOptimal,
+                    write};
+        case RenderGraphAccess::DEPTH_ATTACHMENT:
+            return {vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests,
+                    write ? vk::AccessFlagBits::eDepthStencilAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentRead : vk::AccessFlagBits::eDepthStencilAttachmentRead,
+                    vk::ImageLayout::eDepthStencilAttachmentOptimal,
+                    write};
+        case RenderGraphAccess::DEPTH_READ:
+            return {vk::PipelineStageFlagBits::eFragmentShader | vk::PipelineStageFlagBits::eComputeShader,
+                    vk::AccessFlagBits::eShaderRead,
+                    vk::ImageLayout::eDepthStencilReadOnlyOptimal,
+                    false};
+        case RenderGraphAccess::SAMPLED:
+            return {vk::PipelineStageFlagBits::eFragmentShader | vk::PipelineStageFlagBits::eComputeShader,
+                    vk::AccessFlagBits::eShaderRead,
+                    vk::ImageLayout::eShaderReadOnlyOptimal,
+                    false};
+        case RenderGraphAccess::STORAGE_READ:
+            return {vk::PipelineStageFlagBits::eFragmentShader | vk::PipelineStageFlagBits::eComputeShader,
+                    vk::AccessFlagBits::eShaderRead,
+                    vk::ImageLayout::eGeneral,
+                    false};
+        case RenderGraphAccess::STORAGE_WRITE:
+            return {vk::PipelineStageFlagBits::eComputeShader,
+                    write ? vk::AccessFlagBits::eShaderWrite | vk::AccessFlagBits::eShaderRead : vk::AccessFlagBits::eShaderRead,
+                    vk::ImageLayout::eGeneral,
+                    write};
+        case RenderGraphAccess::TRANSFER_SRC:
+            return {vk::PipelineStageFlagBits::eTransfer,
+                    vk::AccessFlagBits::eTransferRead,
+                    vk::ImageLayout::eTransferSrcOptimal,
+                    false};
+        case RenderGraphAccess::TRANSFER_DST:
+            return {vk::PipelineStageFlagBits::eTransfer,
+                    vk::AccessFlagBits::eTransferWrite,
+                    vk::ImageLayout::eTransferDstOptimal,
+                    true};
+    }
+    return {};
+}
+
+void OdysseyRenderGraph::cullPasses() {
+    // Walk backwards from the imported images: a pass survives if it has side
+    // effects or writes something a later surviving pass (or the frame) needs.
+    std::vector<bool> needed(m_resources.size(), false);
+    for (size_t i = 0; i < m_resources.size(); ++i) {
+        needed[i] = m_resources[i].imported;
+    }
+    m_compiledPasses.clear();
+    for (size_t i = m_passes.size(); i-- > 0;) {
+        const auto& pass = m_passes[i];
+        auto keep = pass.sideEffects || std::any_of(pass.writes.begin(), pass.writes.end(), [&needed](const RenderGraphUse& use) {
+            return needed[use.resource];
+        });
+        if (!keep) {
+            continue;
+        }
+        for (const auto& use : pass.writes) {
+            auto alsoRead = std::any_of(pass.reads.begin(), pass.reads.end(), [&use](const RenderGraphUse& read) {
+                return read.resource == use.resource;
+            });
+            if (!alsoRead) {
+                needed[use.resource] = false;
+            }
+        }
+        for (const auto& use : pass.reads) {
+            needed[use.resource] = true;
+        }
+        m_compiledPasses.push_back(i);
+    }
+    std::reverse(m_compiledPasses.begin(), m_compiledPasses.end());
+}
+
+void OdysseyRenderGraph::computeLifetimes() {
+    for (auto& resource : m_resources) {
+        resource.firstPass = -1;
+        resource.lastPass = -1;
+        resource.memoryBlock = -1;
+        resource.memorySize = 0;
+    }
+    for (size_t i = 0; i < m_compiledPasses.size(); ++i) {
+        const auto& pass = m_passes[m_compiledPasses[i]];
+        auto touch = [this, i](const RenderGraphUse& use) {
+            auto& resource = m_resources[use.resource];
+            if (resource.firstPass < 0) {
+                resource.firstPass = static_cast<int>(i);
+            }
+            resource.lastPass = static_cast<int>(i);
+        };
+        std::for_each(pass.reads.begin(), pass.reads.end(), touch);
+        std::for_each(pass.writes.begin(), pass.writes.end(), touch);
+    }
+}
+
+void OdysseyRenderGraph::allocateTransients() {
+    std::vector<RenderGraphResource> transients{};
+    std::vector<vk::MemoryRequirements> requirements(m_resources.size());
+    for (size_t i = 0; i < m_resources.size(); ++i) {
+        auto& resource = m_resources[i];
+        if (resource.imported || resource.firstPass < 0) {
+            continue;
+        }
+        vk::ImageCreateInfo imageInfo{};
+        imageInfo
+            .setImageType(vk::ImageType::e2D)
+            .setMipLevels(1)
+            .setArrayLayers(1)
+            .setFormat(resource.info.format)
+            .setTiling(vk::ImageTiling::eOptimal)
+            .setInitialLayout(vk::ImageLayout::eUndefined)
+            .setUsage(resource.info.usage)
+            .setSharingMode(vk::SharingMode::eExclusive)
+            .setSamples(vk::SampleCountFlagBits::e1)
+            .setFlags(vk::ImageCreateFlagBits::eAlias);
+        imageInfo.extent
+            .setWidth(resource.info.extent.width)
+            .setHeight(resource.info.extent.height)
+            .setDepth(1);
+        for (size_t slot = 0; slot < m_framesInFlight; ++slot) {
+            resource.images.push_back(m_device->device().createImage(imageInfo));
+        }
+        resource.image = resource.images.front();
+        requirements[i] = m_device->device().getImageMemoryRequirements(resource.image);
+        resource.memorySize = requirements[i].size;
+        transients.push_back(static_cast<RenderGraphResource>(i));
+    }
+    std::sort(transients.begin(), transients.end(), [this](RenderGraphResource lhs, RenderGraphResource rhs) {
+        return m_resources[lhs].firstPass < m_resources[rhs].firstPass;
+    });
+
+    // Greedy interval packing: reuse the block whose previous occupant died
+    // earliest before this image is first used and whose size fits best.
+    for (auto index : transients) {
+        auto& resource = m_resources[index];
+        const auto& requirement = requirements[index];
+        int best = -1;
+        for (size_t i = 0; i < m_memoryBlocks.size(); ++i) {
+            const auto& block = m_memoryBlocks[i];
+            if (block.lastPass >= resource.firstPass || (block.memoryTypeBits & requirement.memoryTypeBits) == 0) {
+                continue;
+            }
+            auto waste = [&requirement](const MemoryBlock& candidate) {
+                return candidate.size > requirement.size ? candidate.size - requirement.size : requirement.size - candidate.size;
+            };
+            if (best < 0 || waste(block) < waste(m_memoryBlocks[best])) {
+                best = static_cast<int>(i);
+            }
+        }
+        if (best < 0) {
+            m_memoryBlocks.emplace_back();
+            best = static_cast<int>(m_memoryBlocks.size() - 1);
+        }
+        auto& block = m_memoryBlocks[best];
+        block.size = (std::max)(block.size, requirement.size);
+        block.memoryTypeBits &= requirement.memoryTypeBits;
+        block.lastPass = resource.lastPass;
+        block.resources.push_back(index);
+        resource.memoryBlock = best;
+    }
+
+    for (auto& block : m_memoryBlocks) {
+        vk::MemoryAllocateInfo allocateInfo{};
+        allocateInfo
+            .setAllocationSize(block.size)
+            .setMemoryTypeIndex(m_device->findMemoryType(block.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal));
+        for (size_t slot = 0; slot < m_framesInFlight; ++slot) {
+            block.memories.push_back(m_device->device().allocateMemory(allocateInfo));
+            // Every occupant starts at offset 0, which satisfies any alignment.
+            for (auto index : block.resources) {
+                auto& resource = m_resources[index];
+                m_device->device().bindImageMemory(resource.images[slot], block.memories[slot], 0);
+                auto viewAspect = resource.info.aspect & vk::ImageAspectFlagBits::eDepth ? vk::ImageAspectFlags{vk::ImageAspectFlagBits::eDepth} : resource.info.aspect;
+                resource.views.push_back(m_device->createImageView(resource.images[slot], resource.info.format, viewAspect));
+            }
+        }
+    }
+    for (auto& resource : m_resources) {
+        if (!resource.views.empty()) {
+            resource.view = resource.views.front();
+        }
+    }
+}
+
+void OdysseyRenderGraph::checkAliasing() const {
+    // Images sharing memory must never be alive in the same pass; the barrier
+    // at each one's first use only orders it after the previous occupant.
+    for (const auto& block : m_memoryBlocks) {
+        for (size_t i = 0; i < block.resources.size(); ++i) {
+            for (size_t j = i + 1; j < block.resources.size(); ++j) {
+                const auto& first = m_resources[block.resources[i]];
+                const auto& second = m_resources[block.resources[j]];
+                if (first.firstPass <= second.lastPass && second.firstPass <= first.lastPass) {
+                    throw std::runtime_error("Render graph images " + first.name + " and " + second.name + " share memory while both are in use.");
+                }
+            }
+        }
+    }
+}
+
+void OdysseyRenderGraph::buildBarriers() {
+    struct State {
+        bool initialized{false};
+        vk::ImageLayout layout{vk::ImageLayout::eUndefined};
+        vk::PipelineStageFlags stage{};
+        vk::AccessFlags access{};
+        bool write{false};
+    };
+    std::vector<State> states(m_resources.size());
+    for (size_t i = 0; i < m_resources.size(); ++i) {
+        if (m_resources[i].imported) {
+            states[i] = {true, m_resources[i].initialLayout, vk::PipelineStageFlagBits::eTopOfPipe, {}, false};
+        }
+    }
+
+    m_passBarriers.assign(m_compiledPasses.size(), {});
+    for (size_t i = 0; i < m_compiledPasses.size(); ++i) {
+        const auto& pass = m_passes[m_compiledPasses[i]];
+        // A resource both read and written by a pass is transitioned once,
+        // with the union of accesses.
+        std::map<RenderGraphResource, std::pair<AccessInfo, vk::ImageLayout>> uses{};
+        for (const auto& use : pass.reads) {
+            uses[use.resource] = {getAccessInfo(use.access, false), use.renderPassFinalLayout};
+        }
+        for (const auto& use : pass.writes) {
+            auto info = getAccessInfo(use.access, true);
+            if (auto iter = uses.find(use.resource); iter != uses.end()) {
+                info.stage |= iter->second.first.stage;
+                info.access |= iter->second.first.access;
+            }
+            uses[use.resource] = {info, use.renderPassFinalLayout};
+        }
+
+        for (const auto& [index, use] : uses) {
+            const auto& [info, renderPassFinalLayout] = use;
+            auto& state = states[index];
+            auto renderPassManaged = renderPassFinalLayout != vk::ImageLayout::eUndefined;
+            if (state.initialized && state.layout == info.layout && !state.write && !info.write) {
+                // Read after read in the same layout only widens the set of readers.
+                state.stage |= info.stage;
+                state.access |= info.access;
+                continue;
+            }
+            Barrier barrier{index, state.layout, info.layout, state.stage, state.write ? state.access : vk::AccessFlags{}, info.stage, info.access};
+            if (!state.initialized) {
+                // First use of a transient: contents are undefined, but the memory
+                // may still be in use by the previous image aliased onto it.
+                barrier.oldLayout = vk::ImageLayout::eUndefined;
+                barrier.srcStage = vk::PipelineStageFlagBits::eTopOfPipe;
+                barrier.srcAccess = {};
+                const auto& block = m_memoryBlocks[m_resources[index].memoryBlock];
+                auto position = std::find(block.resources.begin(), block.resources.end(), index);
+                if (position != block.resources.begin()) {
+                    const auto& previous = states[*(position - 1)];
+                    barrier.srcStage = previous.stage;
+                    barrier.srcAccess = previous.write ? previous.access : vk::AccessFlags{};
+                }
+            }
+            if (!renderPassManaged) {
+                m_passBarriers[i].push_back(barrier);
+            }
+            state = {true, renderPassManaged ? renderPassFinalLayout : info.layout, info.stage, info.access, info.write};
+        }
+    }
+
+    m_finalBarriers.clear();
+    for (size_t i = 0; i < m_resources.size(); ++i) {
+        const auto& resource = m_resources[i];
+        const auto& state = states[i];
+        if (!resource.imported || resource.finalLayout == vk::ImageLayout::eUndefined || state.layout == resource.finalLayout) {
+            continue;
+        }
+        m_finalBarriers.push_back({static_cast<RenderGraphResource>(i), state.layout, resource.finalLayout, state.stage, state.write ? state.access : vk::AccessFlags{}, vk::PipelineStageFlagBits::eBottomOfPipe, {}});
+    }
+}
+
+void OdysseyRenderGraph::destroyTransients() {
+    for (auto& resource : m_resources) {
+        if (resource.imported) {
+            continue;
+        }
+        for (auto view : resource.views) {
+            m_device->device().destroyImageView(view);
+        }
+        for (auto image : resource.images) {
+            m_device->device().destroyImage(image);
+        }
+        resource.views.clear();
+        resource.images.clear();
+        resource.view = nullptr;
+        resource.image = nullptr;
+    }
+    for (auto& block : m_memoryBlocks) {
+        for (auto memory : block.memories) {
+            m_device->device().freeMemory(memory);
+        }
+    }
+    m_memoryBlocks.clear();
+    m_compiled = false;
+}
+
+void OdysseyRenderGraph::recordBarriers(vk::CommandBuffer commandBuffer, const std::vector<Barrier>& barriers) const {
+    if (barriers.empty()) {
+        return;
+    }
+    std::vector<vk::ImageMemoryBarrier> imageBarriers{};
+    vk::PipelineStageFlags srcStage{};
+    vk::PipelineStageFlags dstStage{};
+    for (const auto& barrier : barriers) {
+        const auto& resource = m_resources[barrier.resource];
+        vk::ImageMemoryBarrier imageBarrier{};
+        imageBarrier
+            .setOldLayout(barrier.oldLayout)
+            .setNewLayout(barrier.newLayout)
+            .setSrcAccessMask(barrier.srcAccess)
+            .setDstAccessMask(barrier.dstAccess)
+            .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+            .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+            .setImage(resource.image);
+        imageBarrier.subresourceRange
+            .setAspectMask(resource.info.aspect)
+            .setBaseMipLevel(0)
+            .setLevelCount(VK_REMAINING_MIP_LEVELS)
+            .setBaseArrayLayer(0)
+            .setLayerCount(VK_REMAINING_ARRAY_LAYERS);
+        imageBarriers.push_back(imageBarrier);
+        srcStage |= barrier.srcStage;
+        dstStage |= barrier.dstStage;
+    }
+    commandBuffer.pipelineBarrier(srcStage ? srcStage : vk::PipelineStageFlagBits::eTopOfPipe, dstStage, {}, nullptr, nullptr, imageBarriers);
+}
+
+}  // namespace odyssey
\ No newline at end of file
@@ -6,32 +6,1238 @@
 
 #include "odyssey_render_system.h"
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+
 #include "odyssey_device.h"
+#include "odyssey_profiler.h"
+#include "odyssey_swap_chain.h"
+#include "odyssey_thread_pool.h"
 
 namespace odyssey {
 
-OdysseyRenderSystem::OdysseyRenderSystem(OdysseyDevice* device, vk::RenderPass renderPass) : m_device(device) {
+namespace {
+
+// Transform slots the storage buffers start with; they grow in powers of two.
+constexpr size_t INITIAL_TRANSFORM_CAPACITY{1024};
+
+glm::vec4 worldBoundingSphere(const glm::mat4& model, const OdysseyModel::Bounds& bounds) {
+    if (bounds.radius < 0.0F) {
+        return {0.0F, 0.0F, 0.0F, -1.0F};
+    }
+    // The longest basis vector bounds the scale in any direction, so the
+    // sphere stays conservative under non-uniform scale.
+    auto scale = (std::max)({glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))});
+    return {glm::vec3(model * glm::vec4(bounds.center, 1.0F)), bounds.radius * scale};
+}
+
+}  // namespace
+
+OdysseyRenderSystem::OdysseyRenderSystem(OdysseyDevice* device, vk::RenderPass renderPass) : m_device(device), m_renderPass(renderPass) {
+    createGlobalResources();
     createPipelineLayout();
-    m_pipelineLine = createPipeline("shaders/shader.vert.spv", "shaders/shader.frag.spv", vk::PrimitiveTopology::eTriangleList, 1.0F, renderPass);
+    getPipeline(m_variant);
 }
 
 OdysseyRenderSystem::~OdysseyRenderSystem() {
+    m_pipelines.clear();
+    m_pointPipeline.reset();
+    m_streamInstanceBuffer.reset();
+    m_impostorPipelines.clear();
+    if (m_impostorPipelineLayout) {
+        m_device->device().destroyPipelineLayout(m_impostorPipelineLayout);
+    }
+    m_impostors.reset();
     m_device->device().destroyPipelineLayout(m_pipelineLayout);
-    m_pipelineLine.reset();
+    m_indirectFrames.clear();
+    m_cullPipeline.reset();
+    if (m_cullPipelineLayout) {
+        m_device->device().destroyPipelineLayout(m_cullPipelineLayout);
+    }
+    m_occlusionPipeline.reset();
+    if (m_occlusionPipelineLayout) {
+        m_device->device().destroyPipelineLayout(m_occlusionPipelineLayout);
+    }
+    m_depthPyramid.reset();
+    m_clusteredLights.reset();
+}
+
+void OdysseyRenderSystem::prepareObjects(vk::CommandBuffer commandBuffer, std::vector<OdysseyObject>& objects, OdysseyCamera* camera, size_t frameIndex) {
+    // Both paths draw with the matrices in the transform buffers, which are
+    // copied outside the render pass.
+    updateTransforms();
+    uploadTransforms(commandBuffer, frameIndex);
+    if (m_impostors) {
+        m_impostors->beginFrame(frameIndex);
+        if (!m_gpuDriven) {
+            // Only batched drawing draws impostors.
+            m_impostors->prepare(commandBuffer, objects, m_sceneVersion);
+        }
+    }
+    if (!m_gpuDriven) {
+        return;
+    }
+    if (m_indirectFrames.size() <= frameIndex) {
+        m_indirectFrames.resize(frameIndex + 1);
+    }
+    auto& frame = m_indirectFrames[frameIndex];
+    readOcclusionCounts(frame);
+    auto transformVersion = OdysseyTransformStore::instance().getVersion();
+    if (frame.sceneVersion != m_sceneVersion || frame.transformVersion != transformVersion) {
+        uploadInstances(frame, objects, frameIndex);
+        frame.sceneVersion = m_sceneVersion;
+        frame.transformVersion = transformVersion;
+    }
+    if (frame.objectCount == 0) {
+        return;
+    }
+    auto objectCount = frame.objectCount;
+    updateVisibilityBuffer(commandBuffer, objectCount);
+    updateIndirectFrame(frame, m_instanceBuffers[frameIndex].get(), objectCount);
+
+    constexpr auto commandStride = sizeof(vk::DrawIndexedIndirectCommand);
+    commandBuffer.fillBuffer(frame.count->getBuffer(), 0, DRAW_COUNT_SIZE * sizeof(uint32_t), 0);
+    if (!m_device->supportsDrawIndirectCount()) {
+        // Without a GPU-side count every command up to objectCount is executed,
+        // so the ones the culling passes do not write must draw nothing.
+        auto lists = m_occlusionCulling ? 2U : 1U;
+        commandBuffer.fillBuffer(frame.commands->getBuffer(), 0, lists * objectCount * commandStride, 0);
+    }
+    // Visibility was last written by the previous frame's occlusion pass.
+    vk::MemoryBarrier clearBarrier{};
+    clearBarrier
+        .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite | vk::AccessFlagBits::eShaderWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite);
+    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer | vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader, {}, clearBarrier, nullptr, nullptr);
+
+    CullPushConstantData push{};
+    if (m_culling) {
+        auto frustum = OdysseyFrustum::fromMatrix(camera->getProjection() * camera->getView());
+        std::copy(frustum.planes.begin(), frustum.planes.end(), push.frustumPlanes);
+    }
+    push.objectCount = objectCount;
+    push.useVisibility = m_occlusionCulling ? 1 : 0;
+    m_cullPipeline->bind(commandBuffer);
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_cullPipelineLayout, 0, frame.descriptorSet, nullptr);
+    commandBuffer.pushConstants<CullPushConstantData>(m_cullPipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, push);
+    commandBuffer.dispatch((objectCount + 63) / 64, 1, 1);
+
+    vk::MemoryBarrier cullBarrier{};
+    cullBarrier
+        .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eIndirectCommandRead);
+    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eDrawIndirect, {}, cullBarrier, nullptr, nullptr);
+}
+
+void OdysseyRenderSystem::uploadInstances(IndirectFrame& frame, const std::vector<OdysseyObject>& objects, size_t frameIndex) {
+    // Only the upload is proportional to the object count; culling and draw
+    // generation run on the GPU and the recorded commands are fixed in size.
+    uint32_t objectCount{0};
+    const OdysseyModel* lastModel{nullptr};
+    uint32_t lastMesh{OdysseyGeometryPool::INVALID_MESH};
+    for (const auto& object : objects) {
+        if (!object.model) {
+            continue;
+        }
+        if (object.model.get() != lastModel) {
+            lastModel = object.model.get();
+            lastMesh = m_geometryPool->addModel(object.model);
+        }
+        if (lastMesh != OdysseyGeometryPool::INVALID_MESH) {
+            ++objectCount;
+        }
+    }
+    frame.objectCount = objectCount;
+    if (objectCount == 0) {
+        return;
+    }
+    auto* instanceBuffer = getInstanceBuffer(frameIndex, objectCount);
+    auto* instances = static_cast<InstanceData*>(instanceBuffer->getMappedMemory());
+    uint32_t slot{0};
+    lastModel = nullptr;
+    for (const auto& object : objects) {
+        if (!object.model) {
+            continue;
+        }
+        if (object.model.get() != lastModel) {
+            lastModel = object.model.get();
+            lastMesh = m_geometryPool->addModel(object.model);
+        }
+        if (lastMesh == OdysseyGeometryPool::INVALID_MESH) {
+            continue;
+        }
+        auto& instance = instances[slot++];
+        instance.boundingSphere = m_culling ? worldBoundingSphere(object.transform.mat4(), object.model->getBounds()) : glm::vec4(0.0F, 0.0F, 0.0F, -1.0F);
+        instance.meshIndex = lastMesh;
+        instance.transformIndex = object.transform.getIndex();
+        instance.fade = 1.0F;
+    }
+    instanceBuffer->flush();
+}
+
+void OdysseyRenderSystem::renderObjects(vk::CommandBuffer commandBuffer, std::vector<OdysseyObject>& objects, OdysseyCamera* camera, size_t frameIndex, vk::Extent2D extent) {
+    m_extent = extent;
+    updateGlobals(camera, frameIndex);
+    if (m_gpuDriven) {
+        // Everything the indirect draws depend on per frame is read from
+        // buffers.
+        if (replay(commandBuffer, frameIndex, {m_sceneVersion, 0, 0, m_recordVersion, extent})) {
+            return;
+        }
+        record(commandBuffer, frameIndex, 0, 1, [this, frameIndex](vk::CommandBuffer drawCommandBuffer, [[maybe_unused]] size_t begin, [[maybe_unused]] size_t end) {
+            bindScenePipeline(drawCommandBuffer, frameIndex);
+            renderIndirect(drawCommandBuffer, frameIndex, 0);
+        });
+    } else {
+        // Frustum culling, depth-sorted single draws and impostors depend on
+        // the camera and on where objects are; batches of every object read
+        // both from the global and transform buffers.
+        bool viewDependent = m_culling || !m_batching || m_impostorDistance > 0.0F;
+        auto cameraVersion = viewDependent ? camera->getVersion() : 0;
+        auto transformVersion = viewDependent ? OdysseyTransformStore::instance().getVersion() : 0;
+        if (replay(commandBuffer, frameIndex, {m_sceneVersion, transformVersion, cameraVersion, m_recordVersion, extent})) {
+            auto& profiler = OdysseyProfiler::instance();
+            profiler.setCounter("culling (ms)", 0.0);
+            profiler.setCounter("draw sort (ms)", 0.0);
+            profiler.setCounter("draw recording (ms)", 0.0);
+            return;
+        }
+        cullObjects(objects, camera);
+        renderBatches(commandBuffer, objects, camera, frameIndex);
+    }
+}
+
+void OdysseyRenderSystem::buildDepthPyramid(vk::CommandBuffer commandBuffer, size_t frameIndex, vk::ImageView depthView, vk::Extent2D depthExtent) {
+    if (!m_occlusionCulling || m_indirectFrames.size() <= frameIndex || m_indirectFrames[frameIndex].objectCount == 0) {
+        return;
+    }
+    m_depthPyramid->build(commandBuffer, frameIndex, depthView, depthExtent);
+}
+
+void OdysseyRenderSystem::cullOccluded(vk::CommandBuffer commandBuffer, OdysseyCamera* camera, size_t frameIndex) {
+    if (!m_occlusionCulling || m_indirectFrames.size() <= frameIndex || m_indirectFrames[frameIndex].objectCount == 0) {
+        return;
+    }
+    auto& frame = m_indirectFrames[frameIndex];
+    updateOcclusionFrame(frame, frameIndex);
+
+    const auto& projection = camera->getProjection();
+    OcclusionPushConstantData push{};
+    push.view = camera->getView();
+    push.objectCount = frame.objectCount;
+    if (m_culling) {
+        // The view-space tests assume a symmetric perspective projection;
+        // anything else is only frustum culled by the early pass.
+        auto frustumX = glm::normalize(glm::vec2(projection[0][0], 1.0F));
+        auto frustumY = glm::normalize(glm::vec2(projection[1][1], 1.0F));
+        push.frustum = {frustumX.x, frustumX.y, frustumY.x, frustumY.y};
+        push.projection = {projection[0][0], projection[1][1], projection[2][2], projection[3][2]};
+        auto pyramidExtent = m_depthPyramid->getExtent(frameIndex);
+        push.pyramidSize = {static_cast<float>(pyramidExtent.width), static_cast<float>(pyramidExtent.height)};
+        push.zNear = -projection[3][2] / projection[2][2];
+        push.zFar = projection[3][2] / (1.0F - projection[2][2]);
+        push.occlusion = projection[2][3] == 1.0F ? 1 : 0;
+    }
+    m_occlusionPipeline->bind(commandBuffer);
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_occlusionPipelineLayout, 0, frame.occlusionDescriptorSet, nullptr);
+    commandBuffer.pushConstants<OcclusionPushConstantData>(m_occlusionPipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, push);
+    commandBuffer.dispatch((frame.objectCount + 63) / 64, 1, 1);
+
+    vk::MemoryBarrier cullBarrier{};
+    cullBarrier
+        .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eTransferRead);
+    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eTransfer, {}, cullBarrier, nullptr, nullptr);
+    // Read back on the next use of this frame, once its fence has signalled.
+    vk::BufferCopy copy{0, 0, DRAW_COUNT_SIZE * sizeof(uint32_t)};
+    commandBuffer.copyBuffer(frame.count->getBuffer(), frame.countReadback->getBuffer(), copy);
+    frame.countsPending = true;
+}
+
+void OdysseyRenderSystem::renderLateObjects(vk::CommandBuffer commandBuffer, size_t frameIndex) {
+    if (!m_occlusionCulling) {
+        return;
+    }
+    // Both lists were recorded together, under the key renderObjects checked.
+    if (m_replaying) {
+        const auto& buffers = m_commandCaches[frameIndex].lists[1];
+        if (!buffers.empty()) {
+            commandBuffer.executeCommands(buffers);
+        }
+        return;
+    }
+    record(commandBuffer, frameIndex, 1, 1, [this, frameIndex](vk::CommandBuffer drawCommandBuffer, [[maybe_unused]] size_t begin, [[maybe_unused]] size_t end) {
+        bindScenePipeline(drawCommandBuffer, frameIndex);
+        renderIndirect(drawCommandBuffer, frameIndex, 1);
+    });
+}
+
+void OdysseyRenderSystem::cullLights(vk::CommandBuffer commandBuffer, const std::vector<OdysseyPointLight>& lights, OdysseyCamera* camera, vk::Extent2D extent, size_t frameIndex) {
+    m_clusteredLights->cull(commandBuffer, lights, *camera, extent, frameIndex);
+}
+
+void OdysseyRenderSystem::bindScenePipeline(vk::CommandBuffer commandBuffer, size_t frameIndex) {
+    // setVariant has already created the pipeline, so recording threads only
+    // look it up.
+    getPipeline(m_variant)->bind(commandBuffer);
+    auto globalOffset = static_cast<uint32_t>(frameIndex * m_globalBuffer->getAlignmentSize());
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_pipelineLayout, 0, m_globalDescriptorSet, globalOffset);
+    PushConstantData push{};
+    if (m_variant.runtimeBranching) {
+        push.options = {static_cast<float>(m_variant.lightingModel), static_cast<float>(m_variant.debugView), 0.0F, 0.0F};
+    }
+    commandBuffer.pushConstants<PushConstantData>(m_pipelineLayout, vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment, 0, push);
+}
+
+void OdysseyRenderSystem::bindImpostorPipeline(vk::CommandBuffer commandBuffer, size_t frameIndex) {
+    // The push constant ranges differ from the scene layout's, so set 0 is
+    // not compatible and is bound again.
+    getImpostorPipeline(m_variant)->bind(commandBuffer);
+    auto globalOffset = static_cast<uint32_t>(frameIndex * m_globalBuffer->getAlignmentSize());
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_impostorPipelineLayout, 0, m_globalDescriptorSet, globalOffset);
+}
+
+void OdysseyRenderSystem::updateGlobals(OdysseyCamera* camera, size_t frameIndex) {
+    // This frame's fence has been waited on, so its slot of the ring is idle.
+    GlobalData data{};
+    data.view = camera->getView();
+    data.projection = camera->getProjection();
+    data.projectionView = data.projection * data.view;
+    data.cameraPosition = glm::inverse(data.view)[3];
+    const auto& lights = m_clusteredLights->getFrameInfo(frameIndex);
+    data.clusterScale = lights.clusterScale;
+    data.lightInfo = lights.lightInfo;
+    m_globalBuffer->writeToIndex(&data, static_cast<uint32_t>(frameIndex));
+}
+
+void OdysseyRenderSystem::updateTransforms() {
+    auto start = std::chrono::steady_clock::now();
+    auto& transforms = OdysseyTransformStore::instance();
+    auto rebuilt = m_perObjectTransforms ? transforms.rebuildAll() : transforms.update();
+    auto& profiler = OdysseyProfiler::instance();
+    profiler.setCounter("transforms (ms)", std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    profiler.setCounter("transforms rebuilt", static_cast<double>(rebuilt));
+}
+
+void OdysseyRenderSystem::uploadTransforms(vk::CommandBuffer commandBuffer, size_t frameIndex) {
+    const auto& transforms = OdysseyTransformStore::instance();
+    auto version = transforms.getVersion();
+    auto& profiler = OdysseyProfiler::instance();
+    const auto& matrices = transforms.getMatrices();
+    if (version == m_uploadedTransformVersion || matrices.empty()) {
+        profiler.setCounter("transforms uploaded", 0.0);
+        return;
+    }
+    updateTransformBuffers(matrices.size());
+    // The buffers hold every update up to m_uploadedTransformVersion, and
+    // only the last update's slots are known, so anything older than that
+    // or a rebuild of everything is copied whole.
+    const auto& updatedIndices = transforms.getUpdatedIndices();
+    bool whole = m_uploadedTransformVersion == ~0ULL || m_uploadedTransformVersion + 1 != version || updatedIndices.empty();
+    m_uploadedTransformVersion = version;
+
+    // This frame's fence has been waited on, so its staging buffer is idle.
+    auto& staging = m_transformStagingBuffers[frameIndex];
+    if (!staging || staging->getInstanceCount() < m_modelMatrices->getInstanceCount()) {
+        staging = std::make_unique<OdysseyBuffer>(
+            m_device,
+            sizeof(glm::mat4) + sizeof(glm::mat3x4),
+            m_modelMatrices->getInstanceCount(),
+            vk::BufferUsageFlagBits::eTransferSrc,
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+        staging->map();
+    }
+    // Model matrices first, then normal matrices, each at its slot.
+    auto normalsOffset = staging->getInstanceCount() * sizeof(glm::mat4);
+    auto* stagedMatrices = static_cast<glm::mat4*>(staging->getMappedMemory());
+    auto* stagedNormals = reinterpret_cast<glm::mat3x4*>(static_cast<std::byte*>(staging->getMappedMemory()) + normalsOffset);
+    const auto& normalMatrices = transforms.getNormalMatrices();
+    m_matrixCopies.clear();
+    m_normalCopies.clear();
+    auto stage = [&](uint32_t first, uint32_t count) {
+        std::copy_n(matrices.begin() + first, count, stagedMatrices + first);
+        std::copy_n(normalMatrices.begin() + first, count, stagedNormals + first);
+        m_matrixCopies.push_back({first * sizeof(glm::mat4), first * sizeof(glm::mat4), count * sizeof(glm::mat4)});
+        m_normalCopies.push_back({normalsOffset + first * sizeof(glm::mat3x4), first * sizeof(glm::mat3x4), count * sizeof(glm::mat3x4)});
+    };
+    size_t uploaded{0};
+    if (whole) {
+        uploaded = matrices.size();
+        stage(0, static_cast<uint32_t>(uploaded));
+    } else {
+        // Sorted, neighbouring slots become one copy region.
+        m_updatedTransforms.assign(updatedIndices.begin(), updatedIndices.end());
+        std::sort(m_updatedTransforms.begin(), m_updatedTransforms.end());
+        uploaded = m_updatedTransforms.size();
+        size_t begin{0};
+        while (begin < m_updatedTransforms.size()) {
+            auto end = begin + 1;
+            while (end < m_updatedTransforms.size() && m_updatedTransforms[end] == m_updatedTransforms[end - 1] + 1) {
+                ++end;
+            }
+            stage(m_updatedTransforms[begin], static_cast<uint32_t>(end - begin));
+            begin = end;
+        }
+    }
+    profiler.setCounter("transforms uploaded", static_cast<double>(uploaded));
+
+    // Earlier frames' draws must have read the slots before they change;
+    // impostor.frag reads the normal matrices too.
+    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader, vk::PipelineStageFlagBits::eTransfer, {}, nullptr, nullptr, nullptr);
+    commandBuffer.copyBuffer(staging->getBuffer(), m_modelMatrices->getBuffer(), m_matrixCopies);
+    commandBuffer.copyBuffer(staging->getBuffer(), m_normalMatrices->getBuffer(), m_normalCopies);
+    vk::MemoryBarrier uploadBarrier{};
+    uploadBarrier
+        .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eShaderRead);
+    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader, {}, uploadBarrier, nullptr, nullptr);
+}
+
+void OdysseyRenderSystem::cullObjects(std::vector<OdysseyObject>& objects, OdysseyCamera* camera) {
+    auto start = std::chrono::steady_clock::now();
+    if (m_culling) {
+        m_culler.resize(objects.size());
+        auto bound = [this, &objects](size_t begin, size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                const auto& object = objects[i];
+                if (object.model) {
+                    auto sphere = worldBoundingSphere(object.transform.mat4(), object.model->getBounds());
+                    m_culler.setSphere(i, glm::vec3(sphere), sphere.w);
+                }
+            }
+        };
+        OdysseyThreadPool::instance().parallelFor(objects.size(), OdysseyCuller::PARALLEL_GRAIN_SIZE, bound);
+        m_culler.cull(OdysseyFrustum::fromMatrix(camera->getProjection() * camera->getView()));
+    }
+    OdysseyProfiler::instance().setCounter("culling (ms)", std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
 }
 
-void OdysseyRenderSystem::renderObjects(vk::CommandBuffer commandBuffer, std::vector<OdysseyObject>& objects, OdysseyCamera* camera) {
-    m_pipelineLine->bind(commandBuffer);
+void OdysseyRenderSystem::renderBatches(vk::CommandBuffer commandBuffer, std::vector<OdysseyObject>& objects, OdysseyCamera* camera, size_t frameIndex) {
+    auto isDrawn = [this, &objects](size_t index) {
+        return objects[index].model && (!m_culling || m_culler.isVisible(index));
+    };
+
+    // Counting sort by model: the first pass sizes every batch, the second
+    // writes each instance straight into its slot of the mapped buffer.
+    m_batchIndices.clear();
+    m_batches.clear();
+    m_impostorBatchIndices.clear();
+    m_impostorBatches.clear();
+    m_fades.assign(objects.size(), 1.0F);
+    auto cameraPosition = glm::vec3(glm::inverse(camera->getView())[3]);
+    auto fadeEnd = m_impostorDistance * (1.0F + IMPOSTOR_FADE_BAND);
+    uint32_t modelCount{0};
+    uint32_t visibleCount{0};
+    uint32_t instanceCount{0};
+    uint32_t impostorCount{0};
+    const OdysseyModel* lastModel{nullptr};
+    uint32_t lastBatch{0};
+    for (size_t i = 0; i < objects.size(); ++i) {
+        if (objects[i].model) {
+            ++modelCount;
+        }
+        if (!isDrawn(i)) {
+            continue;
+        }
+        ++visibleCount;
+        if (m_impostorDistance > 0.0F) {
+            // The mesh fades out over the band past the impostor distance
+            // while the impostor fades in; models without an atlas stay meshes.
+            auto sphere = worldBoundingSphere(objects[i].transform.mat4(), objects[i].model->getBounds());
+            auto fade = glm::clamp((fadeEnd - glm::length(glm::vec3(sphere) - cameraPosition)) / (fadeEnd - m_impostorDistance), 0.0F, 1.0F);
+            if (fade < 1.0F && m_impostors->findAtlas(objects[i].model.get())) {
+                m_fades[i] = fade;
+                auto [iter, inserted] = m_impostorBatchIndices.try_emplace(objects[i].model.get(), static_cast<uint32_t>(m_impostorBatches.size()));
+                if (inserted) {
+                    m_impostorBatches.push_back({objects[i].model.get(), 0, 0, true});
+                }
+                ++m_impostorBatches[iter->second].instanceCount;
+                ++impostorCount;
+                if (fade <= 0.0F) {
+                    continue;
+                }
+            }
+        }
+        ++instanceCount;
+        if (!m_batching) {
+            continue;
+        }
+        if (objects[i].model.get() != lastModel) {
+            lastModel = objects[i].model.get();
+            auto [iter, inserted] = m_batchIndices.try_emplace(lastModel, static_cast<uint32_t>(m_batches.size()));
+            if (inserted) {
+                m_batches.push_back({lastModel, 0, 0});
+            }
+            lastBatch = iter->second;
+        }
+        ++m_batches[lastBatch].instanceCount;
+    }
+    auto& profiler = OdysseyProfiler::instance();
+    profiler.setCounter("visible objects", static_cast<double>(visibleCount));
+    profiler.setCounter("culled objects", static_cast<double>(modelCount - visibleCount));
+    profiler.setCounter("impostors", static_cast<double>(impostorCount));
+    profiler.setCounter("impostor atlases", m_impostors ? static_cast<double>(m_impostors->getAtlasCount()) : 0.0);
+    if (visibleCount == 0) {
+        profiler.setCounter("draw calls", 0.0);
+        profiler.setCounter("instances", 0.0);
+        m_orderedDraws.clear();
+        if (!replayDraws(commandBuffer, frameIndex)) {
+            record(commandBuffer, frameIndex, 0, 0, {});
+            if (m_commandCaching) {
+                m_commandCaches[frameIndex].draws.clear();
+            }
+        }
+        return;
+    }
+    uint32_t firstInstance{0};
+    for (auto& batch : m_batches) {
+        batch.firstInstance = firstInstance;
+        firstInstance += batch.instanceCount;
+        batch.instanceCount = 0;
+    }
+    // Impostors follow every mesh instance, batched or single, in the same
+    // instance buffer.
+    firstInstance = instanceCount;
+    for (auto& batch : m_impostorBatches) {
+        batch.firstInstance = firstInstance;
+        firstInstance += batch.instanceCount;
+        batch.instanceCount = 0;
+    }
+
+    auto* instanceBuffer = getInstanceBuffer(frameIndex, instanceCount + impostorCount);
+    auto* instances = static_cast<InstanceData*>(instanceBuffer->getMappedMemory());
+    // Sort keys have no pipeline or material to tell draws apart yet: every
+    // draw uses m_variant's pipeline and models carry no materials. Batches
+    // are drawn once each, so only single draws are keyed by depth.
     auto projectionView = camera->getProjection() * camera->getView();
-    for (auto& object : objects) {
-        PushConstantData push{};
-        auto model = object.transform.mat4();
-        push.transform = projectionView * model;
-        push.normal = object.transform.normal();
-        commandBuffer.pushConstants<PushConstantData>(m_pipelineLayout, vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment, 0, push);
-        object.model->bind(commandBuffer);
-        object.model->draw(commandBuffer);
+    uint32_t slot{0};
+    uint32_t lastModelId{0};
+    lastModel = nullptr;
+    m_draws.clear();
+    m_drawQueue.clear();
+    for (size_t i = 0; i < objects.size(); ++i) {
+        if (!isDrawn(i)) {
+            continue;
+        }
+        auto& object = objects[i];
+        auto fade = m_fades[i];
+        if (fade < 1.0F) {
+            auto& batch = m_impostorBatches[m_impostorBatchIndices[object.model.get()]];
+            auto& impostor = instances[batch.firstInstance + batch.instanceCount++];
+            impostor.transformIndex = object.transform.getIndex();
+            impostor.fade = 1.0F - fade;
+            if (fade <= 0.0F) {
+                continue;
+            }
+        }
+        InstanceData* instance{};
+        if (m_batching) {
+            if (object.model.get() != lastModel) {
+                lastModel = object.model.get();
+                lastBatch = m_batchIndices[lastModel];
+            }
+            auto& batch = m_batches[lastBatch];
+            instance = &instances[batch.firstInstance + batch.instanceCount++];
+        } else {
+            if (object.model.get() != lastModel) {
+                lastModel = object.model.get();
+                lastModelId = getModelId(lastModel);
+            }
+            auto clip = projectionView * object.transform.mat4()[3];
+            auto depth = clip.w > 0.0F ? clip.z / clip.w : 0.0F;
+            m_drawQueue.push(OdysseyDrawQueue::makeKey(0, 0, lastModelId, depth), static_cast<uint32_t>(m_draws.size()));
+            m_draws.push_back({object.model.get(), slot, 1});
+            instance = &instances[slot++];
+        }
+        instance->transformIndex = object.transform.getIndex();
+        instance->fade = fade;
+    }
+    instanceBuffer->flush();
+
+    auto start = std::chrono::steady_clock::now();
+    const auto& draws = m_batching ? m_batches : m_draws;
+    if (m_batching) {
+        for (uint32_t i = 0; i < m_batches.size(); ++i) {
+            m_drawQueue.push(OdysseyDrawQueue::makeKey(0, 0, getModelId(m_batches[i].model), 0.0F), i);
+        }
+    }
+    // Model changes in submission order: the fewest binds possible without sorting.
+    uint32_t unsortedModelChanges{1};
+    for (size_t i = 1; i < draws.size(); ++i) {
+        unsortedModelChanges += draws[i].model != draws[i - 1].model ? 1 : 0;
+    }
+    m_drawQueue.sort();
+    m_orderedDraws.clear();
+    for (const auto& packet : m_drawQueue.getPackets()) {
+        m_orderedDraws.push_back(draws[packet.index]);
+    }
+    // After every mesh, so the impostor pipeline is bound at most once per
+    // secondary buffer.
+    m_orderedDraws.insert(m_orderedDraws.end(), m_impostorBatches.begin(), m_impostorBatches.end());
+    profiler.setCounter("draw sort (ms)", std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    profiler.setCounter("draw calls", static_cast<double>(m_orderedDraws.size()));
+    profiler.setCounter("instances", static_cast<double>(instanceCount));
+    profiler.setCounter("binds unsorted", static_cast<double>(draws.size() + 1));
+    profiler.setCounter("model changes unsorted", static_cast<double>(unsortedModelChanges));
+    if (replayDraws(commandBuffer, frameIndex)) {
+        profiler.setCounter("draw recording (ms)", 0.0);
+        return;
+    }
+
+    if (impostorCount > 0) {
+        // Created here, so recording threads only look it up.
+        getImpostorPipeline(m_variant);
     }
+    start = std::chrono::steady_clock::now();
+    std::atomic<uint32_t> binds{0};
+    record(commandBuffer, frameIndex, 0, m_orderedDraws.size(), [this, frameIndex, &binds, instanceBuffer](vk::CommandBuffer drawCommandBuffer, size_t begin, size_t end) {
+        bindScenePipeline(drawCommandBuffer, frameIndex);
+        drawCommandBuffer.bindVertexBuffers(1, instanceBuffer->getBuffer(), {0});
+        // Every secondary buffer starts without bound state.
+        const OdysseyModel* boundModel{nullptr};
+        bool impostorBound{false};
+        uint32_t chunkBinds{1};
+        for (auto i = begin; i < end; ++i) {
+            const auto& draw = m_orderedDraws[i];
+            if (draw.impostor) {
+                if (!impostorBound) {
+                    bindImpostorPipeline(drawCommandBuffer, frameIndex);
+                    impostorBound = true;
+                    ++chunkBinds;
+                }
+                // Baked while counting, so this only looks the atlas up.
+                const auto* atlas = m_impostors->findAtlas(draw.model);
+                ImpostorPushConstantData push{};
+                push.sphere = atlas->sphere;
+                if (m_variant.runtimeBranching) {
+                    push.options = {static_cast<float>(m_variant.lightingModel), static_cast<float>(m_variant.debugView), 0.0F, 0.0F};
+                }
+                drawCommandBuffer.pushConstants<ImpostorPushConstantData>(m_impostorPipelineLayout, vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment, 0, push);
+                drawCommandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_impostorPipelineLayout, 1, atlas->descriptorSet, nullptr);
+                drawCommandBuffer.draw(6, draw.instanceCount, 0, draw.firstInstance);
+                continue;
+            }
+            if (draw.model != boundModel) {
+                boundModel = draw.model;
+                boundModel->bind(drawCommandBuffer);
+                ++chunkBinds;
+            }
+            draw.model->draw(drawCommandBuffer, draw.instanceCount, draw.firstInstance);
+        }
+        binds += chunkBinds;
+    });
+    if (m_commandCaching) {
+        m_commandCaches[frameIndex].draws = m_orderedDraws;
+    }
+    profiler.setCounter("draw recording (ms)", std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    // Pipeline and model binds, against one pipeline bind plus a model bind
+    // per draw before sorting and skipping unchanged state.
+    profiler.setCounter("binds", static_cast<double>(binds));
+}
+
+uint32_t OdysseyRenderSystem::getModelId(const OdysseyModel* model) {
+    return m_modelIds.try_emplace(model, static_cast<uint32_t>(m_modelIds.size())).first->second;
+}
+
+bool OdysseyRenderSystem::replay(vk::CommandBuffer commandBuffer, size_t frameIndex, const CommandCacheKey& key) {
+    m_frameKey = key;
+    m_replaying = false;
+    if (m_commandCaching) {
+        if (m_commandCaches.size() <= frameIndex) {
+            m_commandCaches.resize(frameIndex + 1);
+        }
+        // Each frame in flight has its own instance buffer and global offset,
+        // so its own commands and key.
+        const auto& cache = m_commandCaches[frameIndex];
+        m_replaying = cache.recorded && cache.key == key;
+        if (m_replaying && !cache.lists[0].empty()) {
+            commandBuffer.executeCommands(cache.lists[0]);
+        }
+    }
+    OdysseyProfiler::instance().setCounter("commands replayed", m_replaying ? 1.0 : 0.0);
+    return m_replaying;
+}
+
+bool OdysseyRenderSystem::replayDraws(vk::CommandBuffer commandBuffer, size_t frameIndex) {
+    // Objects moved, or the camera did under culling, but the same draws came
+    // out: the instance buffer has been rewritten in place and the recorded
+    // commands still apply.
+    if (!m_commandCaching) {
+        return false;
+    }
+    auto& cache = m_commandCaches[frameIndex];
+    if (!cache.recorded || cache.key.recordVersion != m_recordVersion || cache.key.extent != m_frameKey.extent || cache.draws != m_orderedDraws) {
+        return false;
+    }
+    cache.key = m_frameKey;
+    cache.key.recordVersion = m_recordVersion;
+    if (!cache.lists[0].empty()) {
+        commandBuffer.executeCommands(cache.lists[0]);
+    }
+    OdysseyProfiler::instance().setCounter("commands replayed", 1.0);
+    return true;
+}
+
+void OdysseyRenderSystem::record(vk::CommandBuffer commandBuffer, size_t frameIndex, uint32_t list, size_t count, const std::function<void(vk::CommandBuffer commandBuffer, size_t begin, size_t end)>& function) {
+    auto* buffers = &m_secondaryCommandBuffers;
+    if (m_commandCaching) {
+        auto& cache = m_commandCaches[frameIndex];
+        if (list == 0) {
+            // Frees every list of the frame; the later lists are recorded
+            // again in this same frame, since they share its key. The
+            // instance buffer may have been replaced since the key was taken.
+            m_cachedCommandPools->reset(frameIndex);
+            for (auto& cachedList : cache.lists) {
+                cachedList.clear();
+            }
+            cache.key = m_frameKey;
+            cache.key.recordVersion = m_recordVersion;
+            cache.recorded = true;
+        }
+        buffers = &cache.lists[list];
+    } else if (!m_beginSecondary) {
+        if (count > 0) {
+            function(commandBuffer, 0, count);
+        }
+        return;
+    }
+    if (count == 0) {
+        buffers->clear();
+        return;
+    }
+    // Each chunk gets its own secondary buffer from the pool of the thread
+    // that records it; executing them in chunk order keeps the draw order.
+    // Cached commands without parallel recording are a single chunk.
+    auto grainSize = m_beginSecondary ? RECORD_GRAIN_SIZE : count;
+    buffers->assign((count + grainSize - 1) / grainSize, nullptr);
+    OdysseyThreadPool::instance().parallelFor(count, grainSize, [this, frameIndex, grainSize, buffers, &function](size_t begin, size_t end) {
+        auto secondary = beginSecondary(frameIndex);
+        function(secondary, begin, end);
+        secondary.end();
+        (*buffers)[begin / grainSize] = secondary;
+    });
+    commandBuffer.executeCommands(*buffers);
+}
+
+vk::CommandBuffer OdysseyRenderSystem::beginSecondary(size_t frameIndex) {
+    auto threadIndex = OdysseyThreadPool::getThreadIndex();
+    if (!m_commandCaching) {
+        return m_beginSecondary(threadIndex);
+    }
+    auto commandBuffer = m_cachedCommandPools->allocate(frameIndex, threadIndex, vk::CommandBufferLevel::eSecondary);
+    // No framebuffer, since the buffer is replayed into whichever swap chain
+    // image later frames render to, and no eOneTimeSubmit.
+    vk::CommandBufferInheritanceInfo inheritanceInfo{};
+    inheritanceInfo
+        .setRenderPass(m_renderPass)
+        .setSubpass(0);
+    vk::CommandBufferBeginInfo beginInfo{};
+    beginInfo
+        .setFlags(vk::CommandBufferUsageFlagBits::eRenderPassContinue)
+        .setPInheritanceInfo(&inheritanceInfo);
+    commandBuffer.begin(beginInfo);
+    vk::Viewport viewport{0.0F, 0.0F, static_cast<float>(m_extent.width), static_cast<float>(m_extent.height), 0.0F, 1.0F};
+    vk::Rect2D scissor{{0, 0}, m_extent};
+    commandBuffer.setViewport(0, viewport);
+    commandBuffer.setScissor(0, scissor);
+    return commandBuffer;
+}
+
+void OdysseyRenderSystem::renderIndirect(vk::CommandBuffer commandBuffer, size_t frameIndex, uint32_t list) {
+    if (m_indirectFrames.size() <= frameIndex || m_indirectFrames[frameIndex].objectCount == 0) {
+        return;
+    }
+    const auto& frame = m_indirectFrames[frameIndex];
+    constexpr auto commandStride = static_cast<uint32_t>(sizeof(vk::DrawIndexedIndirectCommand));
+    // List 0 is written by cull.comp, list 1 by occlusion.comp, each with
+    // room for every object and its own count.
+    auto commandOffset = vk::DeviceSize{list} * frame.objectCount * commandStride;
+    m_geometryPool->bind(commandBuffer);
+    commandBuffer.bindVertexBuffers(1, frame.instanceBuffer, {0});
+    uint32_t drawCalls{1};
+    if (m_device->supportsDrawIndirectCount()) {
+        commandBuffer.drawIndexedIndirectCount(frame.commands->getBuffer(), commandOffset, frame.count->getBuffer(), list * sizeof(uint32_t), frame.objectCount, commandStride);
+    } else if (m_device->supportsMultiDrawIndirect()) {
+        commandBuffer.drawIndexedIndirect(frame.commands->getBuffer(), commandOffset, frame.objectCount, commandStride);
+    } else {
+        for (uint32_t i = 0; i < frame.objectCount; ++i) {
+            commandBuffer.drawIndexedIndirect(frame.commands->getBuffer(), commandOffset + i * commandStride, 1, commandStride);
+        }
+        drawCalls = frame.objectCount;
+    }
+    auto& profiler = OdysseyProfiler::instance();
+    if (list == 0) {
+        profiler.setCounter("draw calls", static_cast<double>(drawCalls));
+        profiler.setCounter("instances", static_cast<double>(frame.objectCount));
+    } else {
+        profiler.addCounter("draw calls", static_cast<double>(drawCalls));
+    }
+}
+
+void OdysseyRenderSystem::markSceneChanged() {
+    ++m_sceneVersion;
+}
+
+void OdysseyRenderSystem::setBatching(bool batching) {
+    m_batching = batching;
+    ++m_recordVersion;
+}
+
+void OdysseyRenderSystem::setCulling(bool culling) {
+    // Changes the instance data uploaded for the GPU-driven path as well.
+    m_culling = culling;
+    ++m_sceneVersion;
+}
+
+void OdysseyRenderSystem::setPerObjectTransforms(bool perObjectTransforms) {
+    m_perObjectTransforms = perObjectTransforms;
+}
+
+bool OdysseyRenderSystem::setGpuDriven(bool gpuDriven) {
+    // firstInstance is how each indirect command finds its object.
+    if (gpuDriven && !m_device->supportsDrawIndirectFirstInstance()) {
+        gpuDriven = false;
+    }
+    if (gpuDriven && !m_cullPipeline) {
+        createCullResources();
+    }
+    m_gpuDriven = gpuDriven;
+    ++m_recordVersion;
+    return m_gpuDriven;
+}
+
+bool OdysseyRenderSystem::isGpuDriven() const {
+    return m_gpuDriven;
+}
+
+bool OdysseyRenderSystem::setOcclusionCulling(bool occlusionCulling) {
+    // Both culling passes and both draw lists live on the GPU path.
+    if (occlusionCulling && !m_gpuDriven) {
+        occlusionCulling = false;
+    }
+    if (occlusionCulling && !m_occlusionPipeline) {
+        createOcclusionResources();
+    }
+    m_occlusionCulling = occlusionCulling;
+    ++m_recordVersion;
+    return m_occlusionCulling;
+}
+
+bool OdysseyRenderSystem::isOcclusionCulling() const {
+    return m_occlusionCulling;
+}
+
+void OdysseyRenderSystem::setParallelRecording(std::function<vk::CommandBuffer(size_t threadIndex)> beginSecondary) {
+    m_beginSecondary = std::move(beginSecondary);
+}
+
+bool OdysseyRenderSystem::isParallelRecording() const {
+    return static_cast<bool>(m_beginSecondary);
+}
+
+void OdysseyRenderSystem::setCommandCaching(bool commandCaching) {
+    if (commandCaching && !m_cachedCommandPools) {
+        m_cachedCommandPools = std::make_unique<OdysseyCommandPools>(m_device, OdysseySwapChain::MAX_FRAMES_IN_FLIGHT, OdysseyThreadPool::instance().getThreadCount(), vk::CommandPoolCreateFlags{});
+    }
+    m_commandCaching = commandCaching;
+    m_commandCaches.clear();
+}
+
+bool OdysseyRenderSystem::isCommandCaching() const {
+    return m_commandCaching;
+}
+
+void OdysseyRenderSystem::setImpostorDistance(float distance) {
+    if (distance > 0.0F && !m_impostors) {
+        m_impostors = std::make_unique<OdysseyImpostors>(m_device);
+        vk::PushConstantRange pushConstantRange{};
+        pushConstantRange
+            .setStageFlags(vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment)
+            .setOffset(0)
+            .setSize(sizeof(ImpostorPushConstantData));
+        std::array<vk::DescriptorSetLayout, 2> setLayouts{m_globalSetLayout->getDescriptorSetLayout(), m_impostors->getSetLayout()};
+        vk::PipelineLayoutCreateInfo pipelineInfo{};
+        pipelineInfo
+            .setSetLayouts(setLayouts)
+            .setPushConstantRanges(pushConstantRange);
+        m_impostorPipelineLayout = m_device->device().createPipelineLayout(pipelineInfo);
+    }
+    m_impostorDistance = (std::max)(distance, 0.0F);
+    m_variant.impostorFade = m_impostorDistance > 0.0F;
+    getPipeline(m_variant);
+    ++m_recordVersion;
+}
+
+const OdysseyImpostors* OdysseyRenderSystem::getImpostors() const {
+    return m_impostors.get();
+}
+
+OdysseyBuffer* OdysseyRenderSystem::getInstanceBuffer(size_t frameIndex, size_t instanceCount) {
+    if (m_instanceBuffers.size() <= frameIndex) {
+        m_instanceBuffers.resize(frameIndex + 1);
+    }
+    // The caller has waited on this frame's fence, so the buffer is idle and
+    // can be replaced. Growing geometrically keeps reallocations rare.
+    auto& instanceBuffer = m_instanceBuffers[frameIndex];
+    if (!instanceBuffer || instanceBuffer->getInstanceCount() < instanceCount) {
+        auto capacity = std::bit_ceil(instanceCount);
+        instanceBuffer = std::make_unique<OdysseyBuffer>(
+            m_device,
+            sizeof(InstanceData),
+            static_cast<uint32_t>(capacity),
+            vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eStorageBuffer,
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+        instanceBuffer->map();
+        // Recorded commands bind the old buffer.
+        ++m_recordVersion;
+    }
+    return instanceBuffer.get();
+}
+
+void OdysseyRenderSystem::createCullResources() {
+    m_geometryPool = std::make_unique<OdysseyGeometryPool>(m_device);
+    m_cullSetLayout = OdysseyDescriptorSetLayout::Builder(m_device)
+                          .addBinding(0, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eCompute)
+                          .addBinding(1, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eCompute)
+                          .addBinding(2, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eCompute)
+                          .addBinding(3, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eCompute)
+                          .addBinding(4, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eCompute)
+                          .build();
+    m_cullDescriptorPool = OdysseyDescriptorPool::Builder(m_device)
+                               .setMaxSets(static_cast<uint32_t>(OdysseySwapChain::MAX_FRAMES_IN_FLIGHT))
+                               .addPoolSize(vk::DescriptorType::eStorageBuffer, 5 * static_cast<uint32_t>(OdysseySwapChain::MAX_FRAMES_IN_FLIGHT))
+                               .build();
+
+    vk::PushConstantRange pushConstantRange{};
+    pushConstantRange
+        .setStageFlags(vk::ShaderStageFlagBits::eCompute)
+        .setOffset(0)
+        .setSize(sizeof(CullPushConstantData));
+    auto setLayout = m_cullSetLayout->getDescriptorSetLayout();
+    vk::PipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo
+        .setSetLayouts(setLayout)
+        .setPushConstantRanges(pushConstantRange);
+    m_cullPipelineLayout = m_device->device().createPipelineLayout(pipelineLayoutInfo);
+    m_cullPipeline = std::make_unique<OdysseyComputePipeline>(m_device, "shaders/cull.comp.spv", m_cullPipelineLayout);
+}
+
+void OdysseyRenderSystem::createOcclusionResources() {
+    m_depthPyramid = std::make_unique<OdysseyDepthPyramid>(m_device);
+    m_occlusionSetLayout = OdysseyDescriptorSetLayout::Builder(m_device)
+                               .addBinding(0, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eCompute)
+                               .addBinding(1, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eCompute)
+                               .addBinding(2, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eCompute)
+                               .addBinding(3, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eCompute)
+                               .addBinding(4, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eCompute)
+                               .addBinding(5, vk::DescriptorType::eCombinedImageSampler, vk::ShaderStageFlagBits::eCompute)
+                               .build();
+    m_occlusionDescriptorPool = OdysseyDescriptorPool::Builder(m_device)
+                                    .setMaxSets(static_cast<uint32_t>(OdysseySwapChain::MAX_FRAMES_IN_FLIGHT))
+                                    .addPoolSize(vk::DescriptorType::eStorageBuffer, 5 * static_cast<uint32_t>(OdysseySwapChain::MAX_FRAMES_IN_FLIGHT))
+                                    .addPoolSize(vk::DescriptorType::eCombinedImageSampler, static_cast<uint32_t>(OdysseySwapChain::MAX_FRAMES_IN_FLIGHT))
+                                    .build();
+
+    vk::PushConstantRange pushConstantRange{};
+    pushConstantRange
+        .setStageFlags(vk::ShaderStageFlagBits::eCompute)
+        .setOffset(0)
+        .setSize(sizeof(OcclusionPushConstantData));
+    auto setLayout = m_occlusionSetLayout->getDescriptorSetLayout();
+    vk::PipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo
+        .setSetLayouts(setLayout)
+        .setPushConstantRanges(pushConstantRange);
+    m_occlusionPipelineLayout = m_device->device().createPipelineLayout(pipelineLayoutInfo);
+    m_occlusionPipeline = std::make_unique<OdysseyComputePipeline>(m_device, "shaders/occlusion.comp.spv", m_occlusionPipelineLayout);
+}
+
+void OdysseyRenderSystem::createGlobalResources() {
+    constexpr auto frameCount = static_cast<uint32_t>(OdysseySwapChain::MAX_FRAMES_IN_FLIGHT);
+    m_globalSetLayout = OdysseyDescriptorSetLayout::Builder(m_device)
+                            .addBinding(0, vk::DescriptorType::eUniformBufferDynamic, vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment)
+                            .addBinding(1, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eVertex)
+                            // impostor.frag lights with the normal matrices.
+                            .addBinding(2, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment)
+                            .addBinding(3, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eFragment)
+                            .addBinding(4, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eFragment)
+                            .build();
+    m_globalDescriptorPool = OdysseyDescriptorPool::Builder(m_device)
+                                 .setMaxSets(1)
+                                 .addPoolSize(vk::DescriptorType::eUniformBufferDynamic, 1)
+                                 .addPoolSize(vk::DescriptorType::eStorageBuffer, 4)
+                                 .build();
+    // One slot per frame in flight, mapped for the renderer's lifetime; the
+    // bound slot is picked by the dynamic offset alone.
+    m_globalBuffer = std::make_unique<OdysseyBuffer>(
+        m_device,
+        sizeof(GlobalData),
+        frameCount,
+        vk::BufferUsageFlagBits::eUniformBuffer,
+        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+        m_device->getProperties().limits.minUniformBufferOffsetAlignment);
+    m_globalBuffer->map();
+    // shader.frag reads the light buffers whether or not there are lights.
+    m_clusteredLights = std::make_unique<OdysseyClusteredLights>(m_device);
+    m_transformStagingBuffers.resize(frameCount);
+    updateTransformBuffers(INITIAL_TRANSFORM_CAPACITY);
+}
+
+void OdysseyRenderSystem::updateTransformBuffers(size_t transformCount) {
+    if (m_modelMatrices && m_modelMatrices->getInstanceCount() >= transformCount) {
+        return;
+    }
+    // Every frame in flight reads the buffers, so replacing them waits for
+    // all of them; the next upload copies every matrix.
+    if (m_modelMatrices) {
+        m_device->device().waitIdle();
+    }
+    auto capacity = static_cast<uint32_t>(std::bit_ceil((std::max)(transformCount, INITIAL_TRANSFORM_CAPACITY)));
+    m_modelMatrices = std::make_unique<OdysseyBuffer>(
+        m_device,
+        sizeof(glm::mat4),
+        capacity,
+        vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst,
+        vk::MemoryPropertyFlagBits::eDeviceLocal);
+    m_normalMatrices = std::make_unique<OdysseyBuffer>(
+        m_device,
+        sizeof(glm::mat3x4),
+        capacity,
+        vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst,
+        vk::MemoryPropertyFlagBits::eDeviceLocal);
+    m_uploadedTransformVersion = ~0ULL;
+
+    auto globalInfo = m_globalBuffer->descriptorInfo(sizeof(GlobalData), 0);
+    auto modelInfo = m_modelMatrices->descriptorInfo();
+    auto normalInfo = m_normalMatrices->descriptorInfo();
+    auto lightInfo = m_clusteredLights->getLightBufferInfo();
+    auto clusterInfo = m_clusteredLights->getClusterBufferInfo();
+    OdysseyDescriptorWriter writer(*m_globalSetLayout, *m_globalDescriptorPool);
+    writer
+        .writeBuffer(0, &globalInfo)
+        .writeBuffer(1, &modelInfo)
+        .writeBuffer(2, &normalInfo)
+        .writeBuffer(3, &lightInfo)
+        .writeBuffer(4, &clusterInfo);
+    if (m_globalDescriptorSet) {
+        writer.overwrite(m_globalDescriptorSet);
+    } else if (!writer.build(m_globalDescriptorSet)) {
+        throw std::runtime_error("Failed to allocate global descriptor set.");
+    }
+    // Recorded commands bound the set before it was rewritten.
+    ++m_recordVersion;
+}
+
+void OdysseyRenderSystem::updateIndirectFrame(IndirectFrame& frame, OdysseyBuffer* instanceBuffer, uint32_t objectCount) {
+    // This frame's fence has been waited on, so its buffers can be replaced
+    // and its descriptor set rewritten.
+    bool rewrite = !frame.descriptorSet || frame.instanceBuffer != instanceBuffer->getBuffer() || frame.visibilityBuffer != m_visibility->getBuffer();
+    const auto& meshes = m_geometryPool->getMeshes();
+    if (frame.geometryVersion != m_geometryPool->getVersion()) {
+        if (!frame.meshes || frame.meshes->getInstanceCount() < meshes.size()) {
+            frame.meshes = std::make_unique<OdysseyBuffer>(
+                m_device,
+                sizeof(OdysseyMeshRange),
+                static_cast<uint32_t>(std::bit_ceil(meshes.size())),
+                vk::BufferUsageFlagBits::eStorageBuffer,
+                vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+            frame.meshes->map();
+            rewrite = true;
+        }
+        frame.meshes->writeToBuffer(meshes.data(), meshes.size() * sizeof(OdysseyMeshRange));
+        frame.geometryVersion = m_geometryPool->getVersion();
+        // The pool's vertex and index buffers may have grown.
+        ++m_recordVersion;
+    }
+    // Occlusion culling draws twice, from two lists of objectCount commands.
+    auto commandCount = m_occlusionCulling ? 2 * objectCount : objectCount;
+    if (!frame.commands || frame.commands->getInstanceCount() < commandCount) {
+        frame.commands = std::make_unique<OdysseyBuffer>(
+            m_device,
+            sizeof(vk::DrawIndexedIndirectCommand),
+            std::bit_ceil(commandCount),
+            vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst,
+            vk::MemoryPropertyFlagBits::eDeviceLocal);
+        rewrite = true;
+    }
+    if (!frame.count) {
+        frame.count = std::make_unique<OdysseyBuffer>(
+            m_device,
+            sizeof(uint32_t),
+            DRAW_COUNT_SIZE,
+            vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eTransferSrc,
+            vk::MemoryPropertyFlagBits::eDeviceLocal);
+        rewrite = true;
+    }
+    if (!rewrite) {
+        return;
+    }
+    ++m_recordVersion;
+    frame.instanceBuffer = instanceBuffer->getBuffer();
+    frame.visibilityBuffer = m_visibility->getBuffer();
+    frame.occlusionSetDirty = true;
+    auto objectsInfo = instanceBuffer->descriptorInfo();
+    auto meshesInfo = frame.meshes->descriptorInfo();
+    auto commandsInfo = frame.commands->descriptorInfo();
+    auto countInfo = frame.count->descriptorInfo();
+    auto visibilityInfo = m_visibility->descriptorInfo();
+    OdysseyDescriptorWriter writer(*m_cullSetLayout, *m_cullDescriptorPool);
+    writer
+        .writeBuffer(0, &objectsInfo)
+        .writeBuffer(1, &meshesInfo)
+        .writeBuffer(2, &commandsInfo)
+        .writeBuffer(3, &countInfo)
+        .writeBuffer(4, &visibilityInfo);
+    if (frame.descriptorSet) {
+        writer.overwrite(frame.descriptorSet);
+    } else if (!writer.build(frame.descriptorSet)) {
+        throw std::runtime_error("Failed to allocate culling descriptor set.");
+    }
+}
+
+void OdysseyRenderSystem::updateOcclusionFrame(IndirectFrame& frame, size_t frameIndex) {
+    // The pyramid is rebuilt with new views when the swap chain changes size.
+    auto pyramidView = m_depthPyramid->getImageView(frameIndex);
+    if (frame.occlusionDescriptorSet && !frame.occlusionSetDirty && frame.pyramidView == pyramidView) {
+        return;
+    }
+    if (!frame.countReadback) {
+        frame.countReadback = std::make_unique<OdysseyBuffer>(
+            m_device,
+            sizeof(uint32_t),
+            DRAW_COUNT_SIZE,
+            vk::BufferUsageFlagBits::eTransferDst,
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+        frame.countReadback->map();
+    }
+    vk::DescriptorBufferInfo objectsInfo{frame.instanceBuffer, 0, VK_WHOLE_SIZE};
+    auto meshesInfo = frame.meshes->descriptorInfo();
+    auto commandsInfo = frame.commands->descriptorInfo();
+    auto countInfo = frame.count->descriptorInfo();
+    auto visibilityInfo = m_visibility->descriptorInfo();
+    auto pyramidInfo = m_depthPyramid->descriptorInfo(frameIndex);
+    OdysseyDescriptorWriter writer(*m_occlusionSetLayout, *m_occlusionDescriptorPool);
+    writer
+        .writeBuffer(0, &objectsInfo)
+        .writeBuffer(1, &meshesInfo)
+        .writeBuffer(2, &commandsInfo)
+        .writeBuffer(3, &countInfo)
+        .writeBuffer(4, &visibilityInfo)
+        .writeImage(5, &pyramidInfo);
+    if (frame.occlusionDescriptorSet) {
+        writer.overwrite(frame.occlusionDescriptorSet);
+    } else if (!writer.build(frame.occlusionDescriptorSet)) {
+        throw std::runtime_error("Failed to allocate occlusion culling descriptor set.");
+    }
+    frame.pyramidView = pyramidView;
+    frame.occlusionSetDirty = false;
+}
+
+void OdysseyRenderSystem::updateVisibilityBuffer(vk::CommandBuffer commandBuffer, uint32_t objectCount) {
+    if (m_visibility && m_visibility->getInstanceCount() >= objectCount) {
+        return;
+    }
+    // Every frame in flight reads the buffer, so replacing it waits for all
+    // of them. Growth is geometric and new objects start out not visible,
+    // which makes them wait for the late pass of their first frame.
+    if (m_visibility) {
+        m_device->device().waitIdle();
+    }
+    m_visibility = std::make_unique<OdysseyBuffer>(
+        m_device,
+        sizeof(uint32_t),
+        std::bit_ceil(objectCount),
+        vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst,
+        vk::MemoryPropertyFlagBits::eDeviceLocal);
+    commandBuffer.fillBuffer(m_visibility->getBuffer(), 0, VK_WHOLE_SIZE, 0);
+}
+
+void OdysseyRenderSystem::readOcclusionCounts(IndirectFrame& frame) {
+    if (!frame.countsPending) {
+        return;
+    }
+    // This frame's fence has been waited on, so the copy made at the end of
+    // its last use is complete.
+    frame.countsPending = false;
+    const auto* counts = static_cast<const uint32_t*>(frame.countReadback->getMappedMemory());
+    auto& profiler = OdysseyProfiler::instance();
+    profiler.setCounter("occlusion early draws", static_cast<double>(counts[EARLY_DRAWS]));
+    profiler.setCounter("occlusion late draws", static_cast<double>(counts[LATE_DRAWS]));
+    profiler.setCounter("occluded objects", static_cast<double>(counts[OCCLUDED]));
+    profiler.setCounter("occluded fraction", counts[FRUSTUM_VISIBLE] > 0 ? static_cast<double>(counts[OCCLUDED]) / static_cast<double>(counts[FRUSTUM_VISIBLE]) : 0.0);
+}
+
+void OdysseyRenderSystem::renderPointCloud(vk::CommandBuffer commandBuffer, const OdysseyPointCloud& pointCloud, size_t frameIndex) {
+    const auto& draws = pointCloud.getDraws();
+    if (draws.empty()) {
+        return;
+    }
+    if (!m_pointPipeline) {
+        PipelineVariant variant{};
+        variant.primitiveTopology = vk::PrimitiveTopology::ePointList;
+        m_pointPipeline = createPipeline("shaders/point.vert.spv", "shaders/point.frag.spv", variant, m_renderPass, OdysseyPointCloudFile::Point::getBindingDescriptions(), OdysseyPointCloudFile::Point::getAttributeDescriptions());
+    }
+    m_pointPipeline->bind(commandBuffer);
+    auto globalOffset = static_cast<uint32_t>(frameIndex * m_globalBuffer->getAlignmentSize());
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_pipelineLayout, 0, m_globalDescriptorSet, globalOffset);
+    PushConstantData push{};
+    push.options = pointCloud.getPlacement();
+    commandBuffer.pushConstants<PushConstantData>(m_pipelineLayout, vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment, 0, push);
+    for (const auto& draw : draws) {
+        commandBuffer.bindVertexBuffers(0, draw.buffer, {0});
+        commandBuffer.draw(draw.pointCount, 1, 0, 0);
+    }
+}
+
+void OdysseyRenderSystem::renderMeshStream(vk::CommandBuffer commandBuffer, const OdysseyMeshStream& meshStream, size_t frameIndex) {
+    const auto& draws = meshStream.getDraws();
+    if (draws.empty()) {
+        return;
+    }
+    if (m_streamTransformIndex != meshStream.getTransformIndex()) {
+        // Only ever written before the first draw of a stream.
+        m_device->device().waitIdle();
+        m_streamInstanceBuffer = std::make_unique<OdysseyBuffer>(
+            m_device,
+            sizeof(InstanceData),
+            1,
+            vk::BufferUsageFlagBits::eVertexBuffer,
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+        InstanceData instance{};
+        instance.transformIndex = meshStream.getTransformIndex();
+        m_streamInstanceBuffer->map();
+        m_streamInstanceBuffer->writeToBuffer(&instance, sizeof(instance));
+        m_streamTransformIndex = meshStream.getTransformIndex();
+    }
+    bindScenePipeline(commandBuffer, frameIndex);
+    commandBuffer.bindVertexBuffers(1, m_streamInstanceBuffer->getBuffer(), {0});
+    for (const auto& draw : draws) {
+        commandBuffer.bindVertexBuffers(0, draw.buffer, {0});
+        commandBuffer.bindIndexBuffer(draw.buffer, draw.indexOffset, vk::IndexType::eUint32);
+        commandBuffer.drawIndexed(draw.indexCount, 1, 0, 0, 0);
+    }
+}
+
+std::vector<vk::VertexInputBindingDescription> InstanceData::getBindingDescriptions() {
+    std::vector<vk::VertexInputBindingDescription> bindingDescriptions(1);
+    bindingDescriptions.at(0)
+        .setBinding(1)
+        .setStride(sizeof(InstanceData))
+        .setInputRate(vk::VertexInputRate::eInstance);
+    return bindingDescriptions;
+}
+
+std::vector<vk::VertexInputAttributeDescription> InstanceData::getAttributeDescriptions() {
+    // The transform index and fade, after the four per-vertex attributes;
+    // the culling fields are read by the compute passes alone.
+    std::vector<vk::VertexInputAttributeDescription> attributeDescriptions{};
+    attributeDescriptions.push_back({4, 1, vk::Format::eR32Uint, static_cast<uint32_t>(offsetof(InstanceData, transformIndex))});
+    attributeDescriptions.push_back({5, 1, vk::Format::eR32Sfloat, static_cast<uint32_t>(offsetof(InstanceData, fade))});
+    return attributeDescriptions;
 }
 
 void OdysseyRenderSystem::createPipelineLayout() {
@@ -41,19 +1247,56 @@ void OdysseyRenderSystem::createPipelineLayout() {
         .setOffset(0)
         .setSize(sizeof(PushConstantData));
 
+    auto setLayout = m_globalSetLayout->getDescriptorSetLayout();
     vk::PipelineLayoutCreateInfo pipelineInfo{};
     pipelineInfo
-        .setSetLayoutCount(0)
-        .setPSetLayouts(nullptr)
+        .setSetLayouts(setLayout)
         .setPushConstantRangeCount(1)
         .setPushConstantRanges(pushConstantRange);
     m_pipelineLayout = m_device->device().createPipelineLayout(pipelineInfo);
 }
 
-std::unique_ptr<OdysseyPipeline> OdysseyRenderSystem::createPipeline(const std::string& vertShaderPath, const std::string& fragShaderPath, vk::PrimitiveTopology primitiveTopology, float lineWidth, vk::RenderPass renderPass) {
-    auto pipelineConfig = OdysseyPipeline::defaultPipelineConfigInfo(primitiveTopology, lineWidth);
+void OdysseyRenderSystem::setVariant(const PipelineVariant& variant) {
+    m_variant = variant;
+    m_variant.impostorFade = m_impostorDistance > 0.0F;
+    getPipeline(m_variant);
+    ++m_recordVersion;
+}
+
+const PipelineVariant& OdysseyRenderSystem::getVariant() const {
+    return m_variant;
+}
+
+const OdysseyPipeline* OdysseyRenderSystem::getPipeline(const PipelineVariant& variant) {
+    auto iter = m_pipelines.find(variant);
+    if (iter == m_pipelines.end()) {
+        auto bindingDescriptions = OdysseyModel::Vertex::getBindingDescriptions();
+        auto attributeDescriptions = OdysseyModel::Vertex::getAttributeDescriptions();
+        auto instanceBindings = InstanceData::getBindingDescriptions();
+        auto instanceAttributes = InstanceData::getAttributeDescriptions();
+        bindingDescriptions.insert(bindingDescriptions.end(), instanceBindings.begin(), instanceBindings.end());
+        attributeDescriptions.insert(attributeDescriptions.end(), instanceAttributes.begin(), instanceAttributes.end());
+        iter = m_pipelines.emplace(variant, createPipeline("shaders/shader.vert.spv", "shaders/shader.frag.spv", variant, m_renderPass, bindingDescriptions, attributeDescriptions)).first;
+    }
+    return iter->second.get();
+}
+
+const OdysseyPipeline* OdysseyRenderSystem::getImpostorPipeline(const PipelineVariant& variant) {
+    auto iter = m_impostorPipelines.find(variant);
+    if (iter == m_impostorPipelines.end()) {
+        // Quads are built from the vertex index; only instances are read.
+        iter = m_impostorPipelines.emplace(variant, createPipeline("shaders/impostor.vert.spv", "shaders/impostor.frag.spv", variant, m_renderPass, InstanceData::getBindingDescriptions(), InstanceData::getAttributeDescriptions(), m_impostorPipelineLayout)).first;
+    }
+    return iter->second.get();
+}
+
+std::unique_ptr<OdysseyPipeline> OdysseyRenderSystem::createPipeline(const std::string& vertShaderPath, const std::string& fragShaderPath, const PipelineVariant& variant, vk::RenderPass renderPass, const std::vector<vk::VertexInputBindingDescription>& bindingDescriptions, const std::vector<vk::VertexInputAttributeDescription>& attributeDescriptions, vk::PipelineLayout pipelineLayout) {
+    auto pipelineConfig = OdysseyPipeline::defaultPipelineConfigInfo(variant.primitiveTopology, variant.lineWidth);
+    pipelineConfig.bindingDescriptions = bindingDescriptions;
+    pipelineConfig.attributeDescriptions = attributeDescriptions;
     pipelineConfig.renderPass = renderPass;
-    pipelineConfig.pipelineLayout = m_pipelineLayout;
+    pipelineConfig.pipelineLayout = pipelineLayout ? pipelineLayout : m_pipelineLayout;
+    variant.specialize(pipelineConfig);
     return std::make_unique<OdysseyPipeline>(m_device, vertShaderPath, fragShaderPath, pipelineConfig);
 }
 
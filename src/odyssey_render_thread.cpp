@@ -0,0 +1,80 @@
+/**
+ * @file odyssey_render_thread.cpp
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include "odyssey_render_thread.h"
+
+#include <utility>
+
+namespace odyssey {
+
+OdysseyRenderThread::OdysseyRenderThread(OdysseyRedrawScheduler* scheduler, CommandCallback commandCallback) : m_scheduler(scheduler), m_commandCallback(std::move(commandCallback)) {
+}
+
+OdysseyRenderThread::~OdysseyRenderThread() {
+    stop();
+}
+
+void OdysseyRenderThread::start() {
+    if (m_thread.joinable()) {
+        return;
+    }
+    m_stopping.store(false, std::memory_order_relaxed);
+    m_thread = std::thread(&OdysseyRenderThread::run, this);
+}
+
+void OdysseyRenderThread::stop() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+    m_stopping.store(true, std::memory_order_release);
+    m_wakeup.release();
+    m_thread.join();
+}
+
+void OdysseyRenderThread::submit(OdysseyRenderCommand command) {
+    while (!m_commands.push(command)) {
+        std::this_thread::yield();
+    }
+    m_wakeup.release();
+}
+
+const OdysseySceneSnapshot& OdysseyRenderThread::getSnapshot() {
+    if ((m_middle.load(std::memory_order_relaxed) & FRESH) != 0) {
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & ~FRESH;
+    }
+    return m_snapshots[m_front];
+}
+
+void OdysseyRenderThread::publish(const OdysseySceneSnapshot& snapshot) {
+    m_snapshots[m_back] = snapshot;
+    m_back = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel) & ~FRESH;
+}
+
+void OdysseyRenderThread::run() {
+    while (true) {
+        // One permit per command, but the queue is drained whole below: drop
+        // the permits first, so one released after this still wakes the wait.
+        while (m_wakeup.try_acquire()) {
+        }
+        if (m_stopping.load(std::memory_order_acquire)) {
+            return;
+        }
+        while (auto command = m_commands.pop()) {
+            m_commandCallback(*command);
+        }
+        auto deadline = m_scheduler->getDeadline();
+        if (deadline && *deadline <= OdysseyRedrawScheduler::Clock::now()) {
+            m_scheduler->fire();
+        } else if (deadline) {
+            // Woken early by a command, or by stop().
+            static_cast<void>(m_wakeup.try_acquire_until(*deadline));
+        } else {
+            m_wakeup.acquire();
+        }
+    }
+}
+
+}  // namespace odyssey
\ No newline at end of file
@@ -0,0 +1,128 @@
+/**
+ * @file odyssey_scene_graph.cpp
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include "odyssey_scene_graph.h"
+
+namespace odyssey {
+
+uint32_t OdysseySceneGraph::addNode(uint32_t parent, const std::string& name, const glm::mat4& localMatrix) {
+    auto count = static_cast<uint32_t>(m_parents.size());
+    auto parentPosition = parent == INVALID_NODE ? INVALID_NODE : m_positions[parent];
+    auto position = count;
+    if (parentPosition != INVALID_NODE) {
+        position = parentPosition + m_subtreeSizes[parentPosition];
+        for (auto i = parentPosition; i != INVALID_NODE; i = m_parents[i]) {
+            ++m_subtreeSizes[i];
+        }
+    }
+    if (position < count) {
+        // Everything from position on moves up by one; ancestors come first
+        // in the array and keep their positions.
+        for (auto& nodeParent : m_parents) {
+            if (nodeParent != INVALID_NODE && nodeParent >= position) {
+                ++nodeParent;
+            }
+        }
+        for (auto& nodePosition : m_positions) {
+            if (nodePosition >= position) {
+                ++nodePosition;
+            }
+        }
+    }
+    auto handle = static_cast<uint32_t>(m_positions.size());
+    m_parents.insert(m_parents.begin() + position, parentPosition);
+    m_subtreeSizes.insert(m_subtreeSizes.begin() + position, 1);
+    m_localMatrices.insert(m_localMatrices.begin() + position, localMatrix);
+    m_worldMatrices.insert(m_worldMatrices.begin() + position, localMatrix);
+    m_localDirty.insert(m_localDirty.begin() + position, 0);
+    m_subtreeDirty.insert(m_subtreeDirty.begin() + position, 0);
+    m_changed.insert(m_changed.begin() + position, 0);
+    m_frames.insert(m_frames.begin() + position, OdysseyTransformStore::INVALID_INDEX);
+    m_attachments.insert(m_attachments.begin() + position, std::vector<uint32_t>{});
+    m_names.insert(m_names.begin() + position, name);
+    m_handles.insert(m_handles.begin() + position, handle);
+    m_positions.push_back(position);
+    markDirty(position);
+    return handle;
+}
+
+void OdysseySceneGraph::attach(uint32_t node, const TransformComponent& transform) {
+    auto position = m_positions[node];
+    auto& transforms = OdysseyTransformStore::instance();
+    if (m_frames[position] == OdysseyTransformStore::INVALID_INDEX) {
+        m_frames[position] = transforms.createFrame();
+        transforms.setFrame(m_frames[position], m_worldMatrices[position]);
+    }
+    m_attachments[position].push_back(transform.getIndex());
+    transforms.setParentFrame(transform.getIndex(), m_frames[position]);
+}
+
+void OdysseySceneGraph::setLocalMatrix(uint32_t node, const glm::mat4& localMatrix) {
+    auto position = m_positions[node];
+    m_localMatrices[position] = localMatrix;
+    markDirty(position);
+}
+
+const glm::mat4& OdysseySceneGraph::getLocalMatrix(uint32_t node) const {
+    return m_localMatrices[m_positions[node]];
+}
+
+const glm::mat4& OdysseySceneGraph::getWorldMatrix(uint32_t node) const {
+    return m_worldMatrices[m_positions[node]];
+}
+
+const std::string& OdysseySceneGraph::getName(uint32_t node) const {
+    return m_names[m_positions[node]];
+}
+
+uint32_t OdysseySceneGraph::getParent(uint32_t node) const {
+    auto parent = m_parents[m_positions[node]];
+    return parent == INVALID_NODE ? INVALID_NODE : m_handles[parent];
+}
+
+size_t OdysseySceneGraph::getNodeCount() const {
+    return m_parents.size();
+}
+
+size_t OdysseySceneGraph::update() {
+    auto& transforms = OdysseyTransformStore::instance();
+    size_t changedCount{0};
+    size_t position{0};
+    while (position < m_parents.size()) {
+        auto parent = m_parents[position];
+        bool parentChanged = parent != INVALID_NODE && m_changed[parent] != 0;
+        if (!parentChanged && m_subtreeDirty[position] == 0) {
+            position += m_subtreeSizes[position];
+            continue;
+        }
+        // Once a node changes, so does everything below it.
+        bool changed = parentChanged || m_localDirty[position] != 0;
+        m_changed[position] = changed ? 1 : 0;
+        if (changed) {
+            m_worldMatrices[position] = parent == INVALID_NODE ? m_localMatrices[position] : m_worldMatrices[parent] * m_localMatrices[position];
+            if (m_frames[position] != OdysseyTransformStore::INVALID_INDEX) {
+                transforms.setFrame(m_frames[position], m_worldMatrices[position]);
+                for (auto index : m_attachments[position]) {
+                    transforms.markDirty(index);
+                }
+            }
+            ++changedCount;
+        }
+        m_localDirty[position] = 0;
+        m_subtreeDirty[position] = 0;
+        ++position;
+    }
+    return changedCount;
+}
+
+void OdysseySceneGraph::markDirty(uint32_t position) {
+    m_localDirty[position] = 1;
+    for (auto i = position; i != INVALID_NODE && m_subtreeDirty[i] == 0; i = m_parents[i]) {
+        m_subtreeDirty[i] = 1;
+    }
+}
+
+}  // namespace odyssey
\ No newline at end of file
@@ -0,0 +1,114 @@
+/**
+ * @file odyssey_static_batcher.cpp
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include "odyssey_static_batcher.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "odyssey_bvh.h"
+
+namespace odyssey {
+
+OdysseyStaticBatcher::OdysseyStaticBatcher(OdysseyDevice* device) : m_device(device) {
+}
+
+std::vector<OdysseyObject> OdysseyStaticBatcher::merge(std::vector<OdysseyObject> objects) {
+    std::vector<OdysseyObject> result{};
+    std::vector<size_t> mergeable{};
+    std::vector<glm::vec3> centers{};
+    OdysseyAabb bounds{};
+    for (size_t i = 0; i < objects.size(); ++i) {
+        auto& object = objects[i];
+        if (!object.model || object.model->getVertices().empty()) {
+            result.push_back(std::move(object));
+            continue;
+        }
+        const auto& modelBounds = object.model->getBounds();
+        auto worldBounds = OdysseyAabb{modelBounds.min, modelBounds.max}.transformed(object.transform.mat4());
+        mergeable.push_back(i);
+        centers.push_back((worldBounds.min + worldBounds.max) * 0.5F);
+        bounds.grow(centers.back());
+    }
+    if (mergeable.empty()) {
+        return result;
+    }
+
+    // Cubic cells, so a flat layout gets a single layer of them.
+    auto extent = bounds.max - bounds.min;
+    auto cellSize = (std::max)({extent.x, extent.y, extent.z}) / static_cast<float>(CELLS_PER_AXIS);
+    std::vector<std::pair<uint32_t, size_t>> cellObjects{};
+    cellObjects.reserve(mergeable.size());
+    for (size_t i = 0; i < mergeable.size(); ++i) {
+        glm::uvec3 cell{0};
+        if (cellSize > 0.0F) {
+            cell = glm::min(glm::uvec3((centers[i] - bounds.min) / cellSize), glm::uvec3(CELLS_PER_AXIS - 1));
+        }
+        cellObjects.emplace_back(cell.x + CELLS_PER_AXIS * (cell.y + CELLS_PER_AXIS * cell.z), mergeable[i]);
+    }
+    std::sort(cellObjects.begin(), cellObjects.end());
+
+    size_t begin{0};
+    while (begin < cellObjects.size()) {
+        auto end = begin;
+        OdysseyModel::Builder builder{};
+        Cell cell{};
+        for (; end < cellObjects.size() && cellObjects[end].first == cellObjects[begin].first; ++end) {
+            auto& object = objects[cellObjects[end].second];
+            const auto& model = *object.model;
+            const auto& matrix = object.transform.mat4();
+            auto normalMatrix = glm::mat3(object.transform.normal());
+            auto firstVertex = static_cast<uint32_t>(builder.vertices.size());
+            cell.firstTriangles.push_back(static_cast<uint32_t>(builder.indices.size() / 3));
+            cell.sources.push_back(static_cast<uint32_t>(m_sources.size()));
+            for (auto vertex : model.getVertices()) {
+                vertex.position = glm::vec3(matrix * glm::vec4(vertex.position, 1.0F));
+                vertex.normal = glm::normalize(normalMatrix * vertex.normal);
+                builder.vertices.push_back(vertex);
+            }
+            // Models drawn without an index buffer get one here.
+            const auto& indices = model.getIndices();
+            if (indices.empty()) {
+                for (uint32_t index = 0; index < model.getVertexCount(); ++index) {
+                    builder.indices.push_back(firstVertex + index);
+                }
+            } else {
+                for (auto index : indices) {
+                    builder.indices.push_back(firstVertex + index);
+                }
+            }
+            m_sources.push_back(std::move(object));
+        }
+        auto cellModel = std::make_shared<OdysseyModel>(m_device, builder);
+        m_cells.emplace(cellModel.get(), std::move(cell));
+        auto cellObject = OdysseyObject::createObject();
+        cellObject.model = std::move(cellModel);
+        result.push_back(std::move(cellObject));
+        begin = end;
+    }
+    return result;
+}
+
+std::optional<OdysseyStaticBatcher::Source> OdysseyStaticBatcher::findSource(const OdysseyModel* model, uint32_t triangle) const {
+    auto iter = m_cells.find(model);
+    if (iter == m_cells.end()) {
+        return std::nullopt;
+    }
+    // The first range starts at triangle 0, so one always precedes it.
+    const auto& firstTriangles = iter->second.firstTriangles;
+    auto range = static_cast<size_t>(std::upper_bound(firstTriangles.begin(), firstTriangles.end(), triangle) - firstTriangles.begin()) - 1;
+    return Source{&m_sources[iter->second.sources[range]], triangle - firstTriangles[range]};
+}
+
+size_t OdysseyStaticBatcher::getMergedCount() const {
+    return m_sources.size();
+}
+
+size_t OdysseyStaticBatcher::getCellCount() const {
+    return m_cells.size();
+}
+
+}  // namespace odyssey
\ No newline at end of file
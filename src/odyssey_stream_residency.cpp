@@ -0,0 +1,186 @@
+/**
+ * @file odyssey_stream_residency.cpp
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include "odyssey_stream_residency.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+
+#include "odyssey_device.h"
+#include "odyssey_swap_chain.h"
+
+namespace odyssey {
+
+OdysseyStreamResidency::OdysseyStreamResidency(OdysseyDevice* device, const std::string& path, std::vector<Range> ranges, vk::BufferUsageFlags usage, vk::AccessFlags readAccess)
+    : m_device(device), m_path(path), m_ranges(std::move(ranges)), m_usage(usage | vk::BufferUsageFlagBits::eTransferDst), m_readAccess(readAccess) {
+    m_items.resize(m_ranges.size());
+    m_retired.resize(OdysseySwapChain::MAX_FRAMES_IN_FLIGHT);
+    m_ioThread = std::thread(&OdysseyStreamResidency::ioLoop, this);
+}
+
+OdysseyStreamResidency::~OdysseyStreamResidency() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wakeup.notify_all();
+    m_ioThread.join();
+}
+
+void OdysseyStreamResidency::beginFrame(size_t frameIndex) {
+    // This frame's fence has been waited on, so what it last used is idle.
+    m_retired[frameIndex].clear();
+}
+
+void OdysseyStreamResidency::request(const std::vector<uint32_t>& items) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // Whatever was requested and not read yet is wanted again below, or
+        // no longer at all; items being read stay requested.
+        for (auto item : m_requests) {
+            m_items[item].state = State::UNLOADED;
+        }
+        m_requests.clear();
+        for (auto item : items) {
+            if (m_items[item].state == State::UNLOADED) {
+                m_items[item].state = State::REQUESTED;
+                m_requests.push_back(item);
+            }
+        }
+    }
+    m_wakeup.notify_one();
+}
+
+void OdysseyStreamResidency::upload(vk::CommandBuffer commandBuffer, size_t frameIndex, size_t maxUploads, const AdmitCallback& admit) {
+    std::vector<std::pair<uint32_t, std::vector<char>>> loaded{};
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto count = (std::min)(m_loaded.size(), maxUploads);
+        loaded.assign(std::make_move_iterator(m_loaded.begin()), std::make_move_iterator(m_loaded.begin() + static_cast<std::ptrdiff_t>(count)));
+        m_loaded.erase(m_loaded.begin(), m_loaded.begin() + static_cast<std::ptrdiff_t>(count));
+    }
+    bool uploaded{false};
+    for (auto& [item, data] : loaded) {
+        auto& entry = m_items[item];
+        if (entry.state != State::REQUESTED) {
+            continue;
+        }
+        if (data.empty() || !admit(item, data.size())) {
+            entry.state = State::UNLOADED;
+            continue;
+        }
+        entry.buffer = std::make_unique<OdysseyBuffer>(m_device, data.size(), 1, m_usage, vk::MemoryPropertyFlagBits::eDeviceLocal);
+        auto staging = std::make_unique<OdysseyBuffer>(
+            m_device,
+            data.size(),
+            1,
+            vk::BufferUsageFlagBits::eTransferSrc,
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+        staging->map();
+        staging->writeToBuffer(data.data(), data.size());
+        vk::BufferCopy region{0, 0, data.size()};
+        commandBuffer.copyBuffer(staging->getBuffer(), entry.buffer->getBuffer(), region);
+        m_retired[frameIndex].push_back(std::move(staging));
+        entry.state = State::RESIDENT;
+        m_residentBytes += data.size();
+        ++m_residentCount;
+        uploaded = true;
+    }
+    if (!uploaded) {
+        return;
+    }
+    vk::MemoryBarrier uploadBarrier{};
+    uploadBarrier
+        .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+        .setDstAccessMask(m_readAccess);
+    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eVertexInput, {}, uploadBarrier, nullptr, nullptr);
+}
+
+void OdysseyStreamResidency::evict(uint32_t item, size_t frameIndex) {
+    auto& entry = m_items[item];
+    // Frames still in flight may draw from it.
+    m_retired[frameIndex].push_back(std::move(entry.buffer));
+    entry.state = State::UNLOADED;
+    m_residentBytes -= m_ranges[item].size;
+    --m_residentCount;
+    ++m_evictionCount;
+}
+
+OdysseyStreamResidency::State OdysseyStreamResidency::getState(uint32_t item) const {
+    return m_items[item].state;
+}
+
+vk::Buffer OdysseyStreamResidency::getBuffer(uint32_t item) const {
+    return m_items[item].buffer->getBuffer();
+}
+
+uint64_t OdysseyStreamResidency::getSize(uint32_t item) const {
+    return m_ranges[item].size;
+}
+
+uint64_t OdysseyStreamResidency::getResidentBytes() const {
+    return m_residentBytes;
+}
+
+size_t OdysseyStreamResidency::getResidentCount() const {
+    return m_residentCount;
+}
+
+uint64_t OdysseyStreamResidency::getEvictionCount() const {
+    return m_evictionCount;
+}
+
+size_t OdysseyStreamResidency::getPendingCount() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_requests.size();
+}
+
+uint64_t OdysseyStreamResidency::getBytesRead() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_bytesRead;
+}
+
+double OdysseyStreamResidency::getReadSeconds() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_readSeconds;
+}
+
+void OdysseyStreamResidency::ioLoop() {
+    std::ifstream file(m_path, std::ios::binary);
+    while (true) {
+        uint32_t item{0};
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeup.wait(lock, [this]() {
+                return m_stopping || !m_requests.empty();
+            });
+            if (m_stopping) {
+                return;
+            }
+            item = m_requests.back();
+            m_requests.pop_back();
+        }
+        auto start = std::chrono::steady_clock::now();
+        const auto& range = m_ranges[item];
+        std::vector<char> data(range.size);
+        file.seekg(static_cast<std::streamoff>(range.offset));
+        file.read(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!file) {
+            // Left requested, so a truncated file does not retry every frame.
+            file.clear();
+            continue;
+        }
+        auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_bytesRead += data.size();
+        m_readSeconds += seconds;
+        m_loaded.emplace_back(item, std::move(data));
+    }
+}
+
+}  // namespace odyssey
\ No newline at end of file
@@ -6,21 +6,23 @@
 
 #include "odyssey_swap_chain.h"
 
+#include <algorithm>
 #include <array>
 #include <limits>
 
 #include "odyssey_device.h"
+#include "odyssey_profiler.h"
 
 namespace odyssey {
 
-OdysseySwapChain::OdysseySwapChain(OdysseyDevice* device, int width, int height) : m_device(device) {
+OdysseySwapChain::OdysseySwapChain(OdysseyDevice* device, vk::RenderPass renderPass, int width, int height, const OdysseyLatencyPolicy& policy, bool sampledDepth, OdysseySwapChain* previous) : m_device(device), m_policy(policy), m_sampledDepth(sampledDepth), m_renderPass(renderPass) {
+    m_framesInFlight = std::clamp<size_t>(policy.framesInFlight, 1, MAX_FRAMES_IN_FLIGHT);
     m_windowExtent.setWidth(width);
     m_windowExtent.setHeight(height);
-    createSwapChain();
-    createRenderPass();
+    createSwapChain(previous);
     createDepthResources();
     createFrameBuffers();
-    createSyncObjects();
+    createSyncObjects(previous);
 }
 
 OdysseySwapChain::~OdysseySwapChain() {
@@ -40,12 +42,11 @@ OdysseySwapChain::~OdysseySwapChain() {
     for (auto& framebuffer : m_swapChainFrameBuffers) {
         m_device->device().destroyFramebuffer(framebuffer);
     }
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+    for (size_t i = 0; i < m_inFlightFences.size(); ++i) {
         m_device->device().destroySemaphore(m_renderFinishedSemaphores[i]);
         m_device->device().destroySemaphore(m_imageAvailableSemaphores[i]);
         m_device->device().destroyFence(m_inFlightFences[i]);
     }
-    m_device->device().destroyRenderPass(m_renderPass);
 }
 
 const vk::Format& OdysseySwapChain::getSwapChainImageFormat() const {
@@ -60,14 +61,30 @@ vk::Extent2D OdysseySwapChain::getSwapChainExtent() const {
     return m_swapChainExtent;
 }
 
+vk::Extent2D OdysseySwapChain::getWindowExtent() const {
+    return m_windowExtent;
+}
+
 const vk::Framebuffer& OdysseySwapChain::getFrameBuffer(size_t index) const {
-    return m_swapChainFrameBuffers[index];
+    return m_swapChainFrameBuffers[m_currentFrame * getImageCount() + index];
+}
+
+const vk::Image& OdysseySwapChain::getImage(size_t index) const {
+    return m_swapChainImages[index];
 }
 
 const vk::ImageView& OdysseySwapChain::getImageView(size_t index) const {
     return m_swapChainImageViews[index];
 }
 
+const vk::Image& OdysseySwapChain::getDepthImage(size_t index) const {
+    return m_depthImages[index];
+}
+
+const vk::ImageView& OdysseySwapChain::getDepthImageView(size_t index) const {
+    return m_depthImageViews[index];
+}
+
 const vk::RenderPass& OdysseySwapChain::getRenderPass() const {
     return m_renderPass;
 }
@@ -84,9 +101,35 @@ float OdysseySwapChain::getExtentAspectRatio() const {
     return static_cast<float>(m_swapChainExtent.width) / static_cast<float>(m_swapChainExtent.height);
 }
 
+size_t OdysseySwapChain::getCurrentFrame() const {
+    return m_currentFrame;
+}
+
+size_t OdysseySwapChain::getFramesInFlight() const {
+    return m_framesInFlight;
+}
+
+size_t OdysseySwapChain::getPreviousFrame() const {
+    return (m_currentFrame + m_framesInFlight - 1) % m_framesInFlight;
+}
+
+vk::PresentModeKHR OdysseySwapChain::getPresentMode() const {
+    return m_presentMode;
+}
+
+bool OdysseySwapChain::isSuboptimal() const {
+    return m_suboptimal;
+}
+
+void OdysseySwapChain::waitForFrame(size_t frame) const {
+    [[maybe_unused]] auto res = m_device->device().waitForFences(m_inFlightFences[frame], true, (std::numeric_limits<uint64_t>::max)());
+}
+
 uint32_t OdysseySwapChain::acquireNextImage() {
-    [[maybe_unused]] auto res = m_device->device().waitForFences(m_inFlightFences[m_currentFrame], true, (std::numeric_limits<uint64_t>::max)());
-    return m_device->device().acquireNextImageKHR(m_swapChain, (std::numeric_limits<uint64_t>::max)(), m_imageAvailableSemaphores[m_currentFrame], nullptr).value;
+    waitForFrame(m_currentFrame);
+    auto result = m_device->device().acquireNextImageKHR(m_swapChain, (std::numeric_limits<uint64_t>::max)(), m_imageAvailableSemaphores[m_currentFrame], nullptr);
+    m_suboptimal = m_suboptimal || result.result == vk::Result::eSuboptimalKHR;
+    return result.value;
 }
 
 void OdysseySwapChain::submitCommandBuffers(const vk::CommandBuffer& buffer, uint32_t imageIndex) {
@@ -94,42 +137,47 @@ void OdysseySwapChain::submitCommandBuffers(const vk::CommandBuffer& buffer, uin
         [[maybe_unused]] auto res = m_device->device().waitForFences(m_imagesInFlight[imageIndex], true, (std::numeric_limits<uint64_t>::max)());
     }
     m_imagesInFlight[imageIndex] = m_inFlightFences[m_currentFrame];
+    // Advance before presenting: an out-of-date present still consumes the
+    // semaphores and the submitted work must be attributed to this frame.
+    auto frame = m_currentFrame;
+    m_currentFrame = (m_currentFrame + 1) % m_framesInFlight;
 
     vk::SubmitInfo submitInfo;
     vk::PipelineStageFlags waitDstStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput;
     submitInfo
         .setWaitSemaphoreCount(1)
-        .setWaitSemaphores(m_imageAvailableSemaphores[m_currentFrame])
+        .setWaitSemaphores(m_imageAvailableSemaphores[frame])
         .setWaitDstStageMask(waitDstStageMask)
         .setCommandBufferCount(1)
         .setCommandBuffers(buffer)
         .setSignalSemaphoreCount(1)
-        .setSignalSemaphores(m_renderFinishedSemaphores[m_currentFrame]);
+        .setSignalSemaphores(m_renderFinishedSemaphores[frame]);
 
-    m_device->device().resetFences(m_inFlightFences[m_currentFrame]);
+    m_device->device().resetFences(m_inFlightFences[frame]);
 
-    m_device->getGraphicsQueue().submit(submitInfo, m_inFlightFences[m_currentFrame]);
+    m_device->getGraphicsQueue().submit(submitInfo, m_inFlightFences[frame]);
 
     vk::PresentInfoKHR presentInfo;
     presentInfo
         .setWaitSemaphoreCount(1)
-        .setWaitSemaphores(m_renderFinishedSemaphores[m_currentFrame])
+        .setWaitSemaphores(m_renderFinishedSemaphores[frame])
         .setSwapchainCount(1)
         .setSwapchains(m_swapChain)
         .setImageIndices(imageIndex);
 
-    [[maybe_unused]] auto res = m_device->getPresentQueue().presentKHR(presentInfo);
-    m_currentFrame = (m_currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+    auto result = m_device->getPresentQueue().presentKHR(presentInfo);
+    m_suboptimal = m_suboptimal || result == vk::Result::eSuboptimalKHR;
 }
 
-void OdysseySwapChain::createSwapChain() {
+void OdysseySwapChain::createSwapChain(OdysseySwapChain* previous) {
     auto swapChainSupport = m_device->getSwapChainSupport();
     auto surfaceFormat = chooseSwapSurfaceFormat(swapChainSupport.formats);
     m_swapChainImageFormat = surfaceFormat.format;
-    auto presentMode = chooseSwapPresentMode(swapChainSupport.presentModes);
+    auto presentMode = chooseSwapPresentMode(swapChainSupport.presentModes, m_policy.presentMode);
+    m_presentMode = presentMode;
     auto extent = chooseSwapExtent(swapChainSupport.capabilities);
     m_swapChainExtent = extent;
-    uint32_t imageCount = swapChainSupport.capabilities.minImageCount + 1;
+    uint32_t imageCount = m_policy.imageCount > 0 ? (std::max)(m_policy.imageCount, swapChainSupport.capabilities.minImageCount) : swapChainSupport.capabilities.minImageCount + 1;
     if (swapChainSupport.capabilities.maxImageCount > 0 && imageCount > swapChainSupport.capabilities.maxImageCount) {
         imageCount = swapChainSupport.capabilities.maxImageCount;
     }
@@ -145,7 +193,8 @@ void OdysseySwapChain::createSwapChain() {
         .setPreTransform(swapChainSupport.capabilities.currentTransform)
         .setCompositeAlpha(vk::CompositeAlphaFlagBitsKHR::eOpaque)
         .setPresentMode(presentMode)
-        .setClipped(true);
+        .setClipped(true)
+        .setOldSwapchain(previous != nullptr ? previous->m_swapChain : nullptr);
     auto indices = m_device->findPhysicalQueueFamilies();
     if (indices.graphicsFamily != indices.presentFamily) {
         std::array<uint32_t, 2> queueFamilyIndices{indices.graphicsFamily, indices.presentFamily};
@@ -165,104 +214,129 @@ void OdysseySwapChain::createSwapChain() {
     }
 }
 
-void OdysseySwapChain::createRenderPass() {
-    vk::AttachmentDescription depthAttachment{};
-    depthAttachment
-        .setFormat(findDepthFormat())
-        .setSamples(vk::SampleCountFlagBits::e1)
-        .setLoadOp(vk::AttachmentLoadOp::eClear)
-        .setStoreOp(vk::AttachmentStoreOp::eDontCare)
-        .setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
-        .setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
-        .setInitialLayout(vk::ImageLayout::eUndefined)
-        .setFinalLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal);
-    vk::AttachmentReference depthAttachmentReference;
-    depthAttachmentReference
-        .setAttachment(1)
-        .setLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal);
-
-    vk::AttachmentDescription colorAttachment;
-    colorAttachment
-        .setFormat(getSwapChainImageFormat())
-        .setSamples(vk::SampleCountFlagBits::e1)
-        .setLoadOp(vk::AttachmentLoadOp::eClear)
-        .setStoreOp(vk::AttachmentStoreOp::eStore)
-        .setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
-        .setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
-        .setInitialLayout(vk::ImageLayout::eUndefined)
-        .setFinalLayout(vk::ImageLayout::ePresentSrcKHR);
-    vk::AttachmentReference colorAttachmentReference;
-    colorAttachmentReference
-        .setAttachment(0)
-        .setLayout(vk::ImageLayout::eColorAttachmentOptimal);
-
-    vk::SubpassDescription subpass;
-    subpass
-        .setPipelineBindPoint(vk::PipelineBindPoint::eGraphics)
-        .setColorAttachmentCount(1)
-        .setColorAttachments(colorAttachmentReference)
-        .setPDepthStencilAttachment(&depthAttachmentReference);
-
-    vk::SubpassDependency dependency;
-    dependency
-        .setSrcSubpass(VK_SUBPASS_EXTERNAL)
-        .setSrcAccessMask(vk::AccessFlagBits::eNone)
-        .setSrcStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eEarlyFragmentTests)
-        .setDstSubpass(0)
-        .setDstStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eEarlyFragmentTests)
-        .setDstAccessMask(vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentWrite);
-
-    std::array<vk::AttachmentDescription, 2> attachments{colorAttachment, depthAttachment};
-
-    vk::RenderPassCreateInfo renderPassInfo;
-    renderPassInfo
-        .setAttachmentCount(static_cast<uint32_t>(attachments.size()))
-        .setAttachments(attachments)
-        .setSubpassCount(1)
-        .setSubpasses(subpass)
-        .setDependencyCount(1)
-        .setDependencies(dependency);
-    m_renderPass = m_device->device().createRenderPass(renderPassInfo);
-}
-
 void OdysseySwapChain::createDepthResources() {
-    auto depthFormat = findDepthFormat();
+    // Depth is cleared on load and discarded on store, so only the frames in
+    // flight need their own image, and tiled GPUs can keep it in on-chip memory.
+    // Occlusion culling reads it back mid-frame, which rules out transient memory.
+    auto depthFormat = findDepthFormat(m_device);
     auto swapChainExtent = getSwapChainExtent();
-    m_depthImages.resize(getImageCount());
-    m_depthImageMemories.resize(getImageCount());
-    m_depthImageViews.resize(getImageCount());
+    auto lazilyAllocated = !m_sampledDepth && supportsLazilyAllocatedDepth(depthFormat, swapChainExtent);
+    vk::ImageUsageFlags usage = vk::ImageUsageFlagBits::eDepthStencilAttachment;
+    if (m_sampledDepth) {
+        usage |= vk::ImageUsageFlagBits::eSampled;
+    }
+    vk::MemoryPropertyFlags properties = vk::MemoryPropertyFlagBits::eDeviceLocal;
+    if (lazilyAllocated) {
+        usage |= vk::ImageUsageFlagBits::eTransientAttachment;
+        properties |= vk::MemoryPropertyFlagBits::eLazilyAllocated;
+    }
+    m_depthImages.resize(m_framesInFlight);
+    m_depthImageMemories.resize(m_framesInFlight);
+    m_depthImageViews.resize(m_framesInFlight);
     for (size_t i = 0; i < m_depthImages.size(); ++i) {
-        m_device->createImage(swapChainExtent.width, swapChainExtent.height, depthFormat, vk::ImageTiling::eOptimal, vk::ImageUsageFlagBits::eDepthStencilAttachment, vk::MemoryPropertyFlagBits::eDeviceLocal, m_depthImages[i], m_depthImageMemories[i]);
+        m_device->createImage(swapChainExtent.width, swapChainExtent.height, depthFormat, vk::ImageTiling::eOptimal, usage, properties, m_depthImages[i], m_depthImageMemories[i]);
         m_depthImageViews[i] = m_device->createImageView(m_depthImages[i], depthFormat, vk::ImageAspectFlagBits::eDepth);
     }
+    reportDepthMemory(depthFormat, usage, lazilyAllocated);
+}
+
+bool OdysseySwapChain::supportsLazilyAllocatedDepth(vk::Format depthFormat, vk::Extent2D extent) const {
+    // The memory types an image may be bound to depend on its format and
+    // usage, so ask a throwaway transient depth image rather than the device.
+    vk::ImageCreateInfo imageInfo{};
+    imageInfo
+        .setImageType(vk::ImageType::e2D)
+        .setMipLevels(1)
+        .setArrayLayers(1)
+        .setFormat(depthFormat)
+        .setTiling(vk::ImageTiling::eOptimal)
+        .setInitialLayout(vk::ImageLayout::eUndefined)
+        .setUsage(vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eTransientAttachment)
+        .setSharingMode(vk::SharingMode::eExclusive)
+        .setSamples(vk::SampleCountFlagBits::e1);
+    imageInfo.extent
+        .setWidth(extent.width)
+        .setHeight(extent.height)
+        .setDepth(1);
+    auto image = m_device->device().createImage(imageInfo);
+    auto requirements = m_device->device().getImageMemoryRequirements(image);
+    m_device->device().destroyImage(image);
+    return m_device->supportsMemoryProperties(requirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eLazilyAllocated);
+}
+
+void OdysseySwapChain::reportDepthMemory(vk::Format depthFormat, vk::ImageUsageFlags usage, bool lazilyAllocated) const {
+    auto& profiler = OdysseyProfiler::instance();
+    vk::DeviceSize committed{0};
+    for (const auto& memory : m_depthImageMemories) {
+        committed += lazilyAllocated ? m_device->device().getMemoryCommitment(memory) : m_device->device().getImageMemoryRequirements(m_depthImages[0]).size;
+    }
+    profiler.setCounter("depth images", static_cast<double>(m_depthImages.size()));
+    profiler.setCounter("depth lazily allocated", lazilyAllocated ? 1.0 : 0.0);
+    profiler.setCounter("depth memory committed (MiB)", static_cast<double>(committed) / (1024.0 * 1024.0));
+
+    // Per-image size at 3840x2160, for comparing one depth image per swap chain
+    // image in ordinary device-local memory against the current layout.
+    vk::ImageCreateInfo imageInfo{};
+    imageInfo
+        .setImageType(vk::ImageType::e2D)
+        .setMipLevels(1)
+        .setArrayLayers(1)
+        .setFormat(depthFormat)
+        .setTiling(vk::ImageTiling::eOptimal)
+        .setInitialLayout(vk::ImageLayout::eUndefined)
+        .setUsage(usage)
+        .setSharingMode(vk::SharingMode::eExclusive)
+        .setSamples(vk::SampleCountFlagBits::e1)
+        .setExtent({3840, 2160, 1});
+    auto image = m_device->device().createImage(imageInfo);
+    auto size = static_cast<double>(m_device->device().getImageMemoryRequirements(image).size) / (1024.0 * 1024.0);
+    m_device->device().destroyImage(image);
+    profiler.setCounter("depth memory 4K before (MiB)", size * static_cast<double>(getImageCount()));
+    profiler.setCounter("depth memory 4K after (MiB)", lazilyAllocated ? 0.0 : size * static_cast<double>(m_framesInFlight));
 }
 
 void OdysseySwapChain::createFrameBuffers() {
-    m_swapChainFrameBuffers.resize(getImageCount());
-    for (size_t i = 0; i < getImageCount(); ++i) {
-        std::array<vk::ImageView, 2> attachments{m_swapChainImageViews[i], m_depthImageViews[i]};
-        auto swapChainExtent = getSwapChainExtent();
-        vk::FramebufferCreateInfo framebufferInfo{};
-        framebufferInfo
-            .setRenderPass(m_renderPass)
-            .setAttachmentCount(static_cast<uint32_t>(attachments.size()))
-            .setAttachments(attachments)
-            .setWidth(swapChainExtent.width)
-            .setHeight(swapChainExtent.height)
-            .setLayers(1);
-        m_swapChainFrameBuffers[i] = m_device->device().createFramebuffer(framebufferInfo);
+    // One framebuffer per (frame in flight, swap chain image) pair, since the
+    // depth attachment follows the frame and the color attachment the image.
+    m_swapChainFrameBuffers.resize(m_framesInFlight * getImageCount());
+    for (size_t frame = 0; frame < m_framesInFlight; ++frame) {
+        for (size_t i = 0; i < getImageCount(); ++i) {
+            std::array<vk::ImageView, 2> attachments{m_swapChainImageViews[i], m_depthImageViews[frame]};
+            auto swapChainExtent = getSwapChainExtent();
+            vk::FramebufferCreateInfo framebufferInfo{};
+            framebufferInfo
+                .setRenderPass(m_renderPass)
+                .setAttachmentCount(static_cast<uint32_t>(attachments.size()))
+                .setAttachments(attachments)
+                .setWidth(swapChainExtent.width)
+                .setHeight(swapChainExtent.height)
+                .setLayers(1);
+            m_swapChainFrameBuffers[frame * getImageCount() + i] = m_device->device().createFramebuffer(framebufferInfo);
+        }
     }
 }
 
-void OdysseySwapChain::createSyncObjects() {
-    m_imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    m_renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    m_inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
+void OdysseySwapChain::createSyncObjects(OdysseySwapChain* previous) {
     m_imagesInFlight.resize(getImageCount());
+    if (previous != nullptr && previous->m_framesInFlight == m_framesInFlight) {
+        // Frames still in flight on the retired swap chain keep signalling these,
+        // so the new swap chain carries on with the same fences and semaphores.
+        m_imageAvailableSemaphores = std::move(previous->m_imageAvailableSemaphores);
+        m_renderFinishedSemaphores = std::move(previous->m_renderFinishedSemaphores);
+        m_inFlightFences = std::move(previous->m_inFlightFences);
+        m_currentFrame = previous->m_currentFrame;
+        previous->m_imageAvailableSemaphores.clear();
+        previous->m_renderFinishedSemaphores.clear();
+        previous->m_inFlightFences.clear();
+        return;
+    }
+    m_imageAvailableSemaphores.resize(m_framesInFlight);
+    m_renderFinishedSemaphores.resize(m_framesInFlight);
+    m_inFlightFences.resize(m_framesInFlight);
     vk::SemaphoreCreateInfo semaphoreInfo{};
     vk::FenceCreateInfo fenceInfo{};
     fenceInfo.setFlags(vk::FenceCreateFlagBits::eSignaled);
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+    for (size_t i = 0; i < m_framesInFlight; ++i) {
         m_imageAvailableSemaphores[i] = m_device->device().createSemaphore(semaphoreInfo);
         m_renderFinishedSemaphores[i] = m_device->device().createSemaphore(semaphoreInfo);
         m_inFlightFences[i] = m_device->device().createFence(fenceInfo);
@@ -278,9 +352,9 @@ vk::SurfaceFormatKHR OdysseySwapChain::chooseSwapSurfaceFormat(const std::vector
     return availableFormats[0];
 }
 
-vk::PresentModeKHR OdysseySwapChain::chooseSwapPresentMode(const std::vector<vk::PresentModeKHR>& availablePresentModes) {
+vk::PresentModeKHR OdysseySwapChain::chooseSwapPresentMode(const std::vector<vk::PresentModeKHR>& availablePresentModes, vk::PresentModeKHR preferredPresentMode) {
     for (const auto& availablePresentMode : availablePresentModes) {
-        if (availablePresentMode == vk::PresentModeKHR::eMailbox) {
+        if (availablePresentMode == preferredPresentMode) {
             return availablePresentMode;
         }
     }
@@ -297,8 +371,19 @@ vk::Extent2D OdysseySwapChain::chooseSwapExtent(const vk::SurfaceCapabilitiesKHR
     return actualExtent;
 }
 
-vk::Format OdysseySwapChain::findDepthFormat() const {
-    return m_device->findSupportedFormat({vk::Format::eD32Sfloat, vk::Format::eD32SfloatS8Uint, vk::Format::eD24UnormS8Uint}, vk::ImageTiling::eOptimal, vk::FormatFeatureFlagBits::eDepthStencilAttachment);
+vk::Format OdysseySwapChain::findDepthFormat(const OdysseyDevice* device) {
+    return device->findSupportedFormat({vk::Format::eD32Sfloat, vk::Format::eD32SfloatS8Uint, vk::Format::eD24UnormS8Uint}, vk::ImageTiling::eOptimal, vk::FormatFeatureFlagBits::eDepthStencilAttachment);
+}
+
+vk::ImageAspectFlags OdysseySwapChain::getDepthAspect(vk::Format depthFormat) {
+    switch (depthFormat) {
+        case vk::Format::eD16UnormS8Uint:
+        case vk::Format::eD24UnormS8Uint:
+        case vk::Format::eD32SfloatS8Uint:
+            return vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil;
+        default:
+            return vk::ImageAspectFlagBits::eDepth;
+    }
 }
 
-}  // namespace odyssey
+}  // namespace odyssey
\ No newline at end of file
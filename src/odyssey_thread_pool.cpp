@@ -0,0 +1,121 @@
+/**
+ * @file odyssey_thread_pool.cpp
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include "odyssey_thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace odyssey {
+
+namespace {
+
+thread_local size_t currentThreadIndex{0};
+
+}  // namespace
+
+OdysseyThreadPool& OdysseyThreadPool::instance() {
+    static OdysseyThreadPool threadPool;
+    return threadPool;
+}
+
+OdysseyThreadPool::OdysseyThreadPool() {
+    // The calling thread takes part in every parallelFor, so one core is left
+    // for it.
+    auto workerCount = (std::max)(std::thread::hardware_concurrency(), 2U) - 1;
+    for (unsigned i = 0; i < workerCount; ++i) {
+        m_workers.emplace_back(&OdysseyThreadPool::workerLoop, this, i + 1);
+    }
+}
+
+OdysseyThreadPool::~OdysseyThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wakeup.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void OdysseyThreadPool::parallelFor(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)>& function) {
+    grainSize = (std::max)(grainSize, size_t{1});
+    auto chunkCount = (count + grainSize - 1) / grainSize;
+    if (chunkCount <= 1 || m_workers.empty()) {
+        if (count > 0) {
+            function(0, count);
+        }
+        return;
+    }
+
+    // Helpers that wake up after the last chunk was claimed only touch the
+    // shared state, which they keep alive themselves.
+    struct Job {
+        std::atomic<size_t> nextChunk{0};
+        std::atomic<size_t> finishedChunks{0};
+        std::mutex mutex{};
+        std::condition_variable done{};
+    };
+    auto job = std::make_shared<Job>();
+    auto run = [job, chunkCount, count, grainSize, &function]() {
+        for (auto chunk = job->nextChunk++; chunk < chunkCount; chunk = job->nextChunk++) {
+            auto begin = chunk * grainSize;
+            function(begin, (std::min)(begin + grainSize, count));
+            if (++job->finishedChunks == chunkCount) {
+                std::lock_guard<std::mutex> lock(job->mutex);
+                job->done.notify_all();
+            }
+        }
+    };
+    auto helperCount = (std::min)(chunkCount - 1, m_workers.size());
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (size_t i = 0; i < helperCount; ++i) {
+            m_tasks.emplace_back(run);
+        }
+    }
+    if (helperCount == 1) {
+        m_wakeup.notify_one();
+    } else {
+        m_wakeup.notify_all();
+    }
+    run();
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->done.wait(lock, [&job, chunkCount]() {
+        return job->finishedChunks == chunkCount;
+    });
+}
+
+size_t OdysseyThreadPool::getThreadCount() const {
+    return m_workers.size() + 1;
+}
+
+size_t OdysseyThreadPool::getThreadIndex() {
+    return currentThreadIndex;
+}
+
+void OdysseyThreadPool::workerLoop(size_t threadIndex) {
+    currentThreadIndex = threadIndex;
+    while (true) {
+        std::function<void()> task{};
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeup.wait(lock, [this]() {
+                return m_stopping || !m_tasks.empty();
+            });
+            if (m_stopping && m_tasks.empty()) {
+                return;
+            }
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        task();
+    }
+}
+
+}  // namespace odyssey
\ No newline at end of file
@@ -0,0 +1,375 @@
+/**
+ * @file odyssey_transform_store.cpp
+ * @author liuyulvv (liuyulvv@outlook.com)
+ * @date 2026-10-19
+ */
+
+#include "odyssey_transform_store.h"
+
+#include <algorithm>
+
+#include "glm/gtc/matrix_inverse.hpp"
+
+#include "odyssey_thread_pool.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define ODYSSEY_TRANSFORM_X86
+#include <immintrin.h>
+#endif
+
+namespace odyssey {
+
+namespace {
+
+#if defined(ODYSSEY_TRANSFORM_X86)
+
+// Cephes-style sinf and cosf, four lanes at a time: x is reduced to
+// [-pi/4, pi/4] around the nearest multiple j of pi/4 (j even), and the octant
+// picks the polynomial and sign. Accurate to a few ulp for |x| < 8192.
+void sinCos(__m128 x, __m128& sine, __m128& cosine) {
+    const auto signMask = _mm_set1_ps(-0.0F);
+    auto sineSign = _mm_and_ps(x, signMask);
+    x = _mm_andnot_ps(signMask, x);
+
+    auto j = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.27323954473516F)));
+    j = _mm_and_si128(_mm_add_epi32(j, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+    auto y = _mm_cvtepi32_ps(j);
+    // pi/4 in three parts, so the reduction stays exact for large j.
+    x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(0.78515625F)));
+    x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(2.4187564849853515625e-4F)));
+    x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(3.77489497744594108e-8F)));
+
+    auto z = _mm_mul_ps(x, x);
+    auto sinePolynomial = _mm_set1_ps(-1.9515295891e-4F);
+    sinePolynomial = _mm_add_ps(_mm_mul_ps(sinePolynomial, z), _mm_set1_ps(8.3321608736e-3F));
+    sinePolynomial = _mm_add_ps(_mm_mul_ps(sinePolynomial, z), _mm_set1_ps(-1.6666654611e-1F));
+    sinePolynomial = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sinePolynomial, z), x), x);
+    auto cosinePolynomial = _mm_set1_ps(2.443315711809948e-5F);
+    cosinePolynomial = _mm_add_ps(_mm_mul_ps(cosinePolynomial, z), _mm_set1_ps(-1.388731625493765e-3F));
+    cosinePolynomial = _mm_add_ps(_mm_mul_ps(cosinePolynomial, z), _mm_set1_ps(4.166664568298827e-2F));
+    cosinePolynomial = _mm_mul_ps(_mm_mul_ps(cosinePolynomial, z), z);
+    cosinePolynomial = _mm_add_ps(_mm_sub_ps(cosinePolynomial, _mm_mul_ps(z, _mm_set1_ps(0.5F))), _mm_set1_ps(1.0F));
+
+    // Octants 2 and 6 swap the polynomials; sine is negated in octants 4 and
+    // 6, cosine in octants 2 and 4.
+    auto swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, _mm_set1_epi32(2)), _mm_setzero_si128()));
+    sineSign = _mm_xor_ps(sineSign, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, _mm_set1_epi32(4)), 29)));
+    auto cosineSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(j, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+    sine = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, sinePolynomial), _mm_andnot_ps(swap, cosinePolynomial)), sineSign);
+    cosine = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, cosinePolynomial), _mm_andnot_ps(swap, sinePolynomial)), cosineSign);
+}
+
+// Writes column (a[k], b[k], c[k], d[k]) of lane k's matrix.
+void storeColumn(__m128 a, __m128 b, __m128 c, __m128 d, float* const* columns) {
+    _MM_TRANSPOSE4_PS(a, b, c, d);
+    _mm_storeu_ps(columns[0], a);
+    _mm_storeu_ps(columns[1], b);
+    _mm_storeu_ps(columns[2], c);
+    _mm_storeu_ps(columns[3], d);
+}
+
+#endif
+
+}  // namespace
+
+OdysseyTransformStore& OdysseyTransformStore::instance() {
+    static OdysseyTransformStore transformStore;
+    return transformStore;
+}
+
+uint32_t OdysseyTransformStore::create() {
+    uint32_t index{};
+    if (m_freeIndices.empty()) {
+        index = static_cast<uint32_t>(m_matrices.size());
+        for (auto* values : {&m_translationX, &m_translationY, &m_translationZ, &m_rotationX, &m_rotationY, &m_rotationZ, &m_scaleX, &m_scaleY, &m_scaleZ}) {
+            values->emplace_back();
+        }
+        m_matrices.emplace_back(1.0F);
+        m_normalMatrices.emplace_back(1.0F);
+        m_parentFrames.push_back(INVALID_INDEX);
+        m_dirty.push_back(0);
+    } else {
+        index = m_freeIndices.back();
+        m_freeIndices.pop_back();
+    }
+    setTranslation(index, glm::vec3(0.0F));
+    setRotation(index, glm::vec3(0.0F));
+    setScale(index, glm::vec3(1.0F));
+    m_parentFrames[index] = INVALID_INDEX;
+    return index;
+}
+
+void OdysseyTransformStore::destroy(uint32_t index) {
+    m_freeIndices.push_back(index);
+}
+
+void OdysseyTransformStore::setTranslation(uint32_t index, const glm::vec3& translation) {
+    m_translationX[index] = translation.x;
+    m_translationY[index] = translation.y;
+    m_translationZ[index] = translation.z;
+    markDirty(index);
+}
+
+void OdysseyTransformStore::setRotation(uint32_t index, const glm::vec3& rotation) {
+    m_rotationX[index] = rotation.x;
+    m_rotationY[index] = rotation.y;
+    m_rotationZ[index] = rotation.z;
+    markDirty(index);
+}
+
+void OdysseyTransformStore::setScale(uint32_t index, const glm::vec3& scale) {
+    m_scaleX[index] = scale.x;
+    m_scaleY[index] = scale.y;
+    m_scaleZ[index] = scale.z;
+    markDirty(index);
+}
+
+void OdysseyTransformStore::markDirty(uint32_t index) {
+    if (m_dirty[index] == 0) {
+        m_dirty[index] = 1;
+        m_dirtyIndices.push_back(index);
+    }
+}
+
+uint32_t OdysseyTransformStore::createFrame() {
+    m_frames.emplace_back(1.0F);
+    m_frameNormals.emplace_back(1.0F);
+    return static_cast<uint32_t>(m_frames.size() - 1);
+}
+
+void OdysseyTransformStore::setFrame(uint32_t frame, const glm::mat4& matrix) {
+    m_frames[frame] = matrix;
+    m_frameNormals[frame] = glm::inverseTranspose(glm::mat3(matrix));
+}
+
+void OdysseyTransformStore::setParentFrame(uint32_t index, uint32_t frame) {
+    m_parentFrames[index] = frame;
+    markDirty(index);
+}
+
+glm::vec3 OdysseyTransformStore::getTranslation(uint32_t index) const {
+    return {m_translationX[index], m_translationY[index], m_translationZ[index]};
+}
+
+glm::vec3 OdysseyTransformStore::getRotation(uint32_t index) const {
+    return {m_rotationX[index], m_rotationY[index], m_rotationZ[index]};
+}
+
+glm::vec3 OdysseyTransformStore::getScale(uint32_t index) const {
+    return {m_scaleX[index], m_scaleY[index], m_scaleZ[index]};
+}
+
+const glm::mat4& OdysseyTransformStore::getMatrix(uint32_t index) const {
+    return m_matrices[index];
+}
+
+const glm::mat3x4& OdysseyTransformStore::getNormalMatrix(uint32_t index) const {
+    return m_normalMatrices[index];
+}
+
+const std::vector<glm::mat4>& OdysseyTransformStore::getMatrices() const {
+    return m_matrices;
+}
+
+const std::vector<glm::mat3x4>& OdysseyTransformStore::getNormalMatrices() const {
+    return m_normalMatrices;
+}
+
+size_t OdysseyTransformStore::update() {
+    auto count = m_dirtyIndices.size();
+    if (count == 0) {
+        return 0;
+    }
+    // Each slot is in the list once, so chunks never write the same matrices.
+    OdysseyThreadPool::instance().parallelFor(count, PARALLEL_GRAIN_SIZE, [this](size_t begin, size_t end) {
+        rebuildRange(m_dirtyIndices.data() + begin, end - begin);
+    });
+    for (auto index : m_dirtyIndices) {
+        m_dirty[index] = 0;
+    }
+    m_updatedIndices.swap(m_dirtyIndices);
+    m_dirtyIndices.clear();
+    ++m_version;
+    return count;
+}
+
+size_t OdysseyTransformStore::rebuildAll() {
+    auto count = m_matrices.size();
+    OdysseyThreadPool::instance().parallelFor(count, PARALLEL_GRAIN_SIZE, [this](size_t begin, size_t end) {
+        for (auto i = static_cast<uint32_t>(begin); i < end; ++i) {
+            auto rotation = getRotation(i);
+            auto scale = getScale(i);
+            m_matrices[i] = composeMatrix(getTranslation(i), rotation, scale);
+            m_normalMatrices[i] = composeNormalMatrix(rotation, scale);
+            applyParentFrame(i);
+        }
+    });
+    for (auto index : m_dirtyIndices) {
+        m_dirty[index] = 0;
+    }
+    m_dirtyIndices.clear();
+    m_updatedIndices.clear();
+    ++m_version;
+    return count;
+}
+
+size_t OdysseyTransformStore::getCount() const {
+    return m_matrices.size() - m_freeIndices.size();
+}
+
+size_t OdysseyTransformStore::getDirtyCount() const {
+    return m_dirtyIndices.size();
+}
+
+uint64_t OdysseyTransformStore::getVersion() const {
+    return m_version;
+}
+
+const std::vector<uint32_t>& OdysseyTransformStore::getUpdatedIndices() const {
+    return m_updatedIndices;
+}
+
+glm::mat4 OdysseyTransformStore::composeMatrix(const glm::vec3& translation, const glm::vec3& rotation, const glm::vec3& scale) {
+    const float C3 = glm::cos(rotation.z);
+    const float S3 = glm::sin(rotation.z);
+    const float C2 = glm::cos(rotation.x);
+    const float S2 = glm::sin(rotation.x);
+    const float C1 = glm::cos(rotation.y);
+    const float S1 = glm::sin(rotation.y);
+    return glm::mat4{
+        {
+            scale.x * (C1 * C3 + S1 * S2 * S3),
+            scale.x * (C2 * S3),
+            scale.x * (C1 * S2 * S3 - C3 * S1),
+            0.0F,
+        },
+        {
+            scale.y * (C3 * S1 * S2 - C1 * S3),
+            scale.y * (C2 * C3),
+            scale.y * (C1 * C3 * S2 + S1 * S3),
+            0.0F,
+        },
+        {
+            scale.z * (C2 * S1),
+            scale.z * (-S2),
+            scale.z * (C1 * C2),
+            0.0F,
+        },
+        {translation.x, translation.y, translation.z, 1.0F}};
+}
+
+glm::mat3x4 OdysseyTransformStore::composeNormalMatrix(const glm::vec3& rotation, const glm::vec3& scale) {
+    const float C3 = glm::cos(rotation.z);
+    const float S3 = glm::sin(rotation.z);
+    const float C2 = glm::cos(rotation.x);
+    const float S2 = glm::sin(rotation.x);
+    const float C1 = glm::cos(rotation.y);
+    const float S1 = glm::sin(rotation.y);
+    glm::vec3 inverseScale = 1.0F / scale;
+    return glm::mat3x4{
+        {
+            inverseScale.x * (C1 * C3 + S1 * S2 * S3),
+            inverseScale.x * (C2 * S3),
+            inverseScale.x * (C1 * S2 * S3 - C3 * S1),
+            0.0F,
+        },
+        {
+            inverseScale.y * (C3 * S1 * S2 - C1 * S3),
+            inverseScale.y * (C2 * C3),
+            inverseScale.y * (C1 * C3 * S2 + S1 * S3),
+            0.0F,
+        },
+        {
+            inverseScale.z * (C2 * S1),
+            inverseScale.z * (-S2),
+            inverseScale.z * (C1 * C2),
+            0.0F,
+        },
+    };
+}
+
+void OdysseyTransformStore::applyParentFrame(uint32_t index) {
+    auto frame = m_parentFrames[index];
+    if (frame == INVALID_INDEX) {
+        return;
+    }
+    m_matrices[index] = m_frames[frame] * m_matrices[index];
+    auto& normalMatrix = m_normalMatrices[index];
+    for (int column = 0; column < 3; ++column) {
+        normalMatrix[column] = glm::vec4(m_frameNormals[frame] * glm::vec3(normalMatrix[column]), 0.0F);
+    }
+}
+
+void OdysseyTransformStore::rebuildRange(const uint32_t* indices, size_t count) {
+#if defined(ODYSSEY_TRANSFORM_X86)
+    for (size_t i = 0; i < count; i += 4) {
+        // A short last group repeats its final slot, which only rewrites the
+        // same matrices.
+        uint32_t lanes[4]{};
+        for (size_t lane = 0; lane < 4; ++lane) {
+            lanes[lane] = indices[(std::min)(i + lane, count - 1)];
+        }
+        auto gather = [&lanes](const std::vector<float>& values) {
+            return _mm_setr_ps(values[lanes[0]], values[lanes[1]], values[lanes[2]], values[lanes[3]]);
+        };
+        __m128 S1{};
+        __m128 C1{};
+        __m128 S2{};
+        __m128 C2{};
+        __m128 S3{};
+        __m128 C3{};
+        sinCos(gather(m_rotationY), S1, C1);
+        sinCos(gather(m_rotationX), S2, C2);
+        sinCos(gather(m_rotationZ), S3, C3);
+        auto S1S2 = _mm_mul_ps(S1, S2);
+        auto C1S2 = _mm_mul_ps(C1, S2);
+        auto r00 = _mm_add_ps(_mm_mul_ps(C1, C3), _mm_mul_ps(S1S2, S3));
+        auto r01 = _mm_mul_ps(C2, S3);
+        auto r02 = _mm_sub_ps(_mm_mul_ps(C1S2, S3), _mm_mul_ps(C3, S1));
+        auto r10 = _mm_sub_ps(_mm_mul_ps(S1S2, C3), _mm_mul_ps(C1, S3));
+        auto r11 = _mm_mul_ps(C2, C3);
+        auto r12 = _mm_add_ps(_mm_mul_ps(C1S2, C3), _mm_mul_ps(S1, S3));
+        auto r20 = _mm_mul_ps(C2, S1);
+        auto r21 = _mm_xor_ps(S2, _mm_set1_ps(-0.0F));
+        auto r22 = _mm_mul_ps(C1, C2);
+
+        const auto zero = _mm_setzero_ps();
+        const auto one = _mm_set1_ps(1.0F);
+        __m128 scales[3]{gather(m_scaleX), gather(m_scaleY), gather(m_scaleZ)};
+        __m128 rotation[3][3]{{r00, r01, r02}, {r10, r11, r12}, {r20, r21, r22}};
+        float* columns[4]{};
+        for (int column = 0; column < 3; ++column) {
+            auto scale = scales[column];
+            auto inverseScale = _mm_div_ps(one, scale);
+            for (size_t lane = 0; lane < 4; ++lane) {
+                columns[lane] = &m_matrices[lanes[lane]][column].x;
+            }
+            storeColumn(_mm_mul_ps(rotation[column][0], scale), _mm_mul_ps(rotation[column][1], scale), _mm_mul_ps(rotation[column][2], scale), zero, columns);
+            for (size_t lane = 0; lane < 4; ++lane) {
+                columns[lane] = &m_normalMatrices[lanes[lane]][column].x;
+            }
+            storeColumn(_mm_mul_ps(rotation[column][0], inverseScale), _mm_mul_ps(rotation[column][1], inverseScale), _mm_mul_ps(rotation[column][2], inverseScale), zero, columns);
+        }
+        for (size_t lane = 0; lane < 4; ++lane) {
+            columns[lane] = &m_matrices[lanes[lane]][3].x;
+        }
+        storeColumn(gather(m_translationX), gather(m_translationY), gather(m_translationZ), one, columns);
+        // Parent frames are applied per slot on top of the batch, so a
+        // repeated last slot must only get its frame once.
+        for (size_t lane = 0; lane < 4 && i + lane < count; ++lane) {
+            applyParentFrame(lanes[lane]);
+        }
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+        auto index = indices[i];
+        auto rotation = getRotation(index);
+        auto scale = getScale(index);
+        m_matrices[index] = composeMatrix(getTranslation(index), rotation, scale);
+        m_normalMatrices[index] = composeNormalMatrix(rotation, scale);
+        applyParentFrame(index);
+    }
+#endif
+}
+
+}  // namespace odyssey
\ No newline at end of file
@@ -34,6 +34,17 @@ void OdysseyWindow::setMouseCallback(const std::function<void(const OdysseyMouse
     mouseCallback = callback;
 }
 
+void OdysseyWindow::setResizeCallback(const std::function<void(vk::Extent2D)>& callback) {
+    resizeCallback = callback;
+}
+
+void OdysseyWindow::resizeEvent(QResizeEvent* event) {
+    QWindow::resizeEvent(event);
+    if (resizeCallback) {
+        resizeCallback({static_cast<uint32_t>(event->size().width()), static_cast<uint32_t>(event->size().height())});
+    }
+}
+
 void OdysseyWindow::mouseDoubleClickEvent(QMouseEvent* event) {
     auto button = event->button();
     if (button == Qt::LeftButton) {